@@ -15,18 +15,309 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <sstream>
 
 #include <QtWidgets>
+#include <QtEndian>
 
 #include <boost/cstdint.hpp>
 #include <limits>
+#include <algorithm>
+#include <cstring>
 
 #include "cxTransform3D.h"
 #include "cxPositionStorageFile.h"
+#include "cxPositionStorageIndex.h"
 #include "cxUtilHelpers.h"
 #include "cxTime.h"
 #include "cxTypeConversions.h"
 
 #define EVENT_DATE_FORMAT "yyyy:MM:dd-HH:mm:ss.zzz000"
 
+namespace
+{
+
+void printUsage()
+{
+	std::cout
+		<< "Usage:\n"
+		<< "  sscPositionFileReader [-v] <filename> <timestamp>\n"
+		<< "      Print all positions. Timestamp format " << EVENT_DATE_FORMAT << ", required for version 1 files.\n"
+		<< "  sscPositionFileReader info <filename>\n"
+		<< "      List tools, position counts and time ranges.\n"
+		<< "  sscPositionFileReader csv <filename> <output> [options]\n"
+		<< "  sscPositionFileReader columnar <filename> <output> [options]\n"
+		<< "      Export positions as csv or as columnar binary.\n"
+		<< "\n"
+		<< "Options:\n"
+		<< "  --tool <uid>       Export only this tool. Can be repeated.\n"
+		<< "  --start <ms>       Export only positions at or after this time, in ms since epoch.\n"
+		<< "  --stop <ms>        Export only positions at or before this time, in ms since epoch.\n"
+		<< "  --resample <ms>    Interpolate positions at this interval instead of exporting the recorded ones.\n"
+		<< "\n"
+		<< "Columnar format, all values little endian:\n"
+		<< "  \"CXPOSCOL\" <uint8 version=1>\n"
+		<< "  <uint32 toolCount> toolCount x { <uint32 length> <latin1 toolUid> }\n"
+		<< "  <uint64 N>\n"
+		<< "  N x float64 timestamp (ms since epoch)\n"
+		<< "  N x uint16  tool index\n"
+		<< "  N x float64 x, then y, then z\n"
+		<< "  N x float32 qw, then qx, qy, qz (rotation quaternion)\n";
+}
+
+std::string formatTimestamp(double timestamp)
+{
+	return cx::PositionStorageReader::timestampToString(timestamp).toStdString();
+}
+
+int info(int argc, char **argv)
+{
+	if (argc<3)
+	{
+		printUsage();
+		return 1;
+	}
+
+	cx::PositionStorageIndex index(argv[2]);
+	if (!index.isValid())
+		return 1;
+
+	std::cout << "file [" << argv[2] << "], version " << index.version() << ", " << index.getNumberOfPositions() << " positions" << '\n';
+	QStringList tools = index.getToolUids();
+	for (int i=0; i<tools.size(); ++i)
+	{
+		std::cout << "tool [" << tools[i].toStdString() << "]\t" << index.getNumberOfPositions(i) << " positions";
+		double start, stop;
+		if (index.getTimeRange(i, &start, &stop))
+		{
+			std::cout << "\t" << formatTimestamp(start) << " - " << formatTimestamp(stop)
+					  << "\t[" << qint64(start) << ", " << qint64(stop) << "]";
+		}
+		std::cout << '\n';
+	}
+	std::cout << std::flush;
+	return 0;
+}
+
+struct ExportOptions
+{
+	QStringList mTools;
+	double mStart;
+	double mStop;
+	double mResample;
+};
+
+bool parseExportOptions(int argc, char **argv, ExportOptions* options)
+{
+	options->mStart = 0;
+	options->mStop = std::numeric_limits<double>::max();
+	options->mResample = 0;
+	for (int i=4; i<argc; ++i)
+	{
+		QString option(argv[i]);
+		if (i+1>=argc)
+			return false;
+		QString value(argv[++i]);
+		bool ok = true;
+		if (option=="--tool")
+			options->mTools << value;
+		else if (option=="--start")
+			options->mStart = value.toDouble(&ok);
+		else if (option=="--stop")
+			options->mStop = value.toDouble(&ok);
+		else if (option=="--resample")
+			options->mResample = value.toDouble(&ok);
+		else
+			ok = false;
+		if (!ok)
+			return false;
+	}
+	return true;
+}
+
+bool earlier(const cx::PositionStorageIndex::Position& a, const cx::PositionStorageIndex::Position& b)
+{
+	return a.mTimestamp < b.mTimestamp;
+}
+
+bool writeCsv(QString filename, QStringList tools, const std::vector<cx::PositionStorageIndex::Position>& positions)
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+
+	QByteArray buffer("timestamp,tool,m00,m01,m02,m03,m10,m11,m12,m13,m20,m21,m22,m23\n");
+	for (unsigned i=0; i<positions.size(); ++i)
+	{
+		buffer += QByteArray::number(positions[i].mTimestamp, 'f', 0);
+		buffer += ',';
+		buffer += tools[positions[i].mTool].toLatin1();
+		for (int r=0; r<3; ++r)
+		{
+			for (int c=0; c<4; ++c)
+			{
+				buffer += ',';
+				buffer += QByteArray::number(positions[i].mTransform(r,c), 'g', 10);
+			}
+		}
+		buffer += '\n';
+
+		if (buffer.size() > (1<<20))
+		{
+			if (file.write(buffer) != buffer.size())
+				return false;
+			buffer.clear();
+		}
+	}
+	return file.write(buffer) == buffer.size();
+}
+
+bool writeAll(QFile* file, const QByteArray& data)
+{
+	return file->write(data) == data.size();
+}
+
+template<class OUTPUT, class FUNCTION>
+QByteArray createColumn(const std::vector<cx::PositionStorageIndex::Position>& positions, FUNCTION function)
+{
+	QByteArray retval(positions.size()*sizeof(OUTPUT), Qt::Uninitialized);
+	uchar* data = reinterpret_cast<uchar*>(retval.data());
+	for (unsigned i=0; i<positions.size(); ++i)
+		function(positions[i], data + i*sizeof(OUTPUT));
+	return retval;
+}
+
+void storeFloat64(double value, uchar* dest)
+{
+	quint64 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	qToLittleEndian<quint64>(bits, dest);
+}
+
+void storeFloat32(float value, uchar* dest)
+{
+	quint32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	qToLittleEndian<quint32>(bits, dest);
+}
+
+struct TimestampColumn
+{
+	void operator()(const cx::PositionStorageIndex::Position& p, uchar* dest) const { storeFloat64(p.mTimestamp, dest); }
+};
+
+struct ToolColumn
+{
+	void operator()(const cx::PositionStorageIndex::Position& p, uchar* dest) const { qToLittleEndian<quint16>(p.mTool, dest); }
+};
+
+struct TranslationColumn
+{
+	int mAxis;
+	void operator()(const cx::PositionStorageIndex::Position& p, uchar* dest) const { storeFloat64(p.mTransform(mAxis,3), dest); }
+};
+
+struct RotationColumn
+{
+	int mComponent; ///< w, x, y, z
+	void operator()(const cx::PositionStorageIndex::Position& p, uchar* dest) const
+	{
+		Eigen::Quaterniond q(p.mTransform.matrix().block<3, 3>(0,0));
+		double values[4] = { q.w(), q.x(), q.y(), q.z() };
+		storeFloat32(values[mComponent], dest);
+	}
+};
+
+bool writeColumnar(QString filename, QStringList tools, const std::vector<cx::PositionStorageIndex::Position>& positions)
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+
+	QDataStream stream(&file);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.writeRawData("CXPOSCOL", 8);
+	stream << (quint8)1;
+	stream << (quint32)tools.size();
+	for (int i=0; i<tools.size(); ++i)
+	{
+		QByteArray name = tools[i].toLatin1();
+		stream.writeBytes(name.data(), name.size());
+	}
+	stream << (quint64)positions.size();
+
+	if (stream.status()!=QDataStream::Ok)
+		return false;
+
+	if (!writeAll(&file, createColumn<double>(positions, TimestampColumn())))
+		return false;
+	if (!writeAll(&file, createColumn<quint16>(positions, ToolColumn())))
+		return false;
+	for (int k=0; k<3; ++k)
+	{
+		TranslationColumn column = { k };
+		if (!writeAll(&file, createColumn<double>(positions, column)))
+			return false;
+	}
+	for (int k=0; k<4; ++k)
+	{
+		RotationColumn column = { k };
+		if (!writeAll(&file, createColumn<float>(positions, column)))
+			return false;
+	}
+	return true;
+}
+
+int exportPositions(int argc, char **argv)
+{
+	ExportOptions options;
+	if (argc<4 || !parseExportOptions(argc, argv, &options))
+	{
+		printUsage();
+		return 1;
+	}
+
+	cx::PositionStorageIndex index(argv[2]);
+	if (!index.isValid())
+		return 1;
+	if (index.version()==1)
+	{
+		std::cout << "This is a version 1 of the record format, use the print mode with a timestamp parameter." << std::endl;
+		return 1;
+	}
+
+	QStringList tools = index.getToolUids();
+	if (options.mTools.isEmpty())
+		options.mTools = tools;
+
+	std::vector<cx::PositionStorageIndex::Position> positions;
+	for (int i=0; i<options.mTools.size(); ++i)
+	{
+		int tool = index.getToolIndex(options.mTools[i]);
+		if (tool<0)
+		{
+			std::cout << "Tool [" << options.mTools[i].toStdString() << "] not found in file." << std::endl;
+			return 1;
+		}
+		std::vector<cx::PositionStorageIndex::Position> current;
+		if (options.mResample > 0)
+			current = index.resample(tool, options.mStart, options.mStop, options.mResample);
+		else
+			current = index.extract(tool, options.mStart, options.mStop);
+		positions.insert(positions.end(), current.begin(), current.end());
+	}
+	std::stable_sort(positions.begin(), positions.end(), earlier);
+
+	QString output(argv[3]);
+	bool success = (QString(argv[1])=="csv") ? writeCsv(output, tools, positions) : writeColumnar(output, tools, positions);
+	if (!success)
+	{
+		std::cout << "Failed to write [" << output.toStdString() << "]" << std::endl;
+		return 1;
+	}
+	std::cout << "Exported " << positions.size() << " positions to [" << output.toStdString() << "]" << std::endl;
+	return 0;
+}
+
+} // namespace
+
 /** 
  */
 int main(int argc, char **argv)
@@ -36,10 +327,16 @@ int main(int argc, char **argv)
 	
 	if (argc<2)
 	{
-		std::cout << "Usage: sscPositionFileReader [-v] <filename> <timestamp>\nTimestamp format " << EVENT_DATE_FORMAT << std::endl;
+		printUsage();
 		return 0;
 	}
 
+	QString command(argv[1]);
+	if (command=="info")
+		return info(argc, argv);
+	if (command=="csv" || command=="columnar")
+		return exportPositions(argc, argv);
+
 
 	bool verbose = (QString(argv[1]) == "-v");
 	if (verbose) arg++;
@@ -121,7 +418,7 @@ int main(int argc, char **argv)
 //				<< "timestamp:\t" << timestamp << '\n'
 				<< "timestamp:\t" << cx::PositionStorageReader::timestampToString((double)ts64).toStdString() << '\n'
 				<< "matrix:\n" << T << '\n' 
-				<< std::endl;			
+				<< '\n';
 		}
 		else
 		{		
@@ -130,11 +427,12 @@ int main(int argc, char **argv)
 			boost::array<double, 16>  val = T.flatten();
 			cx::stream_range(std::cout, val.begin(), val.end(), ' ');
       std::cout << '\t' << toolIndex.toStdString();
-			std::cout << std::endl;
+			std::cout << '\n';
 		}
 
 		++index;
 	}
 
+	std::cout << std::flush;
 	return 0;
 }
@@ -38,6 +38,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxViewGroupData.h"
 #include "cxReporter.h"
 #include "cxActiveData.h"
+#include "cxDirtyExtentTracker.h"
 
 namespace cx
 {
@@ -195,7 +196,7 @@ void EraserWidget::saveSlot()
 
 
 template <class TYPE>
-void EraserWidget::eraseVolume(TYPE* volumePointer)
+IntBoundingBox3D EraserWidget::eraseVolume(TYPE* volumePointer)
 {
 	ImagePtr image = mActiveData->getActive<Image>();
 	vtkImageDataPtr img = image->getBaseVtkImageData();
@@ -242,6 +243,11 @@ void EraserWidget::eraseVolume(TYPE* volumePointer)
 				if ((Vector3D(x*spacing[0], y*spacing[1], z*spacing[2]) - c_d).length() < r_d)
 					volumePointer[index] = replaceVal;
 			}
+
+	int* extent = img->GetExtent();
+	return IntBoundingBox3D(extent[0]+bb1_raw[0], extent[0]+bb1_raw[1]-1,
+							extent[2]+bb1_raw[2], extent[2]+bb1_raw[3]-1,
+							extent[4]+bb1_raw[4], extent[4]+bb1_raw[5]-1);
 }
 
 //#define VTK_VOID            0
@@ -268,34 +274,32 @@ void EraserWidget::removeSlot()
 	vtkImageDataPtr img = image->getBaseVtkImageData();
 
 	int vtkScalarType = img->GetScalarType();
+	IntBoundingBox3D erased;
 
 	if (vtkScalarType==VTK_CHAR)
-		this->eraseVolume(static_cast<char*> (img->GetScalarPointer()));
+		erased = this->eraseVolume(static_cast<char*> (img->GetScalarPointer()));
 	else if (vtkScalarType==VTK_UNSIGNED_CHAR)
-		this->eraseVolume(static_cast<unsigned char*> (img->GetScalarPointer()));
+		erased = this->eraseVolume(static_cast<unsigned char*> (img->GetScalarPointer()));
 	else if (vtkScalarType==VTK_SIGNED_CHAR)
-		this->eraseVolume(static_cast<signed char*> (img->GetScalarPointer()));
+		erased = this->eraseVolume(static_cast<signed char*> (img->GetScalarPointer()));
 	else if (vtkScalarType==VTK_UNSIGNED_SHORT)
-		this->eraseVolume(static_cast<unsigned short*> (img->GetScalarPointer()));
+		erased = this->eraseVolume(static_cast<unsigned short*> (img->GetScalarPointer()));
 	else if (vtkScalarType==VTK_SHORT)
-		this->eraseVolume(static_cast<short*> (img->GetScalarPointer()));
+		erased = this->eraseVolume(static_cast<short*> (img->GetScalarPointer()));
 	else if (vtkScalarType==VTK_UNSIGNED_INT)
-		this->eraseVolume(static_cast<unsigned int*> (img->GetScalarPointer()));
+		erased = this->eraseVolume(static_cast<unsigned int*> (img->GetScalarPointer()));
 	else if (vtkScalarType==VTK_INT)
-		this->eraseVolume(static_cast<int*> (img->GetScalarPointer()));
+		erased = this->eraseVolume(static_cast<int*> (img->GetScalarPointer()));
 	else
+	{
 		reportError(QString("Unknown VTK ScalarType: %1").arg(vtkScalarType));
+		return;
+	}
 
-	ImageLUT2DPtr tf2D = image->getLookupTable2D();
-	ImageTF3DPtr tf3D = image->getTransferFunctions3D();
-
-//	img->Modified();
-	setDeepModified(img);
-	image->setVtkImageData(img);
-
-	// keep existing transfer functions
-	image->setLookupTable2D(tf2D);
-	image->setTransferFunctions3D(tf3D);
+	// only the erased region has changed: textures are updated for that region only,
+	// and the transfer functions are kept.
+	if (DirtyExtentTracker::getNumberOfVoxels(erased) > 0)
+		image->setVtkImageDataModified(erased);
 }
 
 void EraserWidget::toggleShowEraser(bool on)
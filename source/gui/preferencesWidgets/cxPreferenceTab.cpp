@@ -82,6 +82,13 @@ void PerformanceTab::init()
   mMaxRenderSize = DoubleProperty::initialize("MaxRenderSize", "Max Render Size (Mb)", "Maximum size of volumes used in volume rendering. Applies to new volumes.", maxRenderSize, DoubleRange(1*Mb,300*Mb,1*Mb), 0, QDomNode());
   mMaxRenderSize->setInternal2Display(1.0/Mb);
 
+  double interactiveRenderSize = settings()->value("View3D/interactiveRenderSize").toDouble();
+  mInteractiveRenderSize = DoubleProperty::initialize("InteractiveRenderSize", "Interactive Render Size (Mb)",
+													  "Maximum size of volumes used in volume rendering while the camera moves. "
+													  "The full volume is shown when the camera stops. 0 disables. Applies to new volumes.",
+													  interactiveRenderSize, DoubleRange(0,300*Mb,1*Mb), 0, QDomNode());
+  mInteractiveRenderSize->setInternal2Display(1.0/Mb);
+
   double stillUpdateRate = settings()->value("stillUpdateRate").value<double>();
 	mStillUpdateRate = DoubleProperty::initialize("StillUpdateRate", "Still Update Rate",
 																											"<p>Still Update Rate in vtkRenderWindow. "
@@ -94,7 +101,7 @@ void PerformanceTab::init()
 
   mSmartRenderCheckBox = new QCheckBox("Smart Render");
   mSmartRenderCheckBox->setChecked(settings()->value("smartRender", true).toBool());
-  mSmartRenderCheckBox->setToolTip("Render only when scene has changed, plus once per second.");
+  mSmartRenderCheckBox->setToolTip("Render only views where the scene has changed.");
 
   m3DVisualizer = StringProperty::initialize("ImageRender3DVisualizer",
 	  "3D Renderer",
@@ -133,6 +140,7 @@ void PerformanceTab::init()
   mMainLayout = new QGridLayout;
   mMainLayout->addWidget(renderingIntervalLabel, 0, 0);
   new SpinBoxGroupWidget(this, mMaxRenderSize, mMainLayout, 1);
+  new SpinBoxGroupWidget(this, mInteractiveRenderSize, mMainLayout, 3);
   mMainLayout->addWidget(mRenderingIntervalSpinBox, 0, 1);
   mMainLayout->addWidget(mRenderingRateLabel, 0, 2);
 	mMainLayout->addWidget(mSmartRenderCheckBox, 2, 0);
@@ -187,6 +195,7 @@ void PerformanceTab::saveParametersSlot()
   settings()->setValue("optimizedViews", mOptimizedViewsCheckBox->isChecked());
 
   settings()->setValue("View3D/maxRenderSize",     mMaxRenderSize->getValue());
+  settings()->setValue("View3D/interactiveRenderSize", mInteractiveRenderSize->getValue());
   settings()->setValue("smartRender",       mSmartRenderCheckBox->isChecked());
   settings()->setValue("stillUpdateRate",   mStillUpdateRate->getValue());
   settings()->setValue("View3D/depthPeeling", mGPU3DDepthPeelingCheckBox->isChecked());
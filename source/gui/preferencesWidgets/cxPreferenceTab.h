@@ -75,6 +75,7 @@ protected:
   QCheckBox* mShadingCheckBox;
   QGridLayout* mMainLayout;
   DoublePropertyPtr mMaxRenderSize;
+  DoublePropertyPtr mInteractiveRenderSize;
   DoublePropertyPtr mStillUpdateRate;
   StringPropertyPtr m3DVisualizer;
 
@@ -378,6 +378,7 @@ VideoTab::VideoTab(QWidget *parent) :
 	m24bitRadioButton = NULL;
 	m8bitRadioButton = NULL;
 	mCompressCheckBox = NULL;
+	mRecordDirectlyCheckBox = NULL;
 
 }
 
@@ -405,10 +406,16 @@ void VideoTab::init()
 	mCompressCheckBox->setChecked(settings()->value("Ultrasound/CompressAcquisition", true).toBool());
 	mCompressCheckBox->setToolTip("Store the US Acquisition data as compressed MHD");
 
+	mRecordDirectlyCheckBox = new QCheckBox("Record directly to patient folder");
+	mRecordDirectlyCheckBox->setChecked(settings()->value("Ultrasound/RecordDirectlyToPatient", true).toBool());
+	mRecordDirectlyCheckBox->setToolTip("Write US Acquisition frames to the patient folder while recording,\n"
+										"instead of to a temporary folder that is copied after recording.");
+
 	toplayout->addSpacing(5);
 	toplayout->addWidget(m24bitRadioButton);
 	toplayout->addWidget(m8bitRadioButton);
 	toplayout->addWidget(mCompressCheckBox);
+	toplayout->addWidget(mRecordDirectlyCheckBox);
 
 	mTopLayout->addLayout(toplayout);
 
@@ -419,6 +426,7 @@ void VideoTab::saveParametersSlot()
 	settings()->setValue("Ultrasound/acquisitionName", mAcquisitionNameLineEdit->text());
 	settings()->setValue("Ultrasound/8bitAcquisitionData", m8bitRadioButton->isChecked());
 	settings()->setValue("Ultrasound/CompressAcquisition", mCompressCheckBox->isChecked());
+	settings()->setValue("Ultrasound/RecordDirectlyToPatient", mRecordDirectlyCheckBox->isChecked());
 }
 
 //==============================================================================
@@ -613,6 +621,7 @@ DebugTab::DebugTab(PatientModelServicePtr patientModelService, TrackingServicePt
 	mIGSTKDebugLoggingCheckBox(NULL),
 	mManualToolPhysicalPropertiesCheckBox(NULL),
 	mRenderSpeedLoggingCheckBox(NULL),
+	mBinaryLogFormatCheckBox(NULL),
 	mMainLayout(NULL),
 	mPatientModelService(patientModelService),
 	mTrackingService(trackingService)
@@ -638,6 +647,10 @@ void DebugTab::init()
 	mRenderSpeedLoggingCheckBox->setChecked(settings()->value("renderSpeedLogging", true).toBool());
 	mRenderSpeedLoggingCheckBox->setToolTip("Dump render speed statistics to the console");
 
+	mBinaryLogFormatCheckBox = new QCheckBox("Binary Log Format");
+	mBinaryLogFormatCheckBox->setChecked(settings()->value("binaryLogFormat", false).toBool());
+	mBinaryLogFormatCheckBox->setToolTip("Write log files in the compact binary format (.cxlog) instead of text.\nRead them with LogConsole.");
+
 	//Layout
 	mMainLayout = new QGridLayout;
 	int i=0;
@@ -645,6 +658,7 @@ void DebugTab::init()
 	mMainLayout->addWidget(mManualToolPhysicalPropertiesCheckBox, i++, 0);
 	mMainLayout->addWidget(runDebugToolButton, i++, 0);
 	mMainLayout->addWidget(mRenderSpeedLoggingCheckBox, i++, 0);
+	mMainLayout->addWidget(mBinaryLogFormatCheckBox, i++, 0);
 
 	mTopLayout->addLayout(mMainLayout);
 }
@@ -671,6 +685,7 @@ void DebugTab::saveParametersSlot()
 	settings()->setValue("IGSTKDebugLogging", mIGSTKDebugLoggingCheckBox->isChecked());
 	settings()->setValue("giveManualToolPhysicalProperties", mManualToolPhysicalPropertiesCheckBox->isChecked());
 	settings()->setValue("renderSpeedLogging", mRenderSpeedLoggingCheckBox->isChecked());
+	settings()->setValue("binaryLogFormat", mBinaryLogFormatCheckBox->isChecked());
 }
 
 }//namespace cx
@@ -158,6 +158,7 @@ protected:
   QRadioButton* m24bitRadioButton;
   QRadioButton* m8bitRadioButton;
   QCheckBox* mCompressCheckBox;
+  QCheckBox* mRecordDirectlyCheckBox;
 };
 
 /**
@@ -265,6 +266,7 @@ protected:
   QCheckBox* mIGSTKDebugLoggingCheckBox;
   QCheckBox* mManualToolPhysicalPropertiesCheckBox;
   QCheckBox* mRenderSpeedLoggingCheckBox;
+  QCheckBox* mBinaryLogFormatCheckBox;
   QGridLayout *mMainLayout;
   PatientModelServicePtr mPatientModelService;
   TrackingServicePtr mTrackingService;
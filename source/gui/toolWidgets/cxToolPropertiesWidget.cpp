@@ -148,6 +148,7 @@ void ToolPropertiesWidget::setupUI()
   connect(ts.get(), &TrackingService::stateChanged, this, &ToolPropertiesWidget::reconnectTools);
   connect(mSelector.get(), &StringPropertyBase::changed, this, &ToolPropertiesWidget::activeToolChangedSlot);
   connect(ts.get(), &TrackingService::stateChanged, this, &ToolPropertiesWidget::setModified);
+  connect(ts.get(), &TrackingService::toolsUpdated, this, &ToolPropertiesWidget::setModified);
 
   this->reconnectTools();
   this->activeToolChangedSlot();
@@ -247,13 +248,11 @@ void ToolPropertiesWidget::reconnectTools()
 	for (TrackingService::ToolMap::iterator i=mTools.begin(); i!=mTools.end(); ++i)
 	{
 		disconnect(i->second.get(), &Tool::toolVisible, this, &ToolPropertiesWidget::setModified);
-		disconnect(i->second.get(), &Tool::toolTransformAndTimestamp, this, &ToolPropertiesWidget::setModified);
 	}
 	mTools = mTrackingService->getTools();
 	for (TrackingService::ToolMap::iterator i=mTools.begin(); i!=mTools.end(); ++i)
 	{
 		connect(i->second.get(), &Tool::toolVisible, this, &ToolPropertiesWidget::setModified);
-		connect(i->second.get(), &Tool::toolTransformAndTimestamp, this, &ToolPropertiesWidget::setModified);
 	}
 }
 
@@ -85,6 +85,8 @@ void LogicManager::basicSetup()
 {
 	ProfileManager::initialize();
 	Reporter::initialize();
+	reporter()->setBinaryLogFormat(settings()->value("binaryLogFormat", false).toBool());
+	connect(settings(), SIGNAL(valueChangedFor(QString)), this, SLOT(onSettingsChanged(QString)));
 
 	mPluginFramework = PluginFrameworkManager::create();
 	mPluginFramework->start();
@@ -135,6 +137,12 @@ void LogicManager::onRestartWithNewProfile(QString uid)
     this->restartServicesWithProfile(uid);
 }
 
+void LogicManager::onSettingsChanged(QString key)
+{
+	if (key == "binaryLogFormat")
+		reporter()->setBinaryLogFormat(settings()->value("binaryLogFormat").toBool());
+}
+
 void LogicManager::restartServicesWithProfile(QString uid)
 {
     this->shutdownServices();
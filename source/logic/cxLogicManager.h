@@ -116,6 +116,7 @@ public:
 
 private slots:
   void onRestartWithNewProfile(QString uid);
+  void onSettingsChanged(QString key);
 
 private:
   /**
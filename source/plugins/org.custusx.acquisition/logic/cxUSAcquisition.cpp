@@ -155,6 +155,11 @@ void USAcquisition::recordStarted()
 
 	ToolPtr tool = this->getServices()->tracking()->getFirstProbe();
 	mCore->setWriteColor(this->getWriteColor());
+	if (settings()->value("Ultrasound/RecordDirectlyToPatient", true).toBool())
+		mCore->setRecordDirectlyTo(this->getServices()->patient()->getActivePatientFolder(),
+								   settings()->value("Ultrasound/CompressAcquisition", true).toBool());
+	else
+		mCore->setRecordDirectlyTo("", false);
 	mCore->startRecord(mBase->getLatestSession(),
 										 tool,
 										 this->getServices()->tracking()->getReferenceTool(),
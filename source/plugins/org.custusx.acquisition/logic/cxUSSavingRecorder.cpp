@@ -32,7 +32,11 @@ namespace cx
 {
 
 
-USSavingRecorder::USSavingRecorder() : mDoWriteColor(true), m_rMpr(Transform3D::Identity())
+USSavingRecorder::USSavingRecorder() :
+	mDoWriteColor(true),
+	m_rMpr(Transform3D::Identity()),
+	mDirectCompress(false),
+	mRecordedInPlace(false)
 {
 
 }
@@ -51,6 +55,12 @@ void USSavingRecorder::setWriteColor(bool on)
 	mDoWriteColor = on;
 }
 
+void USSavingRecorder::setRecordDirectlyTo(QString baseFolder, bool compressImages)
+{
+	mDirectBaseFolder = baseFolder;
+	mDirectCompress = compressImages;
+}
+
 void USSavingRecorder::set_rMpr(Transform3D rMpr)
 {
 	m_rMpr = rMpr;
@@ -64,20 +74,31 @@ void USSavingRecorder::startRecord(RecordSessionPtr session, ToolPtr tool, ToolP
 	mReference = reference;
 	mSession = session;
 
-	QString tempBaseFolder = DataLocations::getCachePath()+"/usacq/"+QDateTime::currentDateTime().toString(timestampSecondsFormat());
-	QString cacheFolder = UsReconstructionFileMaker::createUniqueFolder(tempBaseFolder, session->getDescription());
+	mRecordedInPlace = !mDirectBaseFolder.isEmpty();
+	QString recordFolder;
+	if (mRecordedInPlace)
+	{
+		recordFolder = UsReconstructionFileMaker::createFolder(mDirectBaseFolder, session->getDescription());
+	}
+	else
+	{
+		QString tempBaseFolder = DataLocations::getCachePath()+"/usacq/"+QDateTime::currentDateTime().toString(timestampSecondsFormat());
+		recordFolder = UsReconstructionFileMaker::createUniqueFolder(tempBaseFolder, session->getDescription());
+	}
 
 	for (unsigned i=0; i<video.size(); ++i)
 	{
 		SavingVideoRecorderPtr videoRecorder;
 		videoRecorder.reset(new SavingVideoRecorder(
 								 video[i],
-								 cacheFolder,
+								 recordFolder,
 								 QString("%1_%2").arg(session->getDescription()).arg(video[i]->getUid()),
-								 false, // no compression when saving to cache
+								 mRecordedInPlace && mDirectCompress, // no compression when saving to cache, it is done in the final copy
 								 mDoWriteColor,
 								filemanager
 								));
+		if (mRecordedInPlace)
+			videoRecorder->getImageData()->setDeleteFilesOnRelease(false); // the recorded files are the saved data
 		videoRecorder->startRecord();
 		mVideoRecorder.push_back(videoRecorder);
 	}
@@ -100,6 +121,8 @@ void USSavingRecorder::stopRecord()
 
 void USSavingRecorder::cancelRecord()
 {
+	for (unsigned i=0; i<mVideoRecorder.size(); ++i)
+		mVideoRecorder[i]->cancel(); // remove recorded files, also from the patient folder if recorded in place
 	this->clearRecording();
 	report("Ultrasound acquisition cancelled.");
 }
@@ -157,9 +180,13 @@ void USSavingRecorder::startSaveData(QString baseFolder, bool compressImages)
 		USReconstructInputData data = this->getDataForStream(i);
 
 		QString streamSessionName = mSession->getDescription()+"_"+mVideoRecorder[i]->getSource()->getUid();
-		QString saveFolder = UsReconstructionFileMaker::createFolder(baseFolder, mSession->getDescription());
+		QString saveFolder;
+		if (mRecordedInPlace)
+			saveFolder = mVideoRecorder[i]->getSaveFolder();
+		else
+			saveFolder = UsReconstructionFileMaker::createFolder(baseFolder, mSession->getDescription());
 
-		this->saveStreamSession(data, saveFolder, streamSessionName, compressImages);
+		this->saveStreamSession(data, saveFolder, streamSessionName, compressImages, mRecordedInPlace);
 	}
 }
 
@@ -176,20 +203,32 @@ size_t USSavingRecorder::getNumberOfSavingThreads() const
 	return mSaveThreads.size();
 }
 
-void USSavingRecorder::saveStreamSession(USReconstructInputData reconstructData, QString saveFolder, QString streamSessionName, bool compress)
+void USSavingRecorder::saveStreamSession(USReconstructInputData reconstructData, QString saveFolder, QString streamSessionName, bool compress, bool recordedInPlace)
 {
 	UsReconstructionFileMakerPtr fileMaker;
 	fileMaker.reset(new UsReconstructionFileMaker(streamSessionName));
 	fileMaker->setReconstructData(reconstructData);
 
-	// now start saving of data to the patient folder, compressed version:
-	QFuture<QString> fileMakerFuture =
-			QtConcurrent::run(boost::bind(
-								  &UsReconstructionFileMaker::writeToNewFolder,
-								  fileMaker,
-								  saveFolder,
-								  compress
-								  ));
+	QFuture<QString> fileMakerFuture;
+	if (recordedInPlace)
+	{
+		// images are already in the patient folder: write the rest.
+		fileMakerFuture = QtConcurrent::run(boost::bind(
+												&UsReconstructionFileMaker::completeRecordedFolder,
+												fileMaker,
+												saveFolder
+												));
+	}
+	else
+	{
+		// now start saving of data to the patient folder, compressed version:
+		fileMakerFuture = QtConcurrent::run(boost::bind(
+												&UsReconstructionFileMaker::writeToNewFolder,
+												fileMaker,
+												saveFolder,
+												compress
+												));
+	}
 	QFutureWatcher<QString>* fileMakerFutureWatcher = new QFutureWatcher<QString>();
     connect(fileMakerFutureWatcher, SIGNAL(finished()), this, SLOT(fileMakerWriteFinished()));
 	fileMakerFutureWatcher->setFuture(fileMakerFuture);
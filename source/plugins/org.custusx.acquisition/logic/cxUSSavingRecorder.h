@@ -48,6 +48,11 @@ typedef boost::shared_ptr<class RecordSession> RecordSessionPtr;
  *
  * Use clearRecording() to free memory and temporary files (this can be a lot of disk space).
  *
+ * By default, frames are recorded into a temporary cache folder, and copied
+ * to the patient folder by startSaveData(). Call setRecordDirectlyTo() before
+ * startRecord() to record, and optionally compress, frames into the final folder
+ * instead. startSaveData() then writes only the remaining files.
+ *
  * Intended to be a unit-testable part of the USAcquisition class.
  *
  *  \date April 17, 2013
@@ -67,6 +72,12 @@ public:
 	void cancelRecord();
 
 	void setWriteColor(bool on);
+	/**
+	  * Record frames directly into the acquisition folder in baseFolder,
+	  * compressed if set, thus writing each frame only once.
+	  * Applies to the next startRecord(). Empty baseFolder means record to the cache.
+	  */
+	void setRecordDirectlyTo(QString baseFolder, bool compressImages);
 	void set_rMpr(Transform3D rMpr);
 	/**
 	  * Retrieve an in-memory data set for the given stream uid.
@@ -88,7 +99,7 @@ private slots:
 	void fileMakerWriteFinished();
 private:
 //	std::map<double, Transform3D> getToolHistory(ToolPtr tool, RecordSessionPtr session);
-	void saveStreamSession(USReconstructInputData reconstructData, QString saveFolder, QString streamSessionName, bool compress);
+	void saveStreamSession(USReconstructInputData reconstructData, QString saveFolder, QString streamSessionName, bool compress, bool recordedInPlace);
 	USReconstructInputData getDataForStream(unsigned videoRecorderIndex);
 
 	RecordSessionPtr mSession;
@@ -99,6 +110,9 @@ private:
 	ToolPtr mReference;
 	bool mDoWriteColor;
 	Transform3D m_rMpr;
+	QString mDirectBaseFolder;
+	bool mDirectCompress;
+	bool mRecordedInPlace; ///< true if the current recording was written directly to its final folder
 };
 typedef boost::shared_ptr<USSavingRecorder> USSavingRecorderPtr;
 
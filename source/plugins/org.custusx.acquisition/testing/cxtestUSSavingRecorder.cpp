@@ -62,6 +62,24 @@ TEST_CASE_METHOD(cxtest::USSavingRecorderFixture, "USSavingRecorder: Use one Vid
 	this->verifySaveData();
 }
 
+TEST_CASE_METHOD(cxtest::USSavingRecorderFixture, "USSavingRecorder: Use one VideoSource with Tool and record directly to save folder", "[integration][modules][Acquisition]")
+{
+	cx::LogicManager::initialize();
+	cx::DummyToolPtr tool = cx::DummyToolTestUtilities::createDummyTool(cx::DummyToolTestUtilities::createProbeDefinitionLinear());
+	this->setTool(tool);
+	this->addVideoSource(80, 40);
+	this->recordDirectlyToDataPath();
+
+	this->addOperation(boost::bind(&cxtest::USSavingRecorderFixture::startRecord, this));
+	this->addOperation(boost::bind(&cxtest::USSavingRecorderFixture::wait, this, 1000));
+	this->addOperation(boost::bind(&cxtest::USSavingRecorderFixture::stopRecord, this));
+	this->addOperation(boost::bind(&cxtest::USSavingRecorderFixture::saveAndWaitForCompleted, this));
+
+	qApp->exec();
+
+	this->verifySaveData();
+}
+
 TEST_CASE_METHOD(cxtest::USSavingRecorderFixture, "USSavingRecorder: Use 4 VideoSources", "[integration][modules][Acquisition][unstable]")
 {
 	this->setTool(cx::ToolPtr());
@@ -11,6 +11,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include "cxtestUSSavingRecorderFixture.h"
 #include <QTimer>
+#include <QFileInfo>
 #include "cxReporter.h"
 
 #include "cxTypeConversions.h"
@@ -94,6 +95,11 @@ void USSavingRecorderFixture::addVideoSource(int width, int height)
 	mVideo.push_back(videoSource);
 }
 
+void USSavingRecorderFixture::recordDirectlyToDataPath()
+{
+	mRecorder->setRecordDirectlyTo(this->getDataPath(), true);
+}
+
 void USSavingRecorderFixture::startRecord()
 {
 //	double start = QDateTime::currentMSecsSinceEpoch();
@@ -180,6 +186,8 @@ void USSavingRecorderFixture::verifySaveData(QString filename)
 	cx::USReconstructInputData hasBeenRead = fileReader->readAllFiles(filename, "");
 
 	CHECK( hasBeenRead.mFilename == filename );
+	QString manifest = QFileInfo(filename).absolutePath()+"/"+QFileInfo(filename).completeBaseName()+".manifest";
+	CHECK( QFileInfo(manifest).exists() );
 	CHECK( !hasBeenRead.mFrames.empty() );
 	CHECK( hasBeenRead.mUsRaw->getDimensions()[0] > 0 );
 	CHECK( hasBeenRead.mUsRaw->getDimensions()[1] > 0 );
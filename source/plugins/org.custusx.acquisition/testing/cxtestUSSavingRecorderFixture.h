@@ -42,6 +42,7 @@ public:
 
 	void setTool(cx::ToolPtr tool);
 	void addVideoSource(int width, int height);
+	void recordDirectlyToDataPath();
 
 	void startRecord();
 	void wait(int time);
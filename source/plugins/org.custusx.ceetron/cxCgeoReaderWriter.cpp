@@ -11,18 +11,248 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include "cxCgeoReaderWriter.h"
 
-#include <QDir>
+#include <deque>
+#include <cstring>
+#include <QFileInfo>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QtEndian>
 #include "vtkPolyData.h"
 #include <vtkCellArray.h>
-#include "vtkIdList.h"
+#include <vtkPoints.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkIdList.h>
 #include "cxMesh.h"
 #include "cxLogger.h"
 
 namespace cx
 {
 
+namespace
+{
+const qint32 CGEO_MAGIC = 12072001;
+const qint32 CGEO_COLOR = 53672537;
+const int CHUNK_SIZE = 65536; ///< points or triangles per chunk
+const size_t MAX_QUEUED_CHUNKS = 4; ///< bounds the memory held by ChunkWriter
+typedef vtkSmartPointer<vtkIdTypeArray> vtkIdTypeArrayPtr;
+
+/** Write chunks of data to a device from a dedicated thread,
+ *  letting the caller prepare the next chunk meanwhile.
+ *
+ *  A dedicated thread is used instead of a pool task: push() blocks
+ *  while MAX_QUEUED_CHUNKS are queued, which would deadlock if the
+ *  writer were waiting for a free slot in a saturated pool.
+ */
+class ChunkWriter : public QThread
+{
+public:
+	explicit ChunkWriter(QIODevice* device) : mDevice(device), mDone(false), mError(false)
+	{
+		this->start();
+	}
+	~ChunkWriter()
+	{
+		this->finish();
+	}
+	void push(const QByteArray& chunk)
+	{
+		QMutexLocker sentry(&mMutex);
+		while (mQueue.size() >= MAX_QUEUED_CHUNKS && !mError)
+			mChanged.wait(&mMutex);
+		mQueue.push_back(chunk);
+		mChanged.wakeAll();
+	}
+	bool finish() ///< wait for all chunks to be written, return success
+	{
+		{
+			QMutexLocker sentry(&mMutex);
+			mDone = true;
+			mChanged.wakeAll();
+		}
+		this->wait();
+		return !mError;
+	}
+
+private:
+	virtual void run()
+	{
+		while (true)
+		{
+			QByteArray chunk;
+			{
+				QMutexLocker sentry(&mMutex);
+				while (mQueue.empty() && !mDone)
+					mChanged.wait(&mMutex);
+				if (mQueue.empty())
+					return;
+				chunk = mQueue.front();
+				mQueue.pop_front();
+				mChanged.wakeAll();
+			}
+			if (mDevice->write(chunk) != chunk.size())
+			{
+				QMutexLocker sentry(&mMutex);
+				mError = true;
+				mQueue.clear();
+				mChanged.wakeAll();
+				return;
+			}
+		}
+	}
+
+	QIODevice* mDevice;
+	QMutex mMutex;
+	QWaitCondition mChanged;
+	std::deque<QByteArray> mQueue;
+	bool mDone;
+	bool mError;
+};
+
+/** Call function(a,b,c) for each triangle in the cells,
+ *  triangulating polygons as fans and strips with alternating winding.
+ *  Return the number of skipped cells.
+ */
+template<class FUNCTION>
+int forEachTriangle(vtkCellArray* cells, bool strips, FUNCTION& function)
+{
+	int skipped = 0;
+	if (!cells)
+		return skipped;
+
+	vtkIdListPtr cell = vtkIdListPtr::New();
+	cells->InitTraversal();
+	while (cells->GetNextCell(cell))
+	{
+		vtkIdType npts = cell->GetNumberOfIds();
+		vtkIdType* pts = cell->GetPointer(0);
+		if (npts < 3)
+		{
+			++skipped;
+			continue;
+		}
+		for (vtkIdType k=0; k+2<npts; ++k)
+		{
+			if (!strips)
+				function(pts[0], pts[k+1], pts[k+2]);
+			else if (k%2==0)
+				function(pts[k], pts[k+1], pts[k+2]);
+			else
+				function(pts[k+1], pts[k], pts[k+2]);
+		}
+	}
+	return skipped;
+}
+
+struct TriangleCounter
+{
+	TriangleCounter() : mCount(0) {}
+	void operator()(vtkIdType, vtkIdType, vtkIdType) { ++mCount; }
+	qint64 mCount;
+};
+
+/** Collect triangles into chunks, pushed to the writer when full.
+ */
+struct TriangleChunker
+{
+	explicit TriangleChunker(ChunkWriter* writer) : mWriter(writer) { mChunk.reserve(3*CHUNK_SIZE); }
+	void operator()(vtkIdType a, vtkIdType b, vtkIdType c)
+	{
+		mChunk.push_back(qToLittleEndian<qint32>(a));
+		mChunk.push_back(qToLittleEndian<qint32>(b));
+		mChunk.push_back(qToLittleEndian<qint32>(c));
+		if (mChunk.size() >= 3*CHUNK_SIZE)
+			this->flush();
+	}
+	void flush()
+	{
+		if (mChunk.empty())
+			return;
+		mWriter->push(QByteArray(reinterpret_cast<const char*>(&mChunk[0]), mChunk.size()*sizeof(qint32)));
+		mChunk.clear();
+	}
+	ChunkWriter* mWriter;
+	std::vector<qint32> mChunk;
+};
+
+float toLittleEndian(float value)
+{
+	quint32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	bits = qToLittleEndian(bits);
+	memcpy(&value, &bits, sizeof(bits));
+	return value;
+}
+
+float fromLittleEndian(float value)
+{
+	return toLittleEndian(value); // byte swapping is symmetric
+}
+
+void pushPoints(vtkPoints* points, ChunkWriter* writer)
+{
+	vtkIdType N = points->GetNumberOfPoints();
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+	if (points->GetDataType()==VTK_FLOAT)
+	{
+		// the file layout equals the vtk layout: write directly from the points
+		const char* data = static_cast<const char*>(points->GetVoidPointer(0));
+		for (vtkIdType i=0; i<N; i+=CHUNK_SIZE)
+		{
+			vtkIdType size = std::min<vtkIdType>(CHUNK_SIZE, N-i);
+			writer->push(QByteArray::fromRawData(data + 3*sizeof(float)*i, 3*sizeof(float)*size));
+		}
+		return;
+	}
+#endif
+
+	std::vector<float> chunk;
+	for (vtkIdType i=0; i<N; i+=CHUNK_SIZE)
+	{
+		vtkIdType size = std::min<vtkIdType>(CHUNK_SIZE, N-i);
+		chunk.resize(3*size);
+		double p[3];
+		for (vtkIdType j=0; j<size; ++j)
+		{
+			points->GetPoint(i+j, p);
+			for (int k=0; k<3; ++k)
+				chunk[3*j+k] = toLittleEndian(p[k]);
+		}
+		writer->push(QByteArray(reinterpret_cast<const char*>(&chunk[0]), chunk.size()*sizeof(float)));
+	}
+}
+
+QByteArray createHeader(qint32 numberOfVertices, qint32 numberOfTriangles)
+{
+	QByteArray header;
+	QDataStream out(&header, QIODevice::WriteOnly);
+	out.setByteOrder(QDataStream::LittleEndian);
+
+	out << CGEO_MAGIC;        // Magic (12072001)
+	out << (qint32) 0;  // TextureCount
+	out << (qint32) 1;  // PartCount
+
+	out << (qint32) 0; // Component ID
+	out << CGEO_COLOR; // Color
+
+	out << numberOfVertices; // # vertices
+	out << (qint32) 0; // always 0
+	out << (qint32) -1; // always -1
+	out << numberOfTriangles; // # primitives
+	out << (qint32) 3; // 3 nodes per primitive (triangle)
+	return header;
+}
+
+bool readRaw(QFile& file, void* data, qint64 size)
+{
+	return file.read(static_cast<char*>(data), size) == size;
+}
+} // namespace
+
 CgeoReaderWriter::CgeoReaderWriter(PatientModelServicePtr patientModelService) :
-	FileReaderWriterImplService("CgeoReaderWriter", "", Mesh::getTypeName(), "cgeo", patientModelService)
+	FileReaderWriterImplService("CgeoReaderWriter", Mesh::getTypeName(), Mesh::getTypeName(), "cgeo", patientModelService)
 {
 }
 
@@ -33,27 +263,45 @@ bool CgeoReaderWriter::isNull()
 
 bool CgeoReaderWriter::canRead(const QString &type, const QString &filename)
 {
-	return false;
+	QString fileType = QFileInfo(filename).suffix();
+	return (fileType.compare("cgeo", Qt::CaseInsensitive) == 0);
 }
 
 std::vector<DataPtr> CgeoReaderWriter::read(const QString &filename)
 {
-	return std::vector<DataPtr>();
+	std::vector<DataPtr> retval;
+	vtkPolyDataPtr raw = readPolyData(filename);
+	if (!raw)
+		return retval;
+
+	MeshPtr mesh = boost::dynamic_pointer_cast<Mesh>(this->createData(Mesh::getTypeName(), filename));
+	mesh->setVtkPolyData(raw);
+	retval.push_back(mesh);
+	return retval;
 }
 
 DataPtr CgeoReaderWriter::read(const QString &uid, const QString &filename)
 {
-	return DataPtr();
+	MeshPtr mesh(new Mesh(uid));
+	this->readInto(mesh, filename);
+	return mesh;
 }
 
 QString CgeoReaderWriter::canReadDataType() const
 {
-	return "";
+	return Mesh::getTypeName();
 }
 
 bool CgeoReaderWriter::readInto(DataPtr data, QString path)
 {
-	return false;
+	MeshPtr mesh = boost::dynamic_pointer_cast<Mesh>(data);
+	if (!mesh)
+		return false;
+	vtkPolyDataPtr raw = readPolyData(path);
+	if (!raw)
+		return false;
+	mesh->setVtkPolyData(raw);
+	return true;
 }
 
 void CgeoReaderWriter::write(DataPtr data, const QString &filename)
@@ -64,54 +312,121 @@ void CgeoReaderWriter::write(DataPtr data, const QString &filename)
 		CX_LOG_ERROR() << "Couldn't find mesh.";
 		return;
 	}
-	vtkPolyDataPtr polyData = mesh->getTransformedPolyDataCopy(mesh->get_rMd());
-	vtkCellArrayPtr polys = polyData->GetPolys();
+	if (!writePolyData(mesh->getTransformedPolyData(mesh->get_rMd()), filename))
+		CX_LOG_ERROR() << "Failed to write " << filename;
+}
+
+bool CgeoReaderWriter::writePolyData(vtkPolyDataPtr polyData, const QString &filename)
+{
+	if (!polyData || !polyData->GetPoints())
+		return false;
+
+	TriangleCounter counter;
+	int skipped = forEachTriangle(polyData->GetPolys(), false, counter);
+	forEachTriangle(polyData->GetStrips(), true, counter);
+	if (skipped)
+		CX_LOG_WARNING() << "In .cgeo export: Skipped " << skipped << " polygons with less than 3 points.";
 
 	QFile exportFile(filename);
-	exportFile.open(QIODevice::WriteOnly);
-	QDataStream out(&exportFile);
-	out.setByteOrder(QDataStream::LittleEndian);
-	out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+	if (!exportFile.open(QIODevice::WriteOnly))
+		return false;
 
-	out << (qint32) 12072001;        // Magic (12072001)
-	out << (qint32) 0;  // TextureCount
-	out << (qint32) 1;  // PartCount
+	ChunkWriter writer(&exportFile);
+	writer.push(createHeader(polyData->GetNumberOfPoints(), counter.mCount));
+	pushPoints(polyData->GetPoints(), &writer);
 
-	out << (qint32) 0; // Component ID
-	out << (qint32) 53672537; // Color
+	TriangleChunker chunker(&writer);
+	forEachTriangle(polyData->GetPolys(), false, chunker);
+	forEachTriangle(polyData->GetStrips(), true, chunker);
+	chunker.flush();
 
-	out << (qint32) polyData->GetNumberOfPoints(); // # vertices
-	out << (qint32) 0; // always 0
-	out << (qint32) -1; // always -1
-	out << (qint32) polys->GetNumberOfCells(); // # primitives
-	out << (qint32) 3; // 3 nodes per primitive (triangle)
+	return writer.finish();
+}
 
-	for (int i=0; i<polyData->GetNumberOfPoints(); i++)
+vtkPolyDataPtr CgeoReaderWriter::readPolyData(const QString &filename)
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly))
 	{
-		double p[3];
-		polyData->GetPoint(i,p);
-		out << p[0]; // x
-		out << p[1]; // y
-		out << p[2]; // z
+		CX_LOG_ERROR() << "Failed to open " << filename;
+		return vtkPolyDataPtr();
 	}
 
-	vtkIdType n_ids;
-	vtkSmartPointer<vtkIdList> idlist = vtkSmartPointer<vtkIdList>::New();
-	polys->InitTraversal();
+	QDataStream in(&file);
+	in.setByteOrder(QDataStream::LittleEndian);
+	qint32 magic, textureCount, partCount;
+	in >> magic >> textureCount >> partCount;
+	if (magic!=CGEO_MAGIC || textureCount!=0 || partCount<0)
+	{
+		CX_LOG_ERROR() << "Not a supported .cgeo file: " << filename;
+		return vtkPolyDataPtr();
+	}
 
-	while(polys->GetNextCell(idlist))
+	vtkFloatArrayPtr coordinates = vtkFloatArrayPtr::New();
+	coordinates->SetNumberOfComponents(3);
+	vtkIdTypeArrayPtr cells = vtkIdTypeArrayPtr::New();
+	vtkIdType numberOfCells = 0;
+	qint32 nodesPerPrimitive = 3;
+
+	for (qint32 part=0; part<partCount; ++part)
 	{
-		n_ids = idlist->GetNumberOfIds();
-		if (n_ids == 3)
+		qint32 componentId, color, numberOfVertices, zero, minusOne, numberOfPrimitives;
+		in >> componentId >> color >> numberOfVertices >> zero >> minusOne >> numberOfPrimitives >> nodesPerPrimitive;
+		if (in.status()!=QDataStream::Ok || numberOfVertices<0 || numberOfPrimitives<0 || nodesPerPrimitive!=3)
+		{
+			CX_LOG_ERROR() << "Unsupported or corrupt part " << part << " in " << filename;
+			return vtkPolyDataPtr();
+		}
+
+		vtkIdType offset = coordinates->GetNumberOfTuples();
+		coordinates->SetNumberOfTuples(offset + numberOfVertices);
+		float* vertices = coordinates->GetPointer(3*offset);
+		if (!readRaw(file, vertices, 3*sizeof(float)*qint64(numberOfVertices)))
+		{
+			CX_LOG_ERROR() << "Unexpected end of file in " << filename;
+			return vtkPolyDataPtr();
+		}
+		for (qint64 i=0; i<3*qint64(numberOfVertices); ++i)
+			vertices[i] = fromLittleEndian(vertices[i]);
+
+		std::vector<qint32> triangles(3*numberOfPrimitives);
+		if (!triangles.empty() && !readRaw(file, &triangles[0], triangles.size()*sizeof(qint32)))
 		{
-		   out << (qint32)  idlist->GetId(0); // First vertex of triangle
-		   out << (qint32)  idlist->GetId(1); // Second vertex of triangle
-		   out << (qint32)  idlist->GetId(2); // Third vertex of triangle
+			CX_LOG_ERROR() << "Unexpected end of file in " << filename;
+			return vtkPolyDataPtr();
 		}
-		else
-			std::cout << "Warning in .cgeo export: Skipped polygon not containing exactly 3 points." << std::endl;
+
+		vtkIdType cellOffset = cells->GetNumberOfTuples();
+		cells->SetNumberOfTuples(cellOffset + 4*vtkIdType(numberOfPrimitives));
+		vtkIdType* cellData = cells->GetPointer(cellOffset);
+		for (qint32 i=0; i<numberOfPrimitives; ++i)
+		{
+			cellData[4*i] = 3;
+			for (int k=0; k<3; ++k)
+			{
+				qint32 index = qFromLittleEndian<qint32>(triangles[3*i+k]);
+				if (index<0 || index>=numberOfVertices)
+				{
+					CX_LOG_ERROR() << "Vertex index out of range in " << filename;
+					return vtkPolyDataPtr();
+				}
+				cellData[4*i+1+k] = offset + index;
+			}
+		}
+		numberOfCells += numberOfPrimitives;
 	}
+
+	vtkPointsPtr points = vtkPointsPtr::New();
+	points->SetData(coordinates);
+	vtkCellArrayPtr polys = vtkCellArrayPtr::New();
+	polys->SetCells(numberOfCells, cells);
+
+	vtkPolyDataPtr retval = vtkPolyDataPtr::New();
+	retval->SetPoints(points);
+	retval->SetPolys(polys);
+	return retval;
 }
+
 }
 
 
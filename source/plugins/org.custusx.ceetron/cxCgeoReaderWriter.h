@@ -14,11 +14,18 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include "org_custusx_ceetron_Export.h"
 #include "cxFileReaderWriterService.h"
+#include "vtkForwardDeclarations.h"
 
 namespace cx
 {
 /**
- * @brief Write triangular mesh to .cgeo format for Ceetron.
+ * @brief Read and write triangular mesh in .cgeo format for Ceetron.
+ *
+ * Polygons and triangle strips are triangulated while writing, other cells
+ * are skipped. Points and triangles are converted in chunks and written by a
+ * worker thread, without copying the entire mesh.
+ *
+ * The reader accepts files with several parts, merged into one mesh.
  *
  * \date May 19, 2017
  * \author Erlend F Hofstad
@@ -42,6 +49,9 @@ public:
 	QString canWriteDataType() const;
 	bool canWrite(const QString &type, const QString &filename) const;
 	void write(DataPtr data, const QString &filename);
+
+	static bool writePolyData(vtkPolyDataPtr polyData, const QString &filename);
+	static vtkPolyDataPtr readPolyData(const QString &filename);
 };
 
 }
@@ -0,0 +1,141 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <QDir>
+#include <QTime>
+#include <vtkPolyData.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include "cxCgeoReaderWriter.h"
+#include "cxDataLocations.h"
+#include "cxVector3D.h"
+#include "cxtestJenkinsMeasurement.h"
+
+namespace cxtest
+{
+
+TEST_CASE("CgeoReaderWriter: Write and read triangulated mesh", "[unit][plugins][org.custusx.ceetron]")
+{
+	vtkPointsPtr points = vtkPointsPtr::New();
+	points->SetDataTypeToDouble();
+	for (int i=0; i<8; ++i)
+		points->InsertNextPoint(i, 0.5*i*i, -1.25*i);
+
+	vtkCellArrayPtr polys = vtkCellArrayPtr::New();
+	vtkIdType triangle[] = { 0, 1, 2 };
+	vtkIdType quad[] = { 0, 2, 3, 4 };
+	vtkIdType line[] = { 5, 6 };
+	polys->InsertNextCell(3, triangle);
+	polys->InsertNextCell(4, quad);
+	polys->InsertNextCell(2, line);
+
+	vtkCellArrayPtr strips = vtkCellArrayPtr::New();
+	vtkIdType strip[] = { 4, 5, 6, 7 };
+	strips->InsertNextCell(4, strip);
+
+	vtkPolyDataPtr input = vtkPolyDataPtr::New();
+	input->SetPoints(points);
+	input->SetPolys(polys);
+	input->SetStrips(strips);
+
+	QString path = cx::DataLocations::getTestDataPath() + "/temp/Cgeo/";
+	QDir().mkpath(path);
+	QString filename = path + "mesh.cgeo";
+	REQUIRE(cx::CgeoReaderWriter::writePolyData(input, filename));
+
+	vtkPolyDataPtr output = cx::CgeoReaderWriter::readPolyData(filename);
+	REQUIRE(output);
+	REQUIRE(output->GetNumberOfPoints() == input->GetNumberOfPoints());
+	for (vtkIdType i=0; i<input->GetNumberOfPoints(); ++i)
+		CHECK(cx::similar(cx::Vector3D(output->GetPoint(i)), cx::Vector3D(input->GetPoint(i))));
+
+	// triangle + quad as fan + strip as two triangles, line skipped
+	REQUIRE(output->GetNumberOfPolys() == 5);
+	vtkIdType expected[5][3] = { {0,1,2}, {0,2,3}, {0,3,4}, {4,5,6}, {6,5,7} };
+	vtkIdListPtr cell = vtkIdListPtr::New();
+	output->GetPolys()->InitTraversal();
+	for (int i=0; i<5; ++i)
+	{
+		REQUIRE(output->GetPolys()->GetNextCell(cell));
+		REQUIRE(cell->GetNumberOfIds() == 3);
+		for (int k=0; k<3; ++k)
+			CHECK(cell->GetId(k) == expected[i][k]);
+	}
+
+	QFile::remove(filename);
+}
+
+TEST_CASE("CgeoReaderWriter: Reject corrupt file", "[unit][plugins][org.custusx.ceetron]")
+{
+	QString path = cx::DataLocations::getTestDataPath() + "/temp/Cgeo/";
+	QDir().mkpath(path);
+	QString filename = path + "corrupt.cgeo";
+	QFile file(filename);
+	REQUIRE(file.open(QIODevice::WriteOnly));
+	file.write("not a cgeo file");
+	file.close();
+
+	CHECK(!cx::CgeoReaderWriter::readPolyData(filename));
+	QFile::remove(filename);
+}
+
+TEST_CASE("Speed: CgeoReaderWriter write and read 2M triangle mesh", "[speed][plugins][org.custusx.ceetron]")
+{
+	// a 1000x1000 grid split into two triangles per cell
+	int gridSize = 1000;
+	vtkPointsPtr points = vtkPointsPtr::New();
+	points->SetDataTypeToDouble();
+	for (int y=0; y<gridSize; ++y)
+		for (int x=0; x<gridSize; ++x)
+			points->InsertNextPoint(x, y, 0.01*x*y);
+
+	vtkCellArrayPtr polys = vtkCellArrayPtr::New();
+	for (int y=0; y<gridSize-1; ++y)
+		for (int x=0; x<gridSize-1; ++x)
+		{
+			vtkIdType p = y*gridSize + x;
+			vtkIdType lower[] = { p, p+1, p+gridSize };
+			vtkIdType upper[] = { p+1, p+gridSize+1, p+gridSize };
+			polys->InsertNextCell(3, lower);
+			polys->InsertNextCell(3, upper);
+		}
+
+	vtkPolyDataPtr input = vtkPolyDataPtr::New();
+	input->SetPoints(points);
+	input->SetPolys(polys);
+
+	QString path = cx::DataLocations::getTestDataPath() + "/temp/Cgeo/";
+	QDir().mkpath(path);
+	QString filename = path + "large_mesh.cgeo";
+
+	QTime clock;
+	clock.start();
+	REQUIRE(cx::CgeoReaderWriter::writePolyData(input, filename));
+	int writeTime = clock.elapsed();
+
+	clock.restart();
+	vtkPolyDataPtr output = cx::CgeoReaderWriter::readPolyData(filename);
+	int readTime = clock.elapsed();
+
+	REQUIRE(output);
+	CHECK(output->GetNumberOfPoints() == input->GetNumberOfPoints());
+	CHECK(output->GetNumberOfPolys() == input->GetNumberOfPolys());
+
+	JenkinsMeasurement jenkins;
+	jenkins.printMeasurementWithCxReporter("CgeoReaderWriter_write_2M_triangles_ms", QString::number(writeTime));
+	jenkins.printMeasurementWithCxReporter("CgeoReaderWriter_read_2M_triangles_ms", QString::number(readTime));
+
+	QFile::remove(filename);
+}
+
+} // namespace cxtest
@@ -55,6 +55,10 @@ TrackingImplService::TrackingImplService(ctkPluginContext *context) :
 				mContext(context),
 				mToolTipOffset(0)
 {
+	mUpdateBus = new TrackingUpdateBus(this);
+	connect(mUpdateBus, &TrackingUpdateBus::snapshotReady, this, &TrackingImplService::activeCheckSlot);
+	connect(mUpdateBus, &TrackingUpdateBus::snapshotReady, this, &TrackingService::toolsUpdated);
+
 	mSession = SessionStorageServiceProxy::create(mContext);
 	connect(mSession.get(), &SessionStorageService::sessionChanged, this, &TrackingImplService::onSessionChanged);
 	connect(mSession.get(), &SessionStorageService::cleared, this, &TrackingImplService::onSessionCleared);
@@ -170,8 +174,8 @@ void TrackingImplService::initializeManualTool()
 		mTools["ManualTool"] = mManualTool;
 		mManualTool->setVisible(true);
 		connect(mManualTool.get(), &Tool::toolVisible, this, &TrackingImplService::activeCheckSlot);
-		connect(mManualTool.get(), &Tool::toolTransformAndTimestamp, this, &TrackingImplService::activeCheckSlot);
 		connect(mManualTool.get(), &Tool::tooltipOffset, this, &TrackingImplService::onTooltipOffset);
+		mUpdateBus->setTools(mTools);
 	}
 
 	Transform3D rMpr = Transform3D::Identity(); // not known: not really important either
@@ -228,6 +232,7 @@ void TrackingImplService::rebuildCachedTools()
         this->addToolsFrom(mTrackingSystems[i]);
     }
     mTools[mManualTool->getUid()] = mManualTool;
+    mUpdateBus->setTools(mTools);
     this->imbueManualToolWithRealProperties();
     this->loadPositionHistory(); // the tools are always reconfigured after a setloggingfolder
 	this->resetTrackingPositionFilters();
@@ -263,7 +268,6 @@ void TrackingImplService::addToolsFrom(TrackingSystemServicePtr system)
 		ToolPtr tool = tools[i];
 		mTools[tool->getUid()] = tool;
 		connect(tool.get(), SIGNAL(toolVisible(bool)), this, SLOT(activeCheckSlot()));
-		connect(tool.get(), &Tool::toolTransformAndTimestamp, this, &TrackingImplService::activeCheckSlot);
 		connect(tool.get(), &Tool::tooltipOffset, this, &TrackingImplService::onTooltipOffset);
 
 		if (tool->hasType(Tool::TOOL_REFERENCE))
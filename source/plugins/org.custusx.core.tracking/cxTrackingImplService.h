@@ -150,6 +150,7 @@ private:
 	SessionStorageServicePtr mSession;
 
 	double mToolTipOffset; ///< Common tool tip offset for all tools
+	TrackingUpdateBus* mUpdateBus; ///< coalesces tool movement into toolsUpdated()
 
     boost::shared_ptr<ServiceTrackerListener<TrackingSystemService> > mServiceListener;
 };
@@ -0,0 +1,236 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxPlaybackFrameCache.h"
+
+#include <QThread>
+#include <vtkImageData.h>
+#include "cxImageDataContainer.h"
+
+namespace cx
+{
+
+class PlaybackFramePrefetchThread : public QThread
+{
+public:
+	explicit PlaybackFramePrefetchThread(PlaybackFrameCache* cache) : mCache(cache) {}
+protected:
+	virtual void run() { mCache->prefetchLoop(); }
+private:
+	PlaybackFrameCache* mCache;
+};
+
+PlaybackFrameCache::PlaybackFrameCache(ImageDataContainerPtr container, qint64 memoryBudget) :
+	mContainer(container),
+	mMemoryBudget(memoryBudget),
+	mCachedBytes(0),
+	mTypicalFrameBytes(0),
+	mPlayhead(0),
+	mDirection(1),
+	mStop(false),
+	mPrefetching(false)
+{
+	mThread.reset(new PlaybackFramePrefetchThread(this));
+	mThread->start(QThread::LowPriority);
+}
+
+PlaybackFrameCache::~PlaybackFrameCache()
+{
+	{
+		QMutexLocker sentry(&mMutex);
+		mStop = true;
+		mWorkAvailable.wakeAll();
+	}
+	mThread->wait();
+}
+
+unsigned PlaybackFrameCache::size() const
+{
+	return mContainer ? mContainer->size() : 0;
+}
+
+int PlaybackFrameCache::getNumberOfCachedFrames() const
+{
+	QMutexLocker sentry(&mMutex);
+	return mFrames.size();
+}
+
+qint64 PlaybackFrameCache::getCachedBytes() const
+{
+	QMutexLocker sentry(&mMutex);
+	return mCachedBytes;
+}
+
+bool PlaybackFrameCache::isCached(int index) const
+{
+	QMutexLocker sentry(&mMutex);
+	return mFrames.count(index);
+}
+
+vtkImageDataPtr PlaybackFrameCache::get(int index)
+{
+	if (index<0 || index>=int(this->size()))
+		return vtkImageDataPtr();
+
+	vtkImageDataPtr retval;
+	{
+		QMutexLocker sentry(&mMutex);
+		if (index != mPlayhead)
+			mDirection = (index > mPlayhead) ? 1 : -1;
+		mPlayhead = index;
+		std::map<int, vtkImageDataPtr>::iterator iter = mFrames.find(index);
+		if (iter != mFrames.end())
+			retval = iter->second;
+		mWorkAvailable.wakeAll();
+	}
+
+	if (!retval)
+	{
+		retval = this->readFrame(index);
+		this->insert(index, retval);
+	}
+
+	return retval;
+}
+
+bool PlaybackFrameCache::waitForIdle(int msecs)
+{
+	QMutexLocker sentry(&mMutex);
+	if (!mPrefetching && this->findNextFrameToPrefetch()<0)
+		return true;
+	mIdle.wait(&mMutex, msecs);
+	return !mPrefetching && this->findNextFrameToPrefetch()<0;
+}
+
+vtkImageDataPtr PlaybackFrameCache::readFrame(int index)
+{
+	QMutexLocker sentry(&mReadMutex);
+	return mContainer->get(index);
+}
+
+void PlaybackFrameCache::insert(int index, vtkImageDataPtr frame)
+{
+	if (!frame)
+		return;
+	qint64 bytes = qint64(frame->GetActualMemorySize())*1024;
+
+	QMutexLocker sentry(&mMutex);
+	if (mFrames.count(index))
+		return;
+	mFrames[index] = frame;
+	mFrameBytes[index] = bytes;
+	mCachedBytes += bytes;
+	mTypicalFrameBytes = std::max(mTypicalFrameBytes, bytes);
+	this->evict();
+}
+
+/** Frames behind the playhead are three times as expensive to keep as frames ahead.
+  */
+double PlaybackFrameCache::getEvictionCost(int index) const
+{
+	int offset = (index - mPlayhead)*mDirection;
+	if (offset < 0)
+		return -3.0*offset;
+	return offset;
+}
+
+/** Evict frames until within budget. Requires mMutex.
+  */
+void PlaybackFrameCache::evict()
+{
+	while (mCachedBytes > mMemoryBudget && mFrames.size() > 1)
+	{
+		std::map<int, vtkImageDataPtr>::iterator worst = mFrames.end();
+		double worstCost = -1;
+		for (std::map<int, vtkImageDataPtr>::iterator iter=mFrames.begin(); iter!=mFrames.end(); ++iter)
+		{
+			if (iter->first == mPlayhead)
+				continue;
+			double cost = this->getEvictionCost(iter->first);
+			if (cost > worstCost)
+			{
+				worstCost = cost;
+				worst = iter;
+			}
+		}
+		if (worst == mFrames.end())
+			return;
+		mCachedBytes -= mFrameBytes[worst->first];
+		mFrameBytes.erase(worst->first);
+		mFrames.erase(worst);
+	}
+}
+
+/** Return the next frame to read, or -1 if the window around the playhead
+  * is filled. The window holds as many frames as the budget allows,
+  * three quarters of them ahead of the playhead. Requires mMutex.
+  */
+int PlaybackFrameCache::findNextFrameToPrefetch() const
+{
+	int count = this->size();
+	if (!count)
+		return -1;
+	if (!mTypicalFrameBytes)
+		return mFrames.count(mPlayhead) ? -1 : mPlayhead; // unknown frame size: wait for the first frame
+
+	int window = std::max<qint64>(1, mMemoryBudget/mTypicalFrameBytes) - 1;
+	int ahead = (window*3)/4;
+	int behind = window - ahead;
+
+	for (int i=1; i<=ahead; ++i)
+	{
+		int index = mPlayhead + i*mDirection;
+		if (index<0 || index>=count)
+			break;
+		if (!mFrames.count(index))
+			return index;
+	}
+	for (int i=1; i<=behind; ++i)
+	{
+		int index = mPlayhead - i*mDirection;
+		if (index<0 || index>=count)
+			break;
+		if (!mFrames.count(index))
+			return index;
+	}
+	return -1;
+}
+
+void PlaybackFrameCache::prefetchLoop()
+{
+	QMutexLocker sentry(&mMutex);
+	while (!mStop)
+	{
+		int index = this->findNextFrameToPrefetch();
+		if (index < 0)
+		{
+			mPrefetching = false;
+			mIdle.wakeAll();
+			mWorkAvailable.wait(&mMutex);
+			continue;
+		}
+
+		mPrefetching = true;
+		sentry.unlock();
+		vtkImageDataPtr frame = this->readFrame(index);
+		this->insert(index, frame);
+		sentry.relock();
+
+		if (!frame) // avoid spinning on unreadable frames
+		{
+			mPrefetching = false;
+			mIdle.wakeAll();
+			mWorkAvailable.wait(&mMutex);
+		}
+	}
+}
+
+} // namespace cx
@@ -0,0 +1,101 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXPLAYBACKFRAMECACHE_H_
+#define CXPLAYBACKFRAMECACHE_H_
+
+#include "org_custusx_core_video_Export.h"
+
+#include <map>
+#include <QMutex>
+#include <QWaitCondition>
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+#include "vtkForwardDeclarations.h"
+
+class QThread;
+
+namespace cx
+{
+typedef boost::shared_ptr<class ImageDataContainer> ImageDataContainerPtr;
+
+/**
+ * \file
+ * \addtogroup org_custusx_core_video
+ * @{
+ */
+
+/**\brief Frame cache for playback of a recorded US sequence.
+ *
+ * Frames are read from an ImageDataContainer. A background thread
+ * prefetches frames around the playhead (the last frame requested by get()),
+ * mainly in the direction the playhead moves. Frames are evicted when the
+ * cache exceeds the memory budget, those furthest behind the playhead first.
+ *
+ * A frame not in the cache is read synchronously by get().
+ *
+ * \ingroup org_custusx_core_video
+ * \date Oct 19, 2026
+ */
+class org_custusx_core_video_EXPORT PlaybackFrameCache
+{
+public:
+	PlaybackFrameCache(ImageDataContainerPtr container, qint64 memoryBudget = 256*1024*1024);
+	~PlaybackFrameCache();
+
+	/** Return frame index, and move the playhead to index.
+	  */
+	vtkImageDataPtr get(int index);
+	unsigned size() const;
+
+	int getNumberOfCachedFrames() const;
+	qint64 getCachedBytes() const;
+	bool isCached(int index) const;
+	/** Block until the prefetcher has nothing more to do, or until timeout.
+	  * Return true if idle.
+	  */
+	bool waitForIdle(int msecs);
+
+private:
+	friend class PlaybackFramePrefetchThread;
+	void prefetchLoop();
+	int findNextFrameToPrefetch() const;
+	vtkImageDataPtr readFrame(int index);
+	void insert(int index, vtkImageDataPtr frame);
+	void evict();
+	double getEvictionCost(int index) const;
+
+	ImageDataContainerPtr mContainer;
+	qint64 mMemoryBudget;
+
+	mutable QMutex mMutex; ///< protects the members below
+	QWaitCondition mWorkAvailable;
+	QWaitCondition mIdle;
+	std::map<int, vtkImageDataPtr> mFrames;
+	std::map<int, qint64> mFrameBytes;
+	qint64 mCachedBytes;
+	qint64 mTypicalFrameBytes;
+	int mPlayhead;
+	int mDirection; ///< +1 or -1
+	bool mStop;
+	bool mPrefetching;
+
+	QMutex mReadMutex; ///< serializes reads from mContainer
+	boost::scoped_ptr<QThread> mThread;
+};
+typedef boost::shared_ptr<PlaybackFrameCache> PlaybackFrameCachePtr;
+
+/**
+ * @}
+ */
+}
+
+#endif /* CXPLAYBACKFRAMECACHE_H_ */
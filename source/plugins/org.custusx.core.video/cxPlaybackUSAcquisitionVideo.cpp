@@ -31,11 +31,75 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxVideoServiceBackend.h"
 #include "cxFileHelpers.h"
 #include <QtConcurrent>
+#include <QCryptographicHash>
 #include "cxTool.h"
+#include "cxDataLocations.h"
+#include "cxPlaybackFrameCache.h"
 
 namespace cx
 {
 
+namespace
+{
+/** One acquisition in the on-disk timeline index.
+  */
+struct TimelineIndexEntry
+{
+	TimelineIndexEntry() : mSize(-1), mModified(-1), mFrames(0), mStart(0), mStop(0) {}
+	qint64 mSize;
+	qint64 mModified;
+	int mFrames;
+	double mStart;
+	double mStop;
+};
+typedef std::map<QString, TimelineIndexEntry> TimelineIndex;
+
+const QString timelineIndexHeader = "# CustusX US acquisition timeline index v1";
+
+TimelineIndex readTimelineIndex(QString filename)
+{
+	TimelineIndex retval;
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return retval;
+	QTextStream stream(&file);
+	if (stream.readLine() != timelineIndexHeader)
+		return retval;
+
+	while (!stream.atEnd())
+	{
+		QStringList fields = stream.readLine().split("\t");
+		if (fields.size() != 6)
+			continue;
+		TimelineIndexEntry entry;
+		entry.mSize = fields[1].toLongLong();
+		entry.mModified = fields[2].toLongLong();
+		entry.mFrames = fields[3].toInt();
+		entry.mStart = fields[4].toDouble();
+		entry.mStop = fields[5].toDouble();
+		retval[fields[0]] = entry;
+	}
+	return retval;
+}
+
+void writeTimelineIndex(QString filename, const TimelineIndex& index)
+{
+	QDir().mkpath(QFileInfo(filename).absolutePath());
+	QFile file(filename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+		return;
+	QTextStream stream(&file);
+	stream.setRealNumberPrecision(16);
+	stream << timelineIndexHeader << "\n";
+	for (TimelineIndex::const_iterator iter=index.begin(); iter!=index.end(); ++iter)
+	{
+		const TimelineIndexEntry& entry = iter->second;
+		stream << iter->first << "\t" << entry.mSize << "\t" << entry.mModified << "\t"
+			   << entry.mFrames << "\t" << entry.mStart << "\t" << entry.mStop << "\n";
+	}
+}
+}
+
 USAcquisitionVideoPlayback::USAcquisitionVideoPlayback(VideoServiceBackendPtr backend, QString type) :
 	QObject(NULL),
     mVideoSourceUid("playback " + type)
@@ -87,23 +151,50 @@ void USAcquisitionVideoPlayback::setRoot(const QString path)
 	mEvents = this->getEvents();
 }
 
+QString USAcquisitionVideoPlayback::getTimelineIndexFilename() const
+{
+	QByteArray hash = QCryptographicHash::hash((mRoot+"|"+mType).toUtf8(), QCryptographicHash::Md5);
+	return DataLocations::getCachePath() + "/playback/" + QString(hash.toHex()) + ".txt";
+}
+
 std::vector<TimelineEvent> USAcquisitionVideoPlayback::getEvents()
 {
 	std::vector<TimelineEvent> events;
 
+	QString indexFilename = this->getTimelineIndexFilename();
+	TimelineIndex oldIndex = readTimelineIndex(indexFilename);
+	TimelineIndex index;
+
 	QStringList allFiles = this->getAbsolutePathToFtsFiles(mRoot);
 	for (int i=0; i<allFiles.size(); ++i)
 	{
-		UsReconstructionFileReader reader(mBackend->file());
-		std::vector<TimedPosition> timestamps = reader.readFrameTimestamps(allFiles[i]);
+		QFileInfo info(allFiles[i]);
+		TimelineIndexEntry entry = oldIndex[allFiles[i]];
+
+		// parse only files that are new or changed since the index was written.
+		if (entry.mSize != info.size() || entry.mModified != info.lastModified().toMSecsSinceEpoch())
+		{
+			UsReconstructionFileReader reader(mBackend->file());
+			std::vector<TimedPosition> timestamps = reader.readFrameTimestamps(allFiles[i]);
+			entry = TimelineIndexEntry();
+			entry.mSize = info.size();
+			entry.mModified = info.lastModified().toMSecsSinceEpoch();
+			entry.mFrames = timestamps.size();
+			if (!timestamps.empty())
+			{
+				entry.mStart = timestamps.front().mTime;
+				entry.mStop = timestamps.back().mTime;
+			}
+		}
+		index[allFiles[i]] = entry;
 
-		if (timestamps.empty())
+		if (!entry.mFrames)
 			continue;
 
 		TimelineEvent current(
-						QString("Acquisition %1").arg(QFileInfo(allFiles[i]).fileName()),
-						timestamps.front().mTime,
-						timestamps.back().mTime);
+						QString("Acquisition %1").arg(info.fileName()),
+						entry.mStart,
+						entry.mStop);
 		current.mUid = allFiles[i];
 		current.mGroup = "acquisition";
 		current.mColor = QColor::fromHsv(36, 255, 222);
@@ -112,6 +203,9 @@ std::vector<TimelineEvent> USAcquisitionVideoPlayback::getEvents()
 
 	}
 
+	if (!allFiles.isEmpty())
+		writeTimelineIndex(indexFilename, index);
+
 	return events;
 }
 
@@ -159,6 +253,7 @@ void USAcquisitionVideoPlayback::loadFullData(QString filename)
 
 	// clear data
 	mCurrentData = USReconstructInputData();
+	mFrameCache.reset();
 
 	// if no new data, return
 	if (filename.isEmpty())
@@ -193,6 +288,9 @@ void USAcquisitionVideoPlayback::usDataLoadFinishedSlot()
 			probe->setProbeDefinition(mCurrentData.mProbeDefinition.mData);
 	}
 
+	if (mCurrentData.mUsRaw)
+		mFrameCache.reset(new PlaybackFrameCache(mCurrentData.mUsRaw->getImageContainer()));
+
 	// create a vector to allow for quick search
 	mCurrentTimestamps.clear();
 	for (unsigned i=0; i<mCurrentData.mFrames.size(); ++i)
@@ -211,7 +309,7 @@ void  USAcquisitionVideoPlayback::updateFrame(QString filename)
 		return;
 	}
 
-	if (mCurrentData.mFilename.isEmpty() || !mCurrentData.mUsRaw || filename!=mCurrentData.mFilename)
+	if (mCurrentData.mFilename.isEmpty() || !mCurrentData.mUsRaw || !mFrameCache || filename!=mCurrentData.mFilename)
 	{
 		mVideoSource->setInfoString(QString(""));
 		mVideoSource->setStatusString(QString("No US Acquisition"));
@@ -234,7 +332,7 @@ void  USAcquisitionVideoPlayback::updateFrame(QString filename)
 	int timeout = 1000; // invalidate data if timestamp differ from time too much
 	mVideoSource->overrideTimeout(fabs(timestamp-*iter)>timeout);
 
-	ImagePtr image(new Image(mVideoSourceUid, mCurrentData.mUsRaw->getImageContainer()->get(index)));
+	ImagePtr image(new Image(mVideoSourceUid, mFrameCache->get(index)));
 	image->setAcquisitionTime(QDateTime::fromMSecsSinceEpoch(timestamp));
 
 	mVideoSource->setInfoString(QString("%1 - Frame %2").arg(mCurrentData.mUsRaw->getName()).arg(index));
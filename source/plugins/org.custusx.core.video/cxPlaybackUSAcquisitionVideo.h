@@ -26,6 +26,7 @@ namespace cx
 {
 typedef boost::shared_ptr<class BasicVideoSource> BasicVideoSourcePtr;
 typedef boost::shared_ptr<class VideoServiceBackend> VideoServiceBackendPtr;
+typedef boost::shared_ptr<class PlaybackFrameCache> PlaybackFrameCachePtr;
 
 /**
  * \file
@@ -36,6 +37,11 @@ typedef boost::shared_ptr<class VideoServiceBackend> VideoServiceBackendPtr;
 /**\brief Handler for playback of US image data
  * from a US recording session.
  *
+ * Frames of the current acquisition are read through a PlaybackFrameCache,
+ * prefetching frames around the playhead.
+ * The timeline events (one per acquisition) are cached on disk, and only
+ * acquisitions that are new or changed since the last call are parsed.
+ *
  * \ingroup org_custusx_core_video
  * \date Apr 11, 2012
  * \author Christian Askeland, SINTEF
@@ -63,6 +69,7 @@ private:
     void updateFrame(QString filename);
 	void loadFullData(QString filename);
 	QStringList getAbsolutePathToFtsFiles(QString folder);
+	QString getTimelineIndexFilename() const;
 	QString mRoot;
     QString mType;
     PlaybackTimePtr mTimer;
@@ -72,6 +79,7 @@ private:
 
 	USReconstructInputData mCurrentData;
 	std::vector<double> mCurrentTimestamps; // copy of time frame timestamps from mCurrentData.
+	PlaybackFrameCachePtr mFrameCache; // frames from mCurrentData
 
 	UsReconstructionFileReaderPtr mUSImageDataReader;
 	QFuture<USReconstructInputData> mUSImageDataFutureResult;
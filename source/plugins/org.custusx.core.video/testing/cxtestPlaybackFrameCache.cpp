@@ -0,0 +1,71 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+                 
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+                 
+CustusX is released under a BSD 3-Clause license.
+                 
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <vtkImageData.h>
+#include "cxPlaybackFrameCache.h"
+#include "cxImageDataContainer.h"
+#include "cxVolumeHelpers.h"
+
+namespace cxtest
+{
+
+namespace
+{
+cx::ImageDataContainerPtr createFrames(int count)
+{
+	std::vector<vtkImageDataPtr> frames;
+	for (int i=0; i<count; ++i)
+		frames.push_back(cx::generateVtkImageData(Eigen::Array3i(64,64,1), cx::Vector3D(1,1,1), i));
+	return cx::ImageDataContainerPtr(new cx::FramesDataContainer(frames));
+}
+
+qint64 getFrameBytes(cx::ImageDataContainerPtr frames)
+{
+	return qint64(frames->get(0)->GetActualMemorySize())*1024;
+}
+}
+
+TEST_CASE("PlaybackFrameCache: get returns the container frames", "[unit][plugins][org.custusx.core.video]")
+{
+	cx::ImageDataContainerPtr frames = createFrames(20);
+	cx::PlaybackFrameCache cache(frames);
+
+	REQUIRE(cache.size() == 20);
+	for (int i=0; i<20; ++i)
+		CHECK(cache.get(i) == frames->get(i));
+	CHECK(!cache.get(20));
+	CHECK(!cache.get(-1));
+}
+
+TEST_CASE("PlaybackFrameCache: prefetches ahead of the playhead within budget", "[unit][plugins][org.custusx.core.video]")
+{
+	cx::ImageDataContainerPtr frames = createFrames(100);
+	qint64 budget = 9*getFrameBytes(frames);
+	cx::PlaybackFrameCache cache(frames, budget);
+
+	cache.get(50);
+	REQUIRE(cache.waitForIdle(5000));
+	CHECK(cache.isCached(51));
+	CHECK(cache.isCached(56));
+	CHECK(!cache.isCached(70));
+	CHECK(cache.getCachedBytes() <= budget);
+
+	// reverse the direction of travel: prefetch moves to the frames below the playhead.
+	cache.get(49);
+	cache.get(48);
+	REQUIRE(cache.waitForIdle(5000));
+	CHECK(cache.isCached(47));
+	CHECK(cache.isCached(42));
+	CHECK(!cache.isCached(56));
+	CHECK(cache.getCachedBytes() <= budget);
+}
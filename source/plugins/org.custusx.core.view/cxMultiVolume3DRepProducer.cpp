@@ -29,6 +29,7 @@ namespace cx
 MultiVolume3DRepProducer::MultiVolume3DRepProducer()
 {
 	mMaxRenderSize = 10 * pow(10.0,6);
+	mInteractiveRenderSize = 0;
 }
 
 MultiVolume3DRepProducer::~MultiVolume3DRepProducer()
@@ -79,6 +80,20 @@ int MultiVolume3DRepProducer::getMaxRenderSize() const
 	return mMaxRenderSize;
 }
 
+void MultiVolume3DRepProducer::setInteractiveRenderSize(int voxels)
+{
+	mInteractiveRenderSize = voxels;
+	if (mInteractiveRenderSize<0)
+		mInteractiveRenderSize = 0;
+
+	this->updateRepsInView();
+}
+
+int MultiVolume3DRepProducer::getInteractiveRenderSize() const
+{
+	return mInteractiveRenderSize;
+}
+
 void MultiVolume3DRepProducer::setVisualizerType(QString type)
 {
 	mVisualizerType = type;
@@ -270,6 +285,7 @@ void MultiVolume3DRepProducer::buildVtkVolumeTextureMapper3D(ImagePtr image)
 	rep->setUseVolumeTextureMapper();
 
 	rep->setMaxVolumeSize(this->getMaxRenderSize());
+	rep->setInteractiveVolumeSize(this->getInteractiveRenderSize());
 	rep->setImage(image);
 	mReps.push_back(rep);
 }
@@ -280,6 +296,7 @@ void MultiVolume3DRepProducer::buildVtkGPUVolumeRayCastMapper(ImagePtr image)
 	rep->setUseGPUVolumeRayCastMapper();
 
 	rep->setMaxVolumeSize(this->getMaxRenderSize());
+	rep->setInteractiveVolumeSize(this->getInteractiveRenderSize());
 	rep->setImage(image);
 	mReps.push_back(rep);
 }
@@ -42,6 +42,8 @@ public:
 	void setView(ViewPtr view);
 	void setMaxRenderSize(int voxels);
 	int getMaxRenderSize() const;
+	void setInteractiveRenderSize(int voxels); ///< volume size while the camera moves, 0 disables.
+	int getInteractiveRenderSize() const;
 	void setVisualizerType(QString type);
 	void addImage(ImagePtr image);
 	void removeImage(QString uid);
@@ -62,6 +64,7 @@ private:
 	std::vector<ImagePtr> m3DImages;
 	std::vector<RepPtr> mReps;
 	int mMaxRenderSize;
+	int mInteractiveRenderSize;
 	ViewPtr mView;
 
 	void updateRepsInView();
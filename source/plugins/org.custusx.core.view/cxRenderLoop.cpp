@@ -25,39 +25,48 @@ namespace cx
 RenderLoop::RenderLoop() :
 	QObject(NULL),
 	mTimer(NULL),
+	mDeadline(0),
+	mLastFullRender(0),
+	mRunning(false),
+	mSkippedFrames(0),
 	mSmartRender(false),
-	mLogging(false),
-	mBaseRenderInterval(40)
+	mBaseRenderInterval(40),
+	mLogging(false)
 {
-	mLastFullRender = QDateTime::currentDateTime();
 	mCyclicLogger.reset(new CyclicActionLogger("Main Render timer"));
 
 	mTimer = new QTimer(this);
+	mTimer->setSingleShot(true);
+	mTimer->setTimerType(Qt::PreciseTimer);
 	connect(mTimer, SIGNAL(timeout()), this, SLOT(timeoutSlot()));
-
-	this->sendRenderIntervalToTimer(mBaseRenderInterval);
 }
 
 void RenderLoop::start()
 {
-	mTimer->start();
+	mRunning = true;
+	mClock.start();
+	mDeadline = 0;
+	mLastFullRender = 0;
+	mTimer->start(0);
 }
 
 void RenderLoop::stop()
 {
+	mRunning = false;
 	mTimer->stop();
 	emit fps(0);
 }
 
 bool RenderLoop::isRunning() const
 {
-	return mTimer->isActive();
+	return mRunning;
 }
 
 void RenderLoop::setRenderingInterval(int interval)
 {
+	if (interval == 0)
+		interval = 30;
 	mBaseRenderInterval = interval;
-	this->sendRenderIntervalToTimer(mBaseRenderInterval);
 }
 
 void RenderLoop::setLogging(bool on)
@@ -70,21 +79,6 @@ void RenderLoop::setSmartRender(bool val)
 	mSmartRender = val;
 }
 
-void RenderLoop::sendRenderIntervalToTimer(int interval)
-{
-	if (interval==mTimer->interval())
-		return;
-	if (interval == 0)
-		interval = 30;
-
-	bool active = this->isRunning();
-	if (active)
-		mTimer->stop();
-	mTimer->setInterval(interval);
-	if (active)
-		mTimer->start();
-}
-
 void RenderLoop::addLayout(ViewCollectionWidget* layout)
 {
 	mLayoutWidgets.push_back(layout);
@@ -98,23 +92,53 @@ void RenderLoop::clearViews()
 
 void RenderLoop::timeoutSlot()
 {
+	if (!mRunning)
+		return;
+
 	mCyclicLogger->begin();
-	mLastBeginRender = QDateTime::currentDateTime();
-	this->sendRenderIntervalToTimer(mBaseRenderInterval);
+	this->advanceDeadline();
 
 	emit preRender();
+	mCyclicLogger->time("preRender");
 
 	this->renderViews();
 
 	this->emitFPSIfRequired();
 
-	int timeToNext = this->calculateTimeToNextRender();
-	this->sendRenderIntervalToTimer(timeToNext);
+	this->scheduleNextRender();
+}
+
+void RenderLoop::advanceDeadline()
+{
+	int skipped = 0;
+	mDeadline = computeNextDeadline(mDeadline, mClock.elapsed(), mBaseRenderInterval, &skipped);
+	mSkippedFrames += skipped;
+}
+
+/** Return the end of the frame starting at now, given the previous deadline.
+  * Deadlines already passed are skipped, not rendered late, and counted in skipped.
+  * All times are in ms on the same monotonic clock.
+  */
+qint64 RenderLoop::computeNextDeadline(qint64 deadline, qint64 now, int interval, int* skipped)
+{
+	if (deadline - now > interval) // interval reduced
+		deadline = now;
+	qint64 late = now - deadline;
+	*skipped = (late > 0) ? int(late/interval) : 0;
+	return deadline + qint64(*skipped+1)*interval;
+}
+
+void RenderLoop::scheduleNextRender()
+{
+	// always wait at least 1ms - give others time to do stuff
+	qint64 timeToNext = mDeadline - mClock.elapsed();
+	mTimer->start(int(std::max<qint64>(1, timeToNext)));
 }
 
 void RenderLoop::renderViews()
 {
 	bool smart = this->pollForSmartRenderingThisCycle();
+	qint64 budget = mDeadline - mClock.elapsed();
 
 	for (unsigned i=0; i<mLayoutWidgets.size(); ++i)
 	{
@@ -122,7 +146,7 @@ void RenderLoop::renderViews()
 		{
 			if (!smart)
 				mLayoutWidgets[i]->setModified();
-			mLayoutWidgets[i]->render();
+			mLayoutWidgets[i]->renderModified(budget, mCyclicLogger);
 		}
 	}
 
@@ -130,18 +154,20 @@ void RenderLoop::renderViews()
 	emit renderFinished();
 }
 
+/** Return false if all views should be rendered this frame.
+  */
 bool RenderLoop::pollForSmartRenderingThisCycle()
 {
 	// do a full render anyway at low rate. This is a convenience hack for rendering
 	// occational effects that the smart render is too dumb to see.
 	bool smart = mSmartRender;
-	int smartInterval = mTimer->interval() * 40;
-	int passed = mLastFullRender.time().msecsTo(QDateTime::currentDateTime().time());
+	qint64 smartInterval = mBaseRenderInterval * 40;
+	qint64 now = mClock.elapsed();
 
-	if (passed > smartInterval)
+	if (now - mLastFullRender > smartInterval)
 		smart = false;
 	if (!smart)
-		mLastFullRender = QDateTime::currentDateTime();
+		mLastFullRender = now;
 	return smart;
 }
 
@@ -151,10 +177,8 @@ void RenderLoop::emitFPSIfRequired()
 	{
 		emit fps(mCyclicLogger->getFPS());
 		this->dumpStatistics();
-//		static int counter=0;
-//		if (++counter%3==0)
-//			reportDebug(mCyclicLogger->dumpStatisticsSmall());
 		mCyclicLogger->reset();
+		mSkippedFrames = 0;
 	}
 }
 
@@ -165,19 +189,7 @@ void RenderLoop::dumpStatistics()
 
 	static int counter=0;
 	if (++counter%3==0) // every third event
-		reportDebug(mCyclicLogger->dumpStatisticsSmall());
-}
-
-int RenderLoop::calculateTimeToNextRender()
-{
-	// tests show that the application wait between renderings even if the rendering uses more time
-	// than the interval. This hack shortens the wait time between renderings but keeps below the
-	// input update rate at all times.
-	int usage = mLastBeginRender.msecsTo(QDateTime::currentDateTime()); // time spent in rendering
-	int leftover = std::max(0, mTimer->interval() - usage); // time left of the rendering interval
-	int timeToNext = std::max(1, leftover); // always wait at least 1ms - give others time to do stuff
-	//    std::cout << QString("setting interval %1, usage is %2").arg(timeToNext).arg(usage) << std::endl;
-	return timeToNext;
+		reportDebug(QString("%1, skipped %2 frames").arg(mCyclicLogger->dumpStatisticsSmall()).arg(mSkippedFrames));
 }
 
 } // namespace cx
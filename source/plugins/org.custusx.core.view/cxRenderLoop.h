@@ -16,7 +16,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <QObject>
 #include "cxForwardDeclarations.h"
 class QTimer;
-#include <QDateTime>
+#include <QElapsedTimer>
 #include <set>
 
 namespace cx
@@ -27,6 +27,14 @@ class ViewCollectionWidget;
  *
  * This is the main render loop in Custus.
  *
+ * Frames are scheduled at fixed deadlines given by the rendering interval.
+ * Within a frame, only modified views are rendered, those with live
+ * video or tools first. Views not rendered before the deadline are
+ * rendered in the next frame. If a frame overruns, the missed
+ * deadlines are skipped instead of queued. With smart render, all views
+ * are still rendered every 40 intervals, in order to catch changes the
+ * modified check misses.
+ *
  * \ingroup org_custusx_core_view
  * \date 2014-02-06
  * \author christiana
@@ -40,13 +48,15 @@ public:
 	void stop();
 	bool isRunning() const;
 	void setRenderingInterval(int interval);
-	void setSmartRender(bool val); ///< If set: Render only views with modified props using the given interval, render nonmodified at a slower pace.
+	void setSmartRender(bool val); ///< If set: Render only views with modified props. If not set: Render all views each frame.
 	void setLogging(bool on);
 
 	void clearViews();
 	void addLayout(ViewCollectionWidget* layout);
 
 	CyclicActionLoggerPtr getRenderTimer() { return mCyclicLogger; }
+	int getSkippedFrames() const { return mSkippedFrames; } ///< frames skipped because of overrun, since last fps()
+	static qint64 computeNextDeadline(qint64 deadline, qint64 now, int interval, int* skipped);
 
 //public slots:
 //	void requestPreRenderSignal();
@@ -60,17 +70,19 @@ private slots:
 	void timeoutSlot();
 
 private:
-	void sendRenderIntervalToTimer(int interval);
-	void emitPreRenderIfRequested();
+	void advanceDeadline();
+	void scheduleNextRender();
 	void renderViews();
 	bool pollForSmartRenderingThisCycle();
-	int calculateTimeToNextRender();
 	void emitFPSIfRequired();
 	void dumpStatistics();
 
-	QTimer* mTimer; ///< timer that drives rendering
-	QDateTime mLastFullRender;
-	QDateTime mLastBeginRender;
+	QTimer* mTimer; ///< single shot timer that drives rendering
+	QElapsedTimer mClock; ///< monotonic clock for the deadlines, started by start()
+	qint64 mDeadline; ///< end of the current frame, ms on mClock
+	qint64 mLastFullRender; ///< ms on mClock
+	bool mRunning;
+	int mSkippedFrames;
 
 	CyclicActionLoggerPtr mCyclicLogger;
 
@@ -174,6 +174,7 @@ void ViewWrapper3D::initializeMultiVolume3DRepProducer()
 	}
 
 	mMultiVolume3DRepProducer->setMaxRenderSize(settings()->value("View3D/maxRenderSize").toInt());
+	mMultiVolume3DRepProducer->setInteractiveRenderSize(settings()->value("View3D/interactiveRenderSize").toInt());
 	mMultiVolume3DRepProducer->setVisualizerType(settings()->value("View3D/ImageRender3DVisualizer").toString());
 }
 
@@ -194,7 +195,7 @@ void ViewWrapper3D::settingsChangedSlot(QString key)
 		QColor background = settings()->value("backgroundColor").value<QColor>();
 		mView->setBackgroundColor(background);
 	}
-	if (( key=="View3D/ImageRender3DVisualizer" )||( key=="View3D/maxRenderSize" ))
+	if (( key=="View3D/ImageRender3DVisualizer" )||( key=="View3D/maxRenderSize" )||( key=="View3D/interactiveRenderSize" ))
 	{
 		this->initializeMultiVolume3DRepProducer();
 	}
@@ -209,7 +210,9 @@ void ViewWrapper3D::settingsChangedSlot(QString key)
 		mAnnotationMarker->setMarkerFilename(DataLocations::findConfigFilePath(annotationFile, "/models"));
 		mAnnotationMarker->setSize(settings()->value("View3D/annotationModelSize").toDouble());
 	}
-	if (key == "View3D/showManualTool")
+	if ((key == "View3D/showManualTool")
+			||( key == "View3D/toolPathDecimationTolerance" )
+			||( key == "View3D/toolPathMaxRenderedPoints" ))
 	{
 		this->toolsAvailableSlot();
 	}
@@ -833,6 +836,8 @@ void ViewWrapper3D::toolsAvailableSlot()
 
 		toolRep->setSphereRadius(settings()->value("View3D/sphereRadius").toDouble()); // use fraction of set size
 		toolRep->setSphereRadiusInNormalizedViewport(true);
+		toolRep->getTracer()->setDecimationTolerance(settings()->value("View3D/toolPathDecimationTolerance").toDouble());
+		toolRep->getTracer()->setMaxRenderedPoints(settings()->value("View3D/toolPathMaxRenderedPoints").toInt());
 
 		toolRep->setTool(tool);
 		toolRep->setOffsetPointVisibleAtZeroOffset(true);
@@ -0,0 +1,71 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include <iostream>
+#include <QApplication>
+#include <QStringList>
+#include "cxLogicManager.h"
+#include "cxDataLocations.h"
+#include "cxVisServices.h"
+#include "cxtestRenderBenchmark.h"
+
+/** Run rendering benchmarks described by scenario files.
+ *
+ * Usage: cxRenderBenchmark [--software] [scenario.xml ...]
+ *
+ * Runs the built-in default scenario if no files are given.
+ * --software selects the Mesa software OpenGL implementation, for
+ * use on machines without a GPU.
+ */
+int main(int argc, char *argv[])
+{
+	bool software = false;
+	for (int i=1; i<argc; ++i)
+		if (QString(argv[i]) == "--software")
+			software = true;
+	if (software)
+		qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+
+	QApplication app(argc, argv);
+
+	QStringList files = app.arguments().mid(1);
+	files.removeAll("--software");
+
+	std::vector<cxtest::RenderBenchmarkScenario> scenarios;
+	if (files.isEmpty())
+		scenarios.push_back(cxtest::RenderBenchmarkScenario::createDefault());
+	for (int i=0; i<files.size(); ++i)
+	{
+		cxtest::RenderBenchmarkScenario scenario;
+		QString error;
+		if (!scenario.load(files[i], &error))
+		{
+			std::cerr << error.toStdString() << std::endl;
+			return 1;
+		}
+		scenarios.push_back(scenario);
+	}
+
+	cx::DataLocations::setTestMode();
+	cx::LogicManager::initialize();
+
+	bool success = true;
+	for (unsigned i=0; i<scenarios.size(); ++i)
+	{
+		cxtest::RenderBenchmark benchmark(cx::VisServices::create(cx::logicManager()->getPluginContext()));
+		cxtest::RenderBenchmarkResult result = benchmark.run(scenarios[i]);
+		std::cout << result.toString().toStdString() << std::endl;
+		success = success && !result.mTimedOut;
+	}
+
+	cx::LogicManager::shutdown();
+	return success ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+#include <QDomDocument>
+#include "cxtestRenderBenchmark.h"
+#include "cxLogicManager.h"
+#include "cxDataLocations.h"
+#include "cxVisServices.h"
+
+namespace cxtest
+{
+
+TEST_CASE("RenderBenchmarkScenario: Parse scenario xml", "[unit][visualization]")
+{
+	QDomDocument doc;
+	REQUIRE(doc.setContent(QString(
+		"<benchmark name=\"test\">"
+		"  <layout rows=\"1\" cols=\"2\">"
+		"    <view group=\"0\" type=\"3D\" row=\"0\" col=\"0\"/>"
+		"    <view group=\"1\" type=\"axial\" row=\"0\" col=\"1\"/>"
+		"  </layout>"
+		"  <volumes count=\"2\" dim=\"64 32 16\" spacing=\"0.5\"/>"
+		"  <video width=\"320\" height=\"240\"/>"
+		"  <frames warmup=\"5\" count=\"50\"/>"
+		"</benchmark>")));
+
+	RenderBenchmarkScenario scenario;
+	QString error;
+	REQUIRE(scenario.parseXml(doc.documentElement(), &error));
+	CHECK(scenario.mName == "test");
+	CHECK(scenario.mLayout.getOffScreenRendering());
+	CHECK(scenario.mLayout.get(cx::LayoutPosition(0,0)).mType == cx::View::VIEW_3D);
+	CHECK(scenario.mLayout.get(cx::LayoutPosition(0,1)).mPlane == cx::ptAXIAL);
+	CHECK(scenario.mLayout.get(cx::LayoutPosition(0,1)).mGroup == 1);
+	CHECK(scenario.mVolumeCount == 2);
+	CHECK((scenario.mVolumeDim == Eigen::Array3i(64,32,16)).all());
+	CHECK(scenario.mVideo);
+	CHECK(scenario.mMeshCount == 0);
+	CHECK(scenario.mWarmupFrames == 5);
+	CHECK(scenario.mFrames == 50);
+}
+
+TEST_CASE("RenderBenchmarkResult: Frame percentiles", "[unit][visualization]")
+{
+	RenderBenchmarkResult result;
+	for (int i=1; i<=100; ++i)
+		result.mFrameTimes.push_back(101-i);
+
+	CHECK(result.getFramePercentile(50) == Approx(50));
+	CHECK(result.getFramePercentile(99) == Approx(99));
+	CHECK(result.getFramePercentile(100) == Approx(100));
+	CHECK(result.getMeanFrameTime() == Approx(50.5));
+}
+
+TEST_CASE("Speed: Render benchmark default scenario", "[speed][gui][integration]")
+{
+	cx::DataLocations::setTestMode();
+	cx::LogicManager::initialize();
+
+	RenderBenchmarkScenario scenario = RenderBenchmarkScenario::createDefault();
+	RenderBenchmark benchmark(cx::VisServices::create(cx::logicManager()->getPluginContext()));
+	RenderBenchmarkResult result = benchmark.run(scenario);
+	std::cout << result.toString().toStdString() << std::endl;
+
+	CHECK(!result.mTimedOut);
+	CHECK(result.mFrameTimes.size() == scenario.mFrames);
+	CHECK(!result.mRepUpdateTime.empty());
+	result.writeJenkinsMeasurements();
+
+	cx::LogicManager::shutdown();
+}
+
+} // namespace cxtest
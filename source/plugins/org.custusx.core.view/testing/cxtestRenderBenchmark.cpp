@@ -0,0 +1,461 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxtestRenderBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <QApplication>
+#include <QDomDocument>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QWidget>
+#include <vtkSphereSource.h>
+#include <vtkPolyData.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#include <fstream>
+#endif
+
+#include "cxVisServices.h"
+#include "cxViewService.h"
+#include "cxViewGroupData.h"
+#include "cxViewCollectionWidget.h"
+#include "cxPatientModelService.h"
+#include "cxTrackingService.h"
+#include "cxImage.h"
+#include "cxMesh.h"
+#include "cxPointMetric.h"
+#include "cxDummyTool.h"
+#include "cxTestVideoSource.h"
+#include "cxTrackedStream.h"
+#include "cxRepImpl.h"
+#include "cxSettings.h"
+#include "cxBoundingBox3D.h"
+#include "cxtestUtilities.h"
+#include "cxtestJenkinsMeasurement.h"
+
+namespace cxtest
+{
+
+namespace
+{
+bool setView(cx::LayoutData* layout, QDomElement element, QString* error)
+{
+	int group = element.attribute("group", "0").toInt();
+	cx::LayoutRegion region(element.attribute("row", "0").toInt(),
+							element.attribute("col", "0").toInt(),
+							element.attribute("rowSpan", "1").toInt(),
+							element.attribute("colSpan", "1").toInt());
+	QString type = element.attribute("type").toLower();
+
+	std::map<QString, cx::PLANE_TYPE> planes;
+	planes["axial"] = cx::ptAXIAL;
+	planes["coronal"] = cx::ptCORONAL;
+	planes["sagittal"] = cx::ptSAGITTAL;
+	planes["any"] = cx::ptANYPLANE;
+	planes["side"] = cx::ptSIDEPLANE;
+	planes["radial"] = cx::ptRADIALPLANE;
+
+	if (type == "3d")
+		layout->setView(group, cx::View::VIEW_3D, region);
+	else if (type == "video")
+		layout->setView(group, cx::View::VIEW_REAL_TIME, region);
+	else if (planes.count(type))
+		layout->setView(group, planes[type], region);
+	else
+	{
+		if (error)
+			*error = QString("Unknown view type [%1]").arg(type);
+		return false;
+	}
+	return true;
+}
+
+std::vector<int> getGroups(const cx::LayoutData& layout)
+{
+	std::vector<int> retval;
+	for (cx::LayoutData::const_iterator iter=layout.begin(); iter!=layout.end(); ++iter)
+		if (iter->isValid() && std::find(retval.begin(), retval.end(), iter->mGroup)==retval.end())
+			retval.push_back(iter->mGroup);
+	return retval;
+}
+}
+
+///--------------------------------------------------------
+
+RenderBenchmarkScenario::RenderBenchmarkScenario() :
+	mVolumeCount(0),
+	mVolumeDim(128, 128, 128),
+	mVolumeSpacing(1.0),
+	mMeshCount(0),
+	mMeshResolution(32),
+	mMetricCount(0),
+	mToolMotion(false),
+	mToolInterval(16),
+	mVideo(false),
+	mVideoSize(640, 480),
+	mWarmupFrames(10),
+	mFrames(100),
+	mRenderingInterval(1)
+{
+}
+
+RenderBenchmarkScenario RenderBenchmarkScenario::createDefault()
+{
+	RenderBenchmarkScenario retval;
+	retval.mName = "3D ACS with volume, mesh and tool";
+	retval.mLayout = cx::LayoutData::create("LAYOUT_BENCHMARK", retval.mName, 3, 4);
+	retval.mLayout.setView(0, cx::View::VIEW_3D, cx::LayoutRegion(0, 0, 3, 3));
+	retval.mLayout.setView(0, cx::ptAXIAL, cx::LayoutRegion(0, 3));
+	retval.mLayout.setView(0, cx::ptCORONAL, cx::LayoutRegion(1, 3));
+	retval.mLayout.setView(0, cx::ptSAGITTAL, cx::LayoutRegion(2, 3));
+	retval.mLayout.setOffScreenRendering(true);
+	retval.mVolumeCount = 1;
+	retval.mMeshCount = 1;
+	retval.mMetricCount = 5;
+	retval.mToolMotion = true;
+	return retval;
+}
+
+bool RenderBenchmarkScenario::load(QString filename, QString* error)
+{
+	QFile file(filename);
+	QDomDocument doc;
+	QString message;
+	if (!file.open(QIODevice::ReadOnly) || !doc.setContent(&file, &message))
+	{
+		if (error)
+			*error = QString("Failed to read scenario %1: %2").arg(filename).arg(message);
+		return false;
+	}
+	return this->parseXml(doc.documentElement(), error);
+}
+
+bool RenderBenchmarkScenario::parseXml(QDomElement root, QString* error)
+{
+	mName = root.attribute("name", "benchmark");
+
+	QDomElement layout = root.firstChildElement("layout");
+	if (layout.isNull())
+	{
+		if (error)
+			*error = QString("Scenario %1 has no layout").arg(mName);
+		return false;
+	}
+	mLayout = cx::LayoutData::create("LAYOUT_BENCHMARK", mName,
+									 layout.attribute("rows", "1").toInt(),
+									 layout.attribute("cols", "1").toInt());
+	mLayout.setOffScreenRendering(layout.attribute("offscreen", "true") == "true");
+	for (QDomElement view = layout.firstChildElement("view"); !view.isNull(); view = view.nextSiblingElement("view"))
+		if (!setView(&mLayout, view, error))
+			return false;
+
+	QDomElement volumes = root.firstChildElement("volumes");
+	if (!volumes.isNull())
+	{
+		mVolumeCount = volumes.attribute("count", "1").toInt();
+		QStringList dim = volumes.attribute("dim", "128 128 128").split(" ", QString::SkipEmptyParts);
+		if (dim.size()==3)
+			mVolumeDim = Eigen::Array3i(dim[0].toInt(), dim[1].toInt(), dim[2].toInt());
+		mVolumeSpacing = volumes.attribute("spacing", "1").toDouble();
+	}
+
+	QDomElement meshes = root.firstChildElement("meshes");
+	if (!meshes.isNull())
+	{
+		mMeshCount = meshes.attribute("count", "1").toInt();
+		mMeshResolution = meshes.attribute("resolution", "32").toInt();
+	}
+
+	QDomElement metrics = root.firstChildElement("metrics");
+	if (!metrics.isNull())
+		mMetricCount = metrics.attribute("count", "1").toInt();
+
+	QDomElement tool = root.firstChildElement("tool");
+	if (!tool.isNull())
+	{
+		mToolMotion = tool.attribute("motion", "true") == "true";
+		mToolInterval = tool.attribute("interval", "16").toInt();
+	}
+
+	QDomElement video = root.firstChildElement("video");
+	mVideo = !video.isNull();
+	if (mVideo)
+		mVideoSize = Eigen::Array2i(video.attribute("width", "640").toInt(), video.attribute("height", "480").toInt());
+
+	QDomElement frames = root.firstChildElement("frames");
+	if (!frames.isNull())
+	{
+		mWarmupFrames = frames.attribute("warmup", "10").toInt();
+		mFrames = frames.attribute("count", "100").toInt();
+		mRenderingInterval = std::max(1, frames.attribute("interval", "1").toInt());
+	}
+
+	return true;
+}
+
+///--------------------------------------------------------
+
+double RenderBenchmarkResult::getFramePercentile(double percent) const
+{
+	if (mFrameTimes.empty())
+		return 0;
+	std::vector<double> sorted = mFrameTimes;
+	std::sort(sorted.begin(), sorted.end());
+	int index = int(std::ceil(percent/100.0*sorted.size())) - 1;
+	index = std::max(0, std::min(index, int(sorted.size())-1));
+	return sorted[index];
+}
+
+double RenderBenchmarkResult::getMeanFrameTime() const
+{
+	if (mFrameTimes.empty())
+		return 0;
+	double sum = 0;
+	for (unsigned i=0; i<mFrameTimes.size(); ++i)
+		sum += mFrameTimes[i];
+	return sum/mFrameTimes.size();
+}
+
+QString RenderBenchmarkResult::toString() const
+{
+	QString retval;
+	retval += QString("Benchmark: %1%2\n").arg(mName).arg(mTimedOut ? " (timed out)" : "");
+	retval += QString("  Frames: %1, mean %2 ms\n").arg(mFrameTimes.size()).arg(this->getMeanFrameTime(), 0, 'f', 2);
+	retval += QString("  Frame time percentiles: p50 %1 ms, p90 %2 ms, p99 %3 ms, max %4 ms\n")
+			.arg(this->getFramePercentile(50), 0, 'f', 2)
+			.arg(this->getFramePercentile(90), 0, 'f', 2)
+			.arg(this->getFramePercentile(99), 0, 'f', 2)
+			.arg(this->getFramePercentile(100), 0, 'f', 2);
+	retval += QString("  Memory: %1 MB before, %2 MB after\n").arg(mMemoryBefore, 0, 'f', 1).arg(mMemoryAfter, 0, 'f', 1);
+	retval += QString("  Rep update time per frame:\n");
+	for (std::map<QString, double>::const_iterator iter=mRepUpdateTime.begin(); iter!=mRepUpdateTime.end(); ++iter)
+		retval += QString("    %1: %2 ms\n").arg(iter->first, -32).arg(iter->second, 0, 'f', 3);
+	return retval;
+}
+
+void RenderBenchmarkResult::writeJenkinsMeasurements() const
+{
+	JenkinsMeasurement jenkins;
+	QString prefix = mName + " ";
+	jenkins.createOutput(prefix + "p50 (ms)", QString::number(this->getFramePercentile(50)));
+	jenkins.createOutput(prefix + "p99 (ms)", QString::number(this->getFramePercentile(99)));
+	jenkins.createOutput(prefix + "memory (MB)", QString::number(mMemoryAfter));
+}
+
+///--------------------------------------------------------
+
+RenderBenchmark::RenderBenchmark(cx::VisServicesPtr services) :
+	mServices(services)
+{
+}
+
+double RenderBenchmark::getResidentMemory()
+{
+#if defined(__APPLE__)
+	mach_task_basic_info info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS)
+		return 0;
+	return info.resident_size/1024.0/1024.0;
+#elif defined(__linux__)
+	std::ifstream statm("/proc/self/statm");
+	long size = 0;
+	long resident = 0;
+	if (!(statm >> size >> resident))
+		return 0;
+	return double(resident)*sysconf(_SC_PAGESIZE)/1024.0/1024.0;
+#else
+	return 0;
+#endif
+}
+
+RenderBenchmarkResult RenderBenchmark::run(const RenderBenchmarkScenario& scenario, int timeoutMs)
+{
+	RenderBenchmarkResult retval;
+	retval.mName = scenario.mName;
+	retval.mMemoryBefore = this->getResidentMemory();
+
+	cx::ViewServicePtr viewService = mServices->view();
+	cx::settings()->setValue("renderingInterval", scenario.mRenderingInterval);
+	cx::settings()->setValue("smartRender", true);
+
+	this->setupLayout(scenario);
+	this->createData(scenario);
+
+	std::vector<double> frameTimes;
+	QElapsedTimer frameClock;
+	int rendered = 0;
+	QMetaObject::Connection connection = QObject::connect(viewService.get(), &cx::ViewService::renderFinished,
+		[&]()
+		{
+			++rendered;
+			if (rendered > scenario.mWarmupFrames+1)
+				frameTimes.push_back(frameClock.nsecsElapsed()/1.0E6);
+			if (rendered == scenario.mWarmupFrames+1)
+			{
+				std::vector<cx::RepPtr> reps = this->getReps();
+				for (unsigned i=0; i<reps.size(); ++i)
+					if (cx::RepImpl* rep = dynamic_cast<cx::RepImpl*>(reps[i].get()))
+						rep->resetUpdateTime();
+			}
+			frameClock.restart();
+		});
+
+	viewService->enableRender(true);
+	QElapsedTimer timeout;
+	timeout.start();
+	frameClock.start();
+	while (int(frameTimes.size()) < scenario.mFrames)
+	{
+		if (timeout.elapsed() > timeoutMs)
+		{
+			retval.mTimedOut = true;
+			break;
+		}
+		qApp->processEvents(QEventLoop::AllEvents, 5);
+	}
+	viewService->enableRender(false);
+	QObject::disconnect(connection);
+
+	retval.mFrameTimes = frameTimes;
+	std::vector<cx::RepPtr> reps = this->getReps();
+	for (unsigned i=0; i<reps.size(); ++i)
+	{
+		cx::RepImpl* rep = dynamic_cast<cx::RepImpl*>(reps[i].get());
+		if (rep && !frameTimes.empty())
+			retval.mRepUpdateTime[rep->getType()] += rep->getUpdateTime()/frameTimes.size();
+	}
+	retval.mMemoryAfter = this->getResidentMemory();
+
+	this->clear();
+	return retval;
+}
+
+void RenderBenchmark::setupLayout(const RenderBenchmarkScenario& scenario)
+{
+	cx::ViewServicePtr viewService = mServices->view();
+	viewService->addDefaultLayout(scenario.mLayout);
+	QWidget* widget = viewService->createLayoutWidget(NULL, 0);
+	viewService->setActiveLayout(scenario.mLayout.getUid(), 0);
+	if (widget && !scenario.mLayout.getOffScreenRendering())
+	{
+		widget->resize(1024, 768);
+		widget->show();
+	}
+}
+
+void RenderBenchmark::createData(const RenderBenchmarkScenario& scenario)
+{
+	cx::PatientModelServicePtr patient = mServices->patient();
+	cx::Vector3D spacing = cx::Vector3D::Ones()*scenario.mVolumeSpacing;
+	cx::Vector3D extent = (scenario.mVolumeDim.cast<double>()-1).matrix().cwiseProduct(spacing);
+	cx::DoubleBoundingBox3D bb(0, extent[0], 0, extent[1], 0, extent[2]);
+
+	for (int i=0; i<scenario.mVolumeCount; ++i)
+	{
+		cx::ImagePtr image = Utilities::create3DImage(scenario.mVolumeDim, spacing, 100+i*20);
+		patient->insertData(image);
+		this->addToViewGroups(scenario, image->getUid());
+	}
+
+	for (int i=0; i<scenario.mMeshCount; ++i)
+	{
+		vtkSphereSourcePtr source = vtkSphereSourcePtr::New();
+		source->SetCenter(bb.center().data());
+		source->SetRadius(extent.norm()/(4+i));
+		source->SetThetaResolution(scenario.mMeshResolution);
+		source->SetPhiResolution(scenario.mMeshResolution);
+		source->Update();
+		cx::MeshPtr mesh(new cx::Mesh(QString("benchmark_mesh_%1").arg(i), "", source->GetOutput()));
+		patient->insertData(mesh);
+		this->addToViewGroups(scenario, mesh->getUid());
+	}
+
+	for (int i=0; i<scenario.mMetricCount; ++i)
+	{
+		QString uid = QString("benchmark_point_%1").arg(i);
+		cx::PointMetricPtr metric = cx::PointMetric::create(uid, uid, patient, mServices->spaceProvider());
+		double t = double(i)/std::max(1, scenario.mMetricCount);
+		metric->setCoordinate(bb.corner(0,0,0) + t*(bb.corner(1,1,1)-bb.corner(0,0,0)));
+		patient->insertData(metric);
+		this->addToViewGroups(scenario, uid);
+	}
+
+	if (scenario.mVideo)
+		mTool = cx::DummyToolTestUtilities::createDummyTool(cx::DummyToolTestUtilities::createProbeDefinitionLinear());
+	else
+		mTool.reset(new cx::DummyTool("benchmark_tool"));
+	mTool->setToolPositionMovementBB(bb);
+	mTool->setVisible(true);
+	mServices->tracking()->runDummyTool(mTool);
+	mTool->stopTracking();
+	if (scenario.mToolMotion)
+		mTool->startTracking(scenario.mToolInterval);
+
+	if (scenario.mVideo)
+	{
+		mVideoSource.reset(new cx::TestVideoSource("benchmark_video", "benchmark_video",
+												   scenario.mVideoSize[0], scenario.mVideoSize[1]));
+		mVideoSource->start();
+		cx::TrackedStreamPtr stream(new cx::TrackedStream("benchmark_stream", "benchmark_stream", mTool, mVideoSource));
+		patient->insertData(stream);
+		this->addToViewGroups(scenario, stream->getUid());
+	}
+}
+
+void RenderBenchmark::addToViewGroups(const RenderBenchmarkScenario& scenario, QString uid)
+{
+	mDataUids << uid;
+	std::vector<int> groups = getGroups(scenario.mLayout);
+	for (unsigned i=0; i<groups.size(); ++i)
+		mServices->view()->getGroup(groups[i])->addData(uid);
+}
+
+void RenderBenchmark::clear()
+{
+	for (int i=0; i<mDataUids.size(); ++i)
+	{
+		for (int g=0; g<cx::LayoutData::MaxGridSize; ++g)
+			if (mServices->view()->getGroup(g))
+				mServices->view()->getGroup(g)->removeData(mDataUids[i]);
+		mServices->patient()->removeData(mDataUids[i]);
+	}
+	mDataUids.clear();
+
+	if (mVideoSource)
+		mVideoSource->stop();
+	mVideoSource.reset();
+	if (mTool)
+		mTool->stopTracking();
+	mServices->view()->deactivateLayout();
+}
+
+std::vector<cx::RepPtr> RenderBenchmark::getReps()
+{
+	std::vector<cx::RepPtr> retval;
+	cx::ViewCollectionWidget* widget = dynamic_cast<cx::ViewCollectionWidget*>(mServices->view()->getLayoutWidget(0));
+	if (!widget)
+		return retval;
+	std::vector<cx::ViewPtr> views = widget->getViews();
+	for (unsigned i=0; i<views.size(); ++i)
+	{
+		std::vector<cx::RepPtr> reps = views[i]->getReps();
+		retval.insert(retval.end(), reps.begin(), reps.end());
+	}
+	return retval;
+}
+
+} // namespace cxtest
@@ -0,0 +1,138 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXTESTRENDERBENCHMARK_H
+#define CXTESTRENDERBENCHMARK_H
+
+#include "cxtest_org_custusx_core_view_export.h"
+
+#include <map>
+#include <vector>
+#include <QString>
+#include <QStringList>
+#include "cxLayoutData.h"
+#include "cxForwardDeclarations.h"
+
+class QDomElement;
+
+namespace cx
+{
+typedef boost::shared_ptr<class VisServices> VisServicesPtr;
+typedef boost::shared_ptr<class TestVideoSource> TestVideoSourcePtr;
+typedef boost::shared_ptr<class Rep> RepPtr;
+}
+
+namespace cxtest
+{
+
+/** Description of a rendering benchmark: layout, content and motion.
+ *
+ * Scenarios are read from xml files on the form:
+ *
+ * \code
+ * <benchmark name="3D ACS with volume and tool">
+ *   <layout rows="2" cols="2" offscreen="true">
+ *     <view group="0" type="3D" row="0" col="0" rowSpan="2"/>
+ *     <view group="0" type="axial" row="0" col="1"/>
+ *     <view group="0" type="coronal" row="1" col="1"/>
+ *   </layout>
+ *   <volumes count="1" dim="256 256 256" spacing="0.5"/>
+ *   <meshes count="2" resolution="64"/>
+ *   <metrics count="10"/>
+ *   <tool motion="true" interval="16"/>
+ *   <video width="640" height="480"/>
+ *   <frames warmup="20" count="300" interval="1"/>
+ * </benchmark>
+ * \endcode
+ *
+ * View types are 3D, axial, coronal, sagittal, any, side and radial.
+ * All elements except layout are optional. The video element adds a
+ * simulated video stream tracked by the tool.
+ */
+struct CXTEST_ORG_CUSTUSX_CORE_VIEW_EXPORT RenderBenchmarkScenario
+{
+	RenderBenchmarkScenario();
+	static RenderBenchmarkScenario createDefault(); ///< 3D ACS layout with one volume, a mesh and a moving tool
+	bool load(QString filename, QString* error=NULL);
+	bool parseXml(QDomElement root, QString* error=NULL);
+
+	QString mName;
+	cx::LayoutData mLayout;
+	int mVolumeCount;
+	Eigen::Array3i mVolumeDim;
+	double mVolumeSpacing;
+	int mMeshCount;
+	int mMeshResolution;
+	int mMetricCount;
+	bool mToolMotion;
+	int mToolInterval; ///< ms between tool positions
+	bool mVideo;
+	Eigen::Array2i mVideoSize;
+	int mWarmupFrames; ///< frames rendered before measurement starts
+	int mFrames; ///< frames measured
+	int mRenderingInterval; ///< ms, given to the render loop
+};
+
+/** Measurements from one run of a RenderBenchmarkScenario.
+ */
+struct CXTEST_ORG_CUSTUSX_CORE_VIEW_EXPORT RenderBenchmarkResult
+{
+	RenderBenchmarkResult() : mMemoryBefore(0), mMemoryAfter(0), mTimedOut(false) {}
+	double getFramePercentile(double percent) const; ///< frame time (ms) below which the given percentage of the frames lie
+	double getMeanFrameTime() const;
+	QString toString() const;
+	void writeJenkinsMeasurements() const;
+
+	QString mName;
+	std::vector<double> mFrameTimes; ///< ms between consecutive renderings
+	std::map<QString, double> mRepUpdateTime; ///< rep type -> mean update time per frame (ms)
+	double mMemoryBefore; ///< resident memory (MB) before creating the scenario
+	double mMemoryAfter; ///< resident memory (MB) after running the scenario
+	bool mTimedOut;
+};
+
+/** Runs rendering benchmarks through the real view service.
+ *
+ * The scenario layout is installed in layout widget 0 of the view service,
+ * and data are created and added to the view groups. The frames
+ * rendered by the render loop are then timed, along with the update
+ * time of each rep and the resident memory.
+ *
+ * Requires an initialized LogicManager. Use the cxRenderBenchmark
+ * executable to run scenario files, add --software to select a
+ * software OpenGL implementation (Mesa).
+ *
+ * \date Oct 19, 2026
+ */
+class CXTEST_ORG_CUSTUSX_CORE_VIEW_EXPORT RenderBenchmark
+{
+public:
+	explicit RenderBenchmark(cx::VisServicesPtr services);
+	RenderBenchmarkResult run(const RenderBenchmarkScenario& scenario, int timeoutMs=120000);
+
+	static double getResidentMemory(); ///< resident memory of this process, MB. 0 if unknown.
+
+private:
+	void setupLayout(const RenderBenchmarkScenario& scenario);
+	void createData(const RenderBenchmarkScenario& scenario);
+	void addToViewGroups(const RenderBenchmarkScenario& scenario, QString uid);
+	void clear();
+	std::vector<cx::RepPtr> getReps();
+
+	cx::VisServicesPtr mServices;
+	QStringList mDataUids;
+	cx::DummyToolPtr mTool;
+	cx::TestVideoSourcePtr mVideoSource;
+};
+
+} // namespace cxtest
+
+#endif // CXTESTRENDERBENCHMARK_H
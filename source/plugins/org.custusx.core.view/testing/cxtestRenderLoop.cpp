@@ -0,0 +1,90 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QTime>
+#include "cxRenderLoop.h"
+
+namespace cxtest
+{
+
+// These tests measure frame counts against the wall clock, and thus
+// depend on the load on the test machine.
+namespace
+{
+int runRenderLoop(cx::RenderLoop* loop, int msecs)
+{
+	int frames = 0;
+	QObject::connect(loop, &cx::RenderLoop::renderFinished, [&frames]() { ++frames; });
+
+	loop->start();
+	QTime clock;
+	clock.start();
+	while (clock.elapsed() < msecs)
+		QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+	loop->stop();
+	return frames;
+}
+}
+
+TEST_CASE("RenderLoop: Next deadline is one interval after the current", "[unit][visualization]")
+{
+	int skipped = -1;
+	CHECK(cx::RenderLoop::computeNextDeadline(100, 95, 20, &skipped) == 120);
+	CHECK(skipped == 0);
+	CHECK(cx::RenderLoop::computeNextDeadline(100, 100, 20, &skipped) == 120);
+	CHECK(skipped == 0);
+}
+
+TEST_CASE("RenderLoop: Passed deadlines are skipped and counted", "[unit][visualization]")
+{
+	int skipped = -1;
+	CHECK(cx::RenderLoop::computeNextDeadline(100, 105, 20, &skipped) == 120);
+	CHECK(skipped == 0);
+	CHECK(cx::RenderLoop::computeNextDeadline(100, 165, 20, &skipped) == 180);
+	CHECK(skipped == 3);
+}
+
+TEST_CASE("RenderLoop: Deadline restarts when the interval is reduced", "[unit][visualization]")
+{
+	int skipped = -1;
+	CHECK(cx::RenderLoop::computeNextDeadline(500, 100, 20, &skipped) == 120);
+	CHECK(skipped == 0);
+}
+
+TEST_CASE("RenderLoop: Renders at the rendering interval", "[integration][visualization][unstable]")
+{
+	cx::RenderLoop loop;
+	loop.setRenderingInterval(20);
+
+	int frames = runRenderLoop(&loop, 500);
+
+	CHECK(frames > 10);
+	CHECK(frames <= 26);
+}
+
+TEST_CASE("RenderLoop: Skips frames under load instead of queueing them", "[integration][visualization][unstable]")
+{
+	cx::RenderLoop loop;
+	loop.setRenderingInterval(20);
+	QObject::connect(&loop, &cx::RenderLoop::preRender, []() { QThread::msleep(50); });
+
+	int frames = runRenderLoop(&loop, 500);
+
+	CHECK(frames >= 4);
+	CHECK(frames <= 11);
+	CHECK(loop.getSkippedFrames() > 0);
+}
+
+} // namespace cxtest
@@ -20,16 +20,128 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <vtkImageData.h>
 #include <vtkPointData.h>
 #include "cxVolumeHelpers.h"
+#include "cxBoundingBox3D.h"
+#include "cxWorkScheduler.h"
 
 
 namespace cx
 {
 
+namespace
+{
+struct CenterlineSegment
+{
+	Vector3D mA;
+	Vector3D mB;
+	double mRadius;
+
+	/** Signed distance to the surface of the segment inflated by its radius, positive inside.
+	  */
+	double getDepth(const Vector3D& p) const
+	{
+		Vector3D ab = mB - mA;
+		double length2 = dot(ab, ab);
+		double t = (length2 < 1E-12) ? 0 : std::max(0.0, std::min(1.0, dot(p - mA, ab)/length2));
+		return mRadius - (p - (mA + t*ab)).length();
+	}
+};
+
+/** Uniform grid over a bounding box. Each grid cell lists the segments
+  * whose inflated bounding box, extended by a margin, overlaps the cell.
+  */
+class CenterlineSegmentGrid
+{
+public:
+	CenterlineSegmentGrid(const std::vector<CenterlineSegment>& segments, DoubleBoundingBox3D bounds, double cellSize, double margin) :
+		mSegments(segments),
+		mBounds(bounds),
+		mCellSize(cellSize)
+	{
+		for (int i=0; i<3; ++i)
+			mDim[i] = std::max(1, static_cast<int>(std::ceil(mBounds.range()[i]/mCellSize)));
+		mCells.resize(mDim[0]*mDim[1]*mDim[2]);
+
+		for (unsigned s=0; s<mSegments.size(); ++s)
+		{
+			Vector3D extent = Vector3D::Ones()*(mSegments[s].mRadius + margin);
+			Eigen::Array3i lo = this->getCell(mSegments[s].mA.cwiseMin(mSegments[s].mB) - extent);
+			Eigen::Array3i hi = this->getCell(mSegments[s].mA.cwiseMax(mSegments[s].mB) + extent);
+			for (int z=lo[2]; z<=hi[2]; ++z)
+				for (int y=lo[1]; y<=hi[1]; ++y)
+					for (int x=lo[0]; x<=hi[0]; ++x)
+						mCells[this->getIndex(Eigen::Array3i(x,y,z))].push_back(s);
+		}
+	}
+
+	const std::vector<int>& getCandidates(const Vector3D& p) const
+	{
+		return mCells[this->getIndex(this->getCell(p))];
+	}
+	const CenterlineSegment& getSegment(int index) const { return mSegments[index]; }
+
+private:
+	Eigen::Array3i getCell(const Vector3D& p) const
+	{
+		Eigen::Array3i retval;
+		for (int i=0; i<3; ++i)
+			retval[i] = std::max(0, std::min(mDim[i]-1, static_cast<int>(std::floor((p[i]-mBounds[2*i])/mCellSize))));
+		return retval;
+	}
+	int getIndex(const Eigen::Array3i& cell) const
+	{
+		return (cell[2]*mDim[1] + cell[1])*mDim[0] + cell[0];
+	}
+
+	std::vector<CenterlineSegment> mSegments;
+	DoubleBoundingBox3D mBounds;
+	double mCellSize;
+	Eigen::Array3i mDim;
+	std::vector<std::vector<int> > mCells;
+};
+
+struct DistanceFieldInput
+{
+	const CenterlineSegmentGrid* mGrid;
+	vtkImageData* mField;
+	vtkImageData* mVolume;
+	double mBand;
+};
+
+/** Fill the distance field and the volume in the slab of z slices [zMin, zMax).
+  */
+void fillDistanceFieldSlab(const DistanceFieldInput* slab, qint64 zMin, qint64 zMax)
+{
+	int* dim = slab->mField->GetDimensions();
+	double* origin = slab->mField->GetOrigin();
+	double* spacing = slab->mField->GetSpacing();
+	float* field = static_cast<float*>(slab->mField->GetScalarPointer());
+	unsigned char* volume = static_cast<unsigned char*>(slab->mVolume->GetScalarPointer());
+
+	for (qint64 z=zMin; z<zMax; ++z)
+		for (int y=0; y<dim[1]; ++y)
+			for (int x=0; x<dim[0]; ++x)
+			{
+				Vector3D p(origin[0]+x*spacing[0], origin[1]+y*spacing[1], origin[2]+z*spacing[2]);
+				double depth = -slab->mBand;
+				const std::vector<int>& candidates = slab->mGrid->getCandidates(p);
+				for (unsigned i=0; i<candidates.size(); ++i)
+					depth = std::max(depth, slab->mGrid->getSegment(candidates[i]).getDepth(p));
+
+				vtkIdType index = (vtkIdType(z)*dim[1] + y)*dim[0] + x;
+				field[index] = depth;
+				if (depth > 0)
+					volume[index] = 1;
+			}
+}
+}
+
 AirwaysFromCenterline::AirwaysFromCenterline():
     mBranchListPtr(new BranchList),
     mAirwaysVolumeBoundaryExtention(10),
     mAirwaysVolumeBoundaryExtentionTracheaStart(2),
-    mAirwaysVolumeSpacing(0.5)
+    mAirwaysVolumeSpacing(0.5),
+    mUseDistanceField(false),
+    mDistanceFieldCellSize(4.0)
 {
 }
 
@@ -70,12 +182,29 @@ void AirwaysFromCenterline::processCenterline(vtkPolyDataPtr centerline_r)
     AirwaysFromCenterline::generateTubes makes artificial airway tubes around the input centerline. The radius
     of the tubes is decided by the generation number, based on Weibel's model of airways. n contradiction to the model,
     it is set a lower boundary for the tube radius (2 mm) making the peripheral airways larger than in reality,
-    which makes it possible to virtually navigate inside the tubes. The airways are generated by adding a sphere to
-    a volume (image) at each point along every branch. The output is a surface model generated from the volume.
+    which makes it possible to virtually navigate inside the tubes. The airways are generated either from a distance
+    field to the centerline segments, contoured directly, or by adding a sphere to a volume (image) at each point
+    along every branch. The output is a surface model generated from the volume.
 */
 vtkPolyDataPtr AirwaysFromCenterline::generateTubes()
 {
     vtkImageDataPtr airwaysVolumePtr = this->initializeAirwaysVolume();
+    mAirwaysVolume = airwaysVolumePtr;
+
+    if (mUseDistanceField)
+    {
+        vtkImageDataPtr distanceField = this->addTubesAlongCenterlines(airwaysVolumePtr);
+
+        // the field is smooth: contour at the surface without smoothing.
+        return ContourFilter::execute(
+                    distanceField,
+                    0, //treshold
+                    false, // reduce resolution
+                    false, // smoothing
+                    true, // keep topology
+                    0 // target decimation
+        );
+    }
 
     airwaysVolumePtr = addSpheresAlongCenterlines(airwaysVolumePtr);
 
@@ -205,6 +334,81 @@ vtkImageDataPtr AirwaysFromCenterline::addSphereToImage(vtkImageDataPtr airwaysV
     return airwaysVolumePtr;
 }
 
+void AirwaysFromCenterline::setUseDistanceField(bool on)
+{
+    mUseDistanceField = on;
+}
+
+void AirwaysFromCenterline::setDistanceFieldCellSize(double cellSize)
+{
+    mDistanceFieldCellSize = cellSize;
+}
+
+vtkImageDataPtr AirwaysFromCenterline::getAirwaysVolume()
+{
+    return mAirwaysVolume;
+}
+
+vtkImageDataPtr AirwaysFromCenterline::addTubesAlongCenterlines(vtkImageDataPtr airwaysVolumePtr)
+{
+    std::vector<BranchPtr> branches = mBranchListPtr->getBranches();
+    std::vector<CenterlineSegment> segments;
+
+    for (int i = 0; i < branches.size(); i++)
+    {
+        Eigen::MatrixXd positions = branches[i]->getPositions();
+        if (!positions.cols())
+            continue;
+
+        CenterlineSegment segment;
+        segment.mRadius = branches[i]->findBranchRadius();
+
+        // start in the parent end to get connected tubes, as in getVTKPoints()
+        int first = 1;
+        segment.mB = positions.col(0);
+        if (branches[i]->getParentBranch())
+        {
+            Eigen::MatrixXd parentPositions = branches[i]->getParentBranch()->getPositions();
+            segment.mB = parentPositions.col(parentPositions.cols()-1);
+            first = 0;
+        }
+        else if (positions.cols() == 1)
+        {
+            segment.mA = segment.mB; // single point: a sphere
+            segments.push_back(segment);
+        }
+
+        for (int j = first; j < positions.cols(); j++)
+        {
+            segment.mA = segment.mB;
+            segment.mB = positions.col(j);
+            segments.push_back(segment);
+        }
+    }
+
+    vtkImageDataPtr distanceField = vtkImageDataPtr::New();
+    distanceField->SetExtent(airwaysVolumePtr->GetExtent());
+    distanceField->SetSpacing(airwaysVolumePtr->GetSpacing());
+    distanceField->SetOrigin(airwaysVolumePtr->GetOrigin());
+    distanceField->AllocateScalars(VTK_FLOAT, 1);
+
+    // the band must contain the voxels next to the surface for the contour to be exact.
+    double band = 2*mAirwaysVolumeSpacing;
+    DoubleBoundingBox3D bounds(mBounds[0], mBounds[1], mBounds[2], mBounds[3], mBounds[4], mBounds[5]);
+    CenterlineSegmentGrid grid(segments, bounds, mDistanceFieldCellSize, band);
+
+    DistanceFieldInput input;
+    input.mGrid = &grid;
+    input.mField = distanceField.GetPointer();
+    input.mVolume = airwaysVolumePtr.GetPointer();
+    input.mBand = band;
+    int dimZ = airwaysVolumePtr->GetDimensions()[2];
+    WorkScheduler::getInstance()->parallelFor(dimZ, 1, boost::bind(&fillDistanceFieldSlab, &input, _1, _2));
+
+    airwaysVolumePtr->Modified();
+    return distanceField;
+}
+
 vtkPolyDataPtr AirwaysFromCenterline::getVTKPoints()
 {
     vtkPolyDataPtr retval = vtkPolyDataPtr::New();
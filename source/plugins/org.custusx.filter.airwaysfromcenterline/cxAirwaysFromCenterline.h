@@ -25,6 +25,19 @@ typedef boost::shared_ptr<class BranchList> BranchListPtr;
 typedef boost::shared_ptr<class Branch> BranchPtr;
 
 
+/** Generate an airway surface model from a centerline.
+ *
+ * Two synthesis modes are available:
+ *  - spheres (default): One sphere per centerline position is rasterized into
+ *    a binary volume, which then is contoured and smoothed.
+ *  - distance field: A signed distance field to the centerline segments, each
+ *    inflated by its branch radius, is computed in one parallel pass using a
+ *    grid index over the segments. The tubes are contoured directly from the
+ *    field. This also fills the gaps between spheres, thus the output differs
+ *    slightly from the sphere mode.
+ *
+ * Both modes produce the binary airways volume, see getAirwaysVolume().
+ */
 class org_custusx_filter_airwaysfromcenterline_EXPORT AirwaysFromCenterline
 {
 public:
@@ -36,6 +49,14 @@ public:
     vtkImageDataPtr initializeAirwaysVolume();
     vtkImageDataPtr addSpheresAlongCenterlines(vtkImageDataPtr airwaysVolumePtr);
     vtkImageDataPtr addSphereToImage(vtkImageDataPtr airwaysVolumePtr, double position[3], double radius);
+    /** Fill airwaysVolumePtr with tubes around the centerline segments, and return the
+      * signed distance (mm) to the tube surface, positive inside. Outside a narrow band
+      * around the surface, the distance is clamped.
+      */
+    vtkImageDataPtr addTubesAlongCenterlines(vtkImageDataPtr airwaysVolumePtr);
+    void setUseDistanceField(bool on); ///< select synthesis mode, default off
+    void setDistanceFieldCellSize(double cellSize); ///< size (mm) of the grid cells used to find segments near a voxel
+    vtkImageDataPtr getAirwaysVolume(); ///< binary volume from the last call to generateTubes()
     vtkPolyDataPtr addVTKPoints(std::vector< Eigen::Vector3d > positions);
     vtkPolyDataPtr getVTKPoints();
 
@@ -49,6 +70,9 @@ private:
     double mAirwaysVolumeBoundaryExtention;
     double mAirwaysVolumeBoundaryExtentionTracheaStart;
     double mAirwaysVolumeSpacing;
+    bool mUseDistanceField;
+    double mDistanceFieldCellSize;
+    vtkImageDataPtr mAirwaysVolume;
 
 };
 
@@ -71,9 +71,26 @@ QString AirwaysFromCenterlineFilter::getNameSuffixCenterline()
     return "_SmoothedCenterline";
 }
 
-void AirwaysFromCenterlineFilter::createOptions()
+BoolPropertyPtr AirwaysFromCenterlineFilter::getUseDistanceFieldOption(QDomElement root)
 {
+	return BoolProperty::initialize("Use distance field", "",
+									"Generate the tubes from a distance field to the centerline, computed in parallel,\n"
+									"instead of from spheres along the centerline. The tubes also fill the gaps\n"
+									"between the spheres, thus the surface differs slightly.", false, root);
+}
 
+DoublePropertyPtr AirwaysFromCenterlineFilter::getDistanceFieldCellSizeOption(QDomElement root)
+{
+	return DoubleProperty::initialize("Distance field cell size", "",
+									  "Size (mm) of the grid cells used to find centerline segments near each voxel.\n"
+									  "Smaller cells test fewer segments per voxel, but use more memory.",
+									  4.0, DoubleRange(0.5, 50, 0.5), 1, root);
+}
+
+void AirwaysFromCenterlineFilter::createOptions()
+{
+	mOptionsAdapters.push_back(this->getUseDistanceFieldOption(mOptions));
+	mOptionsAdapters.push_back(this->getDistanceFieldCellSizeOption(mOptions));
 }
 
 void AirwaysFromCenterlineFilter::createInputTypes()
@@ -110,8 +127,10 @@ bool AirwaysFromCenterlineFilter::execute()
     if (!mesh)
         return false;
 
-	vtkPolyDataPtr centerline_r = mesh->getTransformedPolyDataCopy(mesh->get_rMd());
+	vtkPolyDataPtr centerline_r = mesh->getTransformedPolyData(mesh->get_rMd());
 
+    mAirwaysFromCenterline->setUseDistanceField(this->getUseDistanceFieldOption(mCopiedOptions)->getValue());
+    mAirwaysFromCenterline->setDistanceFieldCellSize(this->getDistanceFieldCellSizeOption(mCopiedOptions)->getValue());
     mAirwaysFromCenterline->processCenterline(centerline_r);
 
     //note: mOutputAirwayMesh is in reference space
@@ -46,6 +46,9 @@ public:
     static QString getNameSuffix();
     static QString getNameSuffixCenterline();
 
+	BoolPropertyPtr getUseDistanceFieldOption(QDomElement root);
+	DoublePropertyPtr getDistanceFieldCellSizeOption(QDomElement root);
+
 
 	virtual bool execute();
 	virtual bool postProcess();
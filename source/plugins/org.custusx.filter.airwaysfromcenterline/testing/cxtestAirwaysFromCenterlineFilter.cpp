@@ -56,4 +56,48 @@ TEST_CASE("AirwaysFromCenterline: execute", "[integration][org.custusx.filter.ai
     REQUIRE(outputCenterline->getVtkPolyData());
 }
 
+namespace
+{
+int countNonZeroVoxels(vtkImageDataPtr volume)
+{
+    unsigned char* data = static_cast<unsigned char*>(volume->GetScalarPointer());
+    vtkIdType size = volume->GetNumberOfPoints();
+    int retval = 0;
+    for (vtkIdType i=0; i<size; ++i)
+        if (data[i])
+            ++retval;
+    return retval;
+}
+}
+
+TEST_CASE("AirwaysFromCenterline: distance field and spheres give similar airways", "[integration][org.custusx.filter.airwaysfromcenterline]")
+{
+	cxtest::SessionStorageTestFixture storageFixture;
+	storageFixture.loadSession1();
+
+    QString filenameCenterline = cx::DataLocations::getTestDataPath()+"/testing/Lung/Thorax__1_0_I30f_tsf_cl1.vtk";
+	QString info;
+	cx::MeshPtr mesh = boost::dynamic_pointer_cast<cx::Mesh>(storageFixture.mServices->patient()->importData(filenameCenterline, info));
+    REQUIRE(mesh);
+
+    AirwaysFromCenterlinePtr airwaysFromCenterline = AirwaysFromCenterlinePtr(new cx::AirwaysFromCenterline());
+    airwaysFromCenterline->processCenterline(mesh->getTransformedPolyDataCopy(mesh->get_rMd()));
+
+    airwaysFromCenterline->setUseDistanceField(false);
+    vtkPolyDataPtr sphereMesh = airwaysFromCenterline->generateTubes();
+    int sphereVoxels = countNonZeroVoxels(airwaysFromCenterline->getAirwaysVolume());
+
+    airwaysFromCenterline->setUseDistanceField(true);
+    vtkPolyDataPtr tubeMesh = airwaysFromCenterline->generateTubes();
+    int tubeVoxels = countNonZeroVoxels(airwaysFromCenterline->getAirwaysVolume());
+
+    REQUIRE(sphereMesh);
+    REQUIRE(tubeMesh);
+    CHECK(tubeMesh->GetNumberOfPoints() > 0);
+    REQUIRE(sphereVoxels > 0);
+    // the tubes also fill the gaps between spheres and connect each branch to its parent.
+    CHECK(tubeVoxels >= 0.9*sphereVoxels);
+    CHECK(tubeVoxels <= 1.2*sphereVoxels);
+}
+
 }; // end cxtest namespace
@@ -0,0 +1,283 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+#include "cxCenterlineDistanceMapMetric.h"
+
+#include <vector>
+#include <itkSignedMaurerDistanceMapImageFilter.h>
+#include "cxWorkScheduler.h"
+
+namespace cx
+{
+
+CenterlineDistanceMapMetric::CenterlineDistanceMapMetric() :
+	mMapSpacing(1.0),
+	mMaximumNumberOfVoxels(16E6),
+	mMapMargin(20.0),
+	mMapSource(NULL),
+	mMapSourceMTime(0),
+	mBuffer(NULL)
+{
+	for (int k=0; k<3; ++k)
+	{
+		mSize[k] = 0;
+		mOrigin[k] = 0;
+		mSpacing[k] = 1;
+	}
+}
+
+void CenterlineDistanceMapMetric::Initialize(void) throw (itk::ExceptionObject)
+{
+	Superclass::Initialize();
+	this->updateDistanceMap();
+}
+
+unsigned int CenterlineDistanceMapMetric::GetNumberOfValues() const
+{
+	MovingPointSetConstPointer movingPointSet = this->GetMovingPointSet();
+	if (!movingPointSet)
+		itkExceptionMacro(<< "Moving point set has not been assigned");
+	return movingPointSet->GetPoints()->Size();
+}
+
+void CenterlineDistanceMapMetric::updateDistanceMap()
+{
+	const FixedPointSetType* fixed = this->GetFixedPointSet();
+	if (mDistanceMap && fixed==mMapSource && fixed->GetMTime()==mMapSourceMTime)
+		return;
+
+	const FixedPointSetType::PointsContainer* points = fixed->GetPoints();
+	if (!points || !points->Size())
+		itkExceptionMacro(<< "Fixed point set is empty");
+
+	double lo[3] = { 1E30, 1E30, 1E30 };
+	double hi[3] = { -1E30, -1E30, -1E30 };
+	for (FixedPointSetType::PointsContainer::ConstIterator iter=points->Begin(); iter!=points->End(); ++iter)
+	{
+		for (int k=0; k<3; ++k)
+		{
+			lo[k] = std::min<double>(lo[k], iter.Value()[k]);
+			hi[k] = std::max<double>(hi[k], iter.Value()[k]);
+		}
+	}
+
+	double volume = 1;
+	for (int k=0; k<3; ++k)
+	{
+		lo[k] -= mMapMargin;
+		hi[k] += mMapMargin;
+		volume *= hi[k]-lo[k];
+	}
+	double spacing = std::max(mMapSpacing, pow(volume/mMaximumNumberOfVoxels, 1.0/3.0));
+
+	// rasterize the fixed points into a binary image
+	typedef itk::Image<unsigned char, 3> BinaryImageType;
+	BinaryImageType::Pointer binary = BinaryImageType::New();
+	BinaryImageType::SizeType size;
+	BinaryImageType::SpacingType imageSpacing;
+	BinaryImageType::PointType origin;
+	for (int k=0; k<3; ++k)
+	{
+		size[k] = std::max<int>(2, ceil((hi[k]-lo[k])/spacing)+1);
+		imageSpacing[k] = spacing;
+		origin[k] = lo[k];
+	}
+	BinaryImageType::RegionType region;
+	region.SetSize(size);
+	binary->SetRegions(region);
+	binary->SetSpacing(imageSpacing);
+	binary->SetOrigin(origin);
+	binary->Allocate();
+	binary->FillBuffer(0);
+
+	for (FixedPointSetType::PointsContainer::ConstIterator iter=points->Begin(); iter!=points->End(); ++iter)
+	{
+		BinaryImageType::IndexType index;
+		for (int k=0; k<3; ++k)
+			index[k] = itk::Math::Round<itk::IndexValueType>((iter.Value()[k]-lo[k])/spacing);
+		binary->SetPixel(index, 1);
+	}
+
+	typedef itk::SignedMaurerDistanceMapImageFilter<BinaryImageType, DistanceMapType> DistanceFilterType;
+	DistanceFilterType::Pointer filter = DistanceFilterType::New();
+	filter->SetInput(binary);
+	filter->SetBackgroundValue(0);
+	filter->SquaredDistanceOff();
+	filter->UseImageSpacingOn();
+	filter->InsideIsPositiveOff();
+	filter->Update();
+
+	// the fixed points are the object: use unsigned distance
+	mDistanceMap = filter->GetOutput();
+	mDistanceMap->DisconnectPipeline();
+	float* buffer = mDistanceMap->GetBufferPointer();
+	size_t numberOfVoxels = mDistanceMap->GetBufferedRegion().GetNumberOfPixels();
+	for (size_t i=0; i<numberOfVoxels; ++i)
+		buffer[i] = std::max(0.0f, buffer[i]);
+
+	mBuffer = buffer;
+	for (int k=0; k<3; ++k)
+	{
+		mSize[k] = size[k];
+		mOrigin[k] = lo[k];
+		mSpacing[k] = spacing;
+	}
+	mMapSource = fixed;
+	mMapSourceMTime = fixed->GetMTime();
+}
+
+double CenterlineDistanceMapMetric::evaluateDistance(const double p[3], double gradient[3]) const
+{
+	// continuous index, clamped to the map
+	double x[3];
+	double outside[3];
+	bool clamped[3];
+	int i0[3];
+	double f[3];
+	double outsideDistance2 = 0;
+	for (int k=0; k<3; ++k)
+	{
+		double xk = (p[k]-mOrigin[k])/mSpacing[k];
+		x[k] = std::max(0.0, std::min<double>(mSize[k]-1, xk));
+		clamped[k] = (x[k]!=xk);
+		outside[k] = (xk-x[k])*mSpacing[k];
+		outsideDistance2 += outside[k]*outside[k];
+		i0[k] = std::min<int>(floor(x[k]), mSize[k]-2);
+		f[k] = x[k]-i0[k];
+	}
+
+	// trilinear interpolation of value and gradient
+	const float* base = mBuffer + (size_t(i0[2])*mSize[1] + i0[1])*mSize[0] + i0[0];
+	size_t dy = mSize[0];
+	size_t dz = size_t(mSize[0])*mSize[1];
+	double c000 = base[0],       c100 = base[1];
+	double c010 = base[dy],      c110 = base[dy+1];
+	double c001 = base[dz],      c101 = base[dz+1];
+	double c011 = base[dz+dy],   c111 = base[dz+dy+1];
+
+	double c00 = c000 + f[0]*(c100-c000);
+	double c10 = c010 + f[0]*(c110-c010);
+	double c01 = c001 + f[0]*(c101-c001);
+	double c11 = c011 + f[0]*(c111-c011);
+	double c0 = c00 + f[1]*(c10-c00);
+	double c1 = c01 + f[1]*(c11-c01);
+	double value = c0 + f[2]*(c1-c0);
+
+	double dx0 = (1-f[1])*(c100-c000) + f[1]*(c110-c010);
+	double dx1 = (1-f[1])*(c101-c001) + f[1]*(c111-c011);
+	gradient[0] = ((1-f[2])*dx0 + f[2]*dx1) / mSpacing[0];
+	gradient[1] = ((1-f[2])*(c10-c00) + f[2]*(c11-c01)) / mSpacing[1];
+	gradient[2] = (c1-c0) / mSpacing[2];
+
+	for (int k=0; k<3; ++k)
+		if (clamped[k])
+			gradient[k] = 0;
+
+	if (outsideDistance2 > 0)
+	{
+		double outsideDistance = sqrt(outsideDistance2);
+		value += outsideDistance;
+		for (int k=0; k<3; ++k)
+			gradient[k] += outside[k]/outsideDistance;
+	}
+
+	return value;
+}
+
+namespace
+{
+/** Evaluation of the moving points, in ranges run in parallel.
+ */
+struct PointEvaluation
+{
+	const CenterlineDistanceMapMetric* mMetric;
+	const CenterlineDistanceMapMetric::TransformType* mTransform;
+	const std::vector<CenterlineDistanceMapMetric::TransformType::InputPointType>* mPoints;
+	CenterlineDistanceMapMetric::MeasureType* mValue;
+	CenterlineDistanceMapMetric::DerivativeType* mDerivative;
+};
+
+void evaluateRange(const PointEvaluation* evaluation, qint64 begin, qint64 end)
+{
+	typedef CenterlineDistanceMapMetric::TransformType TransformType;
+	TransformType::JacobianType jacobian;
+	unsigned numberOfParameters = evaluation->mTransform->GetNumberOfParameters();
+
+	for (qint64 i=begin; i<end; ++i)
+	{
+		const TransformType::InputPointType& point = (*evaluation->mPoints)[i];
+		TransformType::OutputPointType transformed = evaluation->mTransform->TransformPoint(point);
+		double gradient[3];
+		double distance = evaluation->mMetric->evaluateDistance(transformed.GetDataPointer(), gradient);
+
+		if (evaluation->mValue)
+			(*evaluation->mValue)[i] = distance;
+
+		if (evaluation->mDerivative)
+		{
+			evaluation->mTransform->ComputeJacobianWithRespectToParameters(point, jacobian);
+			for (unsigned p=0; p<numberOfParameters; ++p)
+				(*evaluation->mDerivative)(p, i) = gradient[0]*jacobian(0,p) + gradient[1]*jacobian(1,p) + gradient[2]*jacobian(2,p);
+		}
+	}
+}
+} // namespace
+
+void CenterlineDistanceMapMetric::evaluate(const TransformParametersType& parameters, MeasureType* value, DerivativeType* derivative) const
+{
+	if (!mBuffer)
+		itkExceptionMacro(<< "Distance map not initialized");
+
+	m_Transform->SetParameters(parameters);
+
+	const MovingPointSetType::PointsContainer* movingPoints = this->GetMovingPointSet()->GetPoints();
+	std::vector<TransformType::InputPointType> points;
+	points.reserve(movingPoints->Size());
+	for (MovingPointSetType::PointsContainer::ConstIterator iter=movingPoints->Begin(); iter!=movingPoints->End(); ++iter)
+	{
+		TransformType::InputPointType point;
+		for (int k=0; k<3; ++k)
+			point[k] = iter.Value()[k];
+		points.push_back(point);
+	}
+
+	unsigned N = points.size();
+	if (value)
+		value->SetSize(N);
+	if (derivative)
+		derivative->SetSize(m_Transform->GetNumberOfParameters(), N);
+
+	PointEvaluation evaluation;
+	evaluation.mMetric = this;
+	evaluation.mTransform = m_Transform.GetPointer();
+	evaluation.mPoints = &points;
+	evaluation.mValue = value;
+	evaluation.mDerivative = derivative;
+	WorkScheduler::getInstance()->parallelFor(N, 1000, boost::bind(&evaluateRange, &evaluation, _1, _2));
+}
+
+CenterlineDistanceMapMetric::MeasureType CenterlineDistanceMapMetric::GetValue(const TransformParametersType& parameters) const
+{
+	MeasureType value;
+	this->evaluate(parameters, &value, NULL);
+	return value;
+}
+
+void CenterlineDistanceMapMetric::GetDerivative(const TransformParametersType& parameters, DerivativeType& derivative) const
+{
+	this->evaluate(parameters, NULL, &derivative);
+}
+
+void CenterlineDistanceMapMetric::GetValueAndDerivative(const TransformParametersType& parameters, MeasureType& value, DerivativeType& derivative) const
+{
+	this->evaluate(parameters, &value, &derivative);
+}
+
+} // namespace cx
@@ -0,0 +1,103 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+#ifndef CXCENTERLINEDISTANCEMAPMETRIC_H_
+#define CXCENTERLINEDISTANCEMAPMETRIC_H_
+
+#include "org_custusx_registration_method_centerline_Export.h"
+
+#include <itkPointSet.h>
+#include <itkImage.h>
+#include <itkPointSetToPointSetMetric.h>
+
+namespace cx
+{
+
+/**
+ * \brief Point set metric using a precomputed distance map of the fixed points.
+ *
+ * Drop-in replacement for itk::EuclideanDistancePointMetric: The value for
+ * each moving point is the distance from the transformed point to the closest
+ * fixed point. The distances are read by trilinear interpolation from
+ * a distance map computed once per fixed point set, and the derivative is
+ * computed analytically from the interpolated distance gradient and the
+ * transform jacobian. Both are evaluated in parallel over the moving points.
+ *
+ * The fixed points are rasterized to the map, thus distances are exact
+ * to within half a voxel diagonal. The map spacing is chosen from
+ * setMapSpacing() and setMaximumNumberOfVoxels().
+ *
+ * \date Oct 19, 2026
+ */
+class org_custusx_registration_method_centerline_EXPORT CenterlineDistanceMapMetric :
+		public itk::PointSetToPointSetMetric<itk::PointSet<float, 3>, itk::PointSet<float, 3> >
+{
+public:
+	typedef CenterlineDistanceMapMetric Self;
+	typedef itk::PointSetToPointSetMetric<itk::PointSet<float, 3>, itk::PointSet<float, 3> > Superclass;
+	typedef itk::SmartPointer<Self> Pointer;
+	typedef itk::SmartPointer<const Self> ConstPointer;
+	typedef itk::Image<float, 3> DistanceMapType;
+
+	itkNewMacro(Self);
+	itkTypeMacro(CenterlineDistanceMapMetric, PointSetToPointSetMetric);
+
+	typedef Superclass::FixedPointSetType FixedPointSetType;
+	typedef Superclass::MovingPointSetType MovingPointSetType;
+	typedef Superclass::TransformType TransformType;
+	typedef Superclass::MeasureType MeasureType;
+	typedef Superclass::DerivativeType DerivativeType;
+	typedef Superclass::TransformParametersType TransformParametersType;
+
+	virtual void Initialize(void) throw (itk::ExceptionObject);
+	virtual unsigned int GetNumberOfValues() const;
+	virtual MeasureType GetValue(const TransformParametersType& parameters) const;
+	virtual void GetDerivative(const TransformParametersType& parameters, DerivativeType& derivative) const;
+	void GetValueAndDerivative(const TransformParametersType& parameters, MeasureType& value, DerivativeType& derivative) const;
+
+	void setMapSpacing(double spacing) { mMapSpacing = spacing; }
+	void setMaximumNumberOfVoxels(double voxels) { mMaximumNumberOfVoxels = voxels; }
+	void setMapMargin(double margin) { mMapMargin = margin; }
+	DistanceMapType::Pointer getDistanceMap() const { return mDistanceMap; }
+
+	/** Distance and its gradient at a point, from the distance map.
+	 *  Points outside the map get the distance to the map boundary added.
+	 */
+	double evaluateDistance(const double p[3], double gradient[3]) const;
+
+protected:
+	CenterlineDistanceMapMetric();
+	virtual ~CenterlineDistanceMapMetric() {}
+
+private:
+	CenterlineDistanceMapMetric(const Self&); // purposely not implemented
+	void operator=(const Self&); // purposely not implemented
+
+	void updateDistanceMap();
+	void evaluate(const TransformParametersType& parameters, MeasureType* value, DerivativeType* derivative) const;
+
+	double mMapSpacing;
+	double mMaximumNumberOfVoxels;
+	double mMapMargin;
+
+	DistanceMapType::Pointer mDistanceMap;
+	const FixedPointSetType* mMapSource; ///< fixed point set the map was computed from
+	unsigned long mMapSourceMTime;
+
+	// cached map geometry for fast interpolation
+	const float* mBuffer;
+	int mSize[3];
+	double mOrigin[3];
+	double mSpacing[3];
+};
+
+} // namespace cx
+
+#endif /* CXCENTERLINEDISTANCEMAPMETRIC_H_ */
@@ -28,7 +28,9 @@ namespace cx
 {
 
 
-CenterlineRegistration::CenterlineRegistration()
+CenterlineRegistration::CenterlineRegistration() :
+    mProcessedCenterlineMTime(0),
+    mProcessedCenterline_rMd(Transform3D::Identity())
 {
     mFixedPointSet = PointSetType::New();
     mMovingPointSet = PointSetType::New();
@@ -36,10 +38,10 @@ CenterlineRegistration::CenterlineRegistration()
     mTransform = TransformType::New();
     MetricType::Pointer         metric = MetricType::New();
     mOptimizer = OptimizerType::New();
-    mOptimizer->SetUseCostFunctionGradient(false);
+    mOptimizer->SetUseCostFunctionGradient(true); // analytic, from the metric distance map
     OptimizerType::ScalesType   scales(mTransform->GetNumberOfParameters());
 
-    unsigned long   numberOfIterations = 2000;
+    unsigned long   numberOfIterations = 200;
     double          gradientTolerance = 1e-4;
     double          valueTolerance = 1e-4;
     double          epsilonFunction = 1e-5;
@@ -308,9 +310,18 @@ Transform3D CenterlineRegistration::FullRegisterMoving(Transform3D init_transfor
 Transform3D CenterlineRegistration::runCenterlineRegistration(vtkPolyDataPtr centerline, Transform3D rMd, TimedTransformMap trackingData_prMt, Transform3D old_rMpr)
 {
 
-    vtkPointsPtr centerlinePoints = processCenterline(centerline, rMd);
+    bool centerlineChanged = (centerline!=mProcessedCenterline)
+            || (centerline->GetMTime()!=mProcessedCenterlineMTime)
+            || !similar(rMd, mProcessedCenterline_rMd);
+    if (centerlineChanged)
+    {
+        vtkPointsPtr centerlinePoints = processCenterline(centerline, rMd);
+        SetFixedPoints( centerlinePoints );
+        mProcessedCenterline = centerline;
+        mProcessedCenterlineMTime = centerline->GetMTime();
+        mProcessedCenterline_rMd = rMd;
+    }
 
-    SetFixedPoints( centerlinePoints );
     SetMovingPoints( ConvertTrackingDataToVTK(trackingData_prMt, old_rMpr) );
 
     Transform3D rMpr = FullRegisterMoving(Transform3D::Identity());
@@ -24,10 +24,10 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <vtkLandmarkTransform.h>
 
 #include <itkEuler3DTransform.h>
-#include <itkEuclideanDistancePointMetric.h>
 #include <itkLevenbergMarquardtOptimizer.h>
 #include <itkPointSetToPointSetRegistrationMethod.h>
 #include <itkPointSet.h>
+#include "cxCenterlineDistanceMapMetric.h"
 
 
 typedef std::vector< Eigen::Matrix4d > M4Vector;
@@ -51,10 +51,7 @@ public:
     typedef PointSetType::PointsContainerPointer        PointsContainerPtr;
     typedef PointsContainer::Iterator                   PointsIterator;
 
-    typedef itk::EuclideanDistancePointMetric<
-                                      PointSetType,
-                                      PointSetType>
-                                                        MetricType;
+    typedef CenterlineDistanceMapMetric                 MetricType;
     typedef itk::Euler3DTransform< double >             TransformType;
     typedef itk::LevenbergMarquardtOptimizer            OptimizerType;
 
@@ -70,6 +67,9 @@ public:
     Transform3D FullRegisterMoving(Transform3D init_transform);
     vtkPointsPtr processCenterline(vtkPolyDataPtr centerline, Transform3D rMd);
     vtkPointsPtr ConvertTrackingDataToVTK(TimedTransformMap trackingData_prMt, Transform3D rMpr);
+    /** Register the tracking data to the centerline.
+     *  The processed centerline and its distance map are reused while centerline and rMd are unchanged.
+     */
     Transform3D runCenterlineRegistration(vtkPolyDataPtr centerline, Transform3D rMd, TimedTransformMap trackingData_prMt, Transform3D old_rMpr );
     virtual ~CenterlineRegistration();
 
@@ -83,6 +83,10 @@ private:
     bool mRegistrationUpdated;
     OptimizerType::Pointer mOptimizer;
 
+    vtkPolyDataPtr mProcessedCenterline; ///< centerline currently used as fixed points
+    unsigned long mProcessedCenterlineMTime;
+    Transform3D mProcessedCenterline_rMd;
+
 };
 
 Eigen::Matrix4d registrationAlgorithm(M4Vector Tnavigation);
@@ -17,12 +17,116 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxCenterlineRegistration.h"
 #include "cxtestSessionStorageTestFixture.h"
 #include "cxVisServices.h"
+#include "cxCenterlineDistanceMapMetric.h"
+#include <itkEuler3DTransform.h>
 
 typedef boost::shared_ptr<cx::CenterlineRegistration> CenterlineRegistrationPtr;
 
 
 namespace cxtest {
 
+namespace
+{
+/** A non-planar curve around the origin, sampled with the given spacing.
+ */
+vtkPointsPtr createCurve(double spacing)
+{
+    vtkPointsPtr retval = vtkPointsPtr::New();
+    double t = 0;
+    while (t <= 4*M_PI)
+    {
+        double radius = 20 + 5*t;
+        retval->InsertNextPoint(radius*cos(t), radius*sin(t), 8*t - 50);
+        t += spacing / sqrt(radius*radius + 5*5 + 8*8); // constant arc length step
+    }
+    return retval;
+}
+
+vtkPointsPtr transformPoints(vtkPointsPtr input, cx::Transform3D M, int stride)
+{
+    vtkPointsPtr retval = vtkPointsPtr::New();
+    for (int i=0; i<input->GetNumberOfPoints(); i+=stride)
+    {
+        cx::Vector3D p = M.coord(cx::Vector3D(input->GetPoint(i)));
+        retval->InsertNextPoint(p.data());
+    }
+    return retval;
+}
+
+cx::CenterlineRegistration::PointSetType::Pointer createPointSet(vtkPointsPtr points)
+{
+    cx::CenterlineRegistration::PointSetType::Pointer retval = cx::CenterlineRegistration::PointSetType::New();
+    cx::CenterlineRegistration::PointsContainerPtr container = cx::CenterlineRegistration::PointsContainer::New();
+    for (int i=0; i<points->GetNumberOfPoints(); ++i)
+    {
+        cx::CenterlineRegistration::PointType point;
+        for (int k=0; k<3; ++k)
+            point[k] = points->GetPoint(i)[k];
+        container->InsertElement(i, point);
+    }
+    retval->SetPoints(container);
+    return retval;
+}
+} // namespace
+
+TEST_CASE("CenterlineDistanceMapMetric: analytic derivative matches finite differences", "[unit][org.custusx.registration.method.centerline]")
+{
+    vtkPointsPtr curve = createCurve(0.5);
+    cx::Transform3D offset = cx::createTransformTranslate(cx::Vector3D(2.3, -1.7, 0.9));
+
+    cx::CenterlineDistanceMapMetric::Pointer metric = cx::CenterlineDistanceMapMetric::New();
+    itk::Euler3DTransform<double>::Pointer transform = itk::Euler3DTransform<double>::New();
+    metric->SetFixedPointSet(createPointSet(curve));
+    metric->SetMovingPointSet(createPointSet(transformPoints(curve, offset, 7)));
+    metric->SetTransform(transform);
+    metric->Initialize();
+
+    cx::CenterlineDistanceMapMetric::TransformParametersType parameters(6);
+    parameters[0] = 0.01; parameters[1] = -0.02; parameters[2] = 0.015;
+    parameters[3] = 0.4; parameters[4] = 0.3; parameters[5] = -0.2;
+
+    cx::CenterlineDistanceMapMetric::MeasureType value;
+    cx::CenterlineDistanceMapMetric::DerivativeType derivative;
+    metric->GetValueAndDerivative(parameters, value, derivative);
+    REQUIRE(value.size() == metric->GetNumberOfValues());
+    REQUIRE(derivative.rows() == 6);
+    REQUIRE(derivative.cols() == value.size());
+
+    // compare the gradient of the summed distances
+    for (unsigned p=0; p<6; ++p)
+    {
+        double eps = 1E-6;
+        cx::CenterlineDistanceMapMetric::TransformParametersType lo = parameters;
+        cx::CenterlineDistanceMapMetric::TransformParametersType hi = parameters;
+        lo[p] -= eps;
+        hi[p] += eps;
+        double numeric = (metric->GetValue(hi).sum() - metric->GetValue(lo).sum()) / (2*eps);
+        double analytic = 0;
+        for (unsigned i=0; i<derivative.cols(); ++i)
+            analytic += derivative(p, i);
+        INFO("parameter " << p);
+        CHECK(analytic == Approx(numeric).epsilon(0.01).margin(0.1));
+    }
+}
+
+TEST_CASE("CenterlineRegistration: recovers a rigid perturbation of the tracking positions", "[unit][org.custusx.registration.method.centerline]")
+{
+    vtkPointsPtr curve = createCurve(0.5);
+    cx::Transform3D perturbation = cx::createTransformRotateZ(2.0/180.0*M_PI)
+            * cx::createTransformRotateX(1.5/180.0*M_PI)
+            * cx::createTransformTranslate(cx::Vector3D(3, -2, 1));
+
+    cx::CenterlineRegistration registration;
+    registration.SetFixedPoints(curve);
+    registration.SetMovingPoints(transformPoints(curve, perturbation, 5));
+    cx::Transform3D result = registration.FullRegisterMoving(cx::Transform3D::Identity());
+
+    cx::Transform3D diff = result * perturbation;
+    // the distance map is exact to within about half a voxel
+    CHECK(diff.coord(cx::Vector3D(0,0,0)).norm() < 1.0);
+    CHECK(Eigen::AngleAxisd(diff.matrix().block<3, 3>(0, 0)).angle() < 1.0/180.0*M_PI);
+}
+
 
 // This test just use two random centerlines and register them to each other.
 // The test only verifies that the code is running without crashing, and that all objects are created.
@@ -130,6 +130,7 @@ QWidget* ElastixWidget::createOptionsWidget()
 
 	buttonsLayout->addWidget(new CheckBoxWidget(this, mElastixManager->getDisplayProcessMessages()));
 	buttonsLayout->addWidget(new CheckBoxWidget(this, mElastixManager->getDisableRendering()));
+	buttonsLayout->addWidget(new CheckBoxWidget(this, mElastixManager->getRunInProcess()));
 
 	this->createAction(this,
 	                QIcon(":/icons/preset_remove.png"),
@@ -0,0 +1,414 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxElastixInProcessRegistration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <QTime>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <boost/bind.hpp>
+
+#include <itkMultiResolutionImageRegistrationMethod.h>
+#include <itkRegularStepGradientDescentOptimizer.h>
+#include <itkLinearInterpolateImageFunction.h>
+#include <itkMeanSquaresImageToImageMetric.h>
+#include <itkNormalizedCorrelationImageToImageMetric.h>
+#include <itkMattesMutualInformationImageToImageMetric.h>
+#include <itkEuler3DTransform.h>
+#include <itkAffineTransform.h>
+#include <itkShrinkImageFilter.h>
+
+#include "cxElastixExecuter.h"
+#include "cxAlgorithmHelpers.h"
+#include "cxWorkScheduler.h"
+#include "cxImage.h"
+#include "cxBoundingBox3D.h"
+#include "cxTypeConversions.h"
+#include "cxLogger.h"
+
+namespace cx
+{
+
+ElastixInProcessSettings::ElastixInProcessSettings() :
+	mName("default"),
+	mTransform("EulerTransform"),
+	mMetric("AdvancedMeanSquares"),
+	mNumberOfResolutions(3),
+	mMaximumNumberOfIterations(200),
+	mMaximumStepLength(1.0),
+	mNumberOfHistogramBins(32),
+	mNumberOfSpatialSamples(4096)
+{
+}
+
+namespace
+{
+double readFirstValue(ElastixParameterFile& file, QString key, double defaultValue)
+{
+	std::vector<double> values = file.readParameterDoubleVector(key);
+	return values.empty() ? defaultValue : values[0];
+}
+}
+
+ElastixInProcessSettings ElastixInProcessSettings::fromParameterFile(QString filename)
+{
+	ElastixInProcessSettings retval;
+	ElastixParameterFile file(filename);
+	retval.mName = QFileInfo(filename).completeBaseName();
+
+	QString transform = file.readParameterString("Transform");
+	if (!transform.isEmpty())
+		retval.mTransform = transform;
+	QString metric = file.readParameterString("Metric");
+	if (!metric.isEmpty())
+		retval.mMetric = metric;
+
+	retval.mNumberOfResolutions = readFirstValue(file, "NumberOfResolutions", retval.mNumberOfResolutions);
+	retval.mMaximumNumberOfIterations = readFirstValue(file, "MaximumNumberOfIterations", retval.mMaximumNumberOfIterations);
+	retval.mMaximumStepLength = readFirstValue(file, "MaximumStepLength", retval.mMaximumStepLength);
+	retval.mNumberOfHistogramBins = readFirstValue(file, "NumberOfHistogramBins", retval.mNumberOfHistogramBins);
+	retval.mNumberOfSpatialSamples = readFirstValue(file, "NumberOfSpatialSamples", retval.mNumberOfSpatialSamples);
+	return retval;
+}
+
+bool ElastixInProcessSettings::isSupported() const
+{
+	return (mTransform=="EulerTransform") || (mTransform=="AffineTransform");
+}
+
+ElastixInProcessResult::ElastixInProcessResult() :
+	mSuccess(false),
+	m_mMf(Transform3D::Identity()),
+	mMetric(0),
+	mScore(0),
+	mIterations(0),
+	mSeconds(0)
+{
+}
+
+///--------------------------------------------------------
+///--------------------------------------------------------
+///--------------------------------------------------------
+
+namespace
+{
+typedef itk::MultiResolutionImageRegistrationMethod<itkImageType, itkImageType> RegistrationType;
+typedef itk::RegularStepGradientDescentOptimizer OptimizerType;
+typedef itk::LinearInterpolateImageFunction<itkImageType, double> InterpolatorType;
+typedef itk::ImageToImageMetric<itkImageType, itkImageType> MetricType;
+const double SCORE_MAX_VOXELS = 1000000; ///< upper bound on voxels visited by computeScore
+
+/** Images converted to ITK once, shared read-only by all jobs.
+ */
+struct RegistrationInput
+{
+	ImagePtr mFixedImage; ///< keeps the shared pixel buffers alive
+	ImagePtr mMovingImage;
+	itkImageType::ConstPointer mFixed;
+	itkImageType::ConstPointer mMoving;
+	itkImageType::ConstPointer mScoreFixed; ///< fixed image downsampled for computeScore
+	Transform3D m_mMf_initial;
+	Vector3D mCenter_f;
+};
+typedef boost::shared_ptr<RegistrationInput> RegistrationInputPtr;
+
+/** Shrink the image by an integer factor until it has at most maxVoxels.
+ *  Physical coordinates are preserved, only the sampling is coarser.
+ */
+itkImageType::ConstPointer createScoreImage(itkImageType::ConstPointer image, double maxVoxels)
+{
+	double voxels = image->GetBufferedRegion().GetNumberOfPixels();
+	unsigned factor = std::max(1.0, std::ceil(std::pow(voxels/maxVoxels, 1.0/3.0)));
+	if (factor==1)
+		return image;
+
+	typedef itk::ShrinkImageFilter<itkImageType, itkImageType> ShrinkType;
+	ShrinkType::Pointer shrink = ShrinkType::New();
+	shrink->SetInput(image);
+	shrink->SetShrinkFactors(factor);
+	try
+	{
+		shrink->Update();
+	}
+	catch (std::exception& e)
+	{
+		reportWarning(QString("Failed to downsample image for scoring, using full resolution: %1").arg(e.what()));
+		return image;
+	}
+	return shrink->GetOutput();
+}
+
+RegistrationInputPtr createInput(ImagePtr fixed, ImagePtr moving)
+{
+	RegistrationInputPtr retval(new RegistrationInput);
+	retval->mFixedImage = fixed;
+	retval->mMovingImage = moving;
+	retval->mFixed = AlgorithmHelper::getITKfromSSCImage(fixed);
+	retval->mMoving = AlgorithmHelper::getITKfromSSCImage(moving);
+	if (retval->mFixed)
+		retval->mScoreFixed = createScoreImage(retval->mFixed, SCORE_MAX_VOXELS);
+	retval->m_mMf_initial = moving->get_rMd().inv() * fixed->get_rMd();
+	retval->mCenter_f = fixed->boundingBox().center();
+	return retval;
+}
+
+MetricType::Pointer createMetric(const ElastixInProcessSettings& settings)
+{
+	MetricType::Pointer retval;
+	if (settings.mMetric.contains("MattesMutualInformation"))
+	{
+		typedef itk::MattesMutualInformationImageToImageMetric<itkImageType, itkImageType> MattesType;
+		MattesType::Pointer metric = MattesType::New();
+		metric->SetNumberOfHistogramBins(settings.mNumberOfHistogramBins);
+		retval = metric.GetPointer();
+	}
+	else if (settings.mMetric.contains("NormalizedCorrelation"))
+	{
+		retval = itk::NormalizedCorrelationImageToImageMetric<itkImageType, itkImageType>::New().GetPointer();
+	}
+	else
+	{
+		if (!settings.mMetric.contains("MeanSquares"))
+			reportWarning(QString("Metric %1 not supported in-process, using mean squares").arg(settings.mMetric));
+		retval = itk::MeanSquaresImageToImageMetric<itkImageType, itkImageType>::New().GetPointer();
+	}
+
+	if (settings.mNumberOfSpatialSamples > 0)
+	{
+		retval->SetNumberOfFixedImageSamples(settings.mNumberOfSpatialSamples);
+		retval->UseAllPixelsOff();
+	}
+	return retval;
+}
+
+/** Normalized correlation between the fixed and transformed moving image,
+ *  over the entire fixed image. The metric visits every voxel of its fixed
+ *  region, so it is evaluated on a copy downsampled to at most
+ *  SCORE_MAX_VOXELS, made once per input and shared by all presets.
+ */
+double computeScore(const RegistrationInput& input, itk::Transform<double,3,3>* transform)
+{
+	typedef itk::NormalizedCorrelationImageToImageMetric<itkImageType, itkImageType> ScoreType;
+	ScoreType::Pointer score = ScoreType::New();
+	score->SetFixedImage(input.mScoreFixed);
+	score->SetMovingImage(input.mMoving);
+	score->SetFixedImageRegion(input.mScoreFixed->GetBufferedRegion());
+	score->SetTransform(transform);
+	score->SetInterpolator(InterpolatorType::New());
+	score->Initialize();
+	return score->GetValue(transform->GetParameters());
+}
+
+template<class TransformType>
+void registerLinear(const RegistrationInput& input, const ElastixInProcessSettings& settings, ElastixInProcessResult* result)
+{
+	typename TransformType::Pointer transform = TransformType::New();
+	typename TransformType::InputPointType center;
+	typename TransformType::MatrixType matrix;
+	typename TransformType::OutputVectorType offset;
+	for (int i=0; i<3; ++i)
+	{
+		center[i] = input.mCenter_f[i];
+		offset[i] = input.m_mMf_initial.matrix()(i,3);
+		for (int j=0; j<3; ++j)
+			matrix(i,j) = input.m_mMf_initial.matrix()(i,j);
+	}
+	transform->SetCenter(center);
+	transform->SetMatrix(matrix);
+	transform->SetOffset(offset);
+
+	// translations are in mm, the rest in radians or matrix units
+	OptimizerType::ScalesType scales(transform->GetNumberOfParameters());
+	scales.Fill(1.0);
+	for (unsigned i=scales.size()-3; i<scales.size(); ++i)
+		scales[i] = 1.0/1000.0;
+
+	OptimizerType::Pointer optimizer = OptimizerType::New();
+	optimizer->SetScales(scales);
+	optimizer->SetMaximumStepLength(settings.mMaximumStepLength);
+	optimizer->SetMinimumStepLength(settings.mMaximumStepLength/1000.0);
+	optimizer->SetNumberOfIterations(settings.mMaximumNumberOfIterations);
+	optimizer->SetRelaxationFactor(0.5);
+
+	RegistrationType::Pointer registration = RegistrationType::New();
+	registration->SetMetric(createMetric(settings));
+	registration->SetOptimizer(optimizer);
+	registration->SetTransform(transform);
+	registration->SetInterpolator(InterpolatorType::New());
+	registration->SetFixedImage(input.mFixed);
+	registration->SetMovingImage(input.mMoving);
+	registration->SetFixedImageRegion(input.mFixed->GetBufferedRegion());
+	registration->SetInitialTransformParameters(transform->GetParameters());
+	registration->SetNumberOfLevels(std::max(1, settings.mNumberOfResolutions));
+	registration->Update();
+
+	transform->SetParameters(registration->GetLastTransformParameters());
+
+	Transform3D mMf = Transform3D::Identity();
+	for (int i=0; i<3; ++i)
+	{
+		mMf.matrix()(i,3) = transform->GetOffset()[i];
+		for (int j=0; j<3; ++j)
+			mMf.matrix()(i,j) = transform->GetMatrix()(i,j);
+	}
+
+	result->m_mMf = mMf;
+	result->mMetric = optimizer->GetValue();
+	result->mIterations = optimizer->GetCurrentIteration();
+	result->mScore = computeScore(input, transform);
+	result->mSuccess = true;
+}
+
+ElastixInProcessResult runOnInput(RegistrationInputPtr input, ElastixInProcessSettings settings)
+{
+	ElastixInProcessResult retval;
+	retval.mName = settings.mName;
+	QTime clock;
+	clock.start();
+
+	if (!input->mFixed || !input->mMoving)
+	{
+		retval.mMessage = "Missing fixed or moving image";
+		return retval;
+	}
+
+	try
+	{
+		if (settings.mTransform=="EulerTransform")
+			registerLinear<itk::Euler3DTransform<double> >(*input, settings, &retval);
+		else if (settings.mTransform=="AffineTransform")
+			registerLinear<itk::AffineTransform<double,3> >(*input, settings, &retval);
+		else
+			retval.mMessage = QString("Transform %1 is not supported in-process").arg(settings.mTransform);
+	}
+	catch (itk::ExceptionObject& e)
+	{
+		retval.mSuccess = false;
+		retval.mMessage = QString(e.GetDescription());
+	}
+	catch (std::exception& e)
+	{
+		retval.mSuccess = false;
+		retval.mMessage = QString(e.what());
+	}
+
+	retval.mSeconds = clock.elapsed()/1000.0;
+	return retval;
+}
+
+bool isBetter(const ElastixInProcessResult& a, const ElastixInProcessResult& b)
+{
+	if (a.mSuccess!=b.mSuccess)
+		return a.mSuccess;
+	return a.mScore < b.mScore;
+}
+} // namespace
+
+ElastixInProcessResult ElastixInProcessRegistration::run(ImagePtr fixed, ImagePtr moving, ElastixInProcessSettings settings)
+{
+	if (!fixed || !moving)
+	{
+		ElastixInProcessResult retval;
+		retval.mName = settings.mName;
+		retval.mMessage = "Missing fixed or moving image";
+		return retval;
+	}
+	return runOnInput(createInput(fixed, moving), settings);
+}
+
+///--------------------------------------------------------
+///--------------------------------------------------------
+///--------------------------------------------------------
+
+ElastixPresetSweep::ElastixPresetSweep(ImagePtr fixed, ImagePtr moving) :
+	mFixed(fixed),
+	mMoving(moving),
+	mRemaining(0)
+{
+}
+
+ElastixPresetSweep::~ElastixPresetSweep()
+{
+	this->waitForFinished();
+}
+
+void ElastixPresetSweep::addSettings(ElastixInProcessSettings settings)
+{
+	mSettings.push_back(settings);
+}
+
+void ElastixPresetSweep::start()
+{
+	if (this->isRunning())
+	{
+		reportWarning("Registration sweep already running");
+		return;
+	}
+	if (!mFixed || !mMoving)
+	{
+		reportWarning("Failed to start registration sweep, fixed or moving image missing.");
+		return;
+	}
+
+	mJobs.clear();
+	RegistrationInputPtr input = createInput(mFixed, mMoving);
+	mRemaining = mSettings.size();
+
+	for (unsigned i=0; i<mSettings.size(); ++i)
+	{
+		boost::function<ElastixInProcessResult()> job = boost::bind(&runOnInput, input, mSettings[i]);
+		QFuture<ElastixInProcessResult> future = WorkScheduler::getInstance()->run<ElastixInProcessResult>(job, wpNORMAL);
+		mJobs.push_back(future);
+
+		QFutureWatcher<ElastixInProcessResult>* watcher = new QFutureWatcher<ElastixInProcessResult>(this);
+		connect(watcher, &QFutureWatcher<ElastixInProcessResult>::finished, this, &ElastixPresetSweep::jobFinished);
+		connect(watcher, &QFutureWatcher<ElastixInProcessResult>::finished, watcher, &QObject::deleteLater);
+		watcher->setFuture(future);
+	}
+	report(QString("Started in-process registration of %1 settings").arg(mSettings.size()));
+}
+
+bool ElastixPresetSweep::isRunning() const
+{
+	for (unsigned i=0; i<mJobs.size(); ++i)
+		if (!mJobs[i].isFinished())
+			return true;
+	return false;
+}
+
+void ElastixPresetSweep::waitForFinished()
+{
+	for (unsigned i=0; i<mJobs.size(); ++i)
+		mJobs[i].waitForFinished();
+}
+
+void ElastixPresetSweep::jobFinished()
+{
+	--mRemaining;
+	if (mRemaining==0)
+		emit finished();
+}
+
+std::vector<ElastixInProcessResult> ElastixPresetSweep::getRankedResults() const
+{
+	std::vector<ElastixInProcessResult> retval;
+	for (unsigned i=0; i<mJobs.size(); ++i)
+	{
+		if (mJobs[i].isFinished())
+			retval.push_back(mJobs[i].result());
+	}
+	std::stable_sort(retval.begin(), retval.end(), isBetter);
+	return retval;
+}
+
+} /* namespace cx */
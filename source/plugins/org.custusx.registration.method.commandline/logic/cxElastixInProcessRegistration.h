@@ -0,0 +1,129 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXELASTIXINPROCESSREGISTRATION_H_
+#define CXELASTIXINPROCESSREGISTRATION_H_
+
+#include <vector>
+#include <QObject>
+#include <QFuture>
+#include <QStringList>
+#include "cxForwardDeclarations.h"
+#include "cxTransform3D.h"
+#include "org_custusx_registration_method_commandline_Export.h"
+
+namespace cx
+{
+/**
+ * \file
+ * \addtogroup org_custusx_registration_method_commandline
+ * @{
+ */
+
+/**
+ * \brief Settings for an in-process linear registration.
+ *
+ * Read from the ElastiX parameter file keys that have a counterpart in
+ * the in-process registration: Transform (EulerTransform or AffineTransform),
+ * Metric (mean squares, normalized correlation or Mattes mutual information),
+ * NumberOfResolutions, MaximumNumberOfIterations, MaximumStepLength,
+ * NumberOfHistogramBins and NumberOfSpatialSamples.
+ * Per-resolution values use the first entry.
+ */
+struct org_custusx_registration_method_commandline_EXPORT ElastixInProcessSettings
+{
+	ElastixInProcessSettings();
+	static ElastixInProcessSettings fromParameterFile(QString filename);
+	bool isSupported() const; ///< true if the transform can be run in-process
+
+	QString mName;
+	QString mTransform;
+	QString mMetric;
+	int mNumberOfResolutions;
+	int mMaximumNumberOfIterations;
+	double mMaximumStepLength;
+	int mNumberOfHistogramBins;
+	int mNumberOfSpatialSamples;
+};
+
+/**
+ * \brief Outcome of one in-process registration.
+ */
+struct org_custusx_registration_method_commandline_EXPORT ElastixInProcessResult
+{
+	ElastixInProcessResult();
+
+	QString mName; ///< name of the settings used
+	bool mSuccess;
+	QString mMessage; ///< error description if failed
+	Transform3D m_mMf; ///< moving_M_fixed, as ElastixExecuter::getAffineResult_mMf()
+	double mMetric; ///< final value of the optimized metric
+	double mScore; ///< normalized correlation after registration on a downsampled fixed image, same measure for all settings. Lower is better.
+	int mIterations;
+	double mSeconds;
+};
+
+/**
+ * \brief Linear image to image registration run inside CustusX.
+ *
+ * An alternative to ElastixExecuter for rigid and affine registration:
+ * The images are handed over in memory instead of through files, and
+ * the registration is done by ITK in the calling thread.
+ *
+ * The initial transform is taken from the current rMd of the images.
+ */
+class org_custusx_registration_method_commandline_EXPORT ElastixInProcessRegistration
+{
+public:
+	static ElastixInProcessResult run(ImagePtr fixed, ImagePtr moving, ElastixInProcessSettings settings);
+};
+
+/**
+ * \brief Run several registration settings concurrently on the same images.
+ *
+ * The images are converted once, then each settings is registered
+ * as a separate job on the WorkScheduler. When all are done, finished()
+ * is emitted and the results can be retrieved ranked by score.
+ */
+class org_custusx_registration_method_commandline_EXPORT ElastixPresetSweep : public QObject
+{
+	Q_OBJECT
+public:
+	ElastixPresetSweep(ImagePtr fixed, ImagePtr moving);
+	virtual ~ElastixPresetSweep();
+
+	void addSettings(ElastixInProcessSettings settings);
+	void start();
+	bool isRunning() const;
+	void waitForFinished();
+	std::vector<ElastixInProcessResult> getRankedResults() const; ///< successful results first, lowest score first
+
+signals:
+	void finished();
+
+private slots:
+	void jobFinished();
+
+private:
+	ImagePtr mFixed;
+	ImagePtr mMoving;
+	std::vector<ElastixInProcessSettings> mSettings;
+	std::vector<QFuture<ElastixInProcessResult> > mJobs;
+	int mRemaining;
+};
+typedef boost::shared_ptr<ElastixPresetSweep> ElastixPresetSweepPtr;
+
+/**
+ * @}
+ */
+} /* namespace cx */
+
+#endif /* CXELASTIXINPROCESSREGISTRATION_H_ */
@@ -52,6 +52,14 @@ ElastixManager::ElastixManager(RegServicesPtr services) :
 		false,
 		mOptions.getElement());
 
+	mRunInProcess = BoolProperty::initialize("runInProcess",
+		"Run In-Process",
+		"Run linear (Euler/Affine) parameter files inside CustusX instead of\n"
+		"calling the ElastiX executable. Each active parameter file is\n"
+		"registered in parallel, and the best result is applied.",
+		false,
+		mOptions.getElement());
+
 	mExecuter.reset(new ElastixExecuter(services));
 	connect(mExecuter.get(), SIGNAL(finished()), this, SLOT(executionFinishedSlot()));
 	connect(mExecuter.get(), SIGNAL(aboutToStart()), this, SLOT(preprocessExecuter()));
@@ -63,7 +71,75 @@ ElastixManager::~ElastixManager()
 
 void ElastixManager::execute()
 {
-	mExecuter->execute();
+	if (mRunInProcess->getValue())
+		this->executeInProcess();
+	else
+		mExecuter->execute();
+}
+
+void ElastixManager::executeInProcess()
+{
+	if (mSweep && mSweep->isRunning())
+	{
+		reportWarning("In-process registration already running");
+		return;
+	}
+
+	ImagePtr fixed = boost::dynamic_pointer_cast<Image>(mServices->registration()->getFixedData());
+	ImagePtr moving = boost::dynamic_pointer_cast<Image>(mServices->registration()->getMovingData());
+	if (!fixed || !moving)
+	{
+		reportWarning("In-process registration requires fixed and moving images.");
+		return;
+	}
+
+	mSweep.reset(new ElastixPresetSweep(fixed, moving));
+	QStringList parameterFiles = mParameters->getActiveParameterFiles();
+	int count = 0;
+	for (int i=0; i<parameterFiles.size(); ++i)
+	{
+		ElastixInProcessSettings settings = ElastixInProcessSettings::fromParameterFile(parameterFiles[i]);
+		if (!settings.isSupported())
+		{
+			reportWarning(QString("Skipping %1: transform %2 not supported in-process")
+						  .arg(QFileInfo(parameterFiles[i]).fileName()).arg(settings.mTransform));
+			continue;
+		}
+		mSweep->addSettings(settings);
+		++count;
+	}
+	if (!count)
+	{
+		reportWarning("No active parameter files can be run in-process.");
+		mSweep.reset();
+		return;
+	}
+
+	connect(mSweep.get(), &ElastixPresetSweep::finished, this, &ElastixManager::inProcessFinishedSlot);
+	mSweep->start();
+}
+
+void ElastixManager::inProcessFinishedSlot()
+{
+	if (!mSweep)
+		return;
+	std::vector<ElastixInProcessResult> results = mSweep->getRankedResults();
+
+	for (unsigned i=0; i<results.size(); ++i)
+	{
+		if (results[i].mSuccess)
+			report(QString("In-process registration [%1]: score=%2, metric=%3, %4 iterations, %5s")
+				   .arg(results[i].mName).arg(results[i].mScore).arg(results[i].mMetric)
+				   .arg(results[i].mIterations).arg(results[i].mSeconds, 0, 'f', 1));
+		else
+			reportWarning(QString("In-process registration [%1] failed: %2").arg(results[i].mName).arg(results[i].mMessage));
+	}
+
+	if (results.empty() || !results[0].mSuccess)
+		return;
+
+	QString desc = QString("Image2Image [in-process][par=%1]").arg(results[0].mName);
+	this->applyLinearResult(results[0].m_mMf, desc);
 }
 
 void ElastixManager::preprocessExecuter()
@@ -103,6 +179,14 @@ void ElastixManager::executionFinishedSlot()
 	for (unsigned i=0; i<parameterFiles.size(); ++i)
 		desc += QString("[par=%1]").arg(QFileInfo(parameterFiles[i]).fileName());
 
+	this->applyLinearResult(mMf, desc);
+
+	// add nonlinear data AFTER registering - we dont want these data to be double-registered!
+	this->addNonlinearData();
+}
+
+void ElastixManager::applyLinearResult(Transform3D mMf, QString desc)
+{
 	// Start with fMr * D * rMm = fMm'
 	// where the lhs is the existing data and the delta that is input to regmanager,
 	// and the rhs is the (inverse of the) output from ElastiX.
@@ -120,9 +204,6 @@ void ElastixManager::executionFinishedSlot()
 
 //	mServices->registration()->addImage2ImageRegistration(mMf.inv(), desc);
 	mServices->registration()->addImage2ImageRegistration(delta_pre_rMd, desc);
-
-	// add nonlinear data AFTER registering - we dont want these data to be double-registered!
-	this->addNonlinearData();
 }
 
 /**If the registration is nonlinear, add the (last) volume
@@ -18,6 +18,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxStringProperty.h"
 #include "cxElastixParameters.h"
 #include "cxRegServices.h"
+#include "cxElastixInProcessRegistration.h"
 
 namespace cx
 {
@@ -44,6 +45,7 @@ public:
 
 	BoolPropertyPtr getDisplayProcessMessages() { return mDisplayProcessMessages; }
 	BoolPropertyPtr getDisableRendering() { return mDisableRendering; }
+	BoolPropertyPtr getRunInProcess() { return mRunInProcess; }
 	ElastixExecuterPtr getExecuter() { return mExecuter; }
 	ElastixParametersPtr getParameters() { return mParameters; }
 
@@ -54,15 +56,20 @@ signals:
 private slots:
 	void executionFinishedSlot();
 	void preprocessExecuter();
+	void inProcessFinishedSlot();
 
 private:
 	void addNonlinearData();
+	void executeInProcess();
+	void applyLinearResult(Transform3D mMf, QString desc);
 
 	ElastixParametersPtr mParameters;
 	XmlOptionFile mOptions;
 	BoolPropertyPtr mDisplayProcessMessages;
 	BoolPropertyPtr mDisableRendering;
+	BoolPropertyPtr mRunInProcess;
 	ElastixExecuterPtr mExecuter;
+	ElastixPresetSweepPtr mSweep;
 	RegServicesPtr mServices;
 };
 typedef boost::shared_ptr<ElastixManager> ElastixManagerPtr;
@@ -0,0 +1,144 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <vtkImageData.h>
+#include "cxElastixInProcessRegistration.h"
+#include "cxImage.h"
+#include "cxVolumeHelpers.h"
+#include "cxReporter.h"
+
+namespace cxtest
+{
+
+namespace
+{
+/** Create a volume with a few gaussian blobs of different size,
+ *  giving a unique rigid alignment.
+ */
+vtkImageDataPtr createBlobImageData(int axisSize)
+{
+	vtkImageDataPtr data = cx::generateVtkImageDataSignedShort(Eigen::Array3i(axisSize, axisSize, axisSize), cx::Vector3D(1,1,1), 0);
+	std::vector<cx::Vector3D> centers;
+	centers.push_back(cx::Vector3D(0.3, 0.4, 0.5)*axisSize);
+	centers.push_back(cx::Vector3D(0.7, 0.35, 0.4)*axisSize);
+	centers.push_back(cx::Vector3D(0.5, 0.7, 0.65)*axisSize);
+	double sigma[] = { 4, 6, 3 };
+
+	short* ptr = static_cast<short*>(data->GetScalarPointer());
+	for (int z=0; z<axisSize; ++z)
+		for (int y=0; y<axisSize; ++y)
+			for (int x=0; x<axisSize; ++x)
+			{
+				double value = 0;
+				for (unsigned i=0; i<centers.size(); ++i)
+				{
+					double r2 = (cx::Vector3D(x,y,z)-centers[i]).squaredNorm();
+					value += 1000 * exp(-r2/(2*sigma[i]*sigma[i]));
+				}
+				*ptr++ = static_cast<short>(value);
+			}
+	data->Modified();
+	return data;
+}
+
+struct InProcessRegistrationFixture
+{
+	InProcessRegistrationFixture()
+	{
+		cx::Reporter::initialize();
+		vtkImageDataPtr data = createBlobImageData(48);
+		mFixed.reset(new cx::Image("fixed", data));
+		mMoving.reset(new cx::Image("moving", data));
+		mMoving->get_rMd_History()->setRegistration(cx::createTransformRotateZ(4.0/180.0*M_PI)
+													* cx::createTransformTranslate(cx::Vector3D(2, -1.5, 1)));
+	}
+	~InProcessRegistrationFixture()
+	{
+		cx::Reporter::shutdown();
+	}
+
+	/** The images share voxel data, thus a correct registration gives mMf=identity.
+	 */
+	double getTranslationError(cx::Transform3D mMf) const
+	{
+		cx::Vector3D center = mFixed->boundingBox().center();
+		return (mMf.coord(center)-center).norm();
+	}
+
+	cx::ElastixInProcessSettings createRigidSettings(QString name, QString metric) const
+	{
+		cx::ElastixInProcessSettings settings;
+		settings.mName = name;
+		settings.mTransform = "EulerTransform";
+		settings.mMetric = metric;
+		settings.mNumberOfResolutions = 2;
+		settings.mMaximumNumberOfIterations = 200;
+		settings.mMaximumStepLength = 2.0;
+		return settings;
+	}
+
+	cx::ImagePtr mFixed;
+	cx::ImagePtr mMoving;
+};
+} // namespace
+
+TEST_CASE("ElastixInProcessRegistration: rigid registration recovers the perturbation", "[pluginRegistration][unit]")
+{
+	InProcessRegistrationFixture fixture;
+	cx::Transform3D initial = fixture.mMoving->get_rMd().inv() * fixture.mFixed->get_rMd();
+	REQUIRE(fixture.getTranslationError(initial) > 2.0);
+
+	cx::ElastixInProcessResult result = cx::ElastixInProcessRegistration::run(fixture.mFixed, fixture.mMoving,
+																			 fixture.createRigidSettings("rigid", "AdvancedMeanSquares"));
+	INFO(result.mMessage);
+	REQUIRE(result.mSuccess);
+	CHECK(fixture.getTranslationError(result.m_mMf) < 0.5);
+	CHECK(result.mScore < -0.95);
+}
+
+TEST_CASE("ElastixInProcessRegistration: unsupported transform fails", "[pluginRegistration][unit]")
+{
+	InProcessRegistrationFixture fixture;
+	cx::ElastixInProcessSettings settings = fixture.createRigidSettings("bspline", "AdvancedMeanSquares");
+	settings.mTransform = "BSplineTransform";
+	CHECK_FALSE(settings.isSupported());
+
+	cx::ElastixInProcessResult result = cx::ElastixInProcessRegistration::run(fixture.mFixed, fixture.mMoving, settings);
+	CHECK_FALSE(result.mSuccess);
+}
+
+TEST_CASE("ElastixPresetSweep: ranks concurrent registrations by score", "[pluginRegistration][unit]")
+{
+	InProcessRegistrationFixture fixture;
+	cx::ElastixPresetSweep sweep(fixture.mFixed, fixture.mMoving);
+
+	cx::ElastixInProcessSettings poor = fixture.createRigidSettings("poor", "AdvancedMeanSquares");
+	poor.mMaximumNumberOfIterations = 1;
+	poor.mNumberOfResolutions = 1;
+	sweep.addSettings(poor);
+	sweep.addSettings(fixture.createRigidSettings("meansquares", "AdvancedMeanSquares"));
+	sweep.addSettings(fixture.createRigidSettings("correlation", "AdvancedNormalizedCorrelation"));
+
+	sweep.start();
+	sweep.waitForFinished();
+	CHECK_FALSE(sweep.isRunning());
+
+	std::vector<cx::ElastixInProcessResult> results = sweep.getRankedResults();
+	REQUIRE(results.size() == 3);
+	for (unsigned i=1; i<results.size(); ++i)
+		CHECK(results[i-1].mScore <= results[i].mScore);
+	CHECK(results.back().mName == "poor");
+	CHECK(fixture.getTranslationError(results.front().m_mMf) < 0.5);
+}
+
+} // namespace cxtest
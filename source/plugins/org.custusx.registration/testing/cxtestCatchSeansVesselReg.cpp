@@ -23,8 +23,12 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxTypeConversions.h"
 #include <QFileInfo>
 #include <QDir>
+#include <QTime>
+#include <vtkPoints.h>
+#include "cxReporter.h"
 #include "cxFileManagerServiceProxy.h"
 #include "cxLogicManager.h"
+#include "cxtestJenkinsMeasurement.h"
 
 
 TEST_CASE_METHOD(cxtest::SeansVesselRegFixture, "SeansVesselReg: V2V syntectic data", "[integration][modules][registration][not_win32]")
@@ -164,3 +168,87 @@ TEST_CASE_METHOD(cxtest::SeansVesselRegFixture, "SeansVesselReg: V2V registratio
 
 	cx::LogicManager::shutdown();
 }
+
+namespace
+{
+/** Points on an ellipsoid with a bump, sampled on a regular angle grid.
+ */
+vtkPolyDataPtr createSurfaceCloud(int thetaSteps, int phiSteps)
+{
+	vtkPointsPtr points = vtkPointsPtr::New();
+	for (int i=0; i<thetaSteps; ++i)
+	{
+		double theta = M_PI * (i+0.5) / thetaSteps;
+		for (int j=0; j<phiSteps; ++j)
+		{
+			double phi = 2 * M_PI * j / phiSteps;
+			cx::Vector3D n(sin(theta)*cos(phi), sin(theta)*sin(phi), cos(theta));
+			double bump = 10 * exp(-(n-cx::Vector3D(0.6,0.6,0.5)).squaredNorm()/0.1);
+			cx::Vector3D p = n.array() * (cx::Vector3D(40,30,20) + bump*cx::Vector3D(1,1,1)).array();
+			points->InsertNextPoint(p.data());
+		}
+	}
+	return cx::SeansVesselReg::convertToPolyData(points);
+}
+
+/** Linear registration of a 30k point cloud to a 120k point cloud, perturbed by a few degrees and mm.
+ */
+struct LargePointCloudRegistration
+{
+	cx::MeshPtr mTarget;
+	cx::MeshPtr mSource;
+	cx::Transform3D mPerturbation;
+	cx::SeansVesselReg mVesselReg;
+
+	LargePointCloudRegistration()
+	{
+		mTarget.reset(new cx::Mesh("target", "target", createSurfaceCloud(400, 300)));
+		mSource.reset(new cx::Mesh("source", "source", createSurfaceCloud(200, 150)));
+		mPerturbation = cx::createTransformRotateZ(3/180.0*M_PI)
+				* cx::createTransformRotateX(2/180.0*M_PI)
+				* cx::createTransformTranslate(cx::Vector3D(1.5, -1, 2));
+		mSource->get_rMd_History()->setRegistration(mPerturbation);
+
+		mVesselReg.mt_doOnlyLinear = true;
+		mVesselReg.mt_auto_lts = false;
+		mVesselReg.mt_ltsRatio = 90;
+	}
+
+	bool run()
+	{
+		return mVesselReg.initialize(mSource, mTarget, QDir::tempPath()) && mVesselReg.execute();
+	}
+};
+}
+
+TEST_CASE("SeansVesselReg: coarse-to-fine registration of a large point cloud", "[unit][registration]")
+{
+	cx::Reporter::initialize();
+	LargePointCloudRegistration registration;
+	REQUIRE(registration.run());
+
+	cx::Transform3D diff = registration.mVesselReg.getLinearResult() * registration.mPerturbation.inv();
+	CHECK(diff.coord(cx::Vector3D(0,0,0)).norm() < 0.5);
+	CHECK(Eigen::AngleAxisd(diff.matrix().block<3, 3>(0, 0)).angle() < 0.5/180.0*M_PI);
+
+	// second run on the same target, now using the shared locator
+	CHECK(registration.run());
+	cx::Reporter::shutdown();
+}
+
+TEST_CASE("Speed: SeansVesselReg coarse-to-fine registration of a large point cloud", "[speed][registration][integration]")
+{
+	cx::Reporter::initialize();
+	LargePointCloudRegistration registration;
+
+	QTime clock;
+	clock.start();
+	REQUIRE(registration.run());
+	int elapsed = clock.elapsed();
+
+	cxtest::JenkinsMeasurement jenkins;
+	jenkins.createOutput("SeansVesselRegLargePointCloud_ms", QString::number(elapsed));
+	CHECK(elapsed < 1000);
+	cx::Reporter::shutdown();
+}
+
@@ -20,10 +20,12 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <vtkImageData.h>
 #include "cxImage.h"
 #include "cxDoubleProperty.h"
+#include "cxTimedAlgorithm.h"
 
 namespace cx
 {
-PNNReconstructionMethodService::PNNReconstructionMethodService(ctkPluginContext* context)
+PNNReconstructionMethodService::PNNReconstructionMethodService(ctkPluginContext* context) :
+	mExecutingAlgorithm(NULL)
 {
 }
 
@@ -42,6 +44,22 @@ std::vector<PropertyPtr> PNNReconstructionMethodService::getSettings(QDomElement
 	return retval;
 }
 
+void PNNReconstructionMethodService::setExecutingAlgorithm(TimedBaseAlgorithm* algorithm)
+{
+	mExecutingAlgorithm = algorithm;
+}
+
+bool PNNReconstructionMethodService::isCancelRequested() const
+{
+	return mExecutingAlgorithm && mExecutingAlgorithm->isCancelRequested();
+}
+
+void PNNReconstructionMethodService::reportProgress(int step, int maxSteps)
+{
+	if (mExecutingAlgorithm)
+		mExecutingAlgorithm->reportProgress(step, maxSteps);
+}
+
 DoublePropertyPtr PNNReconstructionMethodService::getInterpolationStepsOption(QDomElement root)
 {
 	DoublePropertyPtr retval;
@@ -97,9 +115,16 @@ bool PNNReconstructionMethodService::reconstruct(ProcessedUSInputDataPtr input,
 	unsigned char *outputPointer = static_cast<unsigned char*> (tempOutput->GetScalarPointer());
 	unsigned char* maskPointer = static_cast<unsigned char*> (input->getMask()->GetScalarPointer());
 
+	// progress: one step per input frame, then one per output slice in interpolate()
+	int progressSteps = inputDims[2] + targetDims[0];
+
 	// Traverse all input pixels
 	for (int record = 0; record < inputDims[2]; record++)
 	{
+		if (this->isCancelRequested())
+			return false;
+		this->reportProgress(record, progressSteps);
+
 		unsigned char *inputPointer = input->getFrame(record);
 		boost::array<double, 16> recordTransform = frameInfo[record].mPos.flatten();
 
@@ -133,7 +158,8 @@ bool PNNReconstructionMethodService::reconstruct(ProcessedUSInputDataPtr input,
 	}//record
 
 	// Fill holes
-	this->interpolate(tempOutputData, outputData, settings);
+	if (!this->interpolate(tempOutputData, outputData, settings, inputDims[2]))
+		return false;
 
 	setDeepModified(outputData);
 	return true;
@@ -227,7 +253,7 @@ vtkImageDataPtr PNNReconstructionMethodService::createMask(vtkImageDataPtr input
 	return mask;
 }
 
-void PNNReconstructionMethodService::interpolate(ImagePtr inputData, vtkImageDataPtr outputData, QDomElement settings)
+bool PNNReconstructionMethodService::interpolate(ImagePtr inputData, vtkImageDataPtr outputData, QDomElement settings, int progressOffset)
 {
 	TimeKeeper timer;
 	DoublePropertyPtr interpolationStepsOption = this->getInterpolationStepsOption(settings);
@@ -256,6 +282,10 @@ void PNNReconstructionMethodService::interpolate(ImagePtr inputData, vtkImageDat
 	// Traverse all voxels
 	for (int x = 0; x < outputDims[0]; x++)
 	{
+		if (this->isCancelRequested())
+			return false;
+		this->reportProgress(progressOffset + x, progressOffset + outputDims[0]);
+
 		for (int y = 0; y < outputDims[1]; y++)
 		{
 			for (int z = 0; z < outputDims[2]; z++)
@@ -293,6 +323,7 @@ void PNNReconstructionMethodService::interpolate(ImagePtr inputData, vtkImageDat
 				.arg(interpolationSteps)
 				.arg(timer.getElapsedSecondsAsString())
 				.arg(holes));
+	return true;
 }
 
 /**Fill the empty voxel (x,y,z) with the average value of the surrounding box.
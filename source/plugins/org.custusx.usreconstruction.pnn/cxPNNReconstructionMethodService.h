@@ -42,6 +42,7 @@ public:
 
 	virtual std::vector<PropertyPtr> getSettings(QDomElement root);
 	virtual bool reconstruct(ProcessedUSInputDataPtr input, vtkImageDataPtr outputData, QDomElement settings);
+	virtual void setExecutingAlgorithm(TimedBaseAlgorithm* algorithm);
 
 
 private:
@@ -56,10 +57,13 @@ private:
 		return (x >= 0) && (x < dims[0]) && (y >= 0) && (y < dims[1]) && (z >= 0) && (z < dims[2]);
 	}
 
-	void interpolate(ImagePtr inputData, vtkImageDataPtr outputData, QDomElement settings);
+	bool isCancelRequested() const;
+	void reportProgress(int step, int maxSteps);
+	bool interpolate(ImagePtr inputData, vtkImageDataPtr outputData, QDomElement settings, int progressOffset);
 	vtkImageDataPtr createMask(vtkImageDataPtr inputData);
 	void fillHole(unsigned char *inputPointer, unsigned char *outputPointer, int x, int y, int z, const Eigen::Array3i& dim, int interpolationSteps);
 
+	TimedBaseAlgorithm* mExecutingAlgorithm;
 
 };
 //typedef boost::shared_ptr<PNNReconstructionMethodService> PNNReconstructionMethodService*;
@@ -74,8 +74,10 @@ void ReconstructCore::threadedPreReconstruct()
 
 /**The reconstruct part that can be run in a separate thread.
  *
+ * If executingAlgorithm is given, the reconstruction algorithm
+ * can poll it for cancellation and report progress to it.
  */
-void ReconstructCore::threadedReconstruct()
+void ReconstructCore::threadedReconstruct(TimedBaseAlgorithm* executingAlgorithm)
 {
 	if (!this->validInputData())
 		return;
@@ -83,7 +85,9 @@ void ReconstructCore::threadedReconstruct()
 
 	TimeKeeper timer;
 
+	mAlgorithm->setExecutingAlgorithm(executingAlgorithm);
 	mSuccess = mAlgorithm->reconstruct(mFileData, mRawOutput, mInput.mAlgoSettings);
+	mAlgorithm->setExecutingAlgorithm(NULL);
 
 	timer.printElapsedSeconds("Reconstruct core time");
 }
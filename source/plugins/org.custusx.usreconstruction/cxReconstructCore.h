@@ -21,6 +21,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 namespace cx
 {
 class ReconstructionMethodService;
+class TimedBaseAlgorithm;
 //typedef class ReconstructionMethodService* ReconstructionMethodServicePtr;
 
 typedef boost::shared_ptr<class ReconstructCore> ReconstructCorePtr;
@@ -74,7 +75,7 @@ public:
 	void initialize(ProcessedUSInputDataPtr fileData, OutputVolumeParams outputVolumeParams);
 	ImagePtr reconstruct();
 	void threadedPreReconstruct();
-	void threadedReconstruct();
+	void threadedReconstruct(TimedBaseAlgorithm* executingAlgorithm = NULL);
 	void threadedPostReconstruct();
 	ImagePtr getOutput();
 
@@ -33,6 +33,7 @@ ThreadedTimedReconstructPreprocessor::ThreadedTimedReconstructPreprocessor(Patie
 	mInput = input;
 	mUseDefaultMessages = false;
 	mCores = cores;
+	this->setPriority(wpBACKGROUND);
 }
 
 ThreadedTimedReconstructPreprocessor::~ThreadedTimedReconstructPreprocessor()
@@ -73,6 +74,7 @@ ThreadedTimedReconstructCore::ThreadedTimedReconstructCore(PatientModelServicePt
 {
 	mUseDefaultMessages = false;
 	mReconstructer = reconstructer;
+	this->setPriority(wpBACKGROUND);
 }
 
 ThreadedTimedReconstructCore::~ThreadedTimedReconstructCore()
@@ -86,11 +88,14 @@ void ThreadedTimedReconstructCore::preProcessingSlot()
 
 void ThreadedTimedReconstructCore::calculate()
 {
-	mReconstructer->threadedReconstruct();
+	mReconstructer->threadedReconstruct(this);
 }
 
 void ThreadedTimedReconstructCore::postProcessingSlot()
 {
+	if (this->isCancelRequested())
+		return;
+
 	mReconstructer->threadedPostReconstruct();
 
 	mPatientModelService->autoSave();
@@ -39,6 +39,7 @@ typedef boost::shared_ptr<class ThreadedTimedReconstructCore> ThreadedTimedRecon
  * \brief Threading adapter for the reconstruction algorithm.
  *
  * Must be run before ThreadedTimedReconstructCore.
+ * Runs with background priority in the WorkScheduler.
  *
  * Executes ReconstructCore functions:
  *  - threadedPreReconstruct() [main thread]
@@ -23,6 +23,12 @@ cx::TimedAlgorithmPtr ReconstructionExecuter::getThread()
 	return mPipeline;
 }
 
+void ReconstructionExecuter::cancel()
+{
+	if (mPipeline)
+		mPipeline->cancel();
+}
+
 void ReconstructionExecuter::startNonThreadedReconstruction(ReconstructionMethodService* algo, ReconstructCore::InputParams par, USReconstructInputData fileData, bool createBModeWhenAngio)
 {
 	cx::ReconstructPreprocessorPtr preprocessor = this->createPreprocessor(par, fileData);
@@ -72,6 +78,8 @@ std::vector<cx::ImagePtr> ReconstructionExecuter::getResult()
 	std::vector<cx::ImagePtr> retval;
 	if (mPipeline && !mPipeline->isFinished())
 		return retval;
+	if (mPipeline && mPipeline->isCancelRequested())
+		return retval;
 
 	for (unsigned i=0; i<mCores.size(); ++i)
 		retval.push_back(mCores[i]->getOutput());
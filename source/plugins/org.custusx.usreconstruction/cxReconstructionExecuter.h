@@ -45,6 +45,7 @@ public:
 	void startReconstruction(ReconstructionMethodService* algo, ReconstructCore::InputParams par, USReconstructInputData fileData, bool createBModeWhenAngio);
 	std::vector<cx::ImagePtr> getResult(); // return latest reconstruct result (after reconstructFinished() emitted), empty during processing.
 	cx::TimedAlgorithmPtr getThread(); ///< Return the currently reconstructing thread object.
+	void cancel(); ///< Request cancellation of a running reconstruction. Remaining steps are skipped, no output is generated.
 	void startNonThreadedReconstruction(ReconstructionMethodService* algo, ReconstructCore::InputParams par, USReconstructInputData fileData, bool createBModeWhenAngio);
 
 signals:
@@ -34,6 +34,7 @@ typedef boost::shared_ptr<class DoubleProperty> DoublePropertyPtr;
 typedef boost::shared_ptr<class BoolProperty> BoolPropertyPtr;
 typedef boost::shared_ptr<class Image> ImagePtr;
 typedef boost::shared_ptr<class ProcessedUSInputData> ProcessedUSInputDataPtr;
+class TimedBaseAlgorithm;
 
 /**
  * \addtogroup org_custusx_usreconstruction
@@ -69,6 +70,12 @@ public:
 	 * \param settings Reference to settings file containing algorithm-specific settings
 	 */
 	virtual bool reconstruct(ProcessedUSInputDataPtr input, vtkImageDataPtr outputData, QDomElement settings) = 0;
+	/**
+	 * Set the algorithm that runs reconstruct(), or NULL.
+	 * reconstruct() can use it to check for cancellation
+	 * and to report progress. Default: ignored.
+	 */
+	virtual void setExecutingAlgorithm(TimedBaseAlgorithm* algorithm) {}
 };
 
 /**
@@ -26,6 +26,8 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include "cxPatientModelService.h"
 #include "cxRemoteAPI.h"
+#include "cxLayoutImageStreamer.h"
+#include <boost/bind.hpp>
 #include <QPixmap>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -73,6 +75,7 @@ void HttpRequestHandler::handle_complete_request(QHttpRequest *req, QHttpRespons
 	   PUT    /layout/display?width=536,height=320,layout=mg_def  : create layout display of given size and layout
 	   GET    /layout/display                                  : get image of layout
 	   DELETE /layout/display                                  : delete display
+	   GET    /layout/display/live?format=jpeg,quality=75,scale=1,fps=10 : multipart stream of layout images
 
 	   PUT    /layout/display/stream?port=8086                 : start streamer on port
 	   DELETE /layout/display/stream                           : stop streamer on port
@@ -112,6 +115,10 @@ void HttpRequestHandler::handle_layout(QHttpRequest *req, QHttpResponse *resp)
     {
         this->process_stream(req, resp);
     }
+    else if (req->path()=="/layout/display/live")
+    {
+        this->process_live_stream(req, resp);
+    }
     else if (req->path() == "/layout/display")
     {
         this->process_display(req, resp);
@@ -154,6 +161,20 @@ void HttpRequestHandler::process_stream(QHttpRequest *req, QHttpResponse *resp)
     }
 }
 
+void HttpRequestHandler::process_live_stream(QHttpRequest *req, QHttpResponse *resp)
+{
+    CX_ASSERT(req->path()=="/layout/display/live");
+
+    if (req->method()==QHttpRequest::HTTP_GET)
+    {
+        this->get_display_live_stream(req, resp);
+    }
+    else
+    {
+        this->reply_method_not_allowed(resp);
+    }
+}
+
 void HttpRequestHandler::process_display(QHttpRequest *req, QHttpResponse *resp)
 {
     CX_ASSERT(req->path()=="/layout/display");
@@ -211,6 +232,37 @@ void HttpRequestHandler::get_display_image(QHttpResponse *resp)
     resp->end();
 }
 
+/** Add the client to the streamer for the requested format. Clients asking for
+ *  the same format share grabbing and encoding.
+ */
+void HttpRequestHandler::get_display_live_stream(QHttpRequest *req, QHttpResponse *resp)
+{
+    // example test line:
+    // curl http://localhost:8085/layout/display/live?format=jpeg&quality=60&scale=0.5&fps=15
+    ImageStreamFormat format = ImageStreamFormat::fromUrl(req->url());
+
+    LayoutImageStreamerPtr streamer = mLiveStreamers[format.getUid()];
+    if (!streamer)
+    {
+        streamer.reset(new LayoutImageStreamer(boost::bind(&RemoteAPI::grabLayout, mApi), format));
+        connect(streamer.get(), &LayoutImageStreamer::noClients, this, &HttpRequestHandler::onLiveStreamIdle, Qt::QueuedConnection);
+        mLiveStreamers[format.getUid()] = streamer;
+    }
+
+    streamer->addClient(resp);
+}
+
+void HttpRequestHandler::onLiveStreamIdle()
+{
+    for (std::map<QString, LayoutImageStreamerPtr>::iterator iter=mLiveStreamers.begin(); iter!=mLiveStreamers.end(); )
+    {
+        if (iter->second->getNumberOfClients()==0)
+            mLiveStreamers.erase(iter++);
+        else
+            ++iter;
+    }
+}
+
 void HttpRequestHandler::create_display(QHttpRequest *req, QHttpResponse *resp)
 {
     // example test line:
@@ -290,6 +342,11 @@ void HttpRequestHandler::reply_mainpage(QHttpResponse *resp)
                  "</tr>"
                  "<tr><td>GET</td><td>/layout/display</td><td>get image of layout</td><td>png image</td></tr>"
                  "<tr><td>DELETE</td><td>/layout/display</td><td>delete display</td></tr>"
+                 "<tr>"
+                 "<td>GET</td><td>/layout/display/live</td>"
+                 "<td>continuous stream of layout images (multipart/x-mixed-replace), slow clients skip frames.</td>"
+                 "<td>url query: format=(jpeg|png),quality=(0..100),scale=(0..1),fps=(int)</td>"
+                 "</tr>"
                  ""
 				 "%2"
                  ""
@@ -12,6 +12,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #define CXHTTPREQUESTHANDLER_H
 
 #include <QObject>
+#include <map>
 #include "cxVisServices.h"
 
 #include "org_custusx_webserver_Export.h"
@@ -22,6 +23,7 @@ class QHttpResponse;
 namespace cx
 {
 typedef boost::shared_ptr<class RemoteAPI> RemoteAPIPtr;
+typedef boost::shared_ptr<class LayoutImageStreamer> LayoutImageStreamerPtr;
 
 /**
  *
@@ -44,6 +46,7 @@ protected:
     void handle_layout(QHttpRequest *req, QHttpResponse *resp);
     void process_display(QHttpRequest *req, QHttpResponse *resp);
     void process_stream(QHttpRequest *req, QHttpResponse *resp);
+    void process_live_stream(QHttpRequest *req, QHttpResponse *resp);
     void process_layout(QHttpRequest *req, QHttpResponse *resp);
 
     void reply_mainpage(QHttpResponse *resp);
@@ -52,6 +55,7 @@ protected:
     void reply_method_not_allowed(QHttpResponse *resp);
     void reply_layout_list(QHttpResponse *resp);
     void get_display_image(QHttpResponse *resp);
+    void get_display_live_stream(QHttpRequest *req, QHttpResponse *resp);
     void create_display(QHttpRequest *req, QHttpResponse *resp);
     void delete_display(QHttpResponse *resp);
     virtual void create_stream(QHttpRequest *req, QHttpResponse *resp);
@@ -64,6 +68,7 @@ protected:
 
 private slots:
 	void onRequestSuccessful();
+	void onLiveStreamIdle();
 private:
 	struct RequestType
 	{
@@ -72,6 +77,7 @@ private:
 		QHttpResponse *resp;
 	};
 	QList<RequestType> mRequests;
+	std::map<QString, LayoutImageStreamerPtr> mLiveStreamers; ///< one streamer per stream format
 
 
     QByteArray generatePNGEncoding(QImage image);
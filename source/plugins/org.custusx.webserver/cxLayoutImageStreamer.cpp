@@ -0,0 +1,264 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxLayoutImageStreamer.h"
+
+#include <QTimer>
+#include <QBuffer>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QtConcurrent>
+#include <QFutureWatcher>
+#include <qhttpresponse.h>
+#include "cxLogger.h"
+
+namespace cx
+{
+
+ImageStreamFormat::ImageStreamFormat() :
+	mFormat("jpeg"),
+	mQuality(75),
+	mScale(1.0),
+	mFps(10)
+{
+}
+
+ImageStreamFormat ImageStreamFormat::fromUrl(QUrl url)
+{
+	ImageStreamFormat retval;
+	QUrlQuery query(url);
+	bool ok = false;
+
+	QString format = query.queryItemValue("format").toLower();
+	if (format=="jpg")
+		format = "jpeg";
+	if (format=="jpeg" || format=="png")
+		retval.mFormat = format;
+
+	int quality = query.queryItemValue("quality").toInt(&ok);
+	if (ok)
+		retval.mQuality = std::max(0, std::min(100, quality));
+
+	double scale = query.queryItemValue("scale").toDouble(&ok);
+	if (ok && scale>0)
+		retval.mScale = std::min(1.0, scale);
+
+	int fps = query.queryItemValue("fps").toInt(&ok);
+	if (ok && fps>0)
+		retval.mFps = std::min(60, fps);
+
+	return retval;
+}
+
+QString ImageStreamFormat::getUid() const
+{
+	return QString("%1_q%2_s%3_f%4").arg(mFormat).arg(mQuality).arg(mScale).arg(mFps);
+}
+
+QByteArray ImageStreamFormat::getMimeType() const
+{
+	return QString("image/%1").arg(mFormat).toLatin1();
+}
+
+bool ImageStreamFormat::isValid() const
+{
+	return (mFormat=="jpeg" || mFormat=="png") && mScale>0 && mFps>0;
+}
+
+///--------------------------------------------------------
+///--------------------------------------------------------
+///--------------------------------------------------------
+
+LayoutImageStreamer::LayoutImageStreamer(GrabFunction grab, ImageStreamFormat format) :
+	mGrab(grab),
+	mFormat(format),
+	mFrameNumber(0),
+	mSkippedGrabs(0)
+{
+	mTimer = new QTimer(this);
+	mTimer->setTimerType(Qt::PreciseTimer);
+	mTimer->setInterval(1000/std::max(1, mFormat.mFps));
+	connect(mTimer, &QTimer::timeout, this, &LayoutImageStreamer::onGrab);
+
+	mEncoder = new QFutureWatcher<QByteArray>(this);
+	connect(mEncoder, &QFutureWatcher<QByteArray>::finished, this, &LayoutImageStreamer::onEncodingFinished);
+}
+
+LayoutImageStreamer::~LayoutImageStreamer()
+{
+	mTimer->stop();
+	mEncoder->waitForFinished();
+
+	for (std::map<QHttpResponse*, Client>::iterator iter=mClients.begin(); iter!=mClients.end(); ++iter)
+	{
+		QHttpResponse* resp = iter->second.mResponse;
+		if (!resp)
+			continue;
+		disconnect(resp, 0, this, 0);
+		resp->end(QByteArray("--"+getBoundary()+"--\r\n"));
+	}
+}
+
+QByteArray LayoutImageStreamer::getBoundary()
+{
+	return "cxframe";
+}
+
+QByteArray LayoutImageStreamer::encode(QImage image, ImageStreamFormat format)
+{
+	if (image.isNull())
+		return QByteArray();
+
+	if (format.mScale < 1.0)
+		image = image.scaled(image.size()*format.mScale, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+
+	QByteArray ba;
+	QBuffer buffer(&ba);
+	buffer.open(QIODevice::WriteOnly);
+	QByteArray type = format.mFormat.toUpper().toLatin1();
+	int quality = (format.mFormat=="png") ? -1 : format.mQuality;
+	image.save(&buffer, type.constData(), quality);
+	return ba;
+}
+
+void LayoutImageStreamer::addClient(QHttpResponse* resp)
+{
+	Client client;
+	client.mResponse = resp;
+	mClients[resp] = client;
+
+	connect(resp, &QHttpResponse::allBytesWritten, this, &LayoutImageStreamer::onClientWritten);
+	connect(resp, &QHttpResponse::done, this, &LayoutImageStreamer::onClientDone);
+
+	resp->setHeader("Content-Type", QString("multipart/x-mixed-replace; boundary=%1").arg(QString(getBoundary())));
+	resp->setHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+	resp->setHeader("Pragma", "no-cache");
+	resp->setHeader("Connection", "close");
+	resp->writeHead(200); // everything is OK
+
+	// give the new client the current frame at once
+	if (!mFrontBuffer.isEmpty())
+		this->sendLatestFrame(mClients[resp]);
+
+	this->start();
+}
+
+int LayoutImageStreamer::getNumberOfClients() const
+{
+	return mClients.size();
+}
+
+void LayoutImageStreamer::start()
+{
+	if (!mTimer->isActive())
+		mTimer->start();
+}
+
+void LayoutImageStreamer::stop()
+{
+	mTimer->stop();
+}
+
+bool LayoutImageStreamer::isStreaming() const
+{
+	return mTimer->isActive();
+}
+
+/** Grab into the back buffer unless it is already waiting for the encoder.
+ */
+void LayoutImageStreamer::onGrab()
+{
+	if (!mBackBuffer.isNull())
+	{
+		++mSkippedGrabs;
+		return;
+	}
+
+	mBackBuffer = mGrab();
+	if (mBackBuffer.isNull())
+		return;
+
+	if (!mEncoder->isRunning())
+		this->startEncoding();
+}
+
+void LayoutImageStreamer::startEncoding()
+{
+	QImage image = mBackBuffer;
+	mBackBuffer = QImage();
+	mEncoder->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), &LayoutImageStreamer::encode, image, mFormat));
+}
+
+void LayoutImageStreamer::onEncodingFinished()
+{
+	QByteArray frame = mEncoder->result();
+	if (!mBackBuffer.isNull())
+		this->startEncoding();
+
+	if (frame.isEmpty())
+		return;
+
+	mFrontBuffer = frame;
+	++mFrameNumber;
+
+	for (std::map<QHttpResponse*, Client>::iterator iter=mClients.begin(); iter!=mClients.end(); ++iter)
+	{
+		if (!iter->second.mWriting)
+			this->sendLatestFrame(iter->second);
+	}
+
+	emit frameEncoded();
+}
+
+void LayoutImageStreamer::sendLatestFrame(Client& client)
+{
+	if (!client.mResponse || client.mLastSentFrame==mFrameNumber)
+		return;
+
+	QByteArray header;
+	header += "--" + getBoundary() + "\r\n";
+	header += "Content-Type: " + mFormat.getMimeType() + "\r\n";
+	header += "Content-Length: " + QByteArray::number(mFrontBuffer.size()) + "\r\n";
+	header += "\r\n";
+
+	client.mWriting = true;
+	client.mLastSentFrame = mFrameNumber;
+	client.mResponse->write(header + mFrontBuffer + "\r\n");
+}
+
+/** The previous frame has been transmitted: send the latest frame if the client
+ *  missed one while writing, skipping any frames in between.
+ */
+void LayoutImageStreamer::onClientWritten()
+{
+	QHttpResponse* resp = dynamic_cast<QHttpResponse*>(sender());
+	std::map<QHttpResponse*, Client>::iterator iter = mClients.find(resp);
+	if (iter==mClients.end())
+		return;
+
+	iter->second.mWriting = false;
+	this->sendLatestFrame(iter->second);
+}
+
+void LayoutImageStreamer::onClientDone()
+{
+	QHttpResponse* resp = dynamic_cast<QHttpResponse*>(sender());
+	mClients.erase(resp);
+	CX_LOG_DEBUG() << QString("Layout image stream client disconnected, %1 remaining").arg(mClients.size());
+
+	if (mClients.empty())
+	{
+		this->stop();
+		emit noClients();
+	}
+}
+
+} // namespace cx
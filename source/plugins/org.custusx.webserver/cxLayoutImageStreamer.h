@@ -0,0 +1,125 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXLAYOUTIMAGESTREAMER_H
+#define CXLAYOUTIMAGESTREAMER_H
+
+#include <map>
+#include <QObject>
+#include <QImage>
+#include <QPointer>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "org_custusx_webserver_Export.h"
+
+class QHttpResponse;
+class QTimer;
+class QUrl;
+template <typename T> class QFutureWatcher;
+
+namespace cx
+{
+
+/**
+ * Encoding and rate of a live image stream.
+ */
+struct org_custusx_webserver_EXPORT ImageStreamFormat
+{
+	ImageStreamFormat();
+	/** Read format=(jpeg|png), quality=(0..100), scale=(0..1) and fps=(int)
+	 *  from the url query. Missing or invalid values keep their defaults.
+	 */
+	static ImageStreamFormat fromUrl(QUrl url);
+
+	QString getUid() const; ///< equal for formats producing identical streams
+	QByteArray getMimeType() const;
+	bool isValid() const;
+
+	QString mFormat; ///< jpeg or png
+	int mQuality; ///< 0..100, ignored for png, which always uses the encoder default
+	double mScale; ///< scale applied to the grabbed image before encoding
+	int mFps; ///< maximum capture rate
+};
+
+/**
+ * Stream images of a layout to any number of http clients,
+ * as a multipart/x-mixed-replace response.
+ *
+ * Images are grabbed on the main thread at a bounded rate into a double
+ * buffer: one image is encoded on the global thread pool while the next
+ * waits. A grab is skipped if both buffers are busy. Each client is sent
+ * the latest encoded frame as soon as it has received the previous one,
+ * thus slow clients skip frames instead of building up a queue.
+ *
+ * Grabbing starts when the first client is added, and stops when the
+ * last client disconnects.
+ *
+ * \date Oct 19, 2026
+ */
+class org_custusx_webserver_EXPORT LayoutImageStreamer : public QObject
+{
+	Q_OBJECT
+public:
+	typedef boost::function<QImage()> GrabFunction;
+
+	LayoutImageStreamer(GrabFunction grab, ImageStreamFormat format);
+	~LayoutImageStreamer();
+
+	void addClient(QHttpResponse* resp);
+	int getNumberOfClients() const;
+	ImageStreamFormat getFormat() const { return mFormat; }
+
+	void start();
+	void stop();
+	bool isStreaming() const;
+	QByteArray getLatestFrame() const { return mFrontBuffer; } ///< latest encoded frame, empty if none
+	qint64 getNumberOfEncodedFrames() const { return mFrameNumber; }
+	int getNumberOfSkippedGrabs() const { return mSkippedGrabs; }
+
+	static QByteArray encode(QImage image, ImageStreamFormat format);
+	static QByteArray getBoundary();
+
+signals:
+	void frameEncoded();
+	void noClients(); ///< emitted when the last client disconnects
+
+private:
+	struct Client
+	{
+		Client() : mLastSentFrame(0), mWriting(false) {}
+		QPointer<QHttpResponse> mResponse;
+		qint64 mLastSentFrame;
+		bool mWriting; ///< waiting for the last frame to be transmitted
+	};
+
+	void onGrab();
+	void onEncodingFinished();
+	void onClientWritten();
+	void onClientDone();
+	void startEncoding();
+	void sendLatestFrame(Client& client);
+
+	GrabFunction mGrab;
+	ImageStreamFormat mFormat;
+	QTimer* mTimer;
+	QFutureWatcher<QByteArray>* mEncoder;
+	QImage mBackBuffer; ///< grabbed, waiting for the encoder
+	QByteArray mFrontBuffer; ///< latest encoded frame, sent to clients
+	qint64 mFrameNumber;
+	int mSkippedGrabs;
+	std::map<QHttpResponse*, Client> mClients;
+};
+typedef boost::shared_ptr<LayoutImageStreamer> LayoutImageStreamerPtr;
+
+} // namespace cx
+
+#endif // CXLAYOUTIMAGESTREAMER_H
@@ -0,0 +1,78 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+#include <QUrl>
+#include <QImage>
+#include "cxLayoutImageStreamer.h"
+#include "cxtestQueuedSignalListener.h"
+
+namespace cxtest
+{
+
+namespace
+{
+QImage createTestImage()
+{
+	QImage image(64, 48, QImage::Format_RGB32);
+	image.fill(Qt::red);
+	return image;
+}
+}
+
+TEST_CASE("ImageStreamFormat: Parses url query", "[unit][plugins][org.custusx.webserver]")
+{
+	cx::ImageStreamFormat format = cx::ImageStreamFormat::fromUrl(QUrl("http://localhost/layout/display/live?format=png&quality=150&scale=0.5&fps=20"));
+	CHECK(format.isValid());
+	CHECK(format.mFormat == "png");
+	CHECK(format.mQuality == 100);
+	CHECK(format.mScale == Approx(0.5));
+	CHECK(format.mFps == 20);
+	CHECK(format.getMimeType() == QByteArray("image/png"));
+
+	cx::ImageStreamFormat defaults = cx::ImageStreamFormat::fromUrl(QUrl("http://localhost/layout/display/live?format=gif&scale=-1"));
+	CHECK(defaults.getUid() == cx::ImageStreamFormat().getUid());
+}
+
+TEST_CASE("LayoutImageStreamer: Encodes scaled jpeg and png", "[unit][plugins][org.custusx.webserver]")
+{
+	cx::ImageStreamFormat format;
+	format.mScale = 0.5;
+
+	format.mFormat = "jpeg";
+	QImage jpeg = QImage::fromData(cx::LayoutImageStreamer::encode(createTestImage(), format), "JPEG");
+	CHECK(jpeg.size() == QSize(32, 24));
+
+	format.mFormat = "png";
+	QImage png = QImage::fromData(cx::LayoutImageStreamer::encode(createTestImage(), format), "PNG");
+	CHECK(png.size() == QSize(32, 24));
+
+	CHECK(cx::LayoutImageStreamer::encode(QImage(), format).isEmpty());
+}
+
+TEST_CASE("LayoutImageStreamer: Grabs and encodes frames without clients", "[unit][plugins][org.custusx.webserver]")
+{
+	cx::ImageStreamFormat format;
+	format.mFps = 50;
+	cx::LayoutImageStreamer streamer(&createTestImage, format);
+	CHECK(streamer.getLatestFrame().isEmpty());
+
+	streamer.start();
+	CHECK(streamer.isStreaming());
+	REQUIRE(waitForQueuedSignal(&streamer, SIGNAL(frameEncoded()), 1000));
+	streamer.stop();
+
+	CHECK(streamer.getNumberOfEncodedFrames() >= 1);
+	CHECK(QImage::fromData(streamer.getLatestFrame(), "JPEG").size() == QSize(64, 48));
+	CHECK(streamer.getNumberOfClients() == 0);
+}
+
+} // namespace cxtest
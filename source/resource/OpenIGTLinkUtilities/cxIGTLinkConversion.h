@@ -48,6 +48,7 @@ public:
     QString decode(igtl::StatusMessage::Pointer msg);
     ImagePtr decode(igtl::ImageMessage::Pointer msg);
 	Transform3D decode(igtl::TransformMessage::Pointer msg);
+	igtl::TransformMessage::Pointer encode(QString deviceName, Transform3D transform, QDateTime timestamp);
 
 	/**
       * Encode the input ProbeDefinition into an IGTLink message. */
@@ -84,7 +84,7 @@ vtkPolyDataPtr IGTLinkConversionPolyData::decodeCoordinateSystem(vtkPolyDataPtr
 	Transform3D rMs = sMr.inv();
 
 	MeshPtr mesh(new Mesh("temp", "temp", polyData));
-	vtkPolyDataPtr poly = mesh->getTransformedPolyDataCopy(rMs);
+	vtkPolyDataPtr poly = mesh->getTransformedPolyData(rMs);
 	return poly;
 }
 
@@ -94,7 +94,7 @@ vtkPolyDataPtr IGTLinkConversionPolyData::encodeCoordinateSystem(MeshPtr mesh, P
 	Transform3D sMr = createTransformFromReferenceToExternal(externalSpace);
 	Transform3D sMd = sMr * rMd;
 
-	vtkPolyDataPtr poly = mesh->getTransformedPolyDataCopy(sMd);
+	vtkPolyDataPtr poly = mesh->getTransformedPolyData(sMd);
 	return poly;
 }
 
@@ -0,0 +1,126 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxDirtyExtentTracker.h"
+
+#include <set>
+#include <vtkImageData.h>
+#include "cxVolumeHelpers.h"
+
+namespace cx
+{
+
+DirtyExtentTracker::DirtyExtentTracker(unsigned maxLength) :
+	mMaxLength(maxLength)
+{
+}
+
+void DirtyExtentTracker::modified(vtkImageDataPtr data, const IntBoundingBox3D& extent)
+{
+	Entry entry;
+	entry.mBefore = data->GetMTime();
+	setDeepModified(data); // the scalars as well, they are checked by some vtk mappers
+	entry.mAfter = data->GetMTime();
+	entry.mExtent = extent;
+
+	mEntries.push_back(entry);
+	while (mEntries.size() > mMaxLength)
+		mEntries.pop_front();
+}
+
+void DirtyExtentTracker::clear()
+{
+	mEntries.clear();
+}
+
+std::vector<IntBoundingBox3D> DirtyExtentTracker::getModifiedSince(vtkImageDataPtr data, unsigned long mtime) const
+{
+	std::vector<IntBoundingBox3D> retval;
+	unsigned long current = data->GetMTime();
+	if (current==mtime)
+		return retval;
+
+	// follow the chain of recorded modifications backwards from the current MTime
+	for (std::deque<Entry>::const_reverse_iterator iter=mEntries.rbegin(); iter!=mEntries.rend(); ++iter)
+	{
+		if (iter->mAfter!=current)
+			break;
+		retval.push_back(iter->mExtent);
+		if (iter->mBefore==mtime)
+			return retval;
+		current = iter->mBefore;
+	}
+
+	retval.clear();
+	retval.push_back(IntBoundingBox3D(data->GetExtent()));
+	return retval;
+}
+
+long DirtyExtentTracker::getNumberOfVoxels(const IntBoundingBox3D& extent)
+{
+	long retval = 1;
+	for (int i=0; i<3; ++i)
+		retval *= std::max(0, extent[2*i+1]-extent[2*i]+1);
+	return retval;
+}
+
+std::vector<IntBoundingBox3D> DirtyExtentTracker::toBricks(const std::vector<IntBoundingBox3D>& extents, const IntBoundingBox3D& wholeExtent, int brickSize)
+{
+	Eigen::Vector3i origin = wholeExtent.bottomLeft();
+
+	// brick indices as (z,y,x), giving x-runs of consecutive bricks when iterated
+	std::set<boost::array<int,3> > dirty;
+	for (unsigned e=0; e<extents.size(); ++e)
+	{
+		Eigen::Vector3i lo, hi;
+		bool empty = false;
+		for (int i=0; i<3; ++i)
+		{
+			int a = std::max(extents[e][2*i], wholeExtent[2*i]);
+			int b = std::min(extents[e][2*i+1], wholeExtent[2*i+1]);
+			empty = empty || (a>b);
+			lo[i] = (a-origin[i])/brickSize;
+			hi[i] = (b-origin[i])/brickSize;
+		}
+		if (empty)
+			continue;
+
+		for (int z=lo[2]; z<=hi[2]; ++z)
+			for (int y=lo[1]; y<=hi[1]; ++y)
+				for (int x=lo[0]; x<=hi[0]; ++x)
+				{
+					boost::array<int,3> index = {{z, y, x}};
+					dirty.insert(index);
+				}
+	}
+
+	std::vector<IntBoundingBox3D> retval;
+	std::set<boost::array<int,3> >::iterator iter = dirty.begin();
+	while (iter!=dirty.end())
+	{
+		int z = (*iter)[0];
+		int y = (*iter)[1];
+		int x0 = (*iter)[2];
+		int x1 = x0;
+		for (++iter; iter!=dirty.end() && (*iter)[0]==z && (*iter)[1]==y && (*iter)[2]==x1+1; ++iter)
+			++x1;
+
+		IntBoundingBox3D brick(origin[0]+x0*brickSize, origin[0]+(x1+1)*brickSize-1,
+							   origin[1]+y*brickSize, origin[1]+(y+1)*brickSize-1,
+							   origin[2]+z*brickSize, origin[2]+(z+1)*brickSize-1);
+		for (int i=0; i<3; ++i)
+			brick[2*i+1] = std::min(brick[2*i+1], wholeExtent[2*i+1]);
+		retval.push_back(brick);
+	}
+	return retval;
+}
+
+} // namespace cx
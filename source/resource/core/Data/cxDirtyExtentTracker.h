@@ -0,0 +1,74 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXDIRTYEXTENTTRACKER_H_
+#define CXDIRTYEXTENTTRACKER_H_
+
+#include "cxResourceExport.h"
+
+#include <deque>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "cxBoundingBox3D.h"
+#include "vtkForwardDeclarations.h"
+
+namespace cx
+{
+typedef boost::shared_ptr<class DirtyExtentTracker> DirtyExtentTrackerPtr;
+
+/** \brief Record of which parts of a vtkImageData that have been modified in place.
+ *
+ * Each call to modified() bumps the MTime of the data and records the
+ * modified extent along with the MTime before and after. A consumer that
+ * has copied the data (e.g. to a GPU texture) remembers the MTime of the copy,
+ * and uses getModifiedSince() to find what must be copied again.
+ *
+ * Modifications not made through modified() break the chain of MTimes,
+ * and the whole extent is then reported as modified.
+ *
+ * Extents are given in the index space of the data, as vtkImageData::GetExtent().
+ *
+ * \ingroup cx_resource_core_data
+ * \date Oct 19, 2026
+ */
+class cxResource_EXPORT DirtyExtentTracker
+{
+public:
+	explicit DirtyExtentTracker(unsigned maxLength=64);
+
+	void modified(vtkImageDataPtr data, const IntBoundingBox3D& extent); ///< mark data and its scalars as modified, and record extent as changed
+	/** Return the extents modified since data had the given MTime:
+	 *  Empty if data is unchanged, the whole extent if the modifications are unknown.
+	 */
+	std::vector<IntBoundingBox3D> getModifiedSince(vtkImageDataPtr data, unsigned long mtime) const;
+	void clear();
+
+	/** Split the extents into bricks of the given size, clipped to wholeExtent.
+	 *  Bricks touched by any extent are returned, neighbouring bricks along x
+	 *  merged into one box.
+	 */
+	static std::vector<IntBoundingBox3D> toBricks(const std::vector<IntBoundingBox3D>& extents, const IntBoundingBox3D& wholeExtent, int brickSize);
+	static long getNumberOfVoxels(const IntBoundingBox3D& extent);
+
+private:
+	struct Entry
+	{
+		unsigned long mBefore;
+		unsigned long mAfter;
+		IntBoundingBox3D mExtent;
+	};
+	std::deque<Entry> mEntries; ///< oldest first
+	unsigned mMaxLength;
+};
+
+} // namespace cx
+
+#endif /* CXDIRTYEXTENTTRACKER_H_ */
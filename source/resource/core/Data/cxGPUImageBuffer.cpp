@@ -22,6 +22,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <boost/cstdint.hpp>
 #include "cxGLHelpers.h"
 #include "cxLogger.h"
+#include "cxDirtyExtentTracker.h"
 
 
 #ifndef WIN32
@@ -51,15 +52,20 @@ public:
 	GLuint textureId;
 	vtkImageDataPtr mTexture;
 	bool mAllocated;
+	bool mUploaded;
 	uint64_t mMTime;
 	int mMemorySize;
+	long mUploadedBytes;
+	DirtyExtentTrackerPtr mDirtyExtents;
 
 	GPUImageDataBufferImpl()
 	{
 		mAllocated = false;
+		mUploaded = false;
 		mMTime = 0;
 		textureId = 0;
 		mMemorySize = 0;
+		mUploadedBytes = 0;
 	}
 	virtual ~GPUImageDataBufferImpl()
 	{
@@ -83,6 +89,14 @@ public:
 	{
 		return textureId;
 	}
+	virtual void setDirtyExtents(DirtyExtentTrackerPtr dirty)
+	{
+		mDirtyExtents = dirty;
+	}
+	virtual long getUploadedBytes() const
+	{
+		return mUploadedBytes;
+	}
 
 	/**Allocate resources for the lookup table and the volume on the GPU.
 	 * Prerequisite: SetImage and SetcolorTable has been called.
@@ -124,6 +138,10 @@ public:
 		{
 			return;
 		}
+
+		std::vector<IntBoundingBox3D> modified;
+		if (mUploaded && mDirtyExtents)
+			modified = mDirtyExtents->getModifiedSince(mTexture, mMTime);
 		mMTime = mTexture->GetMTime();
 		//vtkgl::ActiveTexture(getGLTextureForVolume(textureUnitIndex)); //TODO is this OK?
 		GLenum size,internalType;
@@ -143,6 +161,7 @@ public:
 		glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
 		glTexParameteri( GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
 //		glGenerateMipmap(GL_TEXTURE_3D);
+		int voxelSize = 1;
 		switch (mTexture->GetScalarType())
 		{
 		case VTK_UNSIGNED_CHAR:
@@ -156,6 +175,7 @@ public:
 			size = GL_UNSIGNED_SHORT;
 			internalType = GL_RED; //GL_LUMINANCE16 is deprecated
 			mMemorySize *= 2;
+			voxelSize = 2;
 		}
 			break; //16UI_EXT; break;
 		default:
@@ -168,21 +188,38 @@ public:
 		}
 
 		report_gl_error();
+		GLenum format = 0;
 		if (mTexture->GetNumberOfScalarComponents()==1)
 		{
-			void* data = mTexture->GetPointData()->GetScalars()->GetVoidPointer(0);
-			glTexImage3D(GL_TEXTURE_3D, 0, internalType, dimx, dimy, dimz, 0, GL_RED, size, data);
+			format = GL_RED;
 		}
 		else if (mTexture->GetNumberOfScalarComponents()==3)
 		{
 			internalType = GL_RGB;
-			void* data = mTexture->GetPointData()->GetScalars()->GetVoidPointer(0);
-			glTexImage3D(GL_TEXTURE_3D, 0, internalType, dimx, dimy, dimz, 0, GL_RGB, size, data);
+			format = GL_RGB;
 			mMemorySize *= 3;
+			voxelSize *= 3;
 		}
 		else
 		{
 			std::cout << "unsupported number of image components" << std::endl;
+			return;
+		}
+
+		IntBoundingBox3D wholeExtent(mTexture->GetExtent());
+		bool partial = !modified.empty() && (modified.size()>1 || modified[0]!=wholeExtent);
+		if (partial)
+		{
+			std::vector<IntBoundingBox3D> bricks = DirtyExtentTracker::toBricks(modified, wholeExtent, 32);
+			for (unsigned i=0; i<bricks.size(); ++i)
+				this->uploadSubTexture(bricks[i], format, size, voxelSize);
+		}
+		else
+		{
+			void* data = mTexture->GetPointData()->GetScalars()->GetVoidPointer(0);
+			glTexImage3D(GL_TEXTURE_3D, 0, internalType, dimx, dimy, dimz, 0, format, size, data);
+			mUploadedBytes += mMemorySize;
+			mUploaded = true;
 		}
 
 //		glDisable(GL_TEXTURE_3D);
@@ -190,6 +227,29 @@ public:
 		report_gl_error();
 	}
 
+	/**Send the part of the volume inside region to the bound texture.
+	 */
+	void uploadSubTexture(const IntBoundingBox3D& region, GLenum format, GLenum size, int voxelSize)
+	{
+		int* dim = mTexture->GetDimensions();
+		int* extent = mTexture->GetExtent();
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, dim[0]);
+		glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, dim[1]);
+
+		int x = region[0]-extent[0];
+		int y = region[2]-extent[2];
+		int z = region[4]-extent[4];
+		Eigen::Vector3i range = region.range() + Eigen::Vector3i(1,1,1);
+		unsigned char* data = reinterpret_cast<unsigned char*>(mTexture->GetScalarPointer(region[0], region[2], region[4]));
+		glTexSubImage3D(GL_TEXTURE_3D, 0, x, y, z, range[0], range[1], range[2], format, size, data);
+
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		mUploadedBytes += DirtyExtentTracker::getNumberOfVoxels(region)*voxelSize;
+	}
+
 	/**Activate and bind the volume and lut buffers inside the texture units
 	 * GL_TEXTURE<2X> and GL_TEXTURE<2X+1>.
 	 * Use during RenderInternal()
@@ -579,9 +639,12 @@ int GPUImageBufferRepository::getMemoryUsage(int *textures)
 	return mInternal->mVolumeBuffer.getMemoryUsage(textures);
 }
 
-GPUImageDataBufferPtr GPUImageBufferRepository::getGPUImageDataBuffer(vtkImageDataPtr volume)
+GPUImageDataBufferPtr GPUImageBufferRepository::getGPUImageDataBuffer(vtkImageDataPtr volume, DirtyExtentTrackerPtr dirty)
 {
-	return mInternal->mVolumeBuffer.get(volume);
+	GPUImageDataBufferPtr retval = mInternal->mVolumeBuffer.get(volume);
+	if (dirty)
+		retval->setDirtyExtents(dirty);
+	return retval;
 }
 
 GPUImageLutBufferPtr GPUImageBufferRepository::getGPUImageLutBuffer(vtkUnsignedCharArrayPtr lut)
@@ -24,6 +24,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 namespace cx
 {
+typedef boost::shared_ptr<class DirtyExtentTracker> DirtyExtentTrackerPtr;
 
 /**
  * \file
@@ -55,6 +56,11 @@ public:
 	 */
 	virtual void bind(int textureUnitIndex) = 0;
 	virtual int getMemorySize() = 0;
+	/** Use dirty to find the changed parts of the volume when it is modified,
+	 *  and upload only those. Without it, the entire volume is uploaded.
+	 */
+	virtual void setDirtyExtents(DirtyExtentTrackerPtr dirty) = 0;
+	virtual long getUploadedBytes() const = 0; ///< total number of bytes sent to the GPU
 
 	/** Return the texture uid for this object,
 	  * as generated by glGenTextures().
@@ -115,7 +121,7 @@ public:
 	static GPUImageBufferRepository* getInstance();
 	static void shutdown();
 
-	GPUImageDataBufferPtr getGPUImageDataBuffer(vtkImageDataPtr volume);
+	GPUImageDataBufferPtr getGPUImageDataBuffer(vtkImageDataPtr volume, DirtyExtentTrackerPtr dirty=DirtyExtentTrackerPtr()); ///< dirty: in place modifications of volume, see Image::getDirtyExtents()
 	GPUImageLutBufferPtr getGPUImageLutBuffer(vtkUnsignedCharArrayPtr lut);
 	int getMemoryUsage(int *textures);
 	/**
@@ -14,6 +14,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include <QDomDocument>
 #include <QDir>
+#include <QFileInfo>
 #include <vtkImageAccumulate.h>
 #include <vtkImageReslice.h>
 #include <vtkImageData.h>
@@ -42,6 +43,8 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxUnsignedDerivedImage.h"
 #include "cxEnumConversion.h"
 #include "cxCustomMetaImage.h"
+#include "cxImagePyramid.h"
+#include "cxDirtyExtentTracker.h"
 
 typedef vtkSmartPointer<vtkImageChangeInformation> vtkImageChangeInformationPtr;
 
@@ -106,6 +109,7 @@ Image::~Image()
 Image::Image(const QString& uid, const vtkImageDataPtr& data, const QString& name) :
 	Data(uid, name), mBaseImageData(data), mMaxRGBIntensity(-1), mThresholdPreview(false)
 {
+	mDirtyExtents.reset(new DirtyExtentTracker());
 	mInitialWindowWidth = -1;
 	mInitialWindowLevel = -1;
 
@@ -270,12 +274,23 @@ void Image::setVtkImageData(const vtkImageDataPtr& data, bool resetTransferFunct
 	mBaseImageData = data;
 	mBaseGrayScaleImageData = NULL;
 	mHistogramPtr = NULL;
+	mPyramid.reset();
+	mDirtyExtents->clear();
 
 	if (resetTransferFunctions)
 		this->resetTransferFunctions();
 	emit vtkImageDataChanged(mUid);
 }
 
+void Image::setVtkImageDataModified(const IntBoundingBox3D& extent)
+{
+	mDirtyExtents->modified(mBaseImageData, extent);
+	mBaseGrayScaleImageData = NULL;
+	mHistogramPtr = NULL;
+	mPyramid.reset();
+	emit vtkImageDataChanged(mUid);
+}
+
 vtkImageDataPtr Image::get8bitGrayScaleVtkImageData()
 {
 	double windowWidth = this->getUnmodifiedLookupTable2D()->getWindow();
@@ -571,7 +586,20 @@ bool Image::load(QString path, FileManagerServicePtr filemanager)
 {
 	ImagePtr self = ImagePtr(this, null_deleter());
 	filemanager->readInto(self, path);
-	return this->getBaseVtkImageData()!=0;
+	if (!this->getBaseVtkImageData())
+		return false;
+
+	// Volumes within the render budget are rendered at full resolution,
+	// thus their pyramid is only built if requested by getPyramid().
+	double maxRenderSize = settings()->value("View3D/maxRenderSize").toDouble();
+	if (this->getGrayScaleVtkImageData()->GetNumberOfPoints() <= maxRenderSize)
+		return true;
+
+	mPyramid = ImagePyramid::create(this->getGrayScaleVtkImageData());
+	QDateTime imageTime = QFileInfo(path).lastModified();
+	if (!mPyramid->load(ImagePyramid::getFolderFor(path), imageTime))
+		mPyramid->build();
+	return true;
 }
 
 void Image::parseXml(QDomNode& dataNode)
@@ -922,6 +950,19 @@ void Image::save(const QString& basePath, FileManagerServicePtr filemanager)
 
 	ImagePtr self = ImagePtr(this, null_deleter());
 	filemanager->save(self, filename);
+
+	if (mPyramid && mPyramid->isBuilt())
+		mPyramid->save(ImagePyramid::getFolderFor(filename));
+}
+
+ImagePyramidPtr Image::getPyramid()
+{
+	if (!mPyramid)
+	{
+		mPyramid = ImagePyramid::create(this->getGrayScaleVtkImageData());
+		mPyramid->build();
+	}
+	return mPyramid;
 }
 
 void Image::startThresholdPreview(const Eigen::Vector2d &threshold)
@@ -34,6 +34,8 @@ namespace cx
 {
 typedef std::map<int, int> IntIntMap;
 typedef std::map<int, QColor> ColorMap;
+typedef boost::shared_ptr<class ImagePyramid> ImagePyramidPtr;
+typedef boost::shared_ptr<class DirtyExtentTracker> DirtyExtentTrackerPtr;
 
 /** \brief A volumetric data set.
  *
@@ -73,6 +75,12 @@ public:
 	 */
 	virtual void intitializeFromParentImage(ImagePtr parentImage);
 	virtual void setVtkImageData(const vtkImageDataPtr& data, bool resetTransferFunctions = true);
+	/** Call after changing the given extent of getBaseVtkImageData() in place.
+	 *  Consumers such as GPU textures then update only the changed part,
+	 *  and the transfer functions are kept. Used by the EraserWidget.
+	 */
+	void setVtkImageDataModified(const IntBoundingBox3D& extent);
+	DirtyExtentTrackerPtr getDirtyExtents() { return mDirtyExtents; } ///< in place modifications of getBaseVtkImageData()
 
 	virtual vtkImageDataPtr getBaseVtkImageData(); ///< \return the vtkimagedata in the data coordinate space
 	virtual vtkImageDataPtr getGrayScaleVtkImageData(); ///< as getBaseVtkImageData(), but constrained to 1 component if multicolor.
@@ -149,6 +157,11 @@ public:
 	int getInterpolationType() const;
 
 	vtkImageDataPtr resample(long maxVoxels);
+	/** Multi-resolution version of getGrayScaleVtkImageData().
+	 *  Built in the background on first call, or on load for volumes larger than
+	 *  the View3D/maxRenderSize budget, and saved along with the image.
+	 */
+	ImagePyramidPtr getPyramid();
 
 	virtual void save(const QString &basePath, FileManagerServicePtr filemanager);
 
@@ -174,6 +187,8 @@ protected:
 //	vtkImageDataPtr mReferenceImageData; ///< imagedata after filtering through the orientatior, given in reference space
 	vtkImageAccumulatePtr mHistogramPtr;///< Histogram
 	ImagePtr mUnsigned; ///< version of this containing unsigned data.
+	ImagePyramidPtr mPyramid;
+	DirtyExtentTrackerPtr mDirtyExtents;
 
 //	LandmarksPtr mLandmarks;
 
@@ -0,0 +1,219 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxImagePyramid.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <vtkImageData.h>
+#include <vtkImageShrink3D.h>
+#include <vtkMetaImageWriter.h>
+#include <vtkMetaImageReader.h>
+#include "cxWorkScheduler.h"
+#include "cxTypeConversions.h"
+#include "cxLogger.h"
+
+namespace cx
+{
+
+ImagePyramidPtr ImagePyramid::create(vtkImageDataPtr base, long minVoxels)
+{
+	return ImagePyramidPtr(new ImagePyramid(base, minVoxels));
+}
+
+ImagePyramid::ImagePyramid(vtkImageDataPtr base, long minVoxels) :
+	mMinVoxels(minVoxels),
+	mLevels(new Levels())
+{
+	mLevels->mLevels.push_back(base);
+	mLevels->mOwner = this;
+}
+
+ImagePyramid::~ImagePyramid()
+{
+	mLevels->mCancel.store(1);
+	QMutexLocker sentry(&mLevels->mOwnerMutex);
+	mLevels->mOwner = NULL;
+}
+
+void ImagePyramid::build()
+{
+	if (!mBuildStarted.testAndSetOrdered(0, 1))
+		return;
+	boost::function<void()> function = boost::bind(&ImagePyramid::buildLevels, mLevels, mMinVoxels);
+	mBuild = WorkScheduler::getInstance()->run<void>(function, wpBACKGROUND);
+}
+
+bool ImagePyramid::isBuilt() const
+{
+	return mBuildStarted.load() && mBuild.isFinished();
+}
+
+void ImagePyramid::waitForBuilt()
+{
+	mBuild.waitForFinished();
+}
+
+void ImagePyramid::buildLevels(LevelsPtr levels, long minVoxels)
+{
+	vtkImageDataPtr current;
+	{
+		QMutexLocker sentry(&levels->mMutex);
+		current = levels->mLevels.back();
+	}
+
+	while (!levels->mCancel.load() && !isCoarsest(current, minVoxels))
+	{
+		current = downsample(current);
+
+		int level = 0;
+		{
+			QMutexLocker sentry(&levels->mMutex);
+			levels->mLevels.push_back(current);
+			level = levels->mLevels.size()-1;
+		}
+
+		QMutexLocker sentry(&levels->mOwnerMutex);
+		if (levels->mOwner)
+			emit levels->mOwner->levelAdded(level);
+	}
+}
+
+bool ImagePyramid::isCoarsest(vtkImageDataPtr level, long minVoxels)
+{
+	if (!level)
+		return true;
+	int* dim = level->GetDimensions();
+	bool singleVoxel = (dim[0]<=1) && (dim[1]<=1) && (dim[2]<=1);
+	return singleVoxel || (level->GetNumberOfPoints() <= minVoxels);
+}
+
+vtkImageDataPtr ImagePyramid::downsample(vtkImageDataPtr input)
+{
+	int* dim = input->GetDimensions();
+	vtkImageShrink3DPtr shrinker = vtkImageShrink3DPtr::New();
+	shrinker->SetInputData(input);
+	shrinker->SetShrinkFactors(dim[0]>1 ? 2 : 1, dim[1]>1 ? 2 : 1, dim[2]>1 ? 2 : 1);
+	shrinker->MeanOn();
+	shrinker->Update();
+	return shrinker->GetOutput();
+}
+
+int ImagePyramid::getNumberOfLevels() const
+{
+	QMutexLocker sentry(&mLevels->mMutex);
+	return mLevels->mLevels.size();
+}
+
+vtkImageDataPtr ImagePyramid::getLevel(int level) const
+{
+	QMutexLocker sentry(&mLevels->mMutex);
+	if (level<0 || level>=int(mLevels->mLevels.size()))
+		return vtkImageDataPtr();
+	return mLevels->mLevels[level];
+}
+
+vtkImageDataPtr ImagePyramid::getLevelForMaxVoxels(long maxVoxels) const
+{
+	QMutexLocker sentry(&mLevels->mMutex);
+	const std::vector<vtkImageDataPtr>& levels = mLevels->mLevels;
+	for (unsigned i=0; i<levels.size(); ++i)
+	{
+		if (maxVoxels==0 || levels[i]->GetNumberOfPoints() <= maxVoxels)
+			return levels[i];
+	}
+	return vtkImageDataPtr();
+}
+
+QString ImagePyramid::getFolderFor(QString imageFilename)
+{
+	QFileInfo info(imageFilename);
+	return info.absolutePath() + "/" + info.completeBaseName() + "_pyramid";
+}
+
+bool ImagePyramid::save(QString folder) const
+{
+	int levels = this->getNumberOfLevels();
+	if (levels<2)
+		return true;
+
+	QDir().mkpath(folder);
+	vtkMetaImageWriterPtr writer = vtkMetaImageWriterPtr::New();
+	for (int i=1; i<levels; ++i)
+	{
+		QString filename = QString("%1/level%2.mhd").arg(folder).arg(i);
+		writer->SetInputData(this->getLevel(i));
+		writer->SetFileName(cstring_cast(filename));
+		writer->SetCompression(false);
+		writer->Write();
+	}
+	return true;
+}
+
+bool ImagePyramid::load(QString folder, QDateTime notOlderThan)
+{
+	if (mBuildStarted.load())
+		return false;
+
+	std::vector<vtkImageDataPtr> levels;
+	vtkImageDataPtr previous = this->getLevel(0);
+	for (int i=1; ; ++i)
+	{
+		QFileInfo info(QString("%1/level%2.mhd").arg(folder).arg(i));
+		if (!info.exists())
+			break;
+		if (info.lastModified() < notOlderThan)
+			return false;
+
+		vtkMetaImageReaderPtr reader = vtkMetaImageReaderPtr::New();
+		reader->SetFileName(cstring_cast(info.absoluteFilePath()));
+		reader->Update();
+		vtkImageDataPtr level = reader->GetOutput();
+		if (!this->isValidDownsampling(previous, level))
+		{
+			reportWarning(QString("Discarding outdated image pyramid in %1").arg(folder));
+			return false;
+		}
+		levels.push_back(level);
+		previous = level;
+	}
+
+	if (levels.empty() || !isCoarsest(previous, mMinVoxels))
+		return false;
+	if (!mBuildStarted.testAndSetOrdered(0, 1)) // nothing left to build
+		return false;
+
+	QMutexLocker sentry(&mLevels->mMutex);
+	mLevels->mLevels.insert(mLevels->mLevels.end(), levels.begin(), levels.end());
+	return true;
+}
+
+bool ImagePyramid::isValidDownsampling(vtkImageDataPtr fine, vtkImageDataPtr coarse) const
+{
+	if (!fine || !coarse)
+		return false;
+	if (fine->GetScalarType()!=coarse->GetScalarType())
+		return false;
+	if (fine->GetNumberOfScalarComponents()!=coarse->GetNumberOfScalarComponents())
+		return false;
+
+	int* fineDim = fine->GetDimensions();
+	int* coarseDim = coarse->GetDimensions();
+	for (int i=0; i<3; ++i)
+	{
+		int expected = (fineDim[i]>1) ? fineDim[i]/2 : 1;
+		if (abs(coarseDim[i]-expected) > 1)
+			return false;
+	}
+	return true;
+}
+
+} // namespace cx
@@ -0,0 +1,102 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXIMAGEPYRAMID_H_
+#define CXIMAGEPYRAMID_H_
+
+#include "cxResourceExport.h"
+
+#include <vector>
+#include <QObject>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QFuture>
+#include <QDateTime>
+#include <boost/shared_ptr.hpp>
+#include "vtkForwardDeclarations.h"
+
+namespace cx
+{
+typedef boost::shared_ptr<class ImagePyramid> ImagePyramidPtr;
+
+/** \brief Multi-resolution representation of a volume.
+ *
+ * Level 0 is the input volume. Each following level halves the resolution
+ * along all axes with more than one voxel, using box averaging, until the
+ * level is smaller than a minimum number of voxels.
+ *
+ * build() computes the levels in the background through the WorkScheduler.
+ * Each level is downsampled by a multithreaded vtk filter. Levels are
+ * available as soon as they are built, and levelAdded() is emitted for each.
+ * The levels are shared with the build job, thus the pyramid can be
+ * destroyed without waiting for the job, which stops after the current level.
+ *
+ * The levels can be persisted in a folder next to the image file,
+ * see getFolderFor().
+ *
+ * \ingroup cx_resource_core_data
+ * \date Oct 19, 2026
+ */
+class cxResource_EXPORT ImagePyramid : public QObject
+{
+	Q_OBJECT
+public:
+	static ImagePyramidPtr create(vtkImageDataPtr base, long minVoxels=64*64*64);
+	virtual ~ImagePyramid();
+
+	void build(); ///< start building the missing levels in the background. Does nothing if already started.
+	bool isBuilt() const; ///< all levels are available
+	void waitForBuilt(); ///< block until build() has completed
+
+	int getNumberOfLevels() const; ///< number of levels available, including the base
+	vtkImageDataPtr getLevel(int level) const;
+	/** Return the finest available level with at most maxVoxels voxels,
+	 *  or null if none fit. maxVoxels==0 means no limit.
+	 */
+	vtkImageDataPtr getLevelForMaxVoxels(long maxVoxels) const;
+
+	bool save(QString folder) const; ///< write all levels except the base to folder
+	bool load(QString folder, QDateTime notOlderThan); ///< read levels written by save(). Return false if missing or outdated.
+
+	static QString getFolderFor(QString imageFilename); ///< folder used to persist the pyramid of the given image file
+	static vtkImageDataPtr downsample(vtkImageDataPtr input);
+
+signals:
+	void levelAdded(int level); ///< may be emitted from a worker thread
+
+private:
+	/** Levels shared between the pyramid and the build job.
+	 */
+	struct Levels
+	{
+		Levels() : mOwner(NULL) {}
+		QMutex mMutex; ///< protects mLevels
+		std::vector<vtkImageDataPtr> mLevels;
+		QAtomicInt mCancel;
+		QMutex mOwnerMutex; ///< protects mOwner
+		ImagePyramid* mOwner; ///< receiver of levelAdded(), NULL when destroyed
+	};
+	typedef boost::shared_ptr<Levels> LevelsPtr;
+
+	ImagePyramid(vtkImageDataPtr base, long minVoxels);
+	static void buildLevels(LevelsPtr levels, long minVoxels);
+	static bool isCoarsest(vtkImageDataPtr level, long minVoxels);
+	bool isValidDownsampling(vtkImageDataPtr fine, vtkImageDataPtr coarse) const;
+
+	long mMinVoxels;
+	LevelsPtr mLevels;
+	QFuture<void> mBuild;
+	QAtomicInt mBuildStarted;
+};
+
+} // namespace cx
+
+#endif /* CXIMAGEPYRAMID_H_ */
@@ -15,6 +15,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <vtkColorSeries.h>
 #include <vtkPolyData.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <QDomDocument>
 #include <QColor>
 #include <QDir>
@@ -32,6 +33,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxFileManagerService.h"
 #include "cxLogger.h"
 #include "cxNullDeleter.h"
+#include "cxWorkScheduler.h"
 
 namespace cx
 {
@@ -91,6 +93,10 @@ bool Mesh::load(QString path, FileManagerServicePtr filemanager)
 
 void Mesh::setVtkPolyData(const vtkPolyDataPtr& polyData)
 {
+	{
+		QMutexLocker sentry(&mTransformedPolyDataMutex);
+		mTransformedPolyData = TransformedPolyData();
+	}
 	mVtkPolyData = polyData;
 	mVtkPolyDataOriginal = mVtkPolyData;
 	mOrientationArrayList.clear();
@@ -412,30 +418,68 @@ DoubleBoundingBox3D Mesh::boundingBox() const
 
 vtkPolyDataPtr Mesh::getTransformedPolyDataCopy(Transform3D transform)
 {
-	// if transform elements exists, create a copy with entire position inside the polydata:
-    if (similar(transform, Transform3D::Identity()))
-    {
-        vtkPolyDataPtr poly = vtkPolyDataPtr::New();
-        poly->DeepCopy(getVtkPolyData());
-        return poly;
-    }
+	vtkPolyDataPtr poly = vtkPolyDataPtr::New();
+	poly->DeepCopy(this->getTransformedPolyData(transform));
+	return poly;
+}
+
+vtkPolyDataPtr Mesh::getTransformedPolyData(Transform3D transform)
+{
+	vtkPolyDataPtr source = this->getVtkPolyData();
+	if (similar(transform, Transform3D::Identity()))
+		return source;
+
+	QMutexLocker sentry(&mTransformedPolyDataMutex);
+	TransformedPolyData& cache = mTransformedPolyData;
+	bool valid = cache.mResult
+			&& (cache.mSource==source)
+			&& (cache.mSourceMTime==source->GetMTime())
+			&& (cache.mTransform.matrix()==transform.matrix());
+	if (!valid)
+	{
+		cache.mResult = createTransformedPolyData(source, transform);
+		cache.mSource = source;
+		cache.mSourceMTime = source->GetMTime();
+		cache.mTransform = transform;
+	}
+	return cache.mResult;
+}
+
+namespace
+{
+void transformPointsRange(vtkPoints* input, float* output, const Transform3D* transform, qint64 begin, qint64 end)
+{
+	for (vtkIdType i = begin; i < end; ++i)
+	{
+		Vector3D p;
+		input->GetPoint(i, p.data());
+		p = transform->coord(p);
+		std::copy(p.data(), p.data()+3, output+3*i);
+	}
+}
+}
 
+/** Shallow copy of source with only the points replaced by transformed
+ *  single precision points. Large point sets are transformed in parallel.
+ */
+vtkPolyDataPtr Mesh::createTransformedPolyData(vtkPolyDataPtr source, Transform3D transform)
+{
 	vtkPolyDataPtr poly = vtkPolyDataPtr::New();
-	poly->DeepCopy(getVtkPolyData());
-	vtkPointsPtr points = poly->GetPoints();
+	poly->ShallowCopy(source);
+	vtkPoints* points = source->GetPoints();
+	if (!points)
+		return poly;
 
+	vtkIdType size = points->GetNumberOfPoints();
 	vtkPointsPtr floatPoints = vtkPointsPtr::New();
-	floatPoints->DeepCopy(points);
 	floatPoints->SetDataTypeToFloat();
-	for (int i = 0; i < poly->GetNumberOfPoints(); ++i)
-	{
-		Vector3D p(points->GetPoint(i));
-		p = transform.coord(p);
-		floatPoints->SetPoint(i, p.begin());
-	}
+	floatPoints->SetNumberOfPoints(size);
+	float* output = static_cast<float*>(floatPoints->GetVoidPointer(0));
+
+	WorkScheduler::getInstance()->parallelFor(size, 100000, boost::bind(&transformPointsRange, points, output, &transform, _1, _2));
+
 	poly->SetPoints(floatPoints.GetPointer());
 	poly->Modified();
-
 	return poly;
 }
 
@@ -26,6 +26,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxMeshPropertyData.h"
 
 #include <QColor>
+#include <QMutex>
 #include "cxData.h"
 
 class QDomNode;
@@ -80,6 +81,11 @@ public:
 	void setIsWireframe(bool on);///< Set rep to wireframe, false means surface
 	bool getIsWireframe() const;///< true=wireframe, false=surface
 	vtkPolyDataPtr getTransformedPolyDataCopy(Transform3D tranform);///< Create a new transformed polydata
+	/** Return the polydata transformed, without copying more than the points.
+	 *  The result is cached until the polydata or transform changes,
+	 *  and shares cells and attributes with the mesh: Do not modify it.
+	 */
+	vtkPolyDataPtr getTransformedPolyData(Transform3D transform);
 	bool isFiberBundle() const;
 	bool showGlyph();
 	bool hasGlyph();
@@ -123,6 +129,18 @@ private:
 	QStringList mColorArrayList;
 	MeshPropertyData mProperties;
 	MeshTextureData mTextureData;
+
+	struct TransformedPolyData
+	{
+		TransformedPolyData() : mTransform(Transform3D::Identity()), mSourceMTime(0) {}
+		Transform3D mTransform;
+		vtkPolyDataPtr mSource;
+		unsigned long mSourceMTime;
+		vtkPolyDataPtr mResult;
+	};
+	TransformedPolyData mTransformedPolyData; ///< cache for getTransformedPolyData()
+	QMutex mTransformedPolyDataMutex;
+	static vtkPolyDataPtr createTransformedPolyData(vtkPolyDataPtr source, Transform3D transform);
 };
 
 typedef boost::shared_ptr<Mesh> MeshPtr;
@@ -0,0 +1,164 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxTrackedFrameHistory.h"
+
+#include <string.h>
+#include <vtkImageData.h>
+
+namespace cx
+{
+
+TrackedFrameHistory::TrackedFrameHistory(long maxBytes) :
+	mMaxBytes(maxBytes),
+	mStart(0),
+	mSize(0)
+{
+}
+
+void TrackedFrameHistory::setMaxBytes(long maxBytes)
+{
+	mMaxBytes = maxBytes;
+	mSlots.clear();
+	this->clear();
+}
+
+long TrackedFrameHistory::getMaxBytes() const
+{
+	return mMaxBytes;
+}
+
+void TrackedFrameHistory::clear()
+{
+	mStart = 0;
+	mSize = 0;
+}
+
+int TrackedFrameHistory::size() const
+{
+	return mSize;
+}
+
+int TrackedFrameHistory::getCapacity() const
+{
+	return mSlots.size();
+}
+
+long TrackedFrameHistory::getNumberOfBytes(vtkImageDataPtr image)
+{
+	return image->GetNumberOfPoints() * image->GetScalarSize() * image->GetNumberOfScalarComponents();
+}
+
+bool TrackedFrameHistory::hasSameFormat(vtkImageDataPtr a, vtkImageDataPtr b)
+{
+	if (!a || !b)
+		return false;
+	int* ea = a->GetExtent();
+	int* eb = b->GetExtent();
+	for (int i=0; i<6; ++i)
+		if (ea[i]!=eb[i])
+			return false;
+	return (a->GetScalarType()==b->GetScalarType())
+			&& (a->GetNumberOfScalarComponents()==b->GetNumberOfScalarComponents());
+}
+
+void TrackedFrameHistory::add(vtkImageDataPtr image, double timestamp, Transform3D rMu, bool hasPose)
+{
+	if (!image || mMaxBytes<=0)
+		return;
+
+	if (mSlots.empty() || !hasSameFormat(mSlots[0].mImage, image))
+	{
+		long frameBytes = std::max<long>(1, getNumberOfBytes(image));
+		long capacity = std::max<long>(1, mMaxBytes/frameBytes);
+		mSlots.assign(capacity, TrackedFrame());
+		this->clear();
+	}
+	else if (mSize && timestamp < this->getFrame(mSize-1).mTimestamp)
+	{
+		this->clear();
+	}
+
+	int slot = this->getSlotIndex(mSize);
+	if (mSize==int(mSlots.size())) // full: overwrite the oldest
+	{
+		slot = mStart;
+		mStart = (mStart+1) % mSlots.size();
+	}
+	else
+	{
+		++mSize;
+	}
+
+	this->copy(image, mSlots[slot]);
+	mSlots[slot].mTimestamp = timestamp;
+	mSlots[slot].m_rMu = rMu;
+	mSlots[slot].mHasPose = hasPose;
+}
+
+void TrackedFrameHistory::copy(vtkImageDataPtr source, TrackedFrame& slot)
+{
+	// reuse the buffer unless someone else holds on to it
+	bool reuse = slot.mImage && (slot.mImage->GetReferenceCount()==1) && hasSameFormat(slot.mImage, source);
+	if (!reuse)
+	{
+		slot.mImage = vtkImageDataPtr::New();
+		slot.mImage->DeepCopy(source);
+		return;
+	}
+
+	memcpy(slot.mImage->GetScalarPointer(), source->GetScalarPointer(), getNumberOfBytes(source));
+	slot.mImage->SetOrigin(source->GetOrigin());
+	slot.mImage->SetSpacing(source->GetSpacing());
+	slot.mImage->Modified();
+}
+
+int TrackedFrameHistory::getSlotIndex(int index) const
+{
+	if (mSlots.empty())
+		return 0;
+	return (mStart+index) % mSlots.size();
+}
+
+TrackedFrame TrackedFrameHistory::getFrame(int index) const
+{
+	if (index<0 || index>=mSize)
+		return TrackedFrame();
+	return mSlots[this->getSlotIndex(index)];
+}
+
+int TrackedFrameHistory::findClosest(double timestamp) const
+{
+	if (!mSize)
+		return -1;
+
+	// first frame not older than timestamp
+	int lo = 0;
+	int hi = mSize;
+	while (lo < hi)
+	{
+		int mid = (lo+hi)/2;
+		if (mSlots[this->getSlotIndex(mid)].mTimestamp < timestamp)
+			lo = mid+1;
+		else
+			hi = mid;
+	}
+
+	if (lo==mSize)
+		return mSize-1;
+	if (lo==0)
+		return 0;
+	double after = mSlots[this->getSlotIndex(lo)].mTimestamp - timestamp;
+	double before = timestamp - mSlots[this->getSlotIndex(lo-1)].mTimestamp;
+	return (before <= after) ? lo-1 : lo;
+}
+
+} // namespace cx
@@ -0,0 +1,82 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXTRACKEDFRAMEHISTORY_H_
+#define CXTRACKEDFRAMEHISTORY_H_
+
+#include "cxResourceExport.h"
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "cxTransform3D.h"
+#include "vtkForwardDeclarations.h"
+
+namespace cx
+{
+typedef boost::shared_ptr<class TrackedFrameHistory> TrackedFrameHistoryPtr;
+
+/** \brief A video frame with its timestamp and pose.
+ *
+ * \ingroup cx_resource_core_data
+ */
+struct cxResource_EXPORT TrackedFrame
+{
+	TrackedFrame() : mTimestamp(0), m_rMu(Transform3D::Identity()), mHasPose(false) {}
+	vtkImageDataPtr mImage;
+	double mTimestamp; ///< ms, as VideoSource::getTimestamp()
+	Transform3D m_rMu; ///< pose of the frame in reference space, valid if mHasPose
+	bool mHasPose;
+};
+
+/** \brief Ring buffer of the most recent frames of a stream.
+ *
+ * The frames are copied into a fixed set of image buffers, as many as
+ * fit in the given memory budget, and the oldest frame is overwritten
+ * when the buffer is full. A buffer still referenced from outside,
+ * e.g. by a frame under review, is replaced instead of overwritten.
+ *
+ * Frames must be added in increasing time order: An older timestamp,
+ * or a change of frame format, restarts the history.
+ * Lookup by timestamp is a binary search.
+ *
+ * \ingroup cx_resource_core_data
+ * \date Oct 19, 2026
+ */
+class cxResource_EXPORT TrackedFrameHistory
+{
+public:
+	explicit TrackedFrameHistory(long maxBytes);
+
+	void setMaxBytes(long maxBytes); ///< set the memory budget. 0 disables the history. Clears the history.
+	long getMaxBytes() const;
+	void add(vtkImageDataPtr image, double timestamp, Transform3D rMu, bool hasPose); ///< copy image into the history
+	void clear();
+
+	int size() const;
+	int getCapacity() const; ///< number of frames that fit in the budget for the current frame format
+	TrackedFrame getFrame(int index) const; ///< 0 is the oldest frame, size()-1 the latest
+	int findClosest(double timestamp) const; ///< index of the frame closest in time, -1 if empty
+
+private:
+	static long getNumberOfBytes(vtkImageDataPtr image);
+	static bool hasSameFormat(vtkImageDataPtr a, vtkImageDataPtr b);
+	void copy(vtkImageDataPtr source, TrackedFrame& slot);
+	int getSlotIndex(int index) const;
+
+	long mMaxBytes;
+	std::vector<TrackedFrame> mSlots;
+	int mStart; ///< slot of the oldest frame
+	int mSize;
+};
+
+} // namespace cx
+
+#endif /* CXTRACKEDFRAMEHISTORY_H_ */
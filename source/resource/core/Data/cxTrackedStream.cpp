@@ -19,6 +19,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include "cxProbeSector.h"
 #include "cxSpaceProvider.h"
+#include "cxSettings.h"
 
 namespace cx
 {
@@ -31,7 +32,8 @@ TrackedStreamPtr TrackedStream::create(const QString &uid, const QString &name)
 TrackedStream::TrackedStream(const QString& uid, const QString& name, const ToolPtr &probe, const VideoSourcePtr &videosource) :
 	Data(uid, name), mProbeTool(probe), mVideoSource(VideoSourcePtr()),
 	mImage(ImagePtr()),
-	mSpaceProvider(SpaceProviderPtr())
+	mSpaceProvider(SpaceProviderPtr()),
+	mFrameHistoryMaxBytes(-1)
 {
 	if(mProbeTool)
 		emit newTool(mProbeTool);
@@ -105,6 +107,8 @@ void TrackedStream::setVideoSource(const VideoSourcePtr &videoSource)
 	}
 
 	mVideoSource = videoSource;
+	if (mFrameHistory)
+		mFrameHistory->clear();
 	emit streamChanged(this->getUid());
 	emit newVideoSource(mVideoSource);
 
@@ -117,6 +121,14 @@ void TrackedStream::setVideoSource(const VideoSourcePtr &videoSource)
 
 void TrackedStream::newFrameSlot()
 {
+	if (mFrameHistory && mFrameHistory->getMaxBytes()>0 && mVideoSource && mVideoSource->isStreaming())
+	{
+		double timestamp = mVideoSource->getTimestamp();
+		Transform3D rMu = Transform3D::Identity();
+		bool hasPose = this->getPoseAt(timestamp, &rMu);
+		mFrameHistory->add(mVideoSource->getVtkImageData(), timestamp, rMu, hasPose);
+	}
+
 	//TODO: Check if we need to turn this on/off
 	if (mImage && mVideoSource && mVideoSource->isStreaming())
 	{
@@ -125,6 +137,50 @@ void TrackedStream::newFrameSlot()
 	}
 }
 
+/** Find the probe pose closest in time to timestamp, from the tool position history.
+ */
+bool TrackedStream::getPoseAt(double timestamp, Transform3D* rMu)
+{
+	if (!mProbeTool || !mSpaceProvider || !mProbeTool->getProbe())
+		return false;
+	TimedTransformMapPtr history = mProbeTool->getPositionHistory();
+	if (!history || history->empty())
+		return false;
+
+	TimedTransformMap::iterator iter = history->lower_bound(timestamp);
+	if (iter==history->end())
+		--iter;
+	else if (iter!=history->begin())
+	{
+		TimedTransformMap::iterator previous = iter;
+		--previous;
+		if (timestamp - previous->first <= iter->first - timestamp)
+			iter = previous;
+	}
+
+	*rMu = mSpaceProvider->get_rMpr() * iter->second * this->get_tMu();
+	return true;
+}
+
+TrackedFrameHistoryPtr TrackedStream::getFrameHistory()
+{
+	if (!mFrameHistory)
+	{
+		long maxBytes = mFrameHistoryMaxBytes;
+		if (maxBytes<0)
+			maxBytes = settings()->value("Video/frameHistoryMaxBytes").toLongLong();
+		mFrameHistory.reset(new TrackedFrameHistory(maxBytes));
+	}
+	return mFrameHistory;
+}
+
+void TrackedStream::setFrameHistoryMaxBytes(long maxBytes)
+{
+	mFrameHistoryMaxBytes = maxBytes;
+	if (mFrameHistory)
+		mFrameHistory->setMaxBytes(maxBytes);
+}
+
 VideoSourcePtr TrackedStream::getVideoSource()
 {
 	return mVideoSource;
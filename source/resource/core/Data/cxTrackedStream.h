@@ -13,6 +13,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #define CXTRACKEDSTREAM_H
 
 #include "cxImage.h"
+#include "cxTrackedFrameHistory.h"
 
 namespace cx
 {
@@ -21,6 +22,10 @@ namespace cx
  *
  * Allowing video stream as a data type
  *
+ * The most recent frames can be kept in a TrackedFrameHistory, each paired
+ * with the probe pose closest in time to the frame. The history is created,
+ * and recording started, on the first call to getFrameHistory().
+ *
  * \ingroup cx_resource_core_data
  *
  * \date jan 28, 2015
@@ -55,6 +60,9 @@ public:
 	bool is2D();
 	bool hasVideo() const;
 	bool isStreaming() const;
+
+	TrackedFrameHistoryPtr getFrameHistory(); ///< recent frames with timestamp and pose. Start recording on first call.
+	void setFrameHistoryMaxBytes(long maxBytes); ///< memory used for the frame history, default from setting Video/frameHistoryMaxBytes. 0 disables it.
 signals:
 	void streamChanged(QString uid);
 	void newTool(ToolPtr tool);
@@ -72,7 +80,10 @@ private:
 	ImagePtr mImage;
 
 	SpaceProviderPtr mSpaceProvider;
+	TrackedFrameHistoryPtr mFrameHistory; ///< null until requested
+	long mFrameHistoryMaxBytes; ///< -1 means use the setting
 	Transform3D get_tMu();
+	bool getPoseAt(double timestamp, Transform3D* rMu);
 };
 
 typedef boost::shared_ptr<TrackedStream> TrackedStreamPtr;
@@ -36,6 +36,10 @@ DummyToolManager::DummyToolManager() :
 	mReferenceTool = tool1;
 
 	mDummyTools.insert(std::pair<QString, DummyToolPtr>(tool1->getUid(), tool1));
+
+	mUpdateBus = new TrackingUpdateBus(this);
+	connect(mUpdateBus, &TrackingUpdateBus::snapshotReady, this, &TrackingService::toolsUpdated);
+	mUpdateBus->setTools(this->getTools());
 }
 DummyToolManager::~ DummyToolManager()
 {}
@@ -120,6 +124,7 @@ ToolPtr DummyToolManager::getReferenceTool() const
 void DummyToolManager::addTool(DummyToolPtr tool)
 {
 	mDummyTools.insert(std::make_pair(tool->getUid(), tool));
+	mUpdateBus->setTools(this->getTools());
 }
 
 //void DummyToolManager::setTooltipOffset(double offset)
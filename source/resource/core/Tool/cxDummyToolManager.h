@@ -95,6 +95,7 @@ private:
 //	bool mInitialized;
 //	bool mIsTracking;
 	Tool::State mState;
+	TrackingUpdateBus* mUpdateBus;
 };
 
 }//namespace cx
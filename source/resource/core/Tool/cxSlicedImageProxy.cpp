@@ -13,6 +13,8 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxSlicedImageProxy.h"
 
 #include <vtkImageReslice.h>
+#include <vtkImageResliceToColors.h>
+#include <vtkLookupTable.h>
 #include <vtkImageMapToWindowLevelColors.h>
 #include <vtkWindowLevelLookupTable.h>
 #include <vtkImageData.h>
@@ -120,7 +122,8 @@ vtkImageDataPtr ApplyLUTToImage2DProxy::getOutput()
 ///--------------------------------------------------------
 
 
-SlicedImageProxy::SlicedImageProxy()
+SlicedImageProxy::SlicedImageProxy() :
+	mFusedResliceAndLUT(true)
 {
 	mMatrixAxes = vtkMatrix4x4Ptr::New();
 
@@ -131,9 +134,18 @@ SlicedImageProxy::SlicedImageProxy()
 	//mReslicer->SetAutoCropOutput(false); //faster update rate
 	mReslicer->AutoCropOutputOn(); // fix used in 2.0.9, but slower update rate
 
+	mResliceWithLUT = vtkImageResliceToColorsPtr::New();
+	mResliceWithLUT->SetInterpolationModeToLinear();
+	mResliceWithLUT->SetOutputDimensionality(2);
+	mResliceWithLUT->SetResliceAxes(mMatrixAxes);
+	mResliceWithLUT->AutoCropOutputOn();
+	mResliceWithLUT->SetOutputFormatToRGBA();
+
 	mImageWithLUTProxy.reset(new ApplyLUTToImage2DProxy());
 
 	mRedirecter = vtkImageChangeInformationPtr::New();
+	mOutput = vtkImageChangeInformationPtr::New(); // used for forwarding only.
+	mOutput->SetInputConnection(mImageWithLUTProxy->getOutputPort()->GetOutputPort());
 }
 
 SlicedImageProxy::~SlicedImageProxy()
@@ -148,6 +160,24 @@ void SlicedImageProxy::setOutputFormat(Vector3D origin, Eigen::Array3i dim, Vect
 	// TODO investigate
 //	mReslicer->SetOutputExtent(0, dim[0]-1, 0, dim[1]-1, 0, 0);
 	mReslicer->SetOutputSpacing(spacing.data());
+
+	mResliceWithLUT->SetOutputOrigin(origin.data());
+	mResliceWithLUT->SetOutputExtent(0, dim[0], 0, dim[1], 0, 0);
+	mResliceWithLUT->SetOutputSpacing(spacing.data());
+}
+
+void SlicedImageProxy::setFusedResliceAndLUT(bool on)
+{
+	mFusedResliceAndLUT = on;
+	if (mImage)
+		this->transferFunctionsChangedSlot();
+}
+
+bool SlicedImageProxy::useFusedResliceAndLUT() const
+{
+	if (!mFusedResliceAndLUT || !mImage)
+		return false;
+	return mImage->getBaseVtkImageData()->GetNumberOfScalarComponents() < 3;
 }
 
 void SlicedImageProxy::setSliceProxy(SliceProxyInterfacePtr slicer)
@@ -166,9 +196,24 @@ void SlicedImageProxy::setSliceProxy(SliceProxyInterfacePtr slicer)
 
 void SlicedImageProxy::transferFunctionsChangedSlot()
 {
-	mReslicer->SetInputData(mImage->getBaseVtkImageData());
+	vtkImageDataPtr input = mImage->getBaseVtkImageData();
+	vtkLookupTablePtr lut = mImage->getLookupTable2D()->getOutputLookupTable();
+
+	mReslicer->SetInputData(input);
 	mReslicer->SetBackgroundLevel(mImage->getMin());
-	mImageWithLUTProxy->setInput(mRedirecter, mImage->getLookupTable2D()->getOutputLookupTable());
+
+	if (this->useFusedResliceAndLUT())
+	{
+		mResliceWithLUT->SetInputData(input);
+		mResliceWithLUT->SetBackgroundLevel(mImage->getMin());
+		mResliceWithLUT->SetLookupTable(lut);
+		mOutput->SetInputConnection(mResliceWithLUT->GetOutputPort());
+	}
+	else
+	{
+		mImageWithLUTProxy->setInput(mRedirecter, lut);
+		mOutput->SetInputConnection(mImageWithLUTProxy->getOutputPort()->GetOutputPort());
+	}
 }
 
 void SlicedImageProxy::updateRedirecterSlot()
@@ -203,6 +248,7 @@ void SlicedImageProxy::setImage(ImagePtr image)
 	else // no image
 	{
 		mImageWithLUTProxy->setInput(vtkImageAlgorithmPtr(), vtkLookupTablePtr());
+		mOutput->SetInputConnection(mImageWithLUTProxy->getOutputPort()->GetOutputPort());
 	}
 
 	this->update();
@@ -215,12 +261,13 @@ ImagePtr SlicedImageProxy::getImage() const
 
 vtkImageDataPtr SlicedImageProxy::getOutput()
 {
-	return mImageWithLUTProxy->getOutput();
+	mOutput->Update();
+	return mOutput->GetOutput();
 }
 
 vtkImageAlgorithmPtr SlicedImageProxy::getOutputPort()
 {
-	return mImageWithLUTProxy->getOutputPort();
+	return mOutput;
 }
 
 vtkImageDataPtr SlicedImageProxy::getOutputWithoutLUT()
@@ -66,6 +66,11 @@ private:
  * The image is sliced in software using the slice definition from
  * the SliceProxy
  *
+ * Grayscale images are resliced and mapped through the 2D lut in one
+ * multithreaded pass by a vtkImageResliceToColors, without an intermediate
+ * image. Axis-aligned planes use the permutation fast path of vtkImageReslice.
+ * Color images are resliced first, then passed through ApplyLUTToImage2DProxy.
+ *
  * Used internally by BlendedSliceRep and SlicerRepSW as the slice engine.
  * 
  * Used by Sonowand 2.1
@@ -83,6 +88,7 @@ public:
 	void setImage(ImagePtr image);
 	ImagePtr getImage() const;
 	void setOutputFormat(Vector3D origin, Eigen::Array3i dim, Vector3D spacing);
+	void setFusedResliceAndLUT(bool on); ///< reslice and apply lut in one pass for grayscale images. Default on.
 	void update();
 	vtkImageDataPtr getOutput(); ///< output 2D sliced image
 	vtkImageAlgorithmPtr getOutputPort(); ///< output 2D sliced image
@@ -96,7 +102,11 @@ private slots:
 	void updateRedirecterSlot();
 
 private: 
+	bool useFusedResliceAndLUT() const;
 	ApplyLUTToImage2DProxyPtr mImageWithLUTProxy;
+	vtkImageResliceToColorsPtr mResliceWithLUT;
+	vtkImageChangeInformationPtr mOutput; ///< forwards the output of either the fused or the two-pass pipeline
+	bool mFusedResliceAndLUT;
 
 	SliceProxyInterfacePtr mSlicer;
 	ImagePtr mImage;
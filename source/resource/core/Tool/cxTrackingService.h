@@ -18,6 +18,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <boost/shared_ptr.hpp>
 #include "cxTransform3D.h"
 #include "cxTool.h"
+#include "cxTrackingUpdateBus.h"
 
 #define TrackingService_iid "cx::TrackingService"
 
@@ -85,6 +86,11 @@ public:
 signals:
 	void stateChanged();
 	void activeToolChanged(const QString& uId);
+	/** All tool movement during the last frame window, coalesced.
+	  * Use this for visualization, and listen to each Tool for every raw sample.
+	  * Samples arrive up to one frame window (16 ms) late, see TrackingUpdateBus.
+	  */
+	void toolsUpdated(const TrackingSnapshot& snapshot);
 
 };
 
@@ -47,6 +47,7 @@ void TrackingServiceProxy::onServiceAdded(TrackingService* service)
 
 	connect(mTrackingService.get(), &TrackingService::stateChanged, this, &TrackingService::stateChanged);
 	connect(mTrackingService.get(), &TrackingService::activeToolChanged, this, &TrackingService::activeToolChanged);
+	connect(mTrackingService.get(), &TrackingService::toolsUpdated, this, &TrackingService::toolsUpdated);
 
     emit stateChanged();
     emit activeToolChanged(mTrackingService->getActiveTool()->getUid());
@@ -56,6 +57,7 @@ void TrackingServiceProxy::onServiceRemoved(TrackingService *service)
 {
 	disconnect(mTrackingService.get(), &TrackingService::stateChanged, this, &TrackingService::stateChanged);
 	disconnect(mTrackingService.get(), &TrackingService::activeToolChanged, this, &TrackingService::activeToolChanged);
+	disconnect(mTrackingService.get(), &TrackingService::toolsUpdated, this, &TrackingService::toolsUpdated);
 
 	mTrackingService = TrackingService::getNullObject();
 
@@ -0,0 +1,94 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxTrackingUpdateBus.h"
+
+#include <algorithm>
+#include <QTimer>
+#include "cxTool.h"
+
+namespace cx
+{
+
+TrackingUpdateBus::TrackingUpdateBus(QObject* parent) :
+	QObject(parent)
+{
+	mTimer = new QTimer(this);
+	mTimer->setSingleShot(true);
+	mTimer->setInterval(16);
+	connect(mTimer, &QTimer::timeout, this, &TrackingUpdateBus::flush);
+}
+
+TrackingUpdateBus::~TrackingUpdateBus()
+{
+}
+
+void TrackingUpdateBus::setTools(const ToolMap& tools)
+{
+	for (std::map<QObject*, QString>::iterator iter=mTools.begin(); iter!=mTools.end(); ++iter)
+		disconnect(iter->first, 0, this, 0);
+	mTools.clear();
+
+	for (ToolMap::const_iterator iter=tools.begin(); iter!=tools.end(); ++iter)
+	{
+		Tool* tool = iter->second.get();
+		if (!tool)
+			continue;
+		mTools[tool] = iter->first;
+		connect(tool, &Tool::toolTransformAndTimestamp, this, &TrackingUpdateBus::onToolTransformAndTimestamp);
+		connect(tool, &QObject::destroyed, this, &TrackingUpdateBus::onToolDestroyed);
+	}
+}
+
+void TrackingUpdateBus::setFrameWindow(int msecs)
+{
+	mTimer->setInterval(std::max(0, msecs));
+}
+
+int TrackingUpdateBus::getFrameWindow() const
+{
+	return mTimer->interval();
+}
+
+void TrackingUpdateBus::onToolTransformAndTimestamp(Transform3D prMt, double timestamp)
+{
+	std::map<QObject*, QString>::iterator iter = mTools.find(this->sender());
+	if (iter == mTools.end())
+		return;
+
+	TrackingSnapshot::Sample& sample = mPending.mSamples[iter->second];
+	sample.prMt = prMt;
+	sample.timestamp = timestamp;
+	++mPending.mSampleCount;
+
+	if (mTimer->interval()==0)
+		this->flush();
+	else if (!mTimer->isActive())
+		mTimer->start();
+}
+
+void TrackingUpdateBus::onToolDestroyed(QObject* object)
+{
+	mTools.erase(object);
+}
+
+void TrackingUpdateBus::flush()
+{
+	mTimer->stop();
+	if (mPending.empty())
+		return;
+
+	TrackingSnapshot snapshot;
+	std::swap(snapshot, mPending);
+	emit snapshotReady(snapshot);
+}
+
+} // namespace cx
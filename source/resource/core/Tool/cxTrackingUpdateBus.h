@@ -0,0 +1,98 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXTRACKINGUPDATEBUS_H
+#define CXTRACKINGUPDATEBUS_H
+
+#include "cxResourceExport.h"
+
+#include <map>
+#include <QObject>
+#include <boost/shared_ptr.hpp>
+#include "cxTransform3D.h"
+
+class QTimer;
+
+namespace cx
+{
+typedef boost::shared_ptr<class Tool> ToolPtr;
+typedef boost::shared_ptr<class TrackingUpdateBus> TrackingUpdateBusPtr;
+
+/** \brief The latest position of all tools that moved during one frame window.
+ *
+ *  \ingroup cx_resource_core_tool
+ */
+struct cxResource_EXPORT TrackingSnapshot
+{
+	struct Sample
+	{
+		Transform3D prMt;
+		double timestamp;
+	};
+	std::map<QString, Sample> mSamples; ///< uid -> latest sample
+	int mSampleCount; ///< number of raw samples coalesced into this snapshot
+
+	TrackingSnapshot() : mSampleCount(0) {}
+	bool contains(const QString& uid) const { return mSamples.count(uid); }
+	bool empty() const { return mSamples.empty(); }
+};
+
+/** \brief Coalesces per-sample tool updates into one snapshot per frame.
+ *
+ * Listens to toolTransformAndTimestamp from all tools in setTools().
+ * The first sample after a publish starts a frame window. All samples
+ * arriving within the window are collected, keeping the latest per tool,
+ * and published as one snapshot when the window ends.
+ *
+ * Consumers that only need to know that something moved (views, widgets,
+ * space listeners) should listen to snapshotReady(), and thus update once
+ * per frame regardless of the number of tools and their rates.
+ * Consumers that need every sample (recorders) listen to the tools directly.
+ *
+ * The cost is latency: A sample reaches snapshotReady() up to one frame
+ * window after the tool emitted it. Tool reps, slice proxies and camera
+ * following still listen to their tool directly, thus they see each sample
+ * without delay. Reps only mark themselves modified and render once per
+ * frame anyway. With a frame window of 0 each sample is published
+ * immediately as its own snapshot, with no latency and no coalescing.
+ *
+ *  \ingroup cx_resource_core_tool
+ *  \date Oct 19, 2026
+ */
+class cxResource_EXPORT TrackingUpdateBus : public QObject
+{
+	Q_OBJECT
+public:
+	typedef std::map<QString, ToolPtr> ToolMap;
+
+	TrackingUpdateBus(QObject* parent = NULL);
+	virtual ~TrackingUpdateBus();
+
+	void setTools(const ToolMap& tools);
+	void setFrameWindow(int msecs); ///< default 16 ms. 0 means publish each sample immediately.
+	int getFrameWindow() const;
+	void flush(); ///< publish pending samples now, if any
+
+signals:
+	void snapshotReady(const TrackingSnapshot& snapshot);
+
+private slots:
+	void onToolTransformAndTimestamp(Transform3D prMt, double timestamp);
+	void onToolDestroyed(QObject* object);
+private:
+	std::map<QObject*, QString> mTools; ///< tool -> uid
+	TrackingSnapshot mPending;
+	QTimer* mTimer;
+};
+
+} // namespace cx
+
+#endif // CXTRACKINGUPDATEBUS_H
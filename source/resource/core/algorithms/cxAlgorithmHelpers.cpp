@@ -12,23 +12,56 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include "cxImage.h"
 #include "cxTypeConversions.h"
-#include "itkImageFileReader.h"
-#include "vtkMetaImageWriter.h"
-#include "cxSettings.h"
-#include <QDir>
-#include "cxUtilHelpers.h"
-#include "cxDataLocations.h"
+#include "cxItkVtkImageAdaptor.h"
 #include "cxLogger.h"
+#include <vtkImageCast.h>
+#include <vtkImageExtractComponents.h>
 #include <itkGrayscaleFillholeImageFilter.h>
 
 namespace cx
 {
 
 //---------------------------------------------------------------------------------------------------------------------
-itkImageType::ConstPointer AlgorithmHelper::getITKfromVTKImage(vtkImageDataPtr image)
+/** Convert the image to ITK. The pixel buffer is shared with the input if the
+ * scalar type is PixelType, otherwise the input is cast to PixelType in memory.
+ *
+ * The image is wrapped directly instead of going through itk::VTKImageToImageFilter,
+ * as the latter has caused _unpredictable_ crashes.
+ */
+itkImageType::ConstPointer AlgorithmHelper::getITKfromVTKImage(vtkImageDataPtr input)
 {
-  //HACK
-  return AlgorithmHelper::getITKfromVTKImageViaFile(image);
+	if(!input)
+	{
+		std::cout << "getITKfromSSCImage(): NO image!!!" << std::endl;
+		return itkImageType::ConstPointer();
+	}
+
+	if (ItkVtkImageAdaptor<itkImageType>::canShare(input))
+		return ItkVtkImageAdaptor<itkImageType>::toItk(input).GetPointer();
+
+	double minVal = input->GetScalarRange()[0];
+	double maxVal = input->GetScalarRange()[1];
+
+	if(maxVal > SHRT_MAX || minVal < SHRT_MIN)
+		reportWarning("Image values out of range. max: " + qstring_cast(maxVal)
+				+ " min: " + qstring_cast(minVal) + " See bug #363 if this needs to be fixed");
+
+	vtkImageDataPtr singleComponent = input;
+	if (input->GetNumberOfScalarComponents() > 1)
+	{
+		vtkImageExtractComponentsPtr extractor = vtkImageExtractComponentsPtr::New();
+		extractor->SetInputData(input);
+		extractor->SetComponents(0);
+		extractor->Update();
+		singleComponent = extractor->GetOutput();
+	}
+
+	vtkImageCastPtr imageCast = vtkImageCastPtr::New();
+	imageCast->SetInputData(singleComponent);
+	imageCast->SetOutputScalarType(vtkTypeTraits<PixelType>::VTKTypeID());
+	imageCast->Update();
+
+	return ItkVtkImageAdaptor<itkImageType>::toItk(imageCast->GetOutput()).GetPointer();
 }
 //---------------------------------------------------------------------------------------------------------------------
 
@@ -41,72 +74,12 @@ itkImageType::ConstPointer AlgorithmHelper::getITKfromSSCImage(ImagePtr input)
 }
 //---------------------------------------------------------------------------------------------------------------------
 
-/**This is a workaround for _unpredictable_ crashes
- * experienced when using the itk::VTKImageToImageFilter.
- *
+/** Convert the image to VTK. The pixel buffer is shared with the input,
+ * and the input is kept alive as long as the output is.
  */
-itkImageType::ConstPointer AlgorithmHelper::getITKfromVTKImageViaFile(vtkImageDataPtr input)
-{
-  if(!input)
-  {
-    std::cout << "getITKfromSSCImage(): NO image!!!" << std::endl;
-    return itkImageType::ConstPointer();
-  }
-
-  double minVal = input->GetScalarRange()[0];
-  double maxVal = input->GetScalarRange()[1];
-
-  if(maxVal > SHRT_MAX || minVal < SHRT_MIN)
-  	reportWarning("Image values out of range. max: " + qstring_cast(maxVal)
-  			+ " min: " + qstring_cast(minVal) + " See bug #363 if this needs to be fixed");
-
-  QString tempFolder = DataLocations::getCachePath() + "/vtk2itk/";
-  QDir().mkpath(tempFolder);
-
-  // write to disk
-  vtkMetaImageWriterPtr writer = vtkMetaImageWriterPtr::New();
-
-  QString filename = tempFolder + "/"+qstring_cast(writer.GetPointer())+".mhd";
-
-
-  writer->SetInputData(input);
-  writer->SetFileName(cstring_cast(filename));
-  writer->SetCompression(false);
-  writer->Write();
-
-  // read from disk
-  typedef itk::ImageFileReader<itkImageType> ReaderType;
-  ReaderType::Pointer reader = ReaderType::New();
-#if ITK_VERSION_MAJOR==3
-  reader->SetFileName(cstring_cast(filename));
-#else
-  reader->SetFileName(string_cast(filename));
-#endif
-
-////  reader->SetFileName(cstring_cast(filename));
-//  reader->SetFileName(string_cast(filename));
-  reader->Update();
-  itkImageType::ConstPointer retval = reader->GetOutput();
-
-  QFile(filename).remove(); // cleanup
-  QFile(changeExtension(filename, "raw")).remove(); // cleanup
-
-  return retval;
-}
-//---------------------------------------------------------------------------------------------------------------------
-
 vtkImageDataPtr AlgorithmHelper::getVTKFromITK(itkImageType::ConstPointer input)
 {
-	//Convert ITK to VTK
-	itkToVtkFilterType::Pointer itkToVtkFilter = itkToVtkFilterType::New();
-	itkToVtkFilter->SetInput(input);
-	itkToVtkFilter->Update();
-
-	vtkImageDataPtr rawResult = vtkImageDataPtr::New();
-	rawResult->DeepCopy(itkToVtkFilter->GetOutput());
-	// TODO: possible memory problem here - check debug mem system of itk/vtk
-
-	return rawResult;
+	return ItkVtkImageAdaptor<itkImageType>::toVtk(input);
 }
 
 vtkImageDataPtr AlgorithmHelper::execute_itk_GrayscaleFillholeImageFilter(vtkImageDataPtr input)
@@ -36,6 +36,10 @@ typedef itk::VTKImageToImageFilter<itkImageType> itkVTKImageToImageFilterType;
  * \brief Class with helper functions for algorithms.
  * \ingroup cx_resource_core_algorithms
  *
+ * Conversions between VTK and ITK share the pixel buffer whenever possible,
+ * see ItkVtkImageAdaptor. ITK filters reading converted images must not
+ * run in place.
+ *
  * \date Feb 16, 2011
  * \author Janne Beate Bakeng, SINTEF
  */
@@ -47,9 +51,6 @@ public:
 
   static vtkImageDataPtr getVTKFromITK(itkImageType::ConstPointer input);
   static vtkImageDataPtr execute_itk_GrayscaleFillholeImageFilter(vtkImageDataPtr input);
-
-private:
-  static itkImageType::ConstPointer getITKfromVTKImageViaFile(vtkImageDataPtr image);
 };
 
 
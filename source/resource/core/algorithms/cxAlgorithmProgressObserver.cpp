@@ -0,0 +1,116 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxAlgorithmProgressObserver.h"
+
+#include <vtkAlgorithm.h>
+#include <vtkCommand.h>
+#include <vtkSmartPointer.h>
+#include <itkProcessObject.h>
+#include <itkCommand.h>
+#include "cxTimedAlgorithm.h"
+
+namespace cx
+{
+
+namespace
+{
+const int STEP_RESOLUTION = 100; ///< progress updates per step
+
+void updateProgress(TimedBaseAlgorithm* algorithm, int step, int maxSteps, double progress)
+{
+	int current = step*STEP_RESOLUTION + int(progress*STEP_RESOLUTION);
+	algorithm->reportProgress(current, maxSteps*STEP_RESOLUTION);
+}
+
+class VtkProgressCommand : public vtkCommand
+{
+public:
+	static VtkProgressCommand* New() { return new VtkProgressCommand; }
+
+	virtual void Execute(vtkObject* caller, unsigned long eventId, void* callData)
+	{
+		vtkAlgorithm* filter = vtkAlgorithm::SafeDownCast(caller);
+		if (!filter)
+			return;
+		if (mAlgorithm->isCancelRequested())
+		{
+			filter->AbortExecuteOn();
+			return;
+		}
+		updateProgress(mAlgorithm, mStep, mMaxSteps, filter->GetProgress());
+	}
+
+	TimedBaseAlgorithm* mAlgorithm;
+	int mStep;
+	int mMaxSteps;
+
+private:
+	VtkProgressCommand() : mAlgorithm(NULL), mStep(0), mMaxSteps(1) {}
+};
+
+class ItkProgressCommand : public itk::Command
+{
+public:
+	typedef ItkProgressCommand Self;
+	typedef itk::Command Superclass;
+	typedef itk::SmartPointer<Self> Pointer;
+	itkNewMacro(Self);
+
+	virtual void Execute(itk::Object* caller, const itk::EventObject& event)
+	{
+		itk::ProcessObject* filter = dynamic_cast<itk::ProcessObject*>(caller);
+		if (!filter)
+			return;
+		if (mAlgorithm->isCancelRequested())
+		{
+			filter->AbortGenerateDataOn();
+			return;
+		}
+		updateProgress(mAlgorithm, mStep, mMaxSteps, filter->GetProgress());
+	}
+
+	virtual void Execute(const itk::Object* caller, const itk::EventObject& event)
+	{
+	}
+
+	TimedBaseAlgorithm* mAlgorithm;
+	int mStep;
+	int mMaxSteps;
+
+protected:
+	ItkProgressCommand() : mAlgorithm(NULL), mStep(0), mMaxSteps(1) {}
+};
+} // namespace
+
+void observeProgress(vtkAlgorithm* filter, TimedBaseAlgorithm* algorithm, int step, int maxSteps)
+{
+	if (!filter || !algorithm)
+		return;
+	vtkSmartPointer<VtkProgressCommand> command = vtkSmartPointer<VtkProgressCommand>::New();
+	command->mAlgorithm = algorithm;
+	command->mStep = step;
+	command->mMaxSteps = maxSteps;
+	filter->AddObserver(vtkCommand::ProgressEvent, command);
+}
+
+void observeProgress(itk::ProcessObject* filter, TimedBaseAlgorithm* algorithm, int step, int maxSteps)
+{
+	if (!filter || !algorithm)
+		return;
+	ItkProgressCommand::Pointer command = ItkProgressCommand::New();
+	command->mAlgorithm = algorithm;
+	command->mStep = step;
+	command->mMaxSteps = maxSteps;
+	filter->AddObserver(itk::ProgressEvent(), command);
+}
+
+} // namespace cx
@@ -0,0 +1,47 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXALGORITHMPROGRESSOBSERVER_H_
+#define CXALGORITHMPROGRESSOBSERVER_H_
+
+#include "cxResourceExport.h"
+
+class vtkAlgorithm;
+namespace itk
+{
+class ProcessObject;
+}
+
+namespace cx
+{
+class TimedBaseAlgorithm;
+
+/**
+ * \brief Connect VTK and ITK filters to a running TimedBaseAlgorithm.
+ *
+ * The progress of the filter is reported to the algorithm, mapped to
+ * the interval [step, step+1] out of maxSteps. When the algorithm is
+ * cancelled, the filter is aborted at its next progress update:
+ * VTK filters return early with incomplete output, ITK filters throw
+ * itk::ProcessAborted from Update().
+ *
+ * Both functions do nothing if algorithm is NULL. The observer is owned
+ * by the filter, and must not outlive the algorithm.
+ *
+ * \ingroup cx_resource_core_algorithms
+ * \date Oct 19, 2026
+ */
+cxResource_EXPORT void observeProgress(vtkAlgorithm* filter, TimedBaseAlgorithm* algorithm, int step, int maxSteps);
+cxResource_EXPORT void observeProgress(itk::ProcessObject* filter, TimedBaseAlgorithm* algorithm, int step, int maxSteps);
+
+} // namespace cx
+
+#endif /* CXALGORITHMPROGRESSOBSERVER_H_ */
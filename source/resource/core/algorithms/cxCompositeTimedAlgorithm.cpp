@@ -11,6 +11,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include "cxCompositeTimedAlgorithm.h"
 
+#include <algorithm>
 #include <QStringList>
 #include "cxTypeConversions.h"
 #include "cxLogger.h"
@@ -18,6 +19,11 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 namespace cx
 {
 
+namespace
+{
+const int CHILD_PROGRESS_STEPS = 100; ///< progress resolution for each child in a serial composite
+}
+
 CompositeTimedAlgorithm::CompositeTimedAlgorithm(QString name) :
 	TimedBaseAlgorithm(name, 20)
 {
@@ -28,6 +34,13 @@ void CompositeTimedAlgorithm::append(TimedAlgorithmPtr child)
 	mChildren.push_back(child);
 }
 
+void CompositeTimedAlgorithm::cancel()
+{
+	TimedBaseAlgorithm::cancel();
+	for (unsigned i=0; i<mChildren.size(); ++i)
+		mChildren[i]->cancel();
+}
+
 //---------------------------------------------------------
 //---------------------------------------------------------
 //---------------------------------------------------------
@@ -66,9 +79,10 @@ void CompositeSerialTimedAlgorithm::execute()
 	// if already started, ignore
 	if (mCurrent>=0)
 		return;
+	this->resetCancel();
 	this->startTiming();
 	mCurrent = -1;
-	emit started(0);
+	emit started(mChildren.size());
 	this->jumpToNextChild();
 }
 
@@ -78,12 +92,17 @@ void CompositeSerialTimedAlgorithm::jumpToNextChild()
 	if (mCurrent >= 0 && mCurrent < mChildren.size())
 	{
 		disconnect(mChildren[mCurrent].get(), SIGNAL(finished()), this, SLOT(jumpToNextChild()));
+		disconnect(mChildren[mCurrent].get(), SIGNAL(progress(int, int)), this, SLOT(childProgressSlot(int, int)));
 	}
 	++mCurrent;
+	if (this->isCancelRequested())
+		mCurrent = mChildren.size();
+	this->reportProgress(mCurrent*CHILD_PROGRESS_STEPS, int(mChildren.size())*CHILD_PROGRESS_STEPS);
 	// setup and run next child
 	if (mCurrent >= 0 && mCurrent < mChildren.size())
 	{
 		connect(mChildren[mCurrent].get(), SIGNAL(finished()), this, SLOT(jumpToNextChild()));
+		connect(mChildren[mCurrent].get(), SIGNAL(progress(int, int)), this, SLOT(childProgressSlot(int, int)));
 		emit productChanged();
 		mChildren[mCurrent]->execute();
 	}
@@ -97,6 +116,14 @@ void CompositeSerialTimedAlgorithm::jumpToNextChild()
 	}
 }
 
+void CompositeSerialTimedAlgorithm::childProgressSlot(int step, int maxSteps)
+{
+	if (mCurrent < 0 || maxSteps <= 0)
+		return;
+	int childStep = std::min(CHILD_PROGRESS_STEPS, int(CHILD_PROGRESS_STEPS*double(step)/maxSteps));
+	this->reportProgress(mCurrent*CHILD_PROGRESS_STEPS + childStep, int(mChildren.size())*CHILD_PROGRESS_STEPS);
+}
+
 bool CompositeSerialTimedAlgorithm::isFinished() const
 {
     return mCurrent == -1;
@@ -145,6 +172,7 @@ void CompositeParallelTimedAlgorithm::clear()
 
 void CompositeParallelTimedAlgorithm::execute()
 {
+	this->resetCancel();
 	emit aboutToStart();
 	emit started(0);
 	for (unsigned i=0; i<mChildren.size(); ++i)
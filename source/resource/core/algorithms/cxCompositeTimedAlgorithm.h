@@ -30,6 +30,7 @@ public:
 	CompositeTimedAlgorithm(QString name);
 	virtual void append(TimedAlgorithmPtr child);
 	virtual void clear() = 0;
+	virtual void cancel(); ///< cancel all children
 
 protected:
 	std::vector<TimedAlgorithmPtr> mChildren;
@@ -43,6 +44,9 @@ typedef boost::shared_ptr<CompositeTimedAlgorithm> CompositeTimedAlgorithmPtr;
  *
  * Usage: Append all algorithms as children then execute. All children
  * will be executed in sequence. started()/finished() will also work.
+ * progress() is emitted for each completed child, and includes the
+ * progress reported by the running child. After cancel(), the
+ * remaining children are skipped.
  *
  * \ingroup cx_resource_core_algorithms
  * \date Jun 27, 2012
@@ -63,6 +67,7 @@ public:
 
 private slots:
 	void jumpToNextChild();
+	void childProgressSlot(int step, int maxSteps);
 
 private:
 	int mCurrent;
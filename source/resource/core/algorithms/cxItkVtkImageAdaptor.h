@@ -0,0 +1,193 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXITKVTKIMAGEADAPTOR_H_
+#define CXITKVTKIMAGEADAPTOR_H_
+
+#include <itkImage.h>
+#include <itkImportImageContainer.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkDataArray.h>
+#include <vtkCommand.h>
+#include <vtkTypeTraits.h>
+#include <vtkSmartPointer.h>
+
+namespace cx
+{
+
+/**
+ * ITK pixel container referring to the scalar buffer of a vtkImageData.
+ * The vtkImageData is kept alive as long as the container is in use.
+ *
+ * \ingroup cx_resource_core_algorithms
+ */
+template<class TElement>
+class VtkImageImportContainer : public itk::ImportImageContainer<itk::SizeValueType, TElement>
+{
+public:
+	typedef VtkImageImportContainer Self;
+	typedef itk::ImportImageContainer<itk::SizeValueType, TElement> Superclass;
+	typedef itk::SmartPointer<Self> Pointer;
+	typedef itk::SmartPointer<const Self> ConstPointer;
+
+	itkNewMacro(Self);
+	itkTypeMacro(VtkImageImportContainer, ImportImageContainer);
+
+	void setVtkImage(vtkSmartPointer<vtkImageData> image)
+	{
+		mImage = image;
+		this->SetImportPointer(static_cast<TElement*>(image->GetScalarPointer()),
+							   image->GetPointData()->GetScalars()->GetNumberOfTuples(),
+							   false);
+	}
+
+protected:
+	VtkImageImportContainer() {}
+	virtual ~VtkImageImportContainer() {}
+
+private:
+	VtkImageImportContainer(const Self&); // not implemented
+	void operator=(const Self&); // not implemented
+	vtkSmartPointer<vtkImageData> mImage;
+};
+
+/**
+ * Observer used only to tie the lifetime of an ITK image to a vtkDataArray:
+ * The observer is owned by the array, and holds a reference to the image.
+ *
+ * \ingroup cx_resource_core_algorithms
+ */
+template<class TImage>
+class ItkImageHolderCommand : public vtkCommand
+{
+public:
+	static ItkImageHolderCommand* New() { return new ItkImageHolderCommand; }
+	void setImage(typename TImage::ConstPointer image) { mImage = image; }
+	virtual void Execute(vtkObject*, unsigned long, void*) {}
+private:
+	typename TImage::ConstPointer mImage;
+};
+
+/**
+ * \brief Zero-copy conversion between ITK and VTK images.
+ * \ingroup cx_resource_core_algorithms
+ *
+ * The converted image shares the pixel buffer with the source image,
+ * and keeps the source image alive as long as the buffer is in use.
+ * This replaces the ITK/VTK pipeline glue (itk::VTKImageToImageFilter and
+ * itk::ImageToVTKImageFilter) followed by a DeepCopy.
+ *
+ * Only single-component images with a VTK scalar type equal to
+ * TImage::PixelType can be shared, use canShare() to check. The
+ * direction cosines of the ITK image are ignored, as vtkImageData has none.
+ *
+ * Because the buffer is shared, ITK filters reading a shared image must
+ * not run in place (call InPlaceOff() on itk::InPlaceImageFilter subclasses),
+ * otherwise the VTK source image will be overwritten.
+ *
+ * \date Oct 19, 2026
+ */
+template<class TImage>
+class ItkVtkImageAdaptor
+{
+public:
+	typedef typename TImage::PixelType PixelType;
+	static const unsigned int Dimension = TImage::ImageDimension;
+
+	static bool canShare(vtkImageData* image)
+	{
+		return image
+				&& image->GetPointData()->GetScalars()
+				&& (image->GetScalarType() == vtkTypeTraits<PixelType>::VTKTypeID())
+				&& (image->GetNumberOfScalarComponents() == 1);
+	}
+
+	/** Return an ITK image sharing the scalar buffer of image.
+	  * Return a null pointer if !canShare(image).
+	  */
+	static typename TImage::Pointer toItk(vtkSmartPointer<vtkImageData> image)
+	{
+		if (!canShare(image))
+			return typename TImage::Pointer();
+
+		int* extent = image->GetExtent();
+		double* spacing = image->GetSpacing();
+		double* origin = image->GetOrigin();
+
+		typename TImage::IndexType start;
+		typename TImage::SizeType size;
+		typename TImage::SpacingType itkSpacing;
+		typename TImage::PointType itkOrigin;
+		for (unsigned i=0; i<Dimension; ++i)
+		{
+			start[i] = extent[2*i];
+			size[i] = extent[2*i+1] - extent[2*i] + 1;
+			itkSpacing[i] = spacing[i];
+			itkOrigin[i] = origin[i];
+		}
+
+		typename TImage::Pointer retval = TImage::New();
+		retval->SetRegions(typename TImage::RegionType(start, size));
+		retval->SetSpacing(itkSpacing);
+		retval->SetOrigin(itkOrigin);
+
+		typename VtkImageImportContainer<PixelType>::Pointer container = VtkImageImportContainer<PixelType>::New();
+		container->setVtkImage(image);
+		retval->SetPixelContainer(container);
+
+		return retval;
+	}
+
+	/** Return a vtkImageData sharing the pixel buffer of image.
+	  */
+	static vtkSmartPointer<vtkImageData> toVtk(typename TImage::ConstPointer image)
+	{
+		if (!image)
+			return vtkSmartPointer<vtkImageData>();
+
+		typename TImage::RegionType region = image->GetBufferedRegion();
+		typename TImage::IndexType start = region.GetIndex();
+		typename TImage::SizeType size = region.GetSize();
+
+		int extent[6] = {0, 0, 0, 0, 0, 0};
+		double spacing[3] = {1, 1, 1};
+		double origin[3] = {0, 0, 0};
+		for (unsigned i=0; i<Dimension && i<3; ++i)
+		{
+			extent[2*i] = start[i];
+			extent[2*i+1] = start[i] + size[i] - 1;
+			spacing[i] = image->GetSpacing()[i];
+			origin[i] = image->GetOrigin()[i];
+		}
+
+		vtkSmartPointer<vtkDataArray> scalars;
+		scalars.TakeReference(vtkDataArray::CreateDataArray(vtkTypeTraits<PixelType>::VTKTypeID()));
+		scalars->SetNumberOfComponents(1);
+		scalars->SetVoidArray(const_cast<PixelType*>(image->GetBufferPointer()), region.GetNumberOfPixels(), 1);
+
+		vtkSmartPointer<ItkImageHolderCommand<TImage> > holder = vtkSmartPointer<ItkImageHolderCommand<TImage> >::New();
+		holder->setImage(image);
+		scalars->AddObserver(vtkCommand::DeleteEvent, holder);
+
+		vtkSmartPointer<vtkImageData> retval = vtkSmartPointer<vtkImageData>::New();
+		retval->SetExtent(extent);
+		retval->SetSpacing(spacing);
+		retval->SetOrigin(origin);
+		retval->GetPointData()->SetScalars(scalars);
+
+		return retval;
+	}
+};
+
+} // namespace cx
+
+#endif /* CXITKVTKIMAGEADAPTOR_H_ */
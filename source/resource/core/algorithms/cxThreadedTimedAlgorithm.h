@@ -16,8 +16,10 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include <QFutureWatcher>
 #include <QtConcurrent/QtConcurrentRun>
+#include <boost/bind.hpp>
 
 #include "cxTimedAlgorithm.h"
+#include "cxWorkScheduler.h"
 
 #include "vtkForwardDeclarations.h"
 #include "cxForwardDeclarations.h"
@@ -28,6 +30,14 @@ namespace cx
 /**
  * \brief Base class for algorithms that wants to thread and time their
  * execution. T is the return type of the calculated data in the thread.
+ *
+ * calculate() is run through the shared WorkScheduler, using the
+ * priority given by setPriority(). Implementations of calculate()
+ * should poll isCancelRequested() and call reportProgress() where
+ * convenient, or connect VTK/ITK filters using observeProgress().
+ * If cancel() is called before calculate() has started,
+ * calculate() is skipped and the result is a default-constructed T.
+ *
  * \ingroup cx_resource_core_algorithms
  *
  * \date Feb 22, 2011
@@ -38,7 +48,9 @@ class cxResource_EXPORT ThreadedTimedAlgorithm : public TimedBaseAlgorithm
 {
 public:
   ThreadedTimedAlgorithm(QString product, int secondsBetweenAnnounce) :
-	  TimedBaseAlgorithm(product, secondsBetweenAnnounce)
+	  TimedBaseAlgorithm(product, secondsBetweenAnnounce),
+	  mPriority(wpNORMAL),
+	  mMaxProgressSteps(0)
   {
 	  connect(&mWatcher, SIGNAL(finished()), this, SLOT(finishedSlot()));
 	  connect(&mWatcher, SIGNAL(finished()), this, SLOT(postProcessingSlot()));
@@ -48,6 +60,7 @@ public:
 
   virtual void execute()
   {
+	this->resetCancel();
   	emit aboutToStart();
 	this->preProcessingSlot();
 	this->generate();
@@ -55,6 +68,8 @@ public:
   virtual bool isFinished() const { return mWatcher.isFinished(); }
   virtual bool isRunning() const { return mWatcher.isRunning(); }
 
+  void setPriority(WORK_PRIORITY priority) { mPriority = priority; } ///< priority used when scheduling calculate()
+  WORK_PRIORITY getPriority() const { return mPriority; }
 
 protected:
   virtual void preProcessingSlot() {} ///< This happens before the thread (calculate) is started, here non-thread safe functions can be called
@@ -66,11 +81,13 @@ protected:
   void generate() ///< Call generate to execute the algorithm
   {
 	  TimedBaseAlgorithm::startTiming();
-	  emit started(0); // TODO move to started signal from qtconcurrent??
+	  emit started(mMaxProgressSteps); // TODO move to started signal from qtconcurrent??
 
-	  mFutureResult = QtConcurrent::run(this, &ThreadedTimedAlgorithm<T>::calculate);
+	  boost::function<T()> function = boost::bind(&ThreadedTimedAlgorithm<T>::runCalculate, this);
+	  mFutureResult = WorkScheduler::getInstance()->run<T>(function, mPriority);
 	  mWatcher.setFuture(mFutureResult);
   }
+  void setMaxProgressSteps(int steps) { mMaxProgressSteps = steps; } ///< maxSteps emitted in started(), zero if unknown.
   T getResult() ///< This gets the result calculated in calculate, should only be used after calculate is finished
   {
 	  T result = mWatcher.future().result();
@@ -82,9 +99,17 @@ private:
   {
 	  TimedBaseAlgorithm::stopTiming();
   }
+  T runCalculate()
+  {
+	  if (this->isCancelRequested())
+		  return T();
+	  return this->calculate();
+  }
 
   QFuture<T> mFutureResult;
   QFutureWatcher<T> mWatcher;
+  WORK_PRIORITY mPriority;
+  int mMaxProgressSteps;
 };
 
 //template specicalizations
@@ -25,7 +25,9 @@ namespace cx
 TimedBaseAlgorithm::TimedBaseAlgorithm(QString product, int secondsBetweenAnnounce) :
     QObject(),
     mProduct(product),
-    mUseDefaultMessages(true)
+    mUseDefaultMessages(true),
+    mCancelRequested(0),
+    mLastProgressStep(-1)
 {
   mTimer = new QTimer(this);
   connect(mTimer, SIGNAL(timeout()), this, SLOT(timeoutSlot()));
@@ -35,6 +37,33 @@ TimedBaseAlgorithm::TimedBaseAlgorithm(QString product, int secondsBetweenAnnoun
 TimedBaseAlgorithm::~TimedBaseAlgorithm()
 {}
 
+void TimedBaseAlgorithm::cancel()
+{
+	if (!mCancelRequested.testAndSetOrdered(0, 1))
+		return;
+	if (mUseDefaultMessages)
+		report(QString("Algorithm %1 cancel requested.").arg(mProduct));
+	emit cancelRequested();
+}
+
+bool TimedBaseAlgorithm::isCancelRequested() const
+{
+	return mCancelRequested.load()!=0;
+}
+
+void TimedBaseAlgorithm::resetCancel()
+{
+	mCancelRequested.store(0);
+	mLastProgressStep.store(-1);
+}
+
+void TimedBaseAlgorithm::reportProgress(int step, int maxSteps)
+{
+	if (mLastProgressStep.fetchAndStoreOrdered(step)==step)
+		return;
+	emit progress(step, maxSteps);
+}
+
 void TimedBaseAlgorithm::startTiming()
 {
 	mStartTime = QDateTime::currentDateTime();
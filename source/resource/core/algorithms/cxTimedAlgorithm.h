@@ -20,6 +20,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <QObject>
 #include <QDateTime>
 #include <QTimer>
+#include <QAtomicInt>
 #include <boost/function.hpp>
 #include <vector>
 #include <iostream>
@@ -62,17 +63,36 @@ public:
    * (Right after aboutToStart, right before finished())
    */
   virtual bool isRunning() const = 0;
+  /**
+   * Request cooperative cancellation. Thread safe.
+   * The algorithm stops at the next point where it checks
+   * isCancelRequested(), then finishes as usual: finished() is
+   * still emitted, and the result might be empty.
+   */
+  virtual void cancel();
+  /**
+   * Return true if cancel() has been called since the last execute().
+   * Thread safe: Poll this from the threaded part of the algorithm.
+   */
+  bool isCancelRequested() const;
+  /**
+   * Report progress. Thread safe: Can be called from the threaded part
+   * of the algorithm. Emits progress() if step has changed.
+   */
+  void reportProgress(int step, int maxSteps);
 
 signals:
 	void aboutToStart(); ///< emitted at start of execute. Use to perform preprocessing
 	void started(int maxSteps); ///< emitted at start of run. \param maxSteps is an input to a QProgressBar, set to zero if unknown.
 	void finished(); ///< should be emitted when at the end of postProcessingSlot
 	void productChanged(); ///< emitted whenever product string has changed
-//	void progress();
+	void progress(int step, int maxSteps); ///< emitted during run, possibly from a secondary thread. Input to a QProgressBar.
+	void cancelRequested(); ///< emitted when cancel() is called.
 
 protected:
   void startTiming();
   void stopTiming();
+  void resetCancel(); ///< call at start of execute.
   bool mUseDefaultMessages;
 
   QString getSecondsPassedAsString() const;
@@ -90,6 +110,8 @@ private:
   QTimer*    mTimer;
   QDateTime mStartTime;
   QString   mProduct;
+  QAtomicInt mCancelRequested;
+  QAtomicInt mLastProgressStep;
 };
 typedef boost::shared_ptr<TimedBaseAlgorithm> TimedAlgorithmPtr;
 
@@ -0,0 +1,234 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+                 
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+                 
+CustusX is released under a BSD 3-Clause license.
+                 
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxWorkScheduler.h"
+
+#include <QThread>
+#include <QWaitCondition>
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+#include "cxLogger.h"
+
+namespace cx
+{
+
+namespace
+{
+
+/** Ranges of a WorkScheduler::parallelFor() call, taken in order by
+  * the calling thread and the helper tasks.
+  */
+class ParallelForRanges
+{
+public:
+	ParallelForRanges(qint64 size, int count, boost::function<void(qint64, qint64)> function) :
+		mSize(size), mCount(count), mNext(0), mFinished(0), mFunction(function)
+	{}
+
+	/** Run the next range. Return false if all ranges are taken.
+	  */
+	bool runNext()
+	{
+		int index;
+		{
+			QMutexLocker sentry(&mMutex);
+			if (mNext >= mCount)
+				return false;
+			index = mNext++;
+		}
+
+		std::exception_ptr exception;
+		try
+		{
+			mFunction(mSize*index/mCount, mSize*(index+1)/mCount);
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+
+		QMutexLocker sentry(&mMutex);
+		if (exception && !mException)
+			mException = exception;
+		if (++mFinished == mCount)
+			mDone.wakeAll();
+		return true;
+	}
+
+	void runAll()
+	{
+		while (this->runNext())
+			;
+	}
+
+	/** Wait until all ranges are finished, including those run by other threads.
+	  */
+	void waitForDone()
+	{
+		QMutexLocker sentry(&mMutex);
+		while (mFinished < mCount)
+			mDone.wait(&mMutex);
+		if (mException)
+			std::rethrow_exception(mException);
+	}
+
+private:
+	qint64 mSize;
+	int mCount;
+	int mNext;
+	int mFinished;
+	boost::function<void(qint64, qint64)> mFunction;
+	std::exception_ptr mException;
+	QMutex mMutex;
+	QWaitCondition mDone;
+};
+
+void runParallelForRanges(boost::shared_ptr<ParallelForRanges> ranges)
+{
+	ranges->runAll();
+}
+
+} // namespace
+
+void reportScheduledTaskException(const char* what)
+{
+	if (what)
+		reportError(QString("Unhandled exception in scheduled task: %1").arg(what));
+	else
+		reportError("Unknown exception in scheduled task");
+}
+
+WorkScheduler* WorkScheduler::getInstance()
+{
+	static WorkScheduler instance;
+	return &instance;
+}
+
+WorkScheduler::WorkScheduler() :
+	mRunningBackgroundThreads(0)
+{
+	int threads = std::max(2, QThread::idealThreadCount());
+	mPool.setMaxThreadCount(threads);
+	mMaxBackgroundThreads = std::max(1, threads/2);
+}
+
+void WorkScheduler::setMaxThreadCount(int count)
+{
+	count = std::max(1, count);
+	mPool.setMaxThreadCount(count);
+	{
+		QMutexLocker sentry(&mMutex);
+		mMaxBackgroundThreads = std::max(1, count/2);
+	}
+	this->startPendingBackground();
+}
+
+int WorkScheduler::getMaxThreadCount() const
+{
+	return mPool.maxThreadCount();
+}
+
+void WorkScheduler::setMaxBackgroundThreadCount(int count)
+{
+	{
+		QMutexLocker sentry(&mMutex);
+		mMaxBackgroundThreads = std::max(1, count);
+	}
+	this->startPendingBackground();
+}
+
+int WorkScheduler::getMaxBackgroundThreadCount() const
+{
+	QMutexLocker sentry(&mMutex);
+	return mMaxBackgroundThreads;
+}
+
+void WorkScheduler::start(QRunnable* task, WORK_PRIORITY priority)
+{
+	if (priority==wpBACKGROUND)
+	{
+		QMutexLocker sentry(&mMutex);
+		if (mRunningBackgroundThreads >= mMaxBackgroundThreads)
+		{
+			mPendingBackground.push_back(task);
+			return;
+		}
+		++mRunningBackgroundThreads;
+	}
+
+	mPool.start(task, priority);
+}
+
+/** Called from the pool thread at the end of each background task.
+  */
+void WorkScheduler::backgroundTaskFinished()
+{
+	{
+		QMutexLocker sentry(&mMutex);
+		--mRunningBackgroundThreads;
+	}
+	this->startPendingBackground();
+}
+
+/** Start pending background tasks while below the background thread limit.
+  */
+void WorkScheduler::startPendingBackground()
+{
+	while (true)
+	{
+		QMutexLocker sentry(&mMutex);
+		if (mPendingBackground.empty() || (mRunningBackgroundThreads >= mMaxBackgroundThreads))
+			return;
+		QRunnable* next = mPendingBackground.front();
+		mPendingBackground.pop_front();
+		++mRunningBackgroundThreads;
+		sentry.unlock();
+
+		mPool.start(next, wpBACKGROUND);
+	}
+}
+
+int WorkScheduler::getRangeCount(qint64 size, qint64 minParallelSize) const
+{
+	if (size <= 0)
+		return 0;
+	if (size < minParallelSize)
+		return 1;
+	return int(std::min<qint64>(size, 4*this->getMaxThreadCount()));
+}
+
+void WorkScheduler::parallelFor(qint64 size, qint64 minParallelSize, boost::function<void(qint64, qint64)> function, WORK_PRIORITY priority)
+{
+	int count = this->getRangeCount(size, minParallelSize);
+	if (count == 0)
+		return;
+	if (count == 1)
+	{
+		function(0, size);
+		return;
+	}
+
+	// helpers started after all ranges are taken return immediately.
+	boost::shared_ptr<ParallelForRanges> ranges(new ParallelForRanges(size, count, function));
+	int helpers = std::min(count, this->getMaxThreadCount()) - 1;
+	for (int i=0; i<helpers; ++i)
+		this->run<void>(boost::bind(&runParallelForRanges, ranges), priority);
+
+	ranges->runAll();
+	ranges->waitForDone();
+}
+
+bool WorkScheduler::waitForDone(int msecs)
+{
+	return mPool.waitForDone(msecs);
+}
+
+} // namespace cx
@@ -0,0 +1,198 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+                 
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+                 
+CustusX is released under a BSD 3-Clause license.
+                 
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXWORKSCHEDULER_H_
+#define CXWORKSCHEDULER_H_
+
+#include "cxResourceExport.h"
+
+#include <list>
+#include <exception>
+#include <QMutex>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QException>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+
+namespace cx
+{
+
+/** Priority classes for work run through the WorkScheduler.
+ *
+ * \ingroup cx_resource_core_algorithms
+ */
+enum WORK_PRIORITY
+{
+	wpBACKGROUND = 0, ///< long running jobs such as reconstruction, limited to a subset of the threads
+	wpNORMAL = 1,
+	wpINTERACTIVE = 2 ///< jobs the user is waiting for, such as filters
+};
+
+/** Runnable wrapping a function, publishing the result through a QFuture.
+ *
+ * \ingroup cx_resource_core_algorithms
+ */
+template <class T>
+class ScheduledTask : public QRunnable
+{
+public:
+	ScheduledTask(boost::function<T()> function) : mFunction(function)
+	{
+		this->setAutoDelete(true);
+		mInterface.reportStarted();
+	}
+	virtual ~ScheduledTask() {}
+	QFuture<T> future() { return mInterface.future(); }
+	void setFinishedCallback(boost::function<void()> callback) { mFinishedCallback = callback; }
+	virtual void run();
+
+private:
+	void finish()
+	{
+		mInterface.reportFinished();
+		if (mFinishedCallback)
+			mFinishedCallback();
+	}
+	boost::function<T()> mFunction;
+	boost::function<void()> mFinishedCallback;
+	QFutureInterface<T> mInterface;
+};
+
+/** Log an exception escaping a scheduled task. what is NULL for unknown exceptions.
+ */
+cxResource_EXPORT void reportScheduledTaskException(const char* what);
+
+/** Exceptions thrown by the function are reported through the future, as
+  * QtConcurrent::run does, and are rethrown by QFuture::result().
+  * The task is always finished, thus a failing task never blocks the scheduler.
+  */
+template <class T>
+void ScheduledTask<T>::run()
+{
+	try
+	{
+		mInterface.reportResult(mFunction());
+	}
+	catch (QException& e)
+	{
+		mInterface.reportException(e);
+	}
+	catch (std::exception& e)
+	{
+		reportScheduledTaskException(e.what());
+		mInterface.reportException(QUnhandledException());
+	}
+	catch (...)
+	{
+		reportScheduledTaskException(NULL);
+		mInterface.reportException(QUnhandledException());
+	}
+	this->finish();
+}
+
+template <>
+inline void ScheduledTask<void>::run()
+{
+	try
+	{
+		mFunction();
+	}
+	catch (QException& e)
+	{
+		mInterface.reportException(e);
+	}
+	catch (std::exception& e)
+	{
+		reportScheduledTaskException(e.what());
+		mInterface.reportException(QUnhandledException());
+	}
+	catch (...)
+	{
+		reportScheduledTaskException(NULL);
+		mInterface.reportException(QUnhandledException());
+	}
+	this->finish();
+}
+
+/** Shared, bounded thread pool for algorithms.
+ *
+ * All ThreadedTimedAlgorithm instances run their calculate() through
+ * this scheduler. The total number of threads is bounded, and queued
+ * work is started in priority order.
+ *
+ * wpBACKGROUND work is in addition limited to a subset of the threads,
+ * so that long background jobs (e.g. reconstruction) always leave room
+ * for interactive work (e.g. filters).
+ *
+ * parallelFor() splits data parallel loops over the same pool.
+ *
+ * \ingroup cx_resource_core_algorithms
+ * \date Oct 19, 2026
+ */
+class cxResource_EXPORT WorkScheduler
+{
+public:
+	static WorkScheduler* getInstance();
+
+	void setMaxThreadCount(int count); ///< also sets the background thread count to half of count
+	int getMaxThreadCount() const;
+	void setMaxBackgroundThreadCount(int count);
+	int getMaxBackgroundThreadCount() const;
+
+	/** Run function in the pool with the given priority.
+	  * The returned future can be used with a QFutureWatcher.
+	  */
+	template <class T>
+	QFuture<T> run(boost::function<T()> function, WORK_PRIORITY priority=wpNORMAL)
+	{
+		ScheduledTask<T>* task = new ScheduledTask<T>(function);
+		QFuture<T> retval = task->future();
+		if (priority==wpBACKGROUND)
+			task->setFinishedCallback(boost::bind(&WorkScheduler::backgroundTaskFinished, this));
+		this->start(task, priority);
+		return retval;
+	}
+
+	/** Call function(begin, end) for consecutive ranges covering [0,size), in
+	  * parallel, and return when all are done. Sizes below minParallelSize are
+	  * run as one range in the calling thread.
+	  *
+	  * The calling thread takes part in the work, thus calls from inside the
+	  * pool never deadlock. The first exception thrown by function is rethrown
+	  * after all ranges are done.
+	  */
+	void parallelFor(qint64 size, qint64 minParallelSize, boost::function<void(qint64, qint64)> function, WORK_PRIORITY priority=wpNORMAL);
+	int getRangeCount(qint64 size, qint64 minParallelSize) const; ///< number of ranges used by parallelFor()
+
+	bool waitForDone(int msecs = -1); ///< wait for all running and queued tasks, for testing/shutdown.
+
+private:
+	WorkScheduler();
+	WorkScheduler(const WorkScheduler&);
+	WorkScheduler& operator=(const WorkScheduler&);
+
+	void start(QRunnable* task, WORK_PRIORITY priority);
+	void backgroundTaskFinished();
+	void startPendingBackground();
+
+	QThreadPool mPool;
+	mutable QMutex mMutex;
+	int mMaxBackgroundThreads;
+	int mRunningBackgroundThreads;
+	std::list<QRunnable*> mPendingBackground;
+};
+
+} // namespace cx
+
+#endif /* CXWORKSCHEDULER_H_ */
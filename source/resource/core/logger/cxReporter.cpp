@@ -38,7 +38,8 @@ ReporterPtr reporter()
 	return Reporter::getInstance();
 }
 
-Reporter::Reporter()
+Reporter::Reporter() :
+	mBinaryLogFormat(false)
 {	
 }
 
@@ -67,7 +68,9 @@ void Reporter::initialize()
 
 LogThreadPtr Reporter::createWorker()
 {
-	return LogThreadPtr(new ReporterThread());
+	boost::shared_ptr<ReporterThread> worker(new ReporterThread());
+	worker->setLogFileFormat(mBinaryLogFormat ? lfBINARY : lfTEXT);
+	return worker;
 }
 
 void Reporter::shutdown()
@@ -86,6 +89,14 @@ void Reporter::setAudioSource(AudioPtr audioSource)
   mAudioSource = audioSource;
 }
 
+void Reporter::setBinaryLogFormat(bool on)
+{
+	mBinaryLogFormat = on;
+	boost::shared_ptr<ReporterThread> worker = boost::dynamic_pointer_cast<ReporterThread>(mWorker);
+	if (worker)
+		worker->setLogFileFormat(mBinaryLogFormat ? lfBINARY : lfTEXT);
+}
+
 bool Reporter::hasAudioSource() const
 {
   return mAudioSource ? true : false;
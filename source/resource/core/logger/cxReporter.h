@@ -73,6 +73,7 @@ public:
   static ReporterPtr getInstance(); ///< Returns a reference to the only Reporter that exists.
 
   void setAudioSource(AudioPtr audioSource); ///< define sounds to go with the messages.
+  void setBinaryLogFormat(bool on); ///< write log files in the compact binary format (.cxlog) instead of text.
 
   //Text
   void sendInfo(QString info); ///< Used to report normal interesting activity, no sound associated
@@ -113,6 +114,7 @@ private:
   void playSound(MESSAGE_LEVEL messageLevel);
 
   AudioPtr mAudioSource;
+  bool mBinaryLogFormat;
 
 //  static Reporter *mTheInstance; // global variable
   static boost::weak_ptr<Reporter> mWeakInstance; // global variable
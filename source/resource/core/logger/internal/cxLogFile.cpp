@@ -14,6 +14,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <iostream>
 #include <QTextStream>
 #include <QFileInfo>
+#include <QDataStream>
 #include "cxTime.h"
 #include "cxEnumConversion.h"
 
@@ -21,46 +22,130 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 namespace cx
 {
 
+namespace
+{
+/** Binary log file layout:
+ *   preamble: magic (8 bytes) + quint32 version
+ *   records:  quint32 size + payload of given size
+ *   payload:  quint8 type, qint64 msecs since epoch, qint32 level,
+ *             QString thread, QString file, qint32 line, QString function, QString text
+ */
+const char* binaryMagic = "CXLOGBIN";
+const int binaryMagicSize = 8;
+const quint32 binaryVersion = 1;
+const int binaryPreambleSize = binaryMagicSize + sizeof(quint32);
+const quint32 binaryMaxRecordSize = 64*1024*1024; ///< larger sizes are treated as corruption
+enum BINARY_RECORD_TYPE
+{
+	brSESSION_START = 0,
+	brMESSAGE = 1
+};
+}
+
 LogFile::LogFile() :
+	mFormat(lfTEXT),
 	mFilePosition(0)
 {
 
 }
 
-LogFile LogFile::fromChannel(QString path, QString channel)
+LogFile LogFile::fromChannel(QString path, QString channel, LOGFILE_FORMAT format)
 {
 	LogFile retval;
 	retval.mPath = path;
 	retval.mChannel = channel;
+	retval.mFormat = format;
 	return retval;
 }
 
+QString LogFile::getSuffix() const
+{
+	if (mFormat==lfBINARY)
+		return "cxlog";
+	return "txt";
+}
+
 QString LogFile::getFilename() const
 {
-	return QString("%1/org.custusx.log.%2.txt").arg(mPath).arg(mChannel);
+	return QString("%1/org.custusx.log.%2.%3").arg(mPath).arg(mChannel).arg(this->getSuffix());
 }
 
 LogFile LogFile::fromFilename(QString filename)
 {
 	LogFile retval;
-	retval.mPath = QFileInfo(filename).path();
-	retval.mChannel = QFileInfo(filename).completeBaseName().split(".").back();
+	QFileInfo info(filename);
+	retval.mPath = info.path();
+	retval.mFormat = (info.suffix()=="cxlog") ? lfBINARY : lfTEXT;
+	retval.mChannel = info.completeBaseName().split(".").back();
 	return retval;
 }
 
-void LogFile::writeHeader()
+QByteArray LogFile::encodeFilePreamble() const
 {
+	if (mFormat!=lfBINARY)
+		return QByteArray();
+
+	QByteArray retval(binaryMagic, binaryMagicSize);
+	QDataStream stream(&retval, QIODevice::WriteOnly | QIODevice::Append);
+	stream << binaryVersion;
+	return retval;
+}
+
+QByteArray LogFile::encodeHeader() const
+{
+	if (mFormat==lfBINARY)
+	{
+		Message msg(QString("Session initialized: %1").arg(mChannel), mlSUCCESS);
+		msg.mThread = "";
+		return this->encodeBinaryRecord(brSESSION_START, msg);
+	}
+
 	QString timestamp = QDateTime::currentDateTime().toString(timestampMilliSecondsFormatNice());
 	QString formatInfo = "[timestamp][source info][severity][thread] <text> ";
 	QString text = QString("-------> Logging initialized [%1], format: %2\n").arg(timestamp).arg(formatInfo);
-	bool success = this->appendToLogfile(this->getFilename(), text);
+	return text.toUtf8();
+}
+
+QByteArray LogFile::encodeMessage(Message message) const
+{
+	if (mFormat==lfBINARY)
+		return this->encodeBinaryRecord(brMESSAGE, message);
+
+	QString text = this->formatMessage(message) + "\n";
+	return text.toUtf8();
+}
+
+QByteArray LogFile::encodeBinaryRecord(int type, Message message) const
+{
+	QByteArray payload;
+	QDataStream stream(&payload, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << quint8(type);
+	stream << qint64(message.getTimeStamp().toMSecsSinceEpoch());
+	stream << qint32(message.getMessageLevel());
+	stream << message.mThread;
+	stream << message.mSourceFile;
+	stream << qint32(message.mSourceLine);
+	stream << message.mSourceFunction;
+	stream << message.getText();
+
+	QByteArray retval;
+	QDataStream header(&retval, QIODevice::WriteOnly);
+	header << quint32(payload.size());
+	retval.append(payload);
+	return retval;
+}
+
+void LogFile::writeHeader()
+{
+	QByteArray data = this->encodeHeader();
+	bool success = this->appendToLogfile(this->getFilename(), data);
 //	return success;
 }
 
 void LogFile::write(Message message)
 {
-	QString text = this->formatMessage(message) + "\n";
-	this->appendToLogfile(this->getFilename(), text);
+	this->appendToLogfile(this->getFilename(), this->encodeMessage(message));
 }
 
 bool LogFile::isWritable() const
@@ -79,7 +164,7 @@ QString LogFile::timestampFormat() const
 	return "hh:mm:ss.zzz";
 }
 
-QString LogFile::formatMessage(Message msg)
+QString LogFile::formatMessage(Message msg) const
 {
 	QString retval;
 
@@ -108,22 +193,22 @@ QString LogFile::formatMessage(Message msg)
 
 /** Open the logfile and append the input text to it
  */
-bool LogFile::appendToLogfile(QString filename, QString text)
+bool LogFile::appendToLogfile(QString filename, QByteArray data)
 {
 	if (filename.isEmpty())
 		return false;
 
 	QFile file(filename);
-	QTextStream stream;
 
 	if (!file.open(QFile::WriteOnly | QFile::Append))
 	{
 		return false;
 	}
 
-	stream.setDevice(&file);
-	stream << text;
-	stream << flush;
+	if (file.size()==0)
+		file.write(this->encodeFilePreamble());
+	file.write(data);
+	file.flush();
 
 	return true;
 }
@@ -135,7 +220,91 @@ QRegExp LogFile::getRX_Timestamp() const
 
 std::vector<Message> LogFile::readMessages()
 {
-	QString text = this->readFileTail();
+	if (mFormat==lfBINARY)
+		return this->readBinaryMessages();
+	return this->readTextMessages();
+}
+
+std::vector<Message> LogFile::readBinaryMessages()
+{
+	std::vector<Message> retval;
+
+	QByteArray data = this->readFileTailBytes();
+	qint64 start = mFilePosition - data.size();
+	int pos = 0;
+
+	if (start==0) // at start of file: verify and skip preamble
+	{
+		if (data.size() < binaryPreambleSize)
+		{
+			mFilePosition = 0;
+			return retval;
+		}
+		if (data.left(binaryMagicSize) != QByteArray(binaryMagic, binaryMagicSize))
+		{
+			Message msg(QString("Unrecognized binary log file %1").arg(this->getFilename()), mlERROR);
+			msg.mChannel = mChannel;
+			retval.push_back(msg);
+			return retval;
+		}
+		pos = binaryPreambleSize;
+	}
+
+	while (data.size()-pos >= int(sizeof(quint32)))
+	{
+		QDataStream sizeStream(data.mid(pos, sizeof(quint32)));
+		quint32 size = 0;
+		sizeStream >> size;
+		if (size > binaryMaxRecordSize)
+		{
+			// records cannot be found beyond a corrupt size: skip the rest of the data read.
+			Message msg(QString("Corrupt record size %1 in binary log file %2 at %3, skipped %4 bytes")
+						.arg(size).arg(this->getFilename()).arg(start+pos).arg(data.size()-pos), mlERROR);
+			msg.mChannel = mChannel;
+			retval.push_back(msg);
+			pos = data.size();
+			break;
+		}
+		if (data.size()-pos-int(sizeof(quint32)) < int(size))
+			break; // incomplete record, read again when the rest is flushed
+
+		QDataStream stream(data.mid(pos+sizeof(quint32), size));
+		stream.setVersion(QDataStream::Qt_5_0);
+		quint8 type;
+		qint64 msecs;
+		qint32 level;
+		qint32 line;
+		Message msg;
+		stream >> type >> msecs >> level;
+		stream >> msg.mThread >> msg.mSourceFile >> line >> msg.mSourceFunction >> msg.mText;
+		if (stream.status()!=QDataStream::Ok)
+		{
+			// the record is complete, thus skip it instead of trying again.
+			Message error(QString("Failed to parse record in binary log file %1 at %2")
+						  .arg(this->getFilename()).arg(start+pos), mlERROR);
+			error.mChannel = mChannel;
+			retval.push_back(error);
+			pos += sizeof(quint32) + size;
+			continue;
+		}
+		msg.mMessageLevel = MESSAGE_LEVEL(level);
+		msg.mTimeStamp = QDateTime::fromMSecsSinceEpoch(msecs);
+		msg.mSourceLine = line;
+		msg.mChannel = mChannel;
+		if (type==brSESSION_START)
+			mInitTimestamp = msg.mTimeStamp;
+		retval.push_back(msg);
+
+		pos += sizeof(quint32) + size;
+	}
+
+	mFilePosition = start + pos;
+	return retval;
+}
+
+std::vector<Message> LogFile::readTextMessages()
+{
+	QString text = QString::fromUtf8(this->readFileTailBytes());
 
 //	text = this->removeEarlierSessionsAndSetStartTime(text);
 	if (text.endsWith("\n"))
@@ -284,16 +453,37 @@ QDateTime LogFile::readTimestampFromSessionStartLine(QString text)
 	return ts;
 }
 
-QString LogFile::readFileTail()
+bool LogFile::openForRead()
+{
+	if (mReadFile && mReadFile->isOpen())
+		return true;
+	mReadFile.reset(new QFile(this->getFilename()));
+	return mReadFile->open(QIODevice::ReadOnly);
+}
+
+/** Read everything appended since the last read.
+ *  The file is kept open between calls. If the file has been
+ *  truncated or replaced, reading restarts from the beginning.
+ *  On return, mFilePosition points to the end of the returned data.
+ */
+QByteArray LogFile::readFileTailBytes()
 {
-	QFile file(this->getFilename());
-	file.open(QIODevice::ReadOnly);
+	if (!this->openForRead())
+		return QByteArray();
+
+	if (mReadFile->size() < mFilePosition)
+	{
+		mReadFile->close();
+		mFilePosition = 0;
+		if (!this->openForRead())
+			return QByteArray();
+	}
 
-	file.seek(mFilePosition);
-	QString text = file.readAll();
-	mFilePosition = file.pos();
+	mReadFile->seek(mFilePosition);
+	QByteArray data = mReadFile->readAll();
+	mFilePosition = mReadFile->pos();
 
-	return text;
+	return data;
 }
 
 
@@ -14,19 +14,35 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include "cxResourceExport.h"
 #include "cxLogMessage.h"
+#include "boost/shared_ptr.hpp"
 
 namespace cx
 {
 
+/** On-disk format of a log file.
+ *
+ * lfTEXT is the human readable default. lfBINARY is a compact
+ * length-prefixed record format, faster to write and parse,
+ * intended for high-volume debug channels.
+ */
+enum LOGFILE_FORMAT
+{
+	lfTEXT,
+	lfBINARY
+};
+
 /**\brief Log file, format, read and write.
+ *
+ * The format is given by the file suffix: .txt for text, .cxlog for binary.
+ * Use LogFileWriter for buffered writing, write() opens the file for each call.
  *
  * \addtogroup cx_resource_core_logger
  */
-class LogFile
+class cxResource_EXPORT LogFile
 {
 public:
 	explicit LogFile();
-	static LogFile fromChannel(QString path, QString channel);
+	static LogFile fromChannel(QString path, QString channel, LOGFILE_FORMAT format=lfTEXT);
 	static LogFile fromFilename(QString filename);
 	virtual ~LogFile() {}
 
@@ -34,21 +50,35 @@ public:
 	void write(Message message);
 	bool isWritable() const;
 	QString getFilename() const;
+	QString getChannel() const { return mChannel; }
+	LOGFILE_FORMAT getFormat() const { return mFormat; }
+
+	QByteArray encodeHeader() const; ///< session start marker, in the file format
+	QByteArray encodeMessage(Message message) const; ///< one message, in the file format
+	QByteArray encodeFilePreamble() const; ///< data required at the start of an empty file
 
 	std::vector<Message> readMessages();
 
 private:
 	QString mPath;
 	QString mChannel;
-	int mFilePosition;
+	LOGFILE_FORMAT mFormat;
+	qint64 mFilePosition;
 	QDateTime mInitTimestamp;
+	boost::shared_ptr<QFile> mReadFile; ///< kept open between reads, shared among copies
+
+	std::vector<Message> readTextMessages();
+	std::vector<Message> readBinaryMessages();
+	QByteArray readFileTailBytes();
+	bool openForRead();
+	QString getSuffix() const;
+	QByteArray encodeBinaryRecord(int type, Message message) const;
 
 	Message readMessageFirstLine(QString line);
 	MESSAGE_LEVEL readMessageLevel(QString line);
 	QRegExp getRX_Timestamp() const;
-	QString formatMessage(Message msg);
-	bool appendToLogfile(QString filename, QString text);
-	QString readFileTail();
+	QString formatMessage(Message msg) const;
+	bool appendToLogfile(QString filename, QByteArray data);
 //	QString removeEarlierSessionsAndSetStartTime(QString text);
 //	std::vector<std::pair<QDateTime, QString> > splitIntoSessions(QString text);
 	QString timestampFormat() const;
@@ -52,6 +52,7 @@ void LogFileWatcherThread::onDirectoryChanged(const QString& path)
 	nameFilters << "org.custusx.*";
 	QStringList current = info.entryList(nameFilters, QDir::Files);
 	current.removeAll("org.custusx.log.all.txt");
+	current.removeAll("org.custusx.log.all.cxlog");
 	current.sort();
 
 	if (current==mInitializedFiles)
@@ -0,0 +1,131 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+                 
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+                 
+CustusX is released under a BSD 3-Clause license.
+                 
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxLogFileWriter.h"
+
+#include <QTimer>
+#include <QThread>
+
+namespace cx
+{
+
+LogFileWriter::LogFileWriter(QObject* parent) :
+	QObject(parent),
+	mMaxBufferSize(64*1024)
+{
+	mFlushTimer = new QTimer(this);
+	mFlushTimer->setSingleShot(true);
+	mFlushTimer->setInterval(500);
+	connect(mFlushTimer, &QTimer::timeout, this, &LogFileWriter::onFlushTimeout);
+}
+
+LogFileWriter::~LogFileWriter()
+{
+	this->close();
+}
+
+void LogFileWriter::setMaxBufferSize(int bytes)
+{
+	mMaxBufferSize = bytes;
+}
+
+void LogFileWriter::setFlushInterval(int milliseconds)
+{
+	mFlushTimer->setInterval(milliseconds);
+}
+
+LogFileWriter::OpenFile* LogFileWriter::getOpenFile(const LogFile& file)
+{
+	QString filename = file.getFilename();
+	OpenFile& entry = mFiles[filename];
+
+	if (!entry.mFile)
+	{
+		entry.mFile.reset(new QFile(filename));
+		if (entry.mFile->open(QFile::WriteOnly | QFile::Append))
+		{
+			if (entry.mFile->size()==0)
+				entry.mPending.append(file.encodeFilePreamble());
+		}
+	}
+
+	if (!entry.mFile->isOpen())
+		return NULL;
+	return &entry;
+}
+
+bool LogFileWriter::writeHeader(LogFile file)
+{
+	OpenFile* entry = this->getOpenFile(file);
+	if (!entry)
+		return false;
+	entry->mPending.append(file.encodeHeader());
+	this->flush(entry);
+	return true;
+}
+
+void LogFileWriter::write(LogFile file, Message message)
+{
+	this->append(file, file.encodeMessage(message));
+
+	if ((message.getMessageLevel()==mlERROR) || (message.getMessageLevel()==mlCERR))
+		this->flush();
+}
+
+void LogFileWriter::append(const LogFile& file, const QByteArray& data)
+{
+	OpenFile* entry = this->getOpenFile(file);
+	if (!entry)
+		return;
+
+	entry->mPending.append(data);
+
+	if (entry->mPending.size() >= mMaxBufferSize)
+		this->flush(entry);
+	else
+		this->startFlushTimer();
+}
+
+void LogFileWriter::startFlushTimer()
+{
+	if (!mFlushTimer->isActive())
+		mFlushTimer->start();
+}
+
+void LogFileWriter::onFlushTimeout()
+{
+	this->flush();
+}
+
+void LogFileWriter::flush(OpenFile* file)
+{
+	if (file->mPending.isEmpty() || !file->mFile->isOpen())
+		return;
+	file->mFile->write(file->mPending);
+	file->mFile->flush();
+	file->mPending.clear();
+}
+
+void LogFileWriter::flush()
+{
+	for (std::map<QString, OpenFile>::iterator iter=mFiles.begin(); iter!=mFiles.end(); ++iter)
+		this->flush(&iter->second);
+	if (this->thread()==QThread::currentThread())
+		mFlushTimer->stop();
+}
+
+void LogFileWriter::close()
+{
+	this->flush();
+	mFiles.clear();
+}
+
+} //namespace cx
@@ -0,0 +1,79 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+                 
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+                 
+CustusX is released under a BSD 3-Clause license.
+                 
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXLOGFILEWRITER_H
+#define CXLOGFILEWRITER_H
+
+#include "cxResourceExport.h"
+
+#include <map>
+#include <QObject>
+#include <QFile>
+#include "boost/shared_ptr.hpp"
+#include "cxLogFile.h"
+
+class QTimer;
+
+namespace cx
+{
+
+/**\brief Buffered writer for log files.
+ *
+ * Keeps the log files open and collects the formatted messages
+ * in memory. Pending data is written to disk when:
+ *  - the pending data for a file exceeds the max buffer size,
+ *  - the flush interval has passed since the first pending message,
+ *  - an error message is written,
+ *  - flush() or close() is called.
+ *
+ * Must be used from the thread owning the object.
+ *
+ * \addtogroup cx_resource_core_logger
+ */
+class cxResource_EXPORT LogFileWriter : public QObject
+{
+	Q_OBJECT
+
+public:
+	LogFileWriter(QObject* parent = NULL);
+	virtual ~LogFileWriter();
+
+	void setMaxBufferSize(int bytes);
+	void setFlushInterval(int milliseconds);
+
+	bool writeHeader(LogFile file); ///< write session header, flushed immediately. Return false if file cannot be opened.
+	void write(LogFile file, Message message);
+	void flush(); ///< write all pending data to disk
+	void close(); ///< flush and close all files
+
+private slots:
+	void onFlushTimeout();
+
+private:
+	struct OpenFile
+	{
+		boost::shared_ptr<QFile> mFile;
+		QByteArray mPending;
+	};
+
+	OpenFile* getOpenFile(const LogFile& file);
+	void append(const LogFile& file, const QByteArray& data);
+	void flush(OpenFile* file);
+	void startFlushTimer();
+
+	std::map<QString, OpenFile> mFiles;
+	QTimer* mFlushTimer;
+	int mMaxBufferSize;
+};
+
+} //namespace cx
+
+#endif // CXLOGFILEWRITER_H
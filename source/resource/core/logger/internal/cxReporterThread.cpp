@@ -30,13 +30,16 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxReporterMessageRepository.h"
 #include "cxTime.h"
 #include "cxLogFile.h"
+#include "cxLogFileWriter.h"
 
 namespace cx
 {
 
 ReporterThread::ReporterThread(QObject *parent) :
-	LogThread(parent)
+	LogThread(parent),
+	mFormat(lfTEXT)
 {
+	mWriter = new LogFileWriter(this); // child: follows this into the log thread
 	qInstallMessageHandler(convertQtMessagesToCxMessages);
 	qRegisterMetaType<Message>("Message");
 
@@ -52,6 +55,7 @@ ReporterThread::ReporterThread(QObject *parent) :
 
 ReporterThread::~ReporterThread()
 {
+	mWriter->close();
 	qInstallMessageHandler(0);
 	mCout.reset();
 	mCerr.reset();
@@ -65,9 +69,7 @@ bool ReporterThread::initializeLogFile(LogFile file)
 
 	mInitializedFiles << filename;
 
-	file.writeHeader();
-
-	if (!file.isWritable())
+	if (!mWriter->writeHeader(file))
 	{
 		this->processMessage(Message("Failed to open log file " + filename, mlERROR));
 		return false;
@@ -78,6 +80,7 @@ bool ReporterThread::initializeLogFile(LogFile file)
 
 void ReporterThread::executeSetLoggingFolder(QString absoluteLoggingFolderPath)
 {
+	mWriter->close();
 	mLogPath = absoluteLoggingFolderPath;
 
 	QFileInfo(mLogPath+"/").absoluteDir().mkpath(".");
@@ -85,8 +88,26 @@ void ReporterThread::executeSetLoggingFolder(QString absoluteLoggingFolderPath)
 //	this->initializeLogFile(this->getFilenameForChannel("console"));
 //	this->initializeLogFile(this->getFilenameForChannel("all"));
 
-	this->initializeLogFile(LogFile::fromChannel(mLogPath, "console"));
-	this->initializeLogFile(LogFile::fromChannel(mLogPath, "all"));
+	this->initializeLogFile(LogFile::fromChannel(mLogPath, "console", mFormat));
+	this->initializeLogFile(LogFile::fromChannel(mLogPath, "all", mFormat));
+}
+
+void ReporterThread::setLogFileFormat(LOGFILE_FORMAT format)
+{
+	ThreadMethodInvoker::ActionType action = boost::bind(&ReporterThread::executeSetLogFileFormat, this, format);
+	this->callInLogThread(action);
+}
+
+void ReporterThread::executeSetLogFileFormat(LOGFILE_FORMAT format)
+{
+	if (mFormat==format)
+		return;
+	mFormat = format;
+	if (mLogPath.isEmpty())
+		return;
+	mWriter->close();
+	this->initializeLogFile(LogFile::fromChannel(mLogPath, "console", mFormat));
+	this->initializeLogFile(LogFile::fromChannel(mLogPath, "all", mFormat));
 }
 
 void ReporterThread::logMessage(Message msg)
@@ -112,13 +133,13 @@ void ReporterThread::sendToFile(Message message)
 		return;
 
 //	QString channelFile = this->getFilenameForChannel(message.mChannel);
-	LogFile channelLog = LogFile::fromChannel(mLogPath, message.mChannel);
-	LogFile allLog = LogFile::fromChannel(mLogPath, "all");
+	LogFile channelLog = LogFile::fromChannel(mLogPath, message.mChannel, mFormat);
+	LogFile allLog = LogFile::fromChannel(mLogPath, "all", mFormat);
 
 	this->initializeLogFile(channelLog);
 
-	channelLog.write(message);
-	allLog.write(message);
+	mWriter->write(channelLog, message);
+	mWriter->write(allLog, message);
 }
 
 void ReporterThread::sendToCout(Message message)
@@ -32,6 +32,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <QList>
 #include <QThread>
 #include "cxLogThread.h"
+#include "cxLogFile.h"
 
 class QString;
 class QDomNode;
@@ -62,6 +63,7 @@ public:
 
 public slots:
 	virtual void logMessage(Message msg);
+	void setLogFileFormat(LOGFILE_FORMAT format); ///< format used for files opened after this call
 
 signals:
 	void emittedMessage(Message message); ///< emitted for each new message, in addition to writing to file.
@@ -73,6 +75,7 @@ private slots:
 	void onMessageEmitted(Message msg);
 private:
 	bool initializeLogFile(LogFile file);
+	void executeSetLogFileFormat(LOGFILE_FORMAT format);
 
 	void sendToFile(Message message);
 	void sendToCout(Message message);
@@ -83,6 +86,8 @@ private:
 
 	QString mLogPath;
 	QStringList mInitializedFiles;
+	LOGFILE_FORMAT mFormat;
+	class LogFileWriter* mWriter;
 
 };
 
@@ -80,6 +80,7 @@ void StateService::fillDefaultSettings()
 	this->fillDefault("Ultrasound/acquisitionName", "US-Acq");
 	this->fillDefault("Ultrasound/8bitAcquisitionData", false);
 	this->fillDefault("Ultrasound/CompressAcquisition", true);
+	this->fillDefault("Ultrasound/RecordDirectlyToPatient", true);
 	this->fillDefault("View3D/sphereRadius", 1.0);
 	this->fillDefault("View3D/labelSize", 2.5);
 	this->fillDefault("Navigation/anyplaneViewOffset", 0.25);
@@ -96,6 +97,7 @@ void StateService::fillDefaultSettings()
 	this->fillDefault("View2D/showManualTool", true);
 
 	this->fillDefault("showSectorInRTView", true);
+	this->fillDefault("Video/frameHistoryMaxBytes", 64*1024*1024);
 	this->fillDefault("View/showOrientationAnnotation", true);
 	this->fillDefault("View3D/stereoType", stFRAME_SEQUENTIAL);
 	this->fillDefault("View3D/eyeAngle", 4.0);
@@ -107,6 +109,9 @@ void StateService::fillDefaultSettings()
 	this->fillDefault("View3D/depthPeeling", false);
 	this->fillDefault("View3D/ImageRender3DVisualizer", "vtkGPUVolumeRayCastMapper");
 	this->fillDefault("View3D/maxRenderSize", 10 * pow(10.0,6));
+	this->fillDefault("View3D/interactiveRenderSize", 0);
+	this->fillDefault("View3D/toolPathDecimationTolerance", 0.1);
+	this->fillDefault("View3D/toolPathMaxRenderedPoints", 100000);
 	this->fillDefault("View/shadingOn", true);
 
 	this->fillDefault("Gui/showMenuBar", true);
@@ -122,6 +127,7 @@ void StateService::fillDefaultSettings()
 	this->fillDefault("IGSTKDebugLogging", false);
 	this->fillDefault("giveManualToolPhysicalProperties", false);
 	this->fillDefault("renderSpeedLogging", false);
+	this->fillDefault("binaryLogFormat", false);
 
 	this->fillDefault("applyTransferFunctionPresetsToAll", false);
 
@@ -0,0 +1,69 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <vtkImageData.h>
+#include "cxDirtyExtentTracker.h"
+#include "cxtestUtilities.h"
+
+namespace cxtest
+{
+
+TEST_CASE("DirtyExtentTracker reports the extents modified since a given time", "[unit]")
+{
+	vtkImageDataPtr data = Utilities::create3DVtkImageData(Eigen::Array3i(10,10,10), 100);
+	cx::DirtyExtentTracker tracker;
+	cx::IntBoundingBox3D wholeExtent(data->GetExtent());
+
+	unsigned long t0 = data->GetMTime();
+	CHECK(tracker.getModifiedSince(data, t0).empty());
+
+	cx::IntBoundingBox3D a(0,1, 0,1, 0,1);
+	cx::IntBoundingBox3D b(5,6, 5,6, 5,6);
+	tracker.modified(data, a);
+	unsigned long t1 = data->GetMTime();
+	tracker.modified(data, b);
+
+	std::vector<cx::IntBoundingBox3D> sinceT0 = tracker.getModifiedSince(data, t0);
+	REQUIRE(sinceT0.size()==2);
+	CHECK(sinceT0[0]==b);
+	CHECK(sinceT0[1]==a);
+
+	std::vector<cx::IntBoundingBox3D> sinceT1 = tracker.getModifiedSince(data, t1);
+	REQUIRE(sinceT1.size()==1);
+	CHECK(sinceT1[0]==b);
+
+	// an untracked modification gives the whole extent
+	data->Modified();
+	std::vector<cx::IntBoundingBox3D> untracked = tracker.getModifiedSince(data, t1);
+	REQUIRE(untracked.size()==1);
+	CHECK(untracked[0]==wholeExtent);
+}
+
+TEST_CASE("DirtyExtentTracker splits extents into bricks", "[unit]")
+{
+	cx::IntBoundingBox3D wholeExtent(0,99, 0,99, 0,9);
+
+	std::vector<cx::IntBoundingBox3D> extents;
+	extents.push_back(cx::IntBoundingBox3D(2,40, 3,4, 0,0));
+	extents.push_back(cx::IntBoundingBox3D(98,120, 98,99, 9,9));
+	std::vector<cx::IntBoundingBox3D> bricks = cx::DirtyExtentTracker::toBricks(extents, wholeExtent, 32);
+
+	// the first extent covers two neighbouring bricks along x, merged into one
+	REQUIRE(bricks.size()==2);
+	CHECK(bricks[0]==cx::IntBoundingBox3D(0,63, 0,31, 0,9));
+	// the second is clipped to the whole extent
+	CHECK(bricks[1]==cx::IntBoundingBox3D(96,99, 96,99, 0,9));
+	CHECK(cx::DirtyExtentTracker::getNumberOfVoxels(bricks[1])==4*4*10);
+}
+
+} // namespace cxtest
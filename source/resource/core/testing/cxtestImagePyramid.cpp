@@ -0,0 +1,98 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <QDir>
+#include <vtkImageData.h>
+#include "cxImagePyramid.h"
+#include "cxDataLocations.h"
+#include "cxtestUtilities.h"
+
+namespace cxtest
+{
+
+TEST_CASE("ImagePyramid halves the resolution down to the minimum size", "[unit]")
+{
+	vtkImageDataPtr base = Utilities::create3DVtkImageData(Eigen::Array3i(64,32,1), 100);
+	cx::ImagePyramidPtr pyramid = cx::ImagePyramid::create(base, 16);
+	CHECK(pyramid->getNumberOfLevels()==1);
+
+	pyramid->build();
+	pyramid->waitForBuilt();
+	REQUIRE(pyramid->isBuilt());
+
+	// 64x32 -> 32x16 -> 16x8 -> 8x4 -> 4x2 (8 voxels)
+	REQUIRE(pyramid->getNumberOfLevels()==5);
+	CHECK(pyramid->getLevel(0)==base);
+	int* dim = pyramid->getLevel(1)->GetDimensions();
+	CHECK(dim[0]==32);
+	CHECK(dim[1]==16);
+	CHECK(dim[2]==1);
+	CHECK(pyramid->getLevel(4)->GetNumberOfPoints()<=16);
+	CHECK(pyramid->getLevel(1)->GetScalarRange()[1]==Approx(100));
+}
+
+TEST_CASE("ImagePyramid selects the finest level within the voxel budget", "[unit]")
+{
+	vtkImageDataPtr base = Utilities::create3DVtkImageData(Eigen::Array3i(32,32,32), 100);
+	cx::ImagePyramidPtr pyramid = cx::ImagePyramid::create(base, 1000);
+	pyramid->build();
+	pyramid->waitForBuilt();
+
+	CHECK(pyramid->getLevelForMaxVoxels(0)==base);
+	CHECK(pyramid->getLevelForMaxVoxels(32*32*32)==base);
+	CHECK(pyramid->getLevelForMaxVoxels(16*16*16)==pyramid->getLevel(1));
+	CHECK(pyramid->getLevelForMaxVoxels(16*16*16-1)==pyramid->getLevel(2));
+	CHECK(!pyramid->getLevelForMaxVoxels(1));
+}
+
+TEST_CASE("ImagePyramid can be destroyed while building", "[unit]")
+{
+	vtkImageDataPtr base = Utilities::create3DVtkImageData(Eigen::Array3i(128,128,128), 100);
+	cx::ImagePyramidPtr pyramid = cx::ImagePyramid::create(base, 1);
+	pyramid->build();
+	pyramid.reset(); // the build job keeps the levels, and stops after the current level
+
+	cx::ImagePyramidPtr next = cx::ImagePyramid::create(base, 16*16*16);
+	next->build();
+	next->waitForBuilt();
+	CHECK(next->getNumberOfLevels()==4);
+}
+
+TEST_CASE("ImagePyramid is persisted and reloaded", "[unit]")
+{
+	QString folder = cx::DataLocations::getTestDataPath()+"/temp/ImagePyramid/test_pyramid";
+	QDir(folder).removeRecursively();
+
+	vtkImageDataPtr base = Utilities::create3DVtkImageData(Eigen::Array3i(32,32,32), 100);
+	cx::ImagePyramidPtr pyramid = cx::ImagePyramid::create(base, 1000);
+	pyramid->build();
+	pyramid->waitForBuilt();
+	REQUIRE(pyramid->save(folder));
+
+	cx::ImagePyramidPtr loaded = cx::ImagePyramid::create(base, 1000);
+	REQUIRE(loaded->load(folder, QDateTime()));
+	CHECK(loaded->isBuilt());
+	REQUIRE(loaded->getNumberOfLevels()==pyramid->getNumberOfLevels());
+	CHECK(loaded->getLevel(1)->GetNumberOfPoints()==pyramid->getLevel(1)->GetNumberOfPoints());
+
+	cx::ImagePyramidPtr outdated = cx::ImagePyramid::create(base, 1000);
+	CHECK(!outdated->load(folder, QDateTime::currentDateTime().addDays(1)));
+	CHECK(outdated->getNumberOfLevels()==1);
+
+	vtkImageDataPtr otherBase = Utilities::create3DVtkImageData(Eigen::Array3i(48,48,48), 100);
+	CHECK(!cx::ImagePyramid::create(otherBase, 1000)->load(folder, QDateTime()));
+
+	QDir(folder).removeRecursively();
+}
+
+} // namespace cxtest
@@ -0,0 +1,99 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+                 
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+                 
+CustusX is released under a BSD 3-Clause license.
+                 
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <vtkImageData.h>
+#include "cxAlgorithmHelpers.h"
+#include "cxItkVtkImageAdaptor.h"
+
+namespace cxtest
+{
+
+namespace
+{
+vtkSmartPointer<vtkImageData> createShortImage()
+{
+	vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+	image->SetExtent(0, 9, 0, 19, 0, 4);
+	image->SetSpacing(0.5, 1.0, 2.0);
+	image->SetOrigin(1, 2, 3);
+	image->AllocateScalars(VTK_SHORT, 1);
+	short* ptr = static_cast<short*>(image->GetScalarPointer());
+	for (int i=0; i<10*20*5; ++i)
+		ptr[i] = i%100;
+	return image;
+}
+}
+
+TEST_CASE("ItkVtkImageAdaptor shares the buffer of a VTK image", "[unit]")
+{
+	vtkSmartPointer<vtkImageData> input = createShortImage();
+	void* buffer = input->GetScalarPointer();
+
+	cx::itkImageType::ConstPointer itkImage = cx::AlgorithmHelper::getITKfromVTKImage(input);
+	input = NULL; // the ITK image keeps the buffer alive
+
+	REQUIRE(itkImage.IsNotNull());
+	CHECK(itkImage->GetBufferPointer() == buffer);
+	CHECK(itkImage->GetBufferedRegion().GetSize()[0] == 10);
+	CHECK(itkImage->GetBufferedRegion().GetSize()[1] == 20);
+	CHECK(itkImage->GetBufferedRegion().GetSize()[2] == 5);
+	CHECK(itkImage->GetSpacing()[2] == Approx(2.0));
+	CHECK(itkImage->GetOrigin()[1] == Approx(2.0));
+
+	cx::itkImageType::IndexType index;
+	index[0] = 3; index[1] = 1; index[2] = 0;
+	CHECK(itkImage->GetPixel(index) == 13);
+}
+
+TEST_CASE("ItkVtkImageAdaptor round trip keeps geometry and data without copying", "[unit]")
+{
+	vtkSmartPointer<vtkImageData> input = createShortImage();
+	void* buffer = input->GetScalarPointer();
+	cx::itkImageType::ConstPointer itkImage = cx::AlgorithmHelper::getITKfromVTKImage(input);
+
+	vtkSmartPointer<vtkImageData> output = cx::AlgorithmHelper::getVTKFromITK(itkImage);
+	// release all other owners, the output image alone keeps the buffer alive
+	input = NULL;
+	itkImage = NULL;
+
+	REQUIRE(output.GetPointer());
+	CHECK(output->GetScalarPointer() == buffer);
+	int* extent = output->GetExtent();
+	CHECK(extent[1] == 9);
+	CHECK(extent[3] == 19);
+	CHECK(extent[5] == 4);
+	CHECK(output->GetSpacing()[0] == Approx(0.5));
+	CHECK(output->GetOrigin()[2] == Approx(3.0));
+	CHECK(output->GetScalarType() == VTK_SHORT);
+	CHECK(*static_cast<short*>(output->GetScalarPointer(3,1,0)) == 13);
+}
+
+TEST_CASE("ItkVtkImageAdaptor converts images of other scalar types", "[unit]")
+{
+	vtkSmartPointer<vtkImageData> input = vtkSmartPointer<vtkImageData>::New();
+	input->SetExtent(0, 3, 0, 3, 0, 3);
+	input->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+	unsigned char* ptr = static_cast<unsigned char*>(input->GetScalarPointer());
+	for (int i=0; i<4*4*4; ++i)
+		ptr[i] = i;
+
+	CHECK(!cx::ItkVtkImageAdaptor<cx::itkImageType>::canShare(input));
+
+	cx::itkImageType::ConstPointer itkImage = cx::AlgorithmHelper::getITKfromVTKImage(input);
+	REQUIRE(itkImage.IsNotNull());
+	cx::itkImageType::IndexType index;
+	index[0] = 1; index[1] = 2; index[2] = 3;
+	CHECK(itkImage->GetPixel(index) == 1+2*4+3*16);
+}
+
+} //namespace cxtest
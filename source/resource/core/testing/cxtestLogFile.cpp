@@ -0,0 +1,157 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+                 
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+                 
+CustusX is released under a BSD 3-Clause license.
+                 
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QDataStream>
+#include "cxDataLocations.h"
+#include "internal/cxLogFile.h"
+#include "internal/cxLogFileWriter.h"
+
+namespace cxtest
+{
+
+namespace
+{
+QString createCleanLogFolder()
+{
+	QString path = cx::DataLocations::getTestDataPath() + "/temp/LogFile";
+	QDir(path).removeRecursively();
+	QDir().mkpath(path);
+	return path;
+}
+
+cx::Message createMessage(QString text, cx::MESSAGE_LEVEL level)
+{
+	cx::Message msg(text, level);
+	msg.mChannel = "test";
+	msg.mSourceFile = "cxtestLogFile.cpp";
+	msg.mSourceLine = 42;
+	msg.mSourceFunction = "void createMessage()";
+	return msg;
+}
+
+void checkRoundTrip(cx::LOGFILE_FORMAT format)
+{
+	QString path = createCleanLogFolder();
+	cx::LogFile file = cx::LogFile::fromChannel(path, "test", format);
+	cx::LogFileWriter writer;
+
+	REQUIRE(writer.writeHeader(file));
+	writer.write(file, createMessage("first", cx::mlINFO));
+	writer.write(file, createMessage("second\nwith two lines", cx::mlWARNING));
+
+	cx::LogFile reader = cx::LogFile::fromFilename(file.getFilename());
+	CHECK(reader.getFormat()==format);
+	CHECK(reader.readMessages().size()==1); // only header flushed so far
+
+	writer.flush();
+	std::vector<cx::Message> messages = reader.readMessages();
+	REQUIRE(messages.size()==2);
+	CHECK(messages[0].getText().contains("first"));
+	CHECK(messages[0].getMessageLevel()==cx::mlINFO);
+	CHECK(messages[0].mSourceLine==42);
+	CHECK(messages[0].mChannel=="test");
+	CHECK(messages[1].getText().contains("second\nwith two lines"));
+	CHECK(messages[1].getMessageLevel()==cx::mlWARNING);
+
+	writer.write(file, createMessage("third", cx::mlERROR)); // errors are flushed immediately
+	messages = reader.readMessages();
+	REQUIRE(messages.size()==1);
+	CHECK(messages[0].getText().contains("third"));
+}
+void appendRawRecord(QString filename, quint32 size, QByteArray payload)
+{
+	QFile file(filename);
+	REQUIRE(file.open(QFile::WriteOnly | QFile::Append));
+	QDataStream stream(&file);
+	stream << size;
+	file.write(payload);
+}
+
+bool containsText(const std::vector<cx::Message>& messages, QString text)
+{
+	for (unsigned i=0; i<messages.size(); ++i)
+		if (messages[i].getText().contains(text))
+			return true;
+	return false;
+}
+} // namespace
+
+TEST_CASE("LogFile: buffered text log round trip", "[unit]")
+{
+	checkRoundTrip(cx::lfTEXT);
+}
+
+TEST_CASE("LogFile: buffered binary log round trip", "[unit]")
+{
+	checkRoundTrip(cx::lfBINARY);
+}
+
+TEST_CASE("LogFileWriter: flushes when buffer size is exceeded", "[unit]")
+{
+	QString path = createCleanLogFolder();
+	cx::LogFile file = cx::LogFile::fromChannel(path, "test", cx::lfBINARY);
+	cx::LogFileWriter writer;
+	writer.setMaxBufferSize(1);
+
+	writer.write(file, createMessage("unbuffered", cx::mlDEBUG));
+
+	std::vector<cx::Message> messages = cx::LogFile::fromFilename(file.getFilename()).readMessages();
+	REQUIRE(messages.size()==1);
+	CHECK(messages[0].getText()=="unbuffered");
+}
+
+TEST_CASE("LogFile: binary records that fail to parse are skipped", "[unit]")
+{
+	QString path = createCleanLogFolder();
+	cx::LogFile file = cx::LogFile::fromChannel(path, "test", cx::lfBINARY);
+	cx::LogFileWriter writer;
+	writer.setMaxBufferSize(1);
+
+	writer.write(file, createMessage("before", cx::mlINFO));
+	appendRawRecord(file.getFilename(), 4, QByteArray(4, 'x'));
+	writer.write(file, createMessage("after", cx::mlINFO));
+
+	cx::LogFile reader = cx::LogFile::fromFilename(file.getFilename());
+	std::vector<cx::Message> messages = reader.readMessages();
+	REQUIRE(messages.size()==3);
+	CHECK(messages[0].getText()=="before");
+	CHECK(messages[1].getMessageLevel()==cx::mlERROR);
+	CHECK(messages[2].getText()=="after");
+	CHECK(reader.readMessages().empty());
+}
+
+TEST_CASE("LogFile: binary records with implausible size are reported once", "[unit]")
+{
+	QString path = createCleanLogFolder();
+	cx::LogFile file = cx::LogFile::fromChannel(path, "test", cx::lfBINARY);
+	cx::LogFileWriter writer;
+	writer.setMaxBufferSize(1);
+
+	writer.write(file, createMessage("before", cx::mlINFO));
+	appendRawRecord(file.getFilename(), 0xFFFFFFF0, QByteArray(16, 'x'));
+
+	cx::LogFile reader = cx::LogFile::fromFilename(file.getFilename());
+	std::vector<cx::Message> messages = reader.readMessages();
+	CHECK(containsText(messages, "before"));
+	CHECK(containsText(messages, "Corrupt record size"));
+	CHECK(reader.readMessages().empty());
+
+	writer.write(file, createMessage("after", cx::mlINFO));
+	messages = reader.readMessages();
+	REQUIRE(messages.size()==1);
+	CHECK(messages[0].getText()=="after");
+}
+
+} // namespace cxtest
@@ -0,0 +1,95 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <vtkPolyData.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include "cxMesh.h"
+
+namespace cxtest
+{
+
+namespace
+{
+vtkPolyDataPtr createPointCloud(int numberOfPoints)
+{
+	vtkPointsPtr points = vtkPointsPtr::New();
+	vtkCellArrayPtr verts = vtkCellArrayPtr::New();
+	for (int i=0; i<numberOfPoints; ++i)
+	{
+		vtkIdType id = points->InsertNextPoint(i%100, (i/100)%100, -i/10000);
+		verts->InsertNextCell(1, &id);
+	}
+	vtkPolyDataPtr poly = vtkPolyDataPtr::New();
+	poly->SetPoints(points);
+	poly->SetVerts(verts);
+	return poly;
+}
+
+void checkTransformedPoints(vtkPolyDataPtr original, vtkPolyDataPtr transformed, cx::Transform3D M)
+{
+	REQUIRE(transformed->GetNumberOfPoints()==original->GetNumberOfPoints());
+	for (vtkIdType i=0; i<original->GetNumberOfPoints(); i+=997)
+	{
+		INFO("point " << i);
+		cx::Vector3D expected = M.coord(cx::Vector3D(original->GetPoint(i)));
+		CHECK(cx::similar(cx::Vector3D(transformed->GetPoint(i)), expected, 1.0E-2));
+	}
+}
+} // namespace
+
+TEST_CASE("Mesh getTransformedPolyData transforms all points, in parallel for large meshes", "[unit]")
+{
+	cx::Transform3D M = cx::createTransformTranslate(cx::Vector3D(10,20,30)) * cx::createTransformRotateZ(0.5);
+
+	for (int size=10; size<=1000000; size*=100)
+	{
+		INFO("size " << size);
+		vtkPolyDataPtr poly = createPointCloud(size);
+		cx::MeshPtr mesh(new cx::Mesh("mesh", "mesh", poly));
+
+		vtkPolyDataPtr transformed = mesh->getTransformedPolyData(M);
+		checkTransformedPoints(poly, transformed, M);
+		CHECK(transformed->GetVerts()==poly->GetVerts()); // cells are shared, not copied
+	}
+}
+
+TEST_CASE("Mesh getTransformedPolyData is cached until polydata or transform changes", "[unit]")
+{
+	vtkPolyDataPtr poly = createPointCloud(100);
+	cx::MeshPtr mesh(new cx::Mesh("mesh", "mesh", poly));
+	cx::Transform3D M = cx::createTransformTranslate(cx::Vector3D(1,2,3));
+
+	CHECK(mesh->getTransformedPolyData(cx::Transform3D::Identity())==poly);
+
+	vtkPolyDataPtr first = mesh->getTransformedPolyData(M);
+	CHECK(mesh->getTransformedPolyData(M)==first);
+
+	cx::Transform3D M2 = cx::createTransformTranslate(cx::Vector3D(1,2,4));
+	vtkPolyDataPtr second = mesh->getTransformedPolyData(M2);
+	CHECK(second!=first);
+	checkTransformedPoints(poly, second, M2);
+
+	poly->GetPoints()->SetPoint(0, 5, 5, 5);
+	poly->GetPoints()->Modified();
+	vtkPolyDataPtr third = mesh->getTransformedPolyData(M2);
+	CHECK(third!=second);
+	checkTransformedPoints(poly, third, M2);
+
+	vtkPolyDataPtr copy = mesh->getTransformedPolyDataCopy(M2);
+	CHECK(copy!=third);
+	CHECK(copy->GetVerts()!=poly->GetVerts());
+	checkTransformedPoints(poly, copy, M2);
+}
+
+} // namespace cxtest
@@ -0,0 +1,158 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <vtkPolyData.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include "vesselReg/cxPointCloudKdTree.h"
+#include "cxVector3D.h"
+
+namespace cxtest
+{
+
+namespace
+{
+vtkPolyDataPtr createPolyData(const std::vector<cx::Vector3D>& points)
+{
+	vtkPointsPtr vtkPoints = vtkPointsPtr::New();
+	for (unsigned i=0; i<points.size(); ++i)
+		vtkPoints->InsertNextPoint(points[i].data());
+	vtkPolyDataPtr retval = vtkPolyDataPtr::New();
+	retval->SetPoints(vtkPoints);
+	return retval;
+}
+
+std::vector<cx::Vector3D> createPseudoRandomPoints(int count)
+{
+	std::vector<cx::Vector3D> retval;
+	unsigned seed = 12345;
+	for (int i=0; i<count; ++i)
+	{
+		cx::Vector3D p;
+		for (int k=0; k<3; ++k)
+		{
+			seed = seed*1103515245 + 12345;
+			p[k] = double((seed/65536) % 10000) / 100.0;
+		}
+		retval.push_back(p);
+	}
+	return retval;
+}
+} // namespace
+
+TEST_CASE("PointCloudKdTree finds the same closest point as a linear search", "[unit]")
+{
+	std::vector<cx::Vector3D> points = createPseudoRandomPoints(2000);
+	cx::PointCloudKdTreePtr tree = cx::PointCloudKdTree::create(createPolyData(points));
+	REQUIRE(tree->getNumberOfPoints() == 2000);
+
+	std::vector<cx::Vector3D> queries = createPseudoRandomPoints(200);
+	for (unsigned q=0; q<queries.size(); ++q)
+	{
+		cx::Vector3D query = queries[q] + cx::Vector3D(0.37, -0.21, 0.55);
+		double expected = 1E30;
+		for (unsigned i=0; i<points.size(); ++i)
+			expected = std::min(expected, (points[i]-query).squaredNorm());
+
+		cx::Vector3D closest;
+		double dist2 = tree->findClosestPoint(query.data(), closest.data());
+		CHECK(dist2 == Approx(expected));
+		CHECK((closest-query).squaredNorm() == Approx(expected));
+	}
+}
+
+TEST_CASE("PointCloudKdTree projects onto lines and triangles", "[unit]")
+{
+	std::vector<cx::Vector3D> points;
+	points.push_back(cx::Vector3D(0, 0, 0));
+	points.push_back(cx::Vector3D(10, 0, 0));
+	points.push_back(cx::Vector3D(20, 0, 0));
+	points.push_back(cx::Vector3D(20, 10, 0));
+	vtkPolyDataPtr data = createPolyData(points);
+
+	vtkIdType line[] = { 0, 1 };
+	vtkCellArrayPtr lines = vtkCellArrayPtr::New();
+	lines->InsertNextCell(2, line);
+	data->SetLines(lines);
+
+	vtkIdType triangle[] = { 1, 2, 3 };
+	vtkCellArrayPtr polys = vtkCellArrayPtr::New();
+	polys->InsertNextCell(3, triangle);
+	data->SetPolys(polys);
+
+	cx::PointCloudKdTreePtr tree = cx::PointCloudKdTree::create(data);
+	cx::Vector3D closest;
+
+	cx::Vector3D onLine(6, 1, 0);
+	CHECK(tree->findClosestPoint(onLine.data(), closest.data()) == Approx(1.0));
+	CHECK(cx::similar(closest, cx::Vector3D(6, 0, 0)));
+
+	cx::Vector3D aboveTriangle(17, 2, 3);
+	CHECK(tree->findClosestPoint(aboveTriangle.data(), closest.data()) == Approx(9.0));
+	CHECK(cx::similar(closest, cx::Vector3D(17, 2, 0)));
+}
+
+TEST_CASE("PointCloudKdTree projects onto a large triangle with all corners far away", "[unit]")
+{
+	std::vector<cx::Vector3D> points;
+	points.push_back(cx::Vector3D(0, 0, 0));
+	points.push_back(cx::Vector3D(100, 0, 0));
+	points.push_back(cx::Vector3D(0, 100, 0));
+	// small triangle closer to the query than any corner of the large one
+	points.push_back(cx::Vector3D(40, 40, 20));
+	points.push_back(cx::Vector3D(41, 40, 20));
+	points.push_back(cx::Vector3D(40, 41, 20));
+	vtkPolyDataPtr data = createPolyData(points);
+
+	vtkIdType large[] = { 0, 1, 2 };
+	vtkIdType small[] = { 3, 4, 5 };
+	vtkCellArrayPtr polys = vtkCellArrayPtr::New();
+	polys->InsertNextCell(3, large);
+	polys->InsertNextCell(3, small);
+	data->SetPolys(polys);
+
+	cx::PointCloudKdTreePtr tree = cx::PointCloudKdTree::create(data);
+	cx::Vector3D closest;
+	cx::Vector3D query(30, 30, 1);
+	CHECK(tree->findClosestPoint(query.data(), closest.data()) == Approx(1.0));
+	CHECK(cx::similar(closest, cx::Vector3D(30, 30, 0)));
+}
+
+TEST_CASE("PointCloudKdTree reports an empty tree", "[unit]")
+{
+	cx::PointCloudKdTreePtr tree = cx::PointCloudKdTree::create(createPolyData(std::vector<cx::Vector3D>()));
+	cx::Vector3D closest;
+	cx::Vector3D query(1, 2, 3);
+	CHECK(tree->findClosestPoint(query.data(), closest.data()) < 0);
+}
+
+TEST_CASE("PointCloudKdTree shares trees for unmodified data", "[unit]")
+{
+	cx::PointCloudKdTree::clearShared();
+	vtkPolyDataPtr data = createPolyData(createPseudoRandomPoints(100));
+
+	cx::PointCloudKdTreePtr first = cx::PointCloudKdTree::getShared(data);
+	CHECK(cx::PointCloudKdTree::getShared(data) == first);
+
+	data->GetPoints()->SetPoint(0, 1000, 1000, 1000);
+	data->GetPoints()->Modified();
+	cx::PointCloudKdTreePtr second = cx::PointCloudKdTree::getShared(data);
+	CHECK(second != first);
+
+	cx::Vector3D closest;
+	cx::Vector3D query(999, 999, 999);
+	CHECK(second->findClosestPoint(query.data(), closest.data()) == Approx(3.0));
+	cx::PointCloudKdTree::clearShared();
+}
+
+} // namespace cxtest
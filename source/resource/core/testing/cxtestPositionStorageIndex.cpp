@@ -0,0 +1,171 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <QDir>
+#include <QDataStream>
+#include "cxPositionStorageFile.h"
+#include "cxPositionStorageIndex.h"
+#include "cxDataLocations.h"
+#include "cxFrame3D.h"
+#include "cxVector3D.h"
+
+namespace cxtest
+{
+
+namespace
+{
+cx::Transform3D createPosition(double i)
+{
+	return cx::createTransformTranslate(cx::Vector3D(i, 2*i, 0)) * cx::createTransformRotateZ(0.01*i);
+}
+
+QString createPositionFile()
+{
+	QString path = cx::DataLocations::getTestDataPath() + "/temp/PositionStorageIndex/";
+	QDir().mkpath(path);
+	QString filename = path + "toolpositions.snwpos";
+	QFile::remove(filename);
+
+	cx::PositionStorageWriter writer(filename);
+	for (int i=0; i<100; ++i)
+		writer.write(createPosition(i), 1000+10*i, QString("probe"));
+	for (int i=0; i<50; ++i)
+		writer.write(createPosition(-i), 1005+10*i, QString("pointer"));
+	for (int i=0; i<20; ++i)
+		writer.write(createPosition(i), 2000+10*i, 3);
+	return filename;
+}
+
+/** Version 1 had the same records as version 2, but 32 bit timestamps.
+ */
+QString createVersion1PositionFile()
+{
+	QString path = cx::DataLocations::getTestDataPath() + "/temp/PositionStorageIndex/";
+	QDir().mkpath(path);
+	QString filename = path + "toolpositions_v1.snwpos";
+	QFile file(filename);
+	file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+	QDataStream stream(&file);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.writeRawData("SNWPOS", 6);
+	stream << (quint8)1;
+	for (int i=0; i<10; ++i)
+	{
+		boost::array<double, 6> rep = cx::Frame3D::create(createPosition(i)).getCompactAxisAngleRep();
+		stream << (quint8)1 << (quint8)(4+1+6*8) << (quint32)(1000+10*i) << (quint8)3;
+		for (int k=0; k<6; ++k)
+			stream << rep[k];
+	}
+	return filename;
+}
+
+typedef std::map<QString, cx::TimedTransformMap> ToolPositions;
+
+ToolPositions readWithPositionStorageReader(QString filename)
+{
+	ToolPositions retval;
+	cx::PositionStorageReader reader(filename);
+	cx::Transform3D matrix;
+	double timestamp;
+	QString toolUid;
+	while (!reader.atEnd())
+	{
+		if (!reader.read(&matrix, &timestamp, &toolUid))
+			break;
+		retval[toolUid][timestamp] = matrix;
+	}
+	return retval;
+}
+} // namespace
+
+TEST_CASE("PositionStorageIndex extracts the same positions as PositionStorageReader", "[unit]")
+{
+	QString filename = createPositionFile();
+	ToolPositions expected = readWithPositionStorageReader(filename);
+
+	cx::PositionStorageIndex index(filename);
+	REQUIRE(index.isValid());
+	CHECK(index.version() == 2);
+	CHECK(index.getToolUids().size() == int(expected.size()));
+
+	for (ToolPositions::iterator iter=expected.begin(); iter!=expected.end(); ++iter)
+	{
+		int tool = index.getToolIndex(iter->first);
+		REQUIRE(tool >= 0);
+		std::vector<cx::PositionStorageIndex::Position> positions = index.extract(tool, 0, 1E10);
+		REQUIRE(positions.size() == iter->second.size());
+
+		cx::TimedTransformMap::iterator current = iter->second.begin();
+		for (unsigned i=0; i<positions.size(); ++i, ++current)
+		{
+			CHECK(positions[i].mTool == tool);
+			CHECK(positions[i].mTimestamp == Approx(current->first));
+			CHECK(cx::similar(positions[i].mTransform, current->second));
+		}
+	}
+
+	int probe = index.getToolIndex("probe");
+	std::vector<cx::PositionStorageIndex::Position> range = index.extract(probe, 1100, 1200);
+	REQUIRE(range.size() == 11);
+	CHECK(range.front().mTimestamp == Approx(1100));
+	CHECK(range.back().mTimestamp == Approx(1200));
+
+	double start, stop;
+	REQUIRE(index.getTimeRange(&start, &stop));
+	CHECK(stop == Approx(2190));
+	REQUIRE(index.getTimeRange(probe, &start, &stop));
+	CHECK(start == Approx(1010));
+	CHECK(stop == Approx(1990));
+}
+
+TEST_CASE("PositionStorageIndex resamples between positions", "[unit]")
+{
+	QString filename = createPositionFile();
+	cx::PositionStorageIndex index(filename);
+	REQUIRE(index.isValid());
+
+	int probe = index.getToolIndex("probe");
+	REQUIRE(probe >= 0);
+	std::vector<cx::PositionStorageIndex::Position> positions = index.resample(probe, 1505, 1555, 10);
+	REQUIRE(positions.size() == 6);
+	for (unsigned i=0; i<positions.size(); ++i)
+	{
+		double t = 1505 + 10*i;
+		CHECK(positions[i].mTimestamp == Approx(t));
+		CHECK(cx::similar(positions[i].mTransform, createPosition((t-1000)/10)));
+	}
+
+	CHECK(index.resample(probe, 0, 1010, 10).size() == 1); // the first position after a tool change is not stored
+	CHECK(index.resample(-1, 0, 1E10, 10).empty());
+}
+
+TEST_CASE("PositionStorageIndex reads version 1 files with 32 bit timestamps", "[unit]")
+{
+	QString filename = createVersion1PositionFile();
+	cx::PositionStorageIndex index(filename);
+	REQUIRE(index.isValid());
+	CHECK(index.version() == 1);
+
+	int tool = index.getToolIndex("3");
+	REQUIRE(tool >= 0);
+	std::vector<cx::PositionStorageIndex::Position> positions = index.extract(tool, 0, 1E10);
+	REQUIRE(positions.size() == 10);
+	for (unsigned i=0; i<positions.size(); ++i)
+	{
+		CHECK(positions[i].mTimestamp == Approx(1000+10*i));
+		CHECK(cx::similar(positions[i].mTransform, createPosition(i)));
+	}
+	QFile::remove(filename);
+}
+
+} // namespace cxtest
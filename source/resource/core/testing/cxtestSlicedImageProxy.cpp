@@ -0,0 +1,142 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <QTime>
+#include <vtkImageData.h>
+#include "cxSlicedImageProxy.h"
+#include "cxSliceProxy.h"
+#include "cxImage.h"
+#include "cxtestJenkinsMeasurement.h"
+
+namespace cxtest
+{
+
+namespace
+{
+vtkImageDataPtr createGradientImageData(int axisSize, int scalarType)
+{
+	vtkImageDataPtr data = vtkImageDataPtr::New();
+	data->SetExtent(0, axisSize-1, 0, axisSize-1, 0, axisSize-1);
+	data->SetSpacing(1, 1, 1);
+	data->AllocateScalars(scalarType, 1);
+	for (int z=0; z<axisSize; ++z)
+		for (int y=0; y<axisSize; ++y)
+			for (int x=0; x<axisSize; ++x)
+				data->SetScalarComponentFromDouble(x, y, z, 0, (x+2*y+z)%256);
+	return data;
+}
+
+cx::Transform3D createOblique_sMr(cx::Vector3D center, double angle)
+{
+	return cx::createTransformRotateX(angle) * cx::createTransformRotateZ(angle/2) * cx::createTransformTranslate(-center);
+}
+
+struct SlicingFixture
+{
+	SlicingFixture(cx::ImagePtr image, bool fused)
+	{
+		mSlicer.reset(new cx::SimpleSliceProxy());
+		mProxy.reset(new cx::SlicedImageProxy());
+		mProxy->setFusedResliceAndLUT(fused);
+		mProxy->setImage(image);
+		mProxy->setSliceProxy(mSlicer);
+		int* dim = image->getBaseVtkImageData()->GetDimensions();
+		mProxy->setOutputFormat(cx::Vector3D(-dim[0]/2, -dim[1]/2, 0), Eigen::Array3i(dim[0], dim[1], 1), cx::Vector3D(1,1,1));
+	}
+	vtkImageDataPtr slice(cx::Transform3D sMr)
+	{
+		mSlicer->set_sMr(sMr);
+		return mProxy->getOutput();
+	}
+	cx::SimpleSliceProxyPtr mSlicer;
+	cx::SlicedImageProxyPtr mProxy;
+};
+
+int getMaxDifference(vtkImageDataPtr a, vtkImageDataPtr b)
+{
+	int size = a->GetNumberOfPoints() * a->GetNumberOfScalarComponents();
+	unsigned char* pa = static_cast<unsigned char*>(a->GetScalarPointer());
+	unsigned char* pb = static_cast<unsigned char*>(b->GetScalarPointer());
+	int retval = 0;
+	for (int i=0; i<size; ++i)
+		retval = std::max(retval, abs(int(pa[i])-int(pb[i])));
+	return retval;
+}
+
+double measureSlicingTime(SlicingFixture& fixture, cx::Vector3D center, bool oblique, int numberOfSlices)
+{
+	QTime clock;
+	clock.start();
+	for (int i=0; i<numberOfSlices; ++i)
+	{
+		cx::Vector3D pos = center + cx::Vector3D(0, 0, i%20-10);
+		double angle = oblique ? 0.3 + 0.01*i : 0;
+		fixture.slice(createOblique_sMr(pos, angle));
+	}
+	return double(clock.elapsed())/numberOfSlices;
+}
+} // namespace
+
+TEST_CASE("SlicedImageProxy fused reslice+lut gives the same slices as the two-pass pipeline", "[unit]")
+{
+	int axisSize = 64;
+	cx::ImagePtr image(new cx::Image("gradient", createGradientImageData(axisSize, VTK_UNSIGNED_CHAR)));
+	SlicingFixture fused(image, true);
+	SlicingFixture twoPass(image, false);
+	cx::Vector3D center(axisSize/2, axisSize/2, axisSize/2);
+
+	std::vector<cx::Transform3D> planes;
+	planes.push_back(createOblique_sMr(center, 0)); // axis-aligned
+	planes.push_back(createOblique_sMr(center, 0.4));
+	planes.push_back(createOblique_sMr(center+cx::Vector3D(5,-3,7), 1.1));
+
+	for (unsigned i=0; i<planes.size(); ++i)
+	{
+		INFO("plane " << i);
+		vtkImageDataPtr a = fused.slice(planes[i]);
+		vtkImageDataPtr b = twoPass.slice(planes[i]);
+		REQUIRE(a);
+		REQUIRE(b);
+		CHECK(a->GetNumberOfScalarComponents()==4);
+		REQUIRE(a->GetNumberOfScalarComponents()==b->GetNumberOfScalarComponents());
+		REQUIRE(a->GetNumberOfPoints()==b->GetNumberOfPoints());
+		// interpolation rounding may differ by one input level
+		CHECK(getMaxDifference(a, b) <= 2);
+	}
+}
+
+TEST_CASE("Speed: SlicedImageProxy fused vs two-pass reslice+lut on 512^3 volume", "[speed]")
+{
+	int axisSize = 512;
+	int numberOfSlices = 100;
+	cx::ImagePtr image(new cx::Image("large", createGradientImageData(axisSize, VTK_UNSIGNED_SHORT)));
+	cx::Vector3D center(axisSize/2, axisSize/2, axisSize/2);
+
+	SlicingFixture fused(image, true);
+	SlicingFixture twoPass(image, false);
+
+	double twoPassAxial = measureSlicingTime(twoPass, center, false, numberOfSlices);
+	double fusedAxial = measureSlicingTime(fused, center, false, numberOfSlices);
+	double twoPassOblique = measureSlicingTime(twoPass, center, true, numberOfSlices);
+	double fusedOblique = measureSlicingTime(fused, center, true, numberOfSlices);
+
+	JenkinsMeasurement jenkins;
+	jenkins.printMeasurementWithCxReporter("SlicedImageProxy_two_pass_axis_aligned_ms", QString::number(twoPassAxial));
+	jenkins.printMeasurementWithCxReporter("SlicedImageProxy_fused_axis_aligned_ms", QString::number(fusedAxial));
+	jenkins.printMeasurementWithCxReporter("SlicedImageProxy_two_pass_oblique_ms", QString::number(twoPassOblique));
+	jenkins.printMeasurementWithCxReporter("SlicedImageProxy_fused_oblique_ms", QString::number(fusedOblique));
+
+	CHECK(fusedOblique <= twoPassOblique);
+}
+
+} // namespace cxtest
@@ -0,0 +1,111 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+                 
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+                 
+CustusX is released under a BSD 3-Clause license.
+                 
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+#include "cxSpaceProviderImpl.h"
+#include "cxTrackingService.h"
+#include "cxRegistrationTransform.h"
+#include "cxtestPatientModelServiceMock.h"
+#include "cxDummyToolManager.h"
+#include "cxDummyTool.h"
+#include "cxImage.h"
+#include "cxVolumeHelpers.h"
+
+namespace cxtest
+{
+
+namespace
+{
+class ValidPatientModelServiceMock : public PatientModelServiceMock
+{
+public:
+	virtual bool isPatientValid() const { return true; }
+};
+}
+
+TEST_CASE("SpaceProviderImpl: Transforms follow rMpr changes", "[unit]")
+{
+	PatientModelServiceMockPtr patientModel(new PatientModelServiceMock());
+	cx::SpaceProviderImpl spaceProvider(cx::TrackingService::getNullObject(), patientModel);
+	cx::CoordinateSystem r = spaceProvider.getR();
+	cx::CoordinateSystem pr = spaceProvider.getPr();
+
+	cx::Transform3D rMpr1 = cx::createTransformTranslate(cx::Vector3D(1,2,3));
+	patientModel->get_rMpr_History()->setRegistration(rMpr1);
+	CHECK(cx::similar(spaceProvider.get_toMfrom(pr, r), rMpr1));
+	CHECK(cx::similar(spaceProvider.get_toMfrom(r, pr), rMpr1.inv()));
+
+	cx::Transform3D rMpr2 = cx::createTransformRotateZ(M_PI/2) * cx::createTransformTranslate(cx::Vector3D(4,5,6));
+	patientModel->get_rMpr_History()->setRegistration(rMpr2);
+	CHECK(cx::similar(spaceProvider.get_toMfrom(pr, r), rMpr2));
+	CHECK(cx::similar(spaceProvider.get_toMfrom(r, pr), rMpr2.inv()));
+}
+
+TEST_CASE("SpaceProviderImpl: Batch query gives same result as single queries", "[unit]")
+{
+	PatientModelServiceMockPtr patientModel(new PatientModelServiceMock());
+	cx::SpaceProviderImpl spaceProvider(cx::TrackingService::getNullObject(), patientModel);
+	patientModel->get_rMpr_History()->setRegistration(cx::createTransformTranslate(cx::Vector3D(1,2,3)));
+
+	std::vector<cx::CoordinateSystem> from;
+	from.push_back(spaceProvider.getR());
+	from.push_back(spaceProvider.getPr());
+	from.push_back(spaceProvider.getR());
+
+	std::vector<cx::Transform3D> prMfrom = spaceProvider.get_toMfrom(from, spaceProvider.getPr());
+	REQUIRE(prMfrom.size() == from.size());
+	for (unsigned i=0; i<from.size(); ++i)
+		CHECK(cx::similar(prMfrom[i], spaceProvider.get_toMfrom(from[i], spaceProvider.getPr())));
+}
+
+TEST_CASE("SpaceProviderImpl: Slots connected before the provider read the current transforms", "[unit]")
+{
+	PatientModelServiceMockPtr patientModel(new ValidPatientModelServiceMock());
+	cx::DummyToolManager::DummyToolManagerPtr trackingService = cx::DummyToolManager::create();
+	cx::DummyToolPtr tool(new cx::DummyTool("tool"));
+	trackingService->addTool(tool);
+	cx::ImagePtr image(new cx::Image("image", cx::generateVtkImageData(Eigen::Array3i(3,3,3), cx::Vector3D(1,1,1), 1)));
+	patientModel->insertData(image);
+
+	// connected before the provider exists, thus called before any provider slot
+	cx::SpaceProviderImpl* spaceProvider = NULL;
+	std::vector<cx::Transform3D> seen_rMd, seen_rMt, seen_rMpr;
+	QObject::connect(image.get(), &cx::Data::transformChanged,
+					 [&]() { seen_rMd.push_back(spaceProvider->get_toMfrom(spaceProvider->getD(image), spaceProvider->getR())); });
+	QObject::connect(tool.get(), &cx::Tool::toolTransformAndTimestamp,
+					 [&]() { seen_rMt.push_back(spaceProvider->get_toMfrom(spaceProvider->getT(tool), spaceProvider->getR())); });
+	QObject::connect(patientModel.get(), &cx::PatientModelService::rMprChanged,
+					 [&]() { seen_rMpr.push_back(spaceProvider->get_toMfrom(spaceProvider->getPr(), spaceProvider->getR())); });
+
+	cx::SpaceProviderImpl provider(trackingService, patientModel);
+	spaceProvider = &provider;
+	// query once before the changes
+	provider.get_toMfrom(provider.getD(image), provider.getR());
+	provider.get_toMfrom(provider.getT(tool), provider.getR());
+	provider.get_toMfrom(provider.getPr(), provider.getR());
+
+	cx::Transform3D rMd = cx::createTransformTranslate(cx::Vector3D(1,2,3));
+	cx::Transform3D prMt = cx::createTransformRotateZ(M_PI/2);
+	cx::Transform3D rMpr = cx::createTransformTranslate(cx::Vector3D(4,5,6));
+	image->get_rMd_History()->setRegistration(rMd);
+	tool->set_prMt(prMt);
+	patientModel->get_rMpr_History()->setRegistration(rMpr);
+
+	REQUIRE(!seen_rMd.empty());
+	REQUIRE(!seen_rMt.empty());
+	REQUIRE(!seen_rMpr.empty());
+	CHECK(cx::similar(seen_rMd.back(), rMd));
+	CHECK(cx::similar(seen_rMt.back(), prMt)); // rMpr is still identity
+	CHECK(cx::similar(seen_rMpr.back(), rMpr));
+	CHECK(cx::similar(provider.get_toMfrom(provider.getT(tool), provider.getR()), rMpr*prMt));
+}
+
+} // namespace cxtest
@@ -33,6 +33,7 @@ public:
 	virtual ~SpaceProviderMock() {}
 
 	virtual cx::Transform3D get_toMfrom(cx::CoordinateSystem from, cx::CoordinateSystem to) { return cx::Transform3D::Identity(); }
+	virtual std::vector<cx::Transform3D> get_toMfrom(const std::vector<cx::CoordinateSystem>& from, cx::CoordinateSystem to) { return std::vector<cx::Transform3D>(from.size(), cx::Transform3D::Identity()); }
 	virtual std::vector<cx::CoordinateSystem> getSpacesToPresentInGUI() { return std::vector<cx::CoordinateSystem>(); }
 	virtual std::map<QString, QString> getDisplayNamesForCoordRefObjects() { return std::map<QString, QString>(); }
 	virtual cx::SpaceListenerPtr createListener() { return SpaceListenerMock::create(); }
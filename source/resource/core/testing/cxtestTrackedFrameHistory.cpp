@@ -0,0 +1,149 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <vtkImageData.h>
+#include "cxTrackedFrameHistory.h"
+#include "cxTrackedStream.h"
+#include "cxVideoSource.h"
+#include "cxtestUtilities.h"
+
+namespace cxtest
+{
+
+namespace
+{
+/** Video source emitting frames on demand, with a given timestamp and pixel value.
+ */
+class SyntheticVideoSource : public cx::VideoSource
+{
+public:
+	SyntheticVideoSource() : mTimestamp(0)
+	{
+		mImage = Utilities::create3DVtkImageData(Eigen::Array3i(32,16,1), 0);
+	}
+	void emitFrame(double timestamp, unsigned char value)
+	{
+		mTimestamp = timestamp;
+		unsigned char* ptr = static_cast<unsigned char*>(mImage->GetScalarPointer());
+		std::fill(ptr, ptr+mImage->GetNumberOfPoints(), value);
+		mImage->Modified();
+		emit newFrame();
+	}
+	virtual QString getUid() { return "synthetic"; }
+	virtual QString getName() { return "synthetic"; }
+	virtual vtkImageDataPtr getVtkImageData() { return mImage; }
+	virtual double getTimestamp() { return mTimestamp; }
+	virtual cx::TimeInfo getAdvancedTimeInfo() { cx::TimeInfo retval; retval.mAcquisitionTime.setMSecsSinceEpoch(mTimestamp); return retval; }
+	virtual QString getInfoString() const { return ""; }
+	virtual QString getStatusString() const { return ""; }
+	virtual void start() {}
+	virtual void stop() {}
+	virtual bool validData() const { return true; }
+	virtual bool isConnected() const { return true; }
+	virtual bool isStreaming() const { return true; }
+private:
+	vtkImageDataPtr mImage;
+	double mTimestamp;
+};
+
+unsigned char getFirstPixel(cx::TrackedFrame frame)
+{
+	return static_cast<unsigned char*>(frame.mImage->GetScalarPointer())[0];
+}
+} // namespace
+
+TEST_CASE("TrackedFrameHistory keeps the latest frames within the memory budget", "[unit]")
+{
+	vtkImageDataPtr image = Utilities::create3DVtkImageData(Eigen::Array3i(10,10,1), 0);
+	cx::TrackedFrameHistory history(4*100); // 4 frames of 100 bytes
+
+	for (int i=0; i<10; ++i)
+	{
+		static_cast<unsigned char*>(image->GetScalarPointer())[0] = i;
+		history.add(image, 1000+10*i, cx::Transform3D::Identity(), false);
+	}
+
+	REQUIRE(history.getCapacity()==4);
+	REQUIRE(history.size()==4);
+	for (int i=0; i<4; ++i)
+	{
+		INFO("frame " << i);
+		CHECK(history.getFrame(i).mTimestamp==1060+10*i);
+		CHECK(getFirstPixel(history.getFrame(i))==6+i);
+		CHECK(history.getFrame(i).mImage!=image);
+	}
+}
+
+TEST_CASE("TrackedFrameHistory finds the frame closest in time", "[unit]")
+{
+	vtkImageDataPtr image = Utilities::create3DVtkImageData(Eigen::Array3i(10,10,1), 0);
+	cx::TrackedFrameHistory history(5*100);
+	CHECK(history.findClosest(0)==-1);
+
+	for (int i=0; i<7; ++i) // wrap around the ring
+		history.add(image, 10*i, cx::Transform3D::Identity(), false);
+	// frames at 20,30,40,50,60
+
+	CHECK(history.findClosest(-100)==0);
+	CHECK(history.findClosest(20)==0);
+	CHECK(history.findClosest(34)==1);
+	CHECK(history.findClosest(36)==2);
+	CHECK(history.findClosest(60)==4);
+	CHECK(history.findClosest(1000)==4);
+
+	// older timestamp restarts the history
+	history.add(image, 5, cx::Transform3D::Identity(), false);
+	CHECK(history.size()==1);
+}
+
+TEST_CASE("TrackedFrameHistory does not overwrite frames in use", "[unit]")
+{
+	vtkImageDataPtr image = Utilities::create3DVtkImageData(Eigen::Array3i(10,10,1), 0);
+	cx::TrackedFrameHistory history(2*100);
+
+	static_cast<unsigned char*>(image->GetScalarPointer())[0] = 1;
+	history.add(image, 0, cx::Transform3D::Identity(), false);
+	cx::TrackedFrame frozen = history.getFrame(0);
+
+	static_cast<unsigned char*>(image->GetScalarPointer())[0] = 2;
+	history.add(image, 1, cx::Transform3D::Identity(), false);
+	history.add(image, 2, cx::Transform3D::Identity(), false); // overwrites the slot of the frozen frame
+
+	CHECK(getFirstPixel(frozen)==1);
+	CHECK(history.getFrame(0).mTimestamp==1);
+}
+
+TEST_CASE("TrackedStream records frames from a synthetic source", "[unit]")
+{
+	cx::TrackedStreamPtr stream = cx::TrackedStream::create("stream", "stream");
+	boost::shared_ptr<SyntheticVideoSource> source(new SyntheticVideoSource());
+	stream->setVideoSource(source);
+	stream->setFrameHistoryMaxBytes(3*32*16);
+
+	source->emitFrame(0, 0); // not recorded, the history is not requested yet
+	cx::TrackedFrameHistoryPtr history = stream->getFrameHistory();
+	CHECK(history->getMaxBytes()==3*32*16);
+	CHECK(history->size()==0);
+
+	for (int i=0; i<5; ++i)
+		source->emitFrame(100*i, i);
+
+	REQUIRE(history->size()==3);
+	int index = history->findClosest(290);
+	REQUIRE(index==1);
+	CHECK(history->getFrame(index).mTimestamp==300);
+	CHECK(getFirstPixel(history->getFrame(index))==3);
+	CHECK_FALSE(history->getFrame(index).mHasPose); // no probe tool
+}
+
+} // namespace cxtest
@@ -0,0 +1,122 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+#include "cxTrackingUpdateBus.h"
+#include "cxDummyTool.h"
+#include "cxtestQueuedSignalListener.h"
+
+namespace cxtest
+{
+
+namespace
+{
+struct SnapshotCounter
+{
+	std::vector<cx::TrackingSnapshot> mSnapshots;
+	void connectTo(cx::TrackingUpdateBus* bus)
+	{
+		QObject::connect(bus, &cx::TrackingUpdateBus::snapshotReady,
+						 [this](const cx::TrackingSnapshot& snapshot) { mSnapshots.push_back(snapshot); });
+	}
+};
+}
+
+TEST_CASE("TrackingUpdateBus: Coalesces samples from several tools into one snapshot", "[unit]")
+{
+	cx::DummyToolPtr tool1(new cx::DummyTool("tool1"));
+	cx::DummyToolPtr tool2(new cx::DummyTool("tool2"));
+	cx::TrackingUpdateBus::ToolMap tools;
+	tools[tool1->getUid()] = tool1;
+	tools[tool2->getUid()] = tool2;
+
+	cx::TrackingUpdateBus bus;
+	bus.setFrameWindow(10000);
+	bus.setTools(tools);
+	SnapshotCounter counter;
+	counter.connectTo(&bus);
+
+	for (int i=0; i<10; ++i)
+		tool1->set_prMt(cx::createTransformTranslate(cx::Vector3D(i,0,0)));
+	tool2->set_prMt(cx::createTransformTranslate(cx::Vector3D(0,1,0)));
+	CHECK(counter.mSnapshots.empty());
+
+	bus.flush();
+	REQUIRE(counter.mSnapshots.size() == 1);
+	cx::TrackingSnapshot snapshot = counter.mSnapshots.front();
+	CHECK(snapshot.mSampleCount == 11);
+	CHECK(snapshot.mSamples.size() == 2);
+	REQUIRE(snapshot.contains("tool1"));
+	CHECK(cx::similar(snapshot.mSamples["tool1"].prMt, cx::createTransformTranslate(cx::Vector3D(9,0,0))));
+	CHECK(snapshot.contains("tool2"));
+
+	bus.flush();
+	CHECK(counter.mSnapshots.size() == 1);
+}
+
+TEST_CASE("TrackingUpdateBus: Publishes when the frame window ends", "[unit]")
+{
+	cx::DummyToolPtr tool(new cx::DummyTool("tool1"));
+	cx::TrackingUpdateBus::ToolMap tools;
+	tools[tool->getUid()] = tool;
+
+	cx::TrackingUpdateBus bus;
+	bus.setFrameWindow(5);
+	bus.setTools(tools);
+	SnapshotCounter counter;
+	counter.connectTo(&bus);
+
+	tool->set_prMt(cx::createTransformTranslate(cx::Vector3D(1,0,0)));
+	tool->set_prMt(cx::createTransformTranslate(cx::Vector3D(2,0,0)));
+	CHECK(waitForQueuedSignal(&bus, SIGNAL(snapshotReady(TrackingSnapshot)), 1000));
+
+	REQUIRE(counter.mSnapshots.size() == 1);
+	CHECK(counter.mSnapshots.front().mSampleCount == 2);
+}
+
+TEST_CASE("TrackingUpdateBus: Publishes each sample immediately when the frame window is 0", "[unit]")
+{
+	cx::DummyToolPtr tool(new cx::DummyTool("tool1"));
+	cx::TrackingUpdateBus::ToolMap tools;
+	tools[tool->getUid()] = tool;
+
+	cx::TrackingUpdateBus bus;
+	bus.setFrameWindow(0);
+	bus.setTools(tools);
+	SnapshotCounter counter;
+	counter.connectTo(&bus);
+
+	tool->set_prMt(cx::createTransformTranslate(cx::Vector3D(1,0,0)));
+	REQUIRE(counter.mSnapshots.size() == 1);
+	tool->set_prMt(cx::createTransformTranslate(cx::Vector3D(2,0,0)));
+	REQUIRE(counter.mSnapshots.size() == 2);
+	CHECK(counter.mSnapshots.back().mSampleCount == 1);
+	CHECK(cx::similar(counter.mSnapshots.back().mSamples["tool1"].prMt, cx::createTransformTranslate(cx::Vector3D(2,0,0))));
+}
+
+TEST_CASE("TrackingUpdateBus: Ignores tools removed from the bus", "[unit]")
+{
+	cx::DummyToolPtr tool(new cx::DummyTool("tool1"));
+	cx::TrackingUpdateBus::ToolMap tools;
+	tools[tool->getUid()] = tool;
+
+	cx::TrackingUpdateBus bus;
+	bus.setTools(tools);
+	bus.setTools(cx::TrackingUpdateBus::ToolMap());
+	SnapshotCounter counter;
+	counter.connectTo(&bus);
+
+	tool->set_prMt(cx::createTransformTranslate(cx::Vector3D(1,0,0)));
+	bus.flush();
+	CHECK(counter.mSnapshots.empty());
+}
+
+} // namespace cxtest
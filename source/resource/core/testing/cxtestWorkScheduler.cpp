@@ -0,0 +1,197 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+                 
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+                 
+CustusX is released under a BSD 3-Clause license.
+                 
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <QThread>
+#include <QAtomicInt>
+#include <stdexcept>
+#include <algorithm>
+#include <boost/bind.hpp>
+#include "cxWorkScheduler.h"
+
+namespace cxtest
+{
+
+namespace
+{
+struct ConcurrencyCounter
+{
+	QAtomicInt mRunning;
+	QAtomicInt mMaxRunning;
+
+	int run(int value)
+	{
+		int running = mRunning.fetchAndAddOrdered(1)+1;
+		int max = mMaxRunning.load();
+		while (running > max && !mMaxRunning.testAndSetOrdered(max, running))
+			max = mMaxRunning.load();
+		QThread::msleep(20);
+		mRunning.fetchAndAddOrdered(-1);
+		return value;
+	}
+};
+
+int throwRuntimeError()
+{
+	throw std::runtime_error("test failure");
+	return 0;
+}
+
+void markRange(std::vector<int>* visits, qint64 begin, qint64 end)
+{
+	for (qint64 i=begin; i<end; ++i)
+		++(*visits)[i];
+}
+
+void throwInRange(qint64 begin, qint64 end)
+{
+	if (begin==0)
+		throw std::runtime_error("test failure");
+	Q_UNUSED(end);
+}
+
+void nestedParallelFor(std::vector<std::vector<int> >* visits, qint64 begin, qint64 end)
+{
+	for (qint64 i=begin; i<end; ++i)
+		cx::WorkScheduler::getInstance()->parallelFor((*visits)[i].size(), 1, boost::bind(&markRange, &(*visits)[i], _1, _2));
+}
+}
+
+TEST_CASE("WorkScheduler returns results through futures", "[unit]")
+{
+	cx::WorkScheduler* scheduler = cx::WorkScheduler::getInstance();
+	ConcurrencyCounter counter;
+
+	boost::function<int()> function = boost::bind(&ConcurrencyCounter::run, &counter, 42);
+	QFuture<int> future = scheduler->run<int>(function, cx::wpINTERACTIVE);
+	future.waitForFinished();
+
+	CHECK(future.isFinished());
+	CHECK(future.result()==42);
+}
+
+TEST_CASE("WorkScheduler limits the number of background threads", "[unit]")
+{
+	cx::WorkScheduler* scheduler = cx::WorkScheduler::getInstance();
+	int oldMaxBackground = scheduler->getMaxBackgroundThreadCount();
+	scheduler->setMaxBackgroundThreadCount(1);
+
+	ConcurrencyCounter counter;
+	std::vector<QFuture<int> > futures;
+	for (int i=0; i<5; ++i)
+	{
+		boost::function<int()> function = boost::bind(&ConcurrencyCounter::run, &counter, i);
+		futures.push_back(scheduler->run<int>(function, cx::wpBACKGROUND));
+	}
+	REQUIRE(scheduler->waitForDone(10000));
+
+	CHECK(counter.mMaxRunning.load()==1);
+	for (int i=0; i<5; ++i)
+		CHECK(futures[i].result()==i);
+
+	scheduler->setMaxBackgroundThreadCount(oldMaxBackground);
+}
+
+TEST_CASE("WorkScheduler runs interactive work while background threads are busy", "[unit]")
+{
+	cx::WorkScheduler* scheduler = cx::WorkScheduler::getInstance();
+	int oldMaxBackground = scheduler->getMaxBackgroundThreadCount();
+	int oldMax = scheduler->getMaxThreadCount();
+	scheduler->setMaxThreadCount(2);
+	scheduler->setMaxBackgroundThreadCount(1);
+
+	ConcurrencyCounter background;
+	for (int i=0; i<10; ++i)
+		scheduler->run<int>(boost::bind(&ConcurrencyCounter::run, &background, i), cx::wpBACKGROUND);
+
+	ConcurrencyCounter interactive;
+	QFuture<int> future = scheduler->run<int>(boost::bind(&ConcurrencyCounter::run, &interactive, 1), cx::wpINTERACTIVE);
+	future.waitForFinished();
+
+	CHECK(background.mRunning.load() > 0); // interactive finished while background still queued/running
+	REQUIRE(scheduler->waitForDone(10000));
+
+	scheduler->setMaxThreadCount(oldMax);
+	scheduler->setMaxBackgroundThreadCount(oldMaxBackground);
+}
+
+TEST_CASE("WorkScheduler reports exceptions through the future and keeps running", "[unit]")
+{
+	cx::WorkScheduler* scheduler = cx::WorkScheduler::getInstance();
+	int oldMaxBackground = scheduler->getMaxBackgroundThreadCount();
+	scheduler->setMaxBackgroundThreadCount(1);
+
+	QFuture<int> failed = scheduler->run<int>(&throwRuntimeError, cx::wpBACKGROUND);
+	failed.waitForFinished(); // does not throw here
+	CHECK(failed.isFinished());
+	CHECK_THROWS(failed.result());
+
+	// the background slot of the failed task is released
+	ConcurrencyCounter counter;
+	QFuture<int> next = scheduler->run<int>(boost::bind(&ConcurrencyCounter::run, &counter, 7), cx::wpBACKGROUND);
+	REQUIRE(scheduler->waitForDone(10000));
+	CHECK(next.result()==7);
+
+	scheduler->setMaxBackgroundThreadCount(oldMaxBackground);
+}
+
+TEST_CASE("WorkScheduler sets the background threads to half the threads", "[unit]")
+{
+	cx::WorkScheduler* scheduler = cx::WorkScheduler::getInstance();
+	int oldMax = scheduler->getMaxThreadCount();
+	int oldMaxBackground = scheduler->getMaxBackgroundThreadCount();
+
+	scheduler->setMaxThreadCount(8);
+	CHECK(scheduler->getMaxBackgroundThreadCount()==4);
+	scheduler->setMaxThreadCount(1);
+	CHECK(scheduler->getMaxBackgroundThreadCount()==1);
+
+	scheduler->setMaxThreadCount(oldMax);
+	scheduler->setMaxBackgroundThreadCount(oldMaxBackground);
+}
+
+TEST_CASE("WorkScheduler parallelFor visits each index once", "[unit]")
+{
+	cx::WorkScheduler* scheduler = cx::WorkScheduler::getInstance();
+	std::vector<int> visits(1001, 0);
+
+	scheduler->parallelFor(visits.size(), 1, boost::bind(&markRange, &visits, _1, _2));
+
+	CHECK(std::count(visits.begin(), visits.end(), 1) == int(visits.size()));
+	CHECK(scheduler->getRangeCount(visits.size(), 10000) == 1);
+	CHECK(scheduler->getRangeCount(3, 1) <= 3);
+	CHECK(scheduler->getRangeCount(0, 1) == 0);
+}
+
+TEST_CASE("WorkScheduler parallelFor rethrows exceptions", "[unit]")
+{
+	cx::WorkScheduler* scheduler = cx::WorkScheduler::getInstance();
+	CHECK_THROWS(scheduler->parallelFor(1000, 1, &throwInRange));
+}
+
+TEST_CASE("WorkScheduler parallelFor can be nested without deadlock", "[unit]")
+{
+	cx::WorkScheduler* scheduler = cx::WorkScheduler::getInstance();
+	int oldMax = scheduler->getMaxThreadCount();
+	scheduler->setMaxThreadCount(2);
+
+	std::vector<std::vector<int> > visits(16, std::vector<int>(100, 0));
+	scheduler->parallelFor(visits.size(), 1, boost::bind(&nestedParallelFor, &visits, _1, _2));
+
+	for (unsigned i=0; i<visits.size(); ++i)
+		CHECK(std::count(visits[i].begin(), visits[i].end(), 1) == int(visits[i].size()));
+
+	REQUIRE(scheduler->waitForDone(10000));
+	scheduler->setMaxThreadCount(oldMax);
+}
+
+} // namespace cxtest
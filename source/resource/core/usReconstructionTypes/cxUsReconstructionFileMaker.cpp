@@ -15,6 +15,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QSaveFile>
 #include <vtkImageChangeInformation.h>
 #include <vtkImageData.h>
 #include "vtkImageAppend.h"
@@ -331,7 +332,7 @@ void UsReconstructionFileMaker::report()
 	}
 }
 
-void UsReconstructionFileMaker::writeUSImages(QString path, ImageDataContainerPtr images, bool compression, std::vector<TimedPosition> pos)
+bool UsReconstructionFileMaker::writeUSImages(QString path, ImageDataContainerPtr images, bool compression, std::vector<TimedPosition> pos)
 {
 	CX_ASSERT(images->size()==pos.size());
 	vtkMetaImageWriterPtr writer = vtkMetaImageWriterPtr::New();
@@ -349,11 +350,58 @@ void UsReconstructionFileMaker::writeUSImages(QString path, ImageDataContainerPt
 			writer->Write();
 		}
 
-		CustomMetaImagePtr customReader = CustomMetaImage::create(filename);
-		customReader->setTransform(pos[i].mPos);
-		customReader->setModality(imUS);
-		customReader->setImageType(convertToImageSubType(mSessionDescription));
+		if (!this->writeUSImageHeader(filename, pos[i]))
+			return false;
 	}
+	return true;
+}
+
+bool UsReconstructionFileMaker::writeUSImageHeaders(QString path, std::vector<TimedPosition> pos)
+{
+	for (unsigned i=0; i<pos.size(); ++i)
+	{
+		QString filename = QString("%1/%2_%3.mhd").arg(path).arg(mSessionDescription).arg(i);
+		if (!this->writeUSImageHeader(filename, pos[i]))
+			return false;
+	}
+	return true;
+}
+
+bool UsReconstructionFileMaker::writeUSImageHeader(QString filename, const TimedPosition& pos)
+{
+	CustomMetaImagePtr customReader = CustomMetaImage::create(filename);
+	return customReader->setTransformModalityAndImageType(pos.mPos, imUS, convertToImageSubType(mSessionDescription));
+}
+
+/** Write a list of all files in the session with their sizes. The manifest
+  * is written last and committed atomically, thus its presence marks a complete
+  * acquisition.
+  */
+bool UsReconstructionFileMaker::writeManifest(QString reconstructionFolder, QString session)
+{
+	QDir dir(reconstructionFolder);
+	QRegExp sessionFiles(QString("^%1(_\\d+)?\\..*").arg(QRegExp::escape(session)));
+	QStringList files = dir.entryList(QDir::Files, QDir::Name).filter(sessionFiles);
+	files.removeAll(session+".manifest");
+
+	QSaveFile file(reconstructionFolder+"/"+session+".manifest");
+	if(!file.open(QIODevice::WriteOnly))
+	{
+		reportError("Cannot open "+file.fileName());
+		return false;
+	}
+	QTextStream stream(&file);
+	for (int i=0; i<files.size(); ++i)
+		stream << files[i] << " " << QFileInfo(dir, files[i]).size() << endl;
+	stream.flush();
+	if (!file.commit())
+	{
+		reportError("Failed to commit "+file.fileName());
+		return false;
+	}
+
+	mReport << QString("%1.manifest, %2 files.").arg(session).arg(files.size());
+	return true;
 }
 
 void UsReconstructionFileMaker::writeMask(QString path, QString session, vtkImageDataPtr mask)
@@ -394,6 +442,16 @@ void UsReconstructionFileMaker::writeREADMEFile(QString reconstructionFolder, QS
 }
 
 QString UsReconstructionFileMaker::writeToNewFolder(QString path, bool compression)
+{
+	return this->write(path, compression, true);
+}
+
+QString UsReconstructionFileMaker::completeRecordedFolder(QString path)
+{
+	return this->write(path, false, false);
+}
+
+QString UsReconstructionFileMaker::write(QString path, bool compression, bool writeImages)
 {
 	TimeKeeper timer;
 	mReconstructData.mFilename = path+"/"+mSessionDescription+".fts"; // use fts since this is a single unique file.
@@ -402,24 +460,37 @@ QString UsReconstructionFileMaker::writeToNewFolder(QString path, bool compressi
 	mReport << "Made reconstruction folder: " + path;
 	QString session = mSessionDescription;
 
-	this->writeTrackerMetadata(path, session, mReconstructData.mTrackerRecordedMetadata);
-	this->writeReferenceMetadata(path, session, mReconstructData.mReferenceRecordedMetadata);
-	this->writeTrackerTimestamps(path, session, mReconstructData.mPositions);
-	this->writeTrackerTransforms(path, session, mReconstructData.mPositions);
-	this->writeUSTimestamps(path, session, mReconstructData.mFrames);
-	this->writeUSTransforms(path, session, mReconstructData.mFrames);
+	bool success = true;
+	success &= this->writeTrackerMetadata(path, session, mReconstructData.mTrackerRecordedMetadata);
+	success &= this->writeReferenceMetadata(path, session, mReconstructData.mReferenceRecordedMetadata);
+	success &= this->writeTrackerTimestamps(path, session, mReconstructData.mPositions);
+	success &= this->writeTrackerTransforms(path, session, mReconstructData.mPositions);
+	success &= this->writeUSTimestamps(path, session, mReconstructData.mFrames);
+	success &= this->writeUSTransforms(path, session, mReconstructData.mFrames);
 	this->writeProbeConfiguration(path, session, mReconstructData.mProbeDefinition.mData, mReconstructData.mProbeUid);
 	this->writeMask(path, session, mReconstructData.getMask());
 	this->writeREADMEFile(path, session);
 
 	ImageDataContainerPtr imageData = mReconstructData.mUsRaw->getImageContainer();
-	if (imageData)
-		this->writeUSImages(path, imageData, compression, mReconstructData.mFrames);
-	else
+	if (!imageData)
+	{
 		mReport << "failed to find frame data, save failed.";
+		success = false;
+	}
+	else if (writeImages)
+		success &= this->writeUSImages(path, imageData, compression, mReconstructData.mFrames);
+	else
+		success &= this->writeUSImageHeaders(path, mReconstructData.mFrames);
+
+	// the manifest marks a complete acquisition: never write it for a partial save.
+	if (success)
+		this->writeManifest(path, session);
+	else
+		mReport << "Save incomplete, manifest not written.";
 
 	int time = std::max(1, timer.getElapsedms());
-	mReport << QString("Completed save to %1. Spent %2s, %3fps").arg(mSessionDescription).arg(time/1000).arg(imageData->size()*1000/time);
+	int frames = imageData ? imageData->size() : 0;
+	mReport << QString("Completed save to %1. Spent %2s, %3fps").arg(mSessionDescription).arg(time/1000).arg(frames*1000/time);
 
 	this->report();
 	mReport.clear();
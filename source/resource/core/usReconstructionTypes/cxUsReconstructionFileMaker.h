@@ -59,6 +59,10 @@ public:
 	* that object to rewrite into new location.
 	*/
 	QString writeToNewFolder(QString path, bool compression);
+	/** Write data to disk. Assume videoRecorder has saved images directly into path, using
+	* the session name as prefix. Only the frame headers are updated, the image data is not rewritten.
+	*/
+	QString completeRecordedFolder(QString path);
 
 	QString getSessionName() const { return mSessionDescription; }
 
@@ -93,7 +97,11 @@ private:
 	bool writeTrackerTransforms(QString reconstructionFolder, QString session, std::vector<TimedPosition> ts);
 	bool writeTrackerTimestamps(QString reconstructionFolder, QString session, std::vector<TimedPosition> ts);
 	void writeProbeConfiguration(QString reconstructionFolder, QString session, ProbeDefinition data, QString uid);
-	void writeUSImages(QString path, ImageDataContainerPtr images, bool compression, std::vector<TimedPosition> pos);
+	QString write(QString path, bool compression, bool writeImages);
+	bool writeUSImages(QString path, ImageDataContainerPtr images, bool compression, std::vector<TimedPosition> pos);
+	bool writeUSImageHeaders(QString path, std::vector<TimedPosition> pos);
+	bool writeUSImageHeader(QString filename, const TimedPosition& pos);
+	bool writeManifest(QString reconstructionFolder, QString session);
 	void writeMask(QString path, QString session, vtkImageDataPtr mask);
 	void writeREADMEFile(QString reconstructionFolder, QString session);
 	bool writeTimestamps(QString filename, std::vector<TimedPosition> ts, QString type, TimeStampType timeStampType = Modified);
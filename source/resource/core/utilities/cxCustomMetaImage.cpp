@@ -11,6 +11,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxCustomMetaImage.h"
 
 #include <QFile>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QStringList>
 #include "cxLogger.h"
@@ -151,21 +152,60 @@ void CustomMetaImage::append(QStringList* data, QString key, QString value)
 
 void CustomMetaImage::setKey(QString key, QString value)
 {
-	QFile file(mFilename);
-
-	if (!file.open(QIODevice::ReadWrite))
+	QStringList data;
+	if (!this->readHeader(&data))
 	{
 	  reportError("Failed to open file " + mFilename + ".");
 	  return;
 	}
 
-	QStringList data = QTextStream(&file).readAll().split("\n");
+	this->replace(&data, key, value);
+	this->writeHeader(data);
+}
+
+void CustomMetaImage::replace(QStringList* data, QString key, QString value)
+{
+	this->remove(data, QStringList()<<key);
+	this->append(data, key, value);
+}
+
+bool CustomMetaImage::setTransformModalityAndImageType(const Transform3D M, IMAGE_MODALITY modality, IMAGE_SUBTYPE imageType)
+{
+	QStringList data;
+	if (!this->readHeader(&data))
+	{
+		reportError("Failed to open file " + mFilename + ".");
+		return false;
+	}
+
+	this->replaceTransform(&data, M);
+	this->replace(&data, "Modality", enum2string(modality));
+	this->replace(&data, "ImageType3", enum2string(imageType));
+	return this->writeHeader(data);
+}
 
-	this->remove(&data, QStringList()<<key);
-	this->append(&data, key, value);
+bool CustomMetaImage::readHeader(QStringList* data)
+{
+	QFile file(mFilename);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	*data = QTextStream(&file).readAll().split("\n");
+	return true;
+}
 
-	file.resize(0);
+/** Replace the header in one operation, readers
+  * will see either the old or the new header.
+  */
+bool CustomMetaImage::writeHeader(const QStringList& data)
+{
+	QSaveFile file(mFilename);
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		reportError("Failed to open file " + mFilename + ".");
+		return false;
+	}
 	file.write(data.join("\n").toLatin1());
+	return file.commit();
 }
 
 void CustomMetaImage::setModality(IMAGE_MODALITY value)
@@ -240,32 +280,32 @@ Transform3D CustomMetaImage::readTransform()
 
 void CustomMetaImage::setTransform(const Transform3D M)
 {
-  QFile file(mFilename);
-
-  if (!file.open(QIODevice::ReadWrite))
+  QStringList data;
+  if (!this->readHeader(&data))
   {
     reportWarning("Could not save transform because: Failed to open file " + mFilename);
     return;
   }
 
-  QStringList data = QTextStream(&file).readAll().split("\n");
+  this->replaceTransform(&data, M);
+  this->writeHeader(data);
+}
 
-  this->remove(&data, QStringList()<<"TransformMatrix"<<"Offset"<<"Position"<<"Orientation");
+void CustomMetaImage::replaceTransform(QStringList* data, const Transform3D& M)
+{
+  this->remove(data, QStringList()<<"TransformMatrix"<<"Offset"<<"Position"<<"Orientation");
 
   int dim = 3; // hardcoded - will fail for 2d images
   std::stringstream tmList;
   for (int c=0; c<dim; ++c)
     for (int r=0; r<dim; ++r)
       tmList << " " << M(r,c);
-  this->append(&data, "TransformMatrix", qstring_cast(tmList.str()));
+  this->append(data, "TransformMatrix", qstring_cast(tmList.str()));
 
   std::stringstream posList;
   for (int r=0; r<dim; ++r)
     posList << " " << M(r,3);
-  this->append(&data, "Offset", qstring_cast(posList.str()));
-
-  file.resize(0);
-  file.write(data.join("\n").toLatin1());
+  this->append(data, "Offset", qstring_cast(posList.str()));
 }
 
 }
@@ -49,11 +49,20 @@ public:
   QString readKey(QString key);
   void setKey(QString key, QString value);
 
+  /** Set transform, modality and image type with a single header write.
+   *  Return false if the header could not be read or written.
+   */
+  bool setTransformModalityAndImageType(const Transform3D M, IMAGE_MODALITY modality, IMAGE_SUBTYPE imageType);
+
 private:
   QString mFilename;
 
   void remove(QStringList* data, QStringList keys);
   void append(QStringList* data, QString key, QString value);
+  void replace(QStringList* data, QString key, QString value);
+  void replaceTransform(QStringList* data, const Transform3D& M);
+  bool readHeader(QStringList* data);
+  bool writeHeader(const QStringList& data);
 
 };
 
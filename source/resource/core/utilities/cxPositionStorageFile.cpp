@@ -24,7 +24,17 @@ PositionStorageReader::PositionStorageReader(QString filename) : positions(filen
 {
   mError = false;
   positions.open(QIODevice::ReadOnly);
-  stream.setDevice(&positions);
+  uchar* data = positions.size() ? positions.map(0, positions.size()) : NULL;
+  if (data)
+  {
+    mMapped.setData(QByteArray::fromRawData(reinterpret_cast<const char*>(data), positions.size()));
+    mMapped.open(QIODevice::ReadOnly);
+    stream.setDevice(&mMapped);
+  }
+  else
+  {
+    stream.setDevice(&positions);
+  }
   stream.setByteOrder(QDataStream::LittleEndian);
 
   char header[7];
@@ -42,6 +52,7 @@ PositionStorageReader::PositionStorageReader(QString filename) : positions(filen
   {
     //std::cout << QString(header).toStdString() << "-" << int(mVersion) << std::endl;
     std::cout << "Error in header for file [" << filename.toStdString() << "]" << std::endl;
+    mMapped.close();
     positions.close();
   }
 }
@@ -100,7 +111,7 @@ bool PositionStorageReader::read(Transform3D* matrix, double* timestamp, QString
     char* data = NULL;
     uint isize = 0;
     stream.readBytes(data, isize);
-	mCurrentToolUid = QString(QByteArray(data, size));
+	mCurrentToolUid = QString(QByteArray(data, isize));
     delete[] data;
 
     stream >> type; // read type and make ready for a new read below
@@ -16,6 +16,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include <QString>
 #include <QFile>
+#include <QBuffer>
 #include <QDataStream>
 #include <boost/cstdint.hpp>
 
@@ -27,6 +28,9 @@ namespace cx {
  * 
  * Each call to read() gives the next position entry from the file.
  * When atEnd() returns true, all positions have been read. 
+ * The file is memory mapped when possible.
+ *
+ * For random access by time or tool, see PositionStorageIndex.
  *
  *
  *
@@ -67,6 +71,7 @@ public:
 private:
 	QString mCurrentToolUid; ///< the tool currently being written.
 	QFile positions;
+	QBuffer mMapped; ///< memory mapped contents of positions
 	QDataStream stream;
 	quint8 mVersion;
 	bool mError;
@@ -0,0 +1,319 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxPositionStorageIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <QtEndian>
+#include "cxFrame3D.h"
+#include "cxUSReconstructInputDataAlgoritms.h"
+#include "cxLogger.h"
+#include "cxWorkScheduler.h"
+
+namespace cx
+{
+
+namespace
+{
+const qint64 FRAME_SIZE = 6*sizeof(double);
+
+/** Version 1 files have 32 bit timestamps, later versions 64 bit.
+ */
+qint64 getTimestampSize(int version)
+{
+	return (version==1) ? sizeof(quint32) : sizeof(quint64);
+}
+
+double readTimestamp(const uchar* data, qint64 size)
+{
+	if (size==sizeof(quint32))
+		return qFromLittleEndian<quint32>(data);
+	return qFromLittleEndian<quint64>(data);
+}
+
+double readDouble(const uchar* data)
+{
+	quint64 bits = qFromLittleEndian<quint64>(data);
+	double retval;
+	memcpy(&retval, &bits, sizeof(retval));
+	return retval;
+}
+
+Transform3D readTransform(const uchar* data)
+{
+	boost::array<double, 6> rep;
+	for (int i=0; i<6; ++i)
+		rep[i] = readDouble(data + i*sizeof(double));
+	return Frame3D::fromCompactAxisAngleRep(rep).transform();
+}
+
+/** A position to decode: Either a single frame, or an
+ *  interpolation between two frames.
+ */
+struct Sample
+{
+	double mTimestamp;
+	qint64 mOffset0;
+	qint64 mOffset1;
+	double mWeight; ///< weight of frame 1
+};
+
+void decodeRange(const uchar* data, const std::vector<Sample>* samples, std::vector<PositionStorageIndex::Position>* positions, qint64 begin, qint64 end)
+{
+	for (qint64 i=begin; i<end; ++i)
+	{
+		const Sample& sample = (*samples)[i];
+		PositionStorageIndex::Position& position = (*positions)[i];
+		position.mTimestamp = sample.mTimestamp;
+		position.mTransform = readTransform(data + sample.mOffset0);
+		if (sample.mWeight > 0)
+		{
+			Transform3D next = readTransform(data + sample.mOffset1);
+			position.mTransform = USReconstructInputDataAlgorithm::slerpInterpolate(position.mTransform, next, sample.mWeight);
+		}
+	}
+}
+
+std::vector<PositionStorageIndex::Position> decodeSamples(const uchar* data, int tool, const std::vector<Sample>& samples)
+{
+	size_t N = samples.size();
+	std::vector<PositionStorageIndex::Position> retval(N);
+	for (size_t i=0; i<N; ++i)
+		retval[i].mTool = tool;
+
+	WorkScheduler::getInstance()->parallelFor(N, 10000, boost::bind(&decodeRange, data, &samples, &retval, _1, _2));
+	return retval;
+}
+} // namespace
+
+PositionStorageIndex::PositionStorageIndex(QString filename) :
+	mFile(filename),
+	mData(NULL),
+	mSize(0),
+	mVersion(0),
+	mValid(false)
+{
+	if (!mFile.open(QIODevice::ReadOnly))
+	{
+		CX_LOG_ERROR() << "Failed to open position file " << filename;
+		return;
+	}
+	mSize = mFile.size();
+	mData = mSize ? mFile.map(0, mSize) : NULL;
+	if (!mData)
+	{
+		CX_LOG_ERROR() << "Failed to map position file " << filename;
+		return;
+	}
+	if (mSize<7 || memcmp(mData, "SNWPOS", 6)!=0 || mData[6]<1)
+	{
+		CX_LOG_ERROR() << "Error in header for position file " << filename;
+		return;
+	}
+	mVersion = mData[6];
+	if (mVersion > 2)
+	{
+		CX_LOG_ERROR() << "Unsupported version " << mVersion << " for position file " << filename;
+		return;
+	}
+	this->buildIndex();
+}
+
+PositionStorageIndex::~PositionStorageIndex()
+{
+}
+
+void PositionStorageIndex::buildIndex()
+{
+	int currentTool = -1;
+	qint64 tsSize = getTimestampSize(mVersion);
+	qint64 pos = 7;
+	while (pos < mSize)
+	{
+		quint8 type = mData[pos];
+		if (type==2 && pos+6<=mSize) // change tool: <type><size><quint32 length><name>
+		{
+			quint32 length = qFromLittleEndian<quint32>(mData+pos+2);
+			if (length==0xffffffff)
+				length = 0;
+			if (pos+6+length > mSize)
+				break;
+			currentTool = this->addTool(QString::fromLatin1(reinterpret_cast<const char*>(mData+pos+6), length));
+			pos += 6+length;
+		}
+		else if (type==1 && pos+3+tsSize+FRAME_SIZE<=mSize) // <type><size><timestamp><tool><frame>
+		{
+			Entry entry;
+			entry.mTimestamp = readTimestamp(mData+pos+2, tsSize);
+			entry.mOffset = pos+3+tsSize;
+			int tool = this->addTool(QString::number(mData[pos+2+tsSize]));
+			mEntries[tool].push_back(entry);
+			pos += 3+tsSize+FRAME_SIZE;
+		}
+		else if (type==3 && pos+2+tsSize+FRAME_SIZE<=mSize) // <type><size><timestamp><frame>
+		{
+			if (currentTool<0)
+				currentTool = this->addTool("");
+			Entry entry;
+			entry.mTimestamp = readTimestamp(mData+pos+2, tsSize);
+			entry.mOffset = pos+2+tsSize;
+			mEntries[currentTool].push_back(entry);
+			pos += 2+tsSize+FRAME_SIZE;
+		}
+		else
+		{
+			break;
+		}
+	}
+	if (pos < mSize)
+		CX_LOG_WARNING() << "Position file " << mFile.fileName() << " is truncated or corrupt after byte " << pos;
+
+	// files appended over several sessions might be out of order
+	for (unsigned i=0; i<mEntries.size(); ++i)
+		for (unsigned j=1; j<mEntries[i].size(); ++j)
+			if (mEntries[i][j] < mEntries[i][j-1])
+			{
+				std::stable_sort(mEntries[i].begin(), mEntries[i].end());
+				break;
+			}
+
+	mValid = true;
+}
+
+int PositionStorageIndex::addTool(QString toolUid)
+{
+	std::map<QString, int>::iterator iter = mToolIndices.find(toolUid);
+	if (iter!=mToolIndices.end())
+		return iter->second;
+
+	int index = mToolUids.size();
+	mToolUids << toolUid;
+	mToolIndices[toolUid] = index;
+	mEntries.push_back(std::vector<Entry>());
+	return index;
+}
+
+bool PositionStorageIndex::isValid() const
+{
+	return mValid;
+}
+
+int PositionStorageIndex::version() const
+{
+	return mVersion;
+}
+
+QStringList PositionStorageIndex::getToolUids() const
+{
+	return mToolUids;
+}
+
+int PositionStorageIndex::getToolIndex(QString toolUid) const
+{
+	std::map<QString, int>::const_iterator iter = mToolIndices.find(toolUid);
+	if (iter==mToolIndices.end())
+		return -1;
+	return iter->second;
+}
+
+int PositionStorageIndex::getNumberOfPositions() const
+{
+	int retval = 0;
+	for (unsigned i=0; i<mEntries.size(); ++i)
+		retval += mEntries[i].size();
+	return retval;
+}
+
+int PositionStorageIndex::getNumberOfPositions(int tool) const
+{
+	if (tool<0 || tool>=int(mEntries.size()))
+		return 0;
+	return mEntries[tool].size();
+}
+
+bool PositionStorageIndex::getTimeRange(double* start, double* stop) const
+{
+	bool found = false;
+	for (unsigned i=0; i<mEntries.size(); ++i)
+	{
+		if (mEntries[i].empty())
+			continue;
+		if (!found || mEntries[i].front().mTimestamp < *start)
+			*start = mEntries[i].front().mTimestamp;
+		if (!found || mEntries[i].back().mTimestamp > *stop)
+			*stop = mEntries[i].back().mTimestamp;
+		found = true;
+	}
+	return found;
+}
+
+bool PositionStorageIndex::getTimeRange(int tool, double* start, double* stop) const
+{
+	if (tool<0 || tool>=int(mEntries.size()) || mEntries[tool].empty())
+		return false;
+	*start = mEntries[tool].front().mTimestamp;
+	*stop = mEntries[tool].back().mTimestamp;
+	return true;
+}
+
+std::vector<PositionStorageIndex::Position> PositionStorageIndex::extract(int tool, double start, double stop) const
+{
+	std::vector<Sample> samples;
+	if (tool<0 || tool>=int(mEntries.size()))
+		return decodeSamples(mData, tool, samples);
+
+	const std::vector<Entry>& entries = mEntries[tool];
+	Entry lo = { start, 0 };
+	Entry hi = { stop, 0 };
+	std::vector<Entry>::const_iterator begin = std::lower_bound(entries.begin(), entries.end(), lo);
+	std::vector<Entry>::const_iterator end = std::upper_bound(begin, entries.end(), hi);
+
+	samples.reserve(end-begin);
+	for (std::vector<Entry>::const_iterator iter=begin; iter!=end; ++iter)
+	{
+		Sample sample = { iter->mTimestamp, iter->mOffset, iter->mOffset, 0 };
+		samples.push_back(sample);
+	}
+	return decodeSamples(mData, tool, samples);
+}
+
+std::vector<PositionStorageIndex::Position> PositionStorageIndex::resample(int tool, double start, double stop, double interval) const
+{
+	std::vector<Sample> samples;
+	if (tool<0 || tool>=int(mEntries.size()) || mEntries[tool].empty() || interval<=0)
+		return decodeSamples(mData, tool, samples);
+
+	const std::vector<Entry>& entries = mEntries[tool];
+	start = std::max(start, entries.front().mTimestamp);
+	stop = std::min(stop, entries.back().mTimestamp);
+
+	std::vector<Entry>::const_iterator next = entries.begin();
+	for (qint64 i=0; start+i*interval<=stop; ++i)
+	{
+		double t = start+i*interval;
+		while (next!=entries.end() && next->mTimestamp<=t)
+			++next;
+
+		// next is the first entry after t, thus next-1 is at or before t
+		std::vector<Entry>::const_iterator previous = next-1;
+		Sample sample = { t, previous->mOffset, previous->mOffset, 0 };
+		if (next!=entries.end() && next->mTimestamp > previous->mTimestamp)
+		{
+			sample.mOffset1 = next->mOffset;
+			sample.mWeight = (t-previous->mTimestamp)/(next->mTimestamp-previous->mTimestamp);
+		}
+		samples.push_back(sample);
+	}
+	return decodeSamples(mData, tool, samples);
+}
+
+} // namespace cx
@@ -0,0 +1,98 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXPOSITIONSTORAGEINDEX_H_
+#define CXPOSITIONSTORAGEINDEX_H_
+
+#include "cxResourceExport.h"
+
+#include <vector>
+#include <map>
+#include <QFile>
+#include <QStringList>
+#include <boost/shared_ptr.hpp>
+
+#include "cxTransform3D.h"
+
+namespace cx
+{
+
+/**\brief Random access to the positions in a position file.
+ *
+ * The file is memory mapped and scanned once, storing only the timestamp
+ * and file offset of each position, grouped by tool and sorted by time.
+ * Transforms are decoded on demand, in parallel for large requests.
+ *
+ * Positions can be extracted for a tool within a time range, or
+ * resampled at a fixed interval using slerp between the neighbouring
+ * positions.
+ *
+ * For a description of the file format, see PositionStorageReader.
+ *
+ * \sa PositionStorageReader
+ * \ingroup cx_resource_core_utilities
+ */
+class cxResource_EXPORT PositionStorageIndex
+{
+public:
+	struct Position
+	{
+		double mTimestamp; ///< milliseconds since epoch, only the lower 32 bits for version 1 files
+		int mTool; ///< index into getToolUids()
+		Transform3D mTransform;
+	};
+
+	explicit PositionStorageIndex(QString filename);
+	~PositionStorageIndex();
+
+	bool isValid() const;
+	int version() const;
+	QStringList getToolUids() const;
+	int getToolIndex(QString toolUid) const; ///< return -1 if not found
+	int getNumberOfPositions() const;
+	int getNumberOfPositions(int tool) const;
+	bool getTimeRange(double* start, double* stop) const; ///< time range of all positions, false if empty
+	bool getTimeRange(int tool, double* start, double* stop) const; ///< time range of the tool, false if empty
+
+	/** Return all positions for the tool with start <= timestamp <= stop, sorted by time.
+	 */
+	std::vector<Position> extract(int tool, double start, double stop) const;
+	/** Return positions for the tool at start, start+interval, ... up to stop.
+	 *  Times outside the recorded positions of the tool are skipped.
+	 */
+	std::vector<Position> resample(int tool, double start, double stop, double interval) const;
+
+private:
+	struct Entry
+	{
+		double mTimestamp;
+		qint64 mOffset; ///< file offset of the compact frame representation
+		bool operator<(const Entry& other) const { return mTimestamp < other.mTimestamp; }
+	};
+
+	void buildIndex();
+	int addTool(QString toolUid);
+
+	QFile mFile;
+	const uchar* mData;
+	qint64 mSize;
+	int mVersion;
+	bool mValid;
+	QStringList mToolUids;
+	std::map<QString, int> mToolIndices;
+	std::vector<std::vector<Entry> > mEntries; ///< per tool, sorted by time
+};
+
+typedef boost::shared_ptr<PositionStorageIndex> PositionStorageIndexPtr;
+
+} // namespace cx
+
+#endif /*CXPOSITIONSTORAGEINDEX_H_*/
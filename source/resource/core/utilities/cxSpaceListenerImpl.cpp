@@ -75,18 +75,16 @@ void SpaceListenerImpl::doConnect()
 		if (mSpace.mRefObject == "active")
 		{
 			mActiveTool = ActiveToolProxy::New(mTrackingService);
-			connect(mActiveTool.get(), SIGNAL(toolTransformAndTimestamp(Transform3D,double)), this, SIGNAL(changed()));
+			connect(mActiveTool.get(), &ActiveToolProxy::activeToolChanged, this, &SpaceListener::changed);
 			connect(mActiveTool.get(), SIGNAL(tooltipOffset(double)), this, SIGNAL(changed()));
 		}
 		else
 		{
 			ToolPtr tool = mTrackingService->getTool(mSpace.mRefObject);
 			if (tool)
-			{
-				connect(tool.get(), SIGNAL(toolTransformAndTimestamp(Transform3D,double)), this, SIGNAL(changed()));
 				connect(tool.get(), SIGNAL(tooltipOffset(double)), this, SIGNAL(changed()));
-			}
 		}
+		connect(mTrackingService.get(), &TrackingService::toolsUpdated, this, &SpaceListenerImpl::onToolsUpdated);
 		connect(mDataManager.get(), SIGNAL(rMprChanged()), this, SIGNAL(changed()));
 	}
 
@@ -116,7 +114,7 @@ void SpaceListenerImpl::doDisconnect()
 	{
 		if (mActiveTool)
 		{
-			disconnect(mActiveTool.get(), SIGNAL(toolTransformAndTimestamp(Transform3D,double)), this, SIGNAL(changed()));
+			disconnect(mActiveTool.get(), &ActiveToolProxy::activeToolChanged, this, &SpaceListener::changed);
 			disconnect(mActiveTool.get(), SIGNAL(tooltipOffset(double)), this, SIGNAL(changed()));
 			mActiveTool.reset();
 		}
@@ -124,11 +122,9 @@ void SpaceListenerImpl::doDisconnect()
 		{
 			ToolPtr tool = mTrackingService->getTool(mSpace.mRefObject);
 			if (tool)
-			{
-				disconnect(tool.get(), SIGNAL(toolTransformAndTimestamp(Transform3D,double)), this, SIGNAL(changed()));
 				disconnect(tool.get(), SIGNAL(tooltipOffset(double)), this, SIGNAL(changed()));
-			}
 		}
+		disconnect(mTrackingService.get(), &TrackingService::toolsUpdated, this, &SpaceListenerImpl::onToolsUpdated);
 		disconnect(mDataManager.get(), SIGNAL(rMprChanged()), this, SIGNAL(changed()));
 	}
 
@@ -138,4 +134,20 @@ void SpaceListenerImpl::doDisconnect()
 	}
 }
 
+/** Tool movement arrives coalesced per frame: emit at most once per frame.
+  */
+void SpaceListenerImpl::onToolsUpdated(const TrackingSnapshot& snapshot)
+{
+	QString uid = mSpace.mRefObject;
+	if (mActiveTool)
+	{
+		ToolPtr tool = mTrackingService->getActiveTool();
+		if (!tool)
+			return;
+		uid = tool->getUid();
+	}
+	if (snapshot.contains(uid))
+		emit changed();
+}
+
 } // namespace cx
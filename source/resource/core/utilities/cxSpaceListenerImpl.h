@@ -18,6 +18,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 namespace cx
 {
 typedef boost::shared_ptr<class ActiveToolProxy> ActiveToolProxyPtr;
+struct TrackingSnapshot;
 
 
 /**\brief Class that listens to changes in a coordinate system,
@@ -42,6 +43,7 @@ public:
 private slots:
 	void reconnect();
 private:
+	void onToolsUpdated(const TrackingSnapshot& snapshot);
 	void doConnect();
 	void doDisconnect();
 	CoordinateSystem mSpace;
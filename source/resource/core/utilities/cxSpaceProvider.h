@@ -36,6 +36,7 @@ public:
 	virtual ~SpaceProvider() {}
 
 	virtual Transform3D get_toMfrom(CoordinateSystem from, CoordinateSystem to) = 0; ///< to_M_from
+	virtual std::vector<Transform3D> get_toMfrom(const std::vector<CoordinateSystem>& from, CoordinateSystem to) = 0; ///< to_M_from for each from
 	virtual std::vector<CoordinateSystem> getSpacesToPresentInGUI() = 0;
 	virtual std::map<QString, QString> getDisplayNamesForCoordRefObjects() = 0;
 	virtual SpaceListenerPtr createListener() = 0;
@@ -132,6 +132,17 @@ Transform3D SpaceProviderImpl::get_toMfrom(CoordinateSystem from, CoordinateSyst
 	return to_M_from;
 }
 
+/** Resolve all from spaces against to, inverting ref_M_to only once.
+  */
+std::vector<Transform3D> SpaceProviderImpl::get_toMfrom(const std::vector<CoordinateSystem>& from, CoordinateSystem to)
+{
+	Transform3D toMr = this->get_rMfrom(to).inv();
+	std::vector<Transform3D> retval(from.size());
+	for (unsigned i=0; i<from.size(); ++i)
+		retval[i] = toMr * this->get_rMfrom(from[i]);
+	return retval;
+}
+
 Transform3D SpaceProviderImpl::get_rMfrom(CoordinateSystem from)
 {
 	Transform3D rMfrom = Transform3D::Identity();
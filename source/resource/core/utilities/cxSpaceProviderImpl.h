@@ -33,6 +33,7 @@ public:
 	virtual ~SpaceProviderImpl() {}
 
 	virtual Transform3D get_toMfrom(CoordinateSystem from, CoordinateSystem to); ///< to_M_from
+	virtual std::vector<Transform3D> get_toMfrom(const std::vector<CoordinateSystem>& from, CoordinateSystem to);
 	virtual std::vector<CoordinateSystem> getSpacesToPresentInGUI();
 	virtual std::map<QString, QString> getDisplayNamesForCoordRefObjects();
 	virtual SpaceListenerPtr createListener();
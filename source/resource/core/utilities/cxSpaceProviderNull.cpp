@@ -25,6 +25,11 @@ Transform3D SpaceProviderNull::get_toMfrom(CoordinateSystem from, CoordinateSyst
 	return Transform3D::Identity();
 }
 
+std::vector<Transform3D> SpaceProviderNull::get_toMfrom(const std::vector<CoordinateSystem>& from, CoordinateSystem to)
+{
+	return std::vector<Transform3D>(from.size(), Transform3D::Identity());
+}
+
 std::vector<CoordinateSystem> SpaceProviderNull::getSpacesToPresentInGUI()
 {
 	return std::vector<CoordinateSystem>();
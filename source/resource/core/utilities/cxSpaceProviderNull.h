@@ -21,6 +21,7 @@ class cxResource_EXPORT SpaceProviderNull : public SpaceProvider
 public:
 	SpaceProviderNull();
 	Transform3D get_toMfrom(CoordinateSystem from, CoordinateSystem to);
+	std::vector<Transform3D> get_toMfrom(const std::vector<CoordinateSystem>& from, CoordinateSystem to);
 	std::vector<CoordinateSystem> getSpacesToPresentInGUI();
 	std::map<QString, QString> getDisplayNamesForCoordRefObjects();
 	SpaceListenerPtr createListener();
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <time.h>
 #include <fstream>
+#include <limits>
 
 #include <QFileInfo>
 
@@ -19,7 +20,6 @@
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkCellArray.h"
-#include "vtkCellLocator.h"
 #include "vtkMINCImageReader.h"
 #include "vtkTransform.h"
 #include "vtkImageData.h"
@@ -32,6 +32,7 @@
 #include "vtkFloatArray.h"
 #include "cxMesh.h"
 #include "cxLogger.h"
+#include "cxWorkScheduler.h"
 
 namespace cx
 {
@@ -49,6 +50,7 @@ SeansVesselReg::SeansVesselReg()// : mInvertedTransform(false)
 	mt_maximumNumberOfIterations = 100;
 	mt_verbose = false;
 	mt_maximumDurationSeconds = 1E6; // Random high number
+	mt_coarsestNumberOfPoints = 5000;
 	margin = 40;
 }
 
@@ -185,13 +187,71 @@ SeansVesselReg::ContextPtr SeansVesselReg::linearRefineAllLTS(ContextPtr seed)
 
 /**iteratetively register linearly on the input context until it converges.
  *
+ * Large source data are registered coarse-to-fine: The first iterations
+ * use a subsampling of the source points, each level refining the result
+ * from the previous one, ending with the full data set.
  */
 void SeansVesselReg::linearRefine(ContextPtr context)
+{
+	QDateTime t0 = QDateTime::currentDateTime();
+
+	std::vector<int> strides;
+	int numPoints = context->mSourcePoints->GetNumberOfPoints();
+	if (mt_coarsestNumberOfPoints > 0)
+	{
+		for (int stride = 4; numPoints/stride >= mt_coarsestNumberOfPoints; stride *= 4)
+			strides.insert(strides.begin(), stride);
+	}
+
+	for (unsigned level=0; level<strides.size(); ++level)
+	{
+		ContextPtr coarse = this->subsampleContext(context, strides[level]);
+		this->linearIterate(coarse, mt_maximumNumberOfIterations, t0);
+
+		// move the full data along with the coarse result
+		for (int i = 0; i < coarse->mConcatenation->GetNumberOfConcatenatedTransforms(); ++i)
+		{
+			vtkAbstractTransform* transform = coarse->mConcatenation->GetConcatenatedTransform(i);
+			context->mSourcePoints = this->transformPoints(context->mSourcePoints, transform);
+			context->mConcatenation->Concatenate(transform);
+		}
+		context->mSortedSourcePoints = vtkPointsPtr();
+		context->mSortedTargetPoints = vtkPointsPtr();
+		if (mt_verbose)
+			std::cout << QString("subsampling 1/%1\trms:\t%2").arg(strides[level]).arg(coarse->mMetric) << std::endl;
+	}
+
+	this->linearIterate(context, mt_maximumNumberOfIterations, t0);
+}
+
+/**Create a context containing every stride'th source point,
+ * sharing the target with the input context.
+ */
+SeansVesselReg::ContextPtr SeansVesselReg::subsampleContext(ContextPtr context, int stride)
+{
+	ContextPtr retval = this->splitContext(context);
+
+	int numPoints = context->mSourcePoints->GetNumberOfPoints();
+	retval->mSourcePoints = vtkPointsPtr::New();
+	retval->mSourcePoints->SetNumberOfPoints((numPoints+stride-1)/stride);
+	double p[3];
+	for (int i = 0; i < numPoints; i += stride)
+	{
+		context->mSourcePoints->GetPoint(i, p);
+		retval->mSourcePoints->SetPoint(i/stride, p);
+	}
+
+	return retval;
+}
+
+/**Register linearly on the input context until it converges,
+ * the iteration count is reached, or the time since start runs out.
+ */
+void SeansVesselReg::linearIterate(ContextPtr context, int maximumNumberOfIterations, QDateTime t0)
 {
 	// Perform registrations iteratively until convergence is reached:
 	double previousMetric = 1E6;
-	QDateTime t0 = QDateTime::currentDateTime();
-	for (int iteration = 1; iteration < mt_maximumNumberOfIterations && (t0.msecsTo(QDateTime::currentDateTime()) < mt_maximumDurationSeconds*1000); ++iteration)
+	for (int iteration = 1; iteration < maximumNumberOfIterations && (t0.msecsTo(QDateTime::currentDateTime()) < mt_maximumDurationSeconds*1000); ++iteration)
 	{
 		this->performOneRegistration(context, true);
 		double difference = context->mMetric - previousMetric;
@@ -285,12 +345,9 @@ SeansVesselReg::ContextPtr SeansVesselReg::createContext(DataPtr source, DataPtr
 	}
 
 
-	// Create locator for target points
+	// Create locator for target points, reused if the same data has been registered to before
 	context->mTargetPoints = targetPolyData;
-	context->mTargetPointLocator = vtkCellLocatorPtr::New();
-	context->mTargetPointLocator->SetDataSet(targetPolyData);
-	context->mTargetPointLocator->SetNumberOfCellsPerBucket(1);
-	context->mTargetPointLocator->BuildLocator();
+	context->mTargetPointLocator = PointCloudKdTree::getShared(targetPolyData);
 
 	//Since we are going to play with the data, we have to make a copy
 	context->mSourcePoints = vtkPointsPtr::New();
@@ -301,6 +358,42 @@ SeansVesselReg::ContextPtr SeansVesselReg::createContext(DataPtr source, DataPtr
 	return context;
 }
 
+namespace
+{
+/** Match source points to the target, in ranges run in parallel.
+ */
+struct ClosestPointSearch
+{
+	const PointCloudKdTree* mLocator;
+	vtkPointsPtr mSourcePoints;
+	vtkPointsPtr mClosestPoints;
+	vtkFloatArrayPtr mResiduals;
+	vtkIdListPtr mIdList;
+	std::vector<double> mDistances; ///< output: distance for each source point, NaN if not found
+
+	void run(qint64 begin, qint64 end)
+	{
+		double sourcePoint[3];
+		double outPoint[3];
+		for (qint64 i = begin; i < end; ++i)
+		{
+			mSourcePoints->GetPoint(i, sourcePoint);
+			double distanceSquared = mLocator->findClosestPoint(sourcePoint, outPoint);
+			if ((distanceSquared < 0) || (boost::math::isnan)(distanceSquared))
+			{
+				// empty target or failed search
+				mDistances[i] = std::numeric_limits<double>::quiet_NaN();
+				return;
+			}
+			mClosestPoints->SetPoint(i, outPoint);
+			mResiduals->SetValue(i, distanceSquared);
+			mIdList->SetId(i, i);
+			mDistances[i] = sqrt(distanceSquared);
+		}
+	}
+};
+} // namespace
+
 /**\brief Compute distances between the two datasets.
  *
  * The results will be added into the context: sorted source and target points,
@@ -335,28 +428,27 @@ void SeansVesselReg::computeDistances(ContextPtr context)
 
 	vtkIdListPtr IdList = vtkIdListPtr::New();
 	IdList->SetNumberOfIds(numPoints);
+
+	//Find closest points to all source points, large data in parallel
+	ClosestPointSearch search;
+	search.mLocator = context->mTargetPointLocator.get();
+	search.mSourcePoints = context->mSourcePoints;
+	search.mClosestPoints = closestPoint;
+	search.mResiduals = residuals;
+	search.mIdList = IdList;
+	search.mDistances.resize(numPoints, 0);
+	WorkScheduler::getInstance()->parallelFor(numPoints, 10000, boost::bind(&ClosestPointSearch::run, &search, _1, _2));
+
 	double total_distance = 0;
-	double distanceSquared = 0;
-	//Find closest points to all source points
 	for (int i = 0; i < numPoints; ++i)
 	{
-		//Check the distance to neighbouring points (neighbours should be matched to nearby points)
-		vtkIdType cell_id;
-		int sub_id;
-		double outPoint[3];
-		context->mTargetPointLocator->FindClosestPoint(context->mSourcePoints->GetPoint(i), outPoint, cell_id, sub_id, distanceSquared);
-		closestPoint->SetPoint(i, outPoint);
-		if ((boost::math::isnan)(distanceSquared))
+		if ((boost::math::isnan)(search.mDistances[i]))
 		{
 			std::cout << "nan found during findClosestPoint!" << std::endl;
-			{
-				context->mMetric = 1E6;
-				return;
-			}
+			context->mMetric = 1E6;
+			return;
 		}
-		residuals->InsertValue(i, distanceSquared);
-		IdList->InsertId(i, i);
-		total_distance += sqrt(distanceSquared);
+		total_distance += search.mDistances[i];
 	}
 
 	// quality of the current iteration
@@ -522,7 +614,8 @@ vtkPolyDataPtr SeansVesselReg::convertToPolyData(DataPtr data, QString id)
 		return vtkPolyDataPtr();
 	}
 
-	vtkPolyDataPtr poly = mesh->getTransformedPolyDataCopy(mesh->get_rMd());
+	// shared with the mesh, only read from: allows reuse of the target locator across runs
+	vtkPolyDataPtr poly = mesh->getTransformedPolyData(mesh->get_rMd());
 
 	if (!poly || !poly->GetNumberOfPoints())
 	{
@@ -613,12 +706,13 @@ void SeansVesselReg::print(vtkPolyDataPtr data)
 /**Crop the input data using a bounding box generated from the fixed data.
  * The margin is used to enlarge the bounding box.
  *
+ * The input is returned unchanged if it lies inside the box.
  */
 vtkPolyDataPtr SeansVesselReg::crop(vtkPolyDataPtr input, vtkPolyDataPtr fixed, double margin)
 {
 	// use the bounding box of target to clip the source data.
-	fixed->GetPoints()->ComputeBounds();
-	double* targetBounds = fixed->GetPoints()->GetBounds();
+	double targetBounds[6];
+	fixed->GetPoints()->GetBounds(targetBounds);
 	targetBounds[0] -= margin;
 	targetBounds[1] += margin;
 	targetBounds[2] -= margin;
@@ -626,6 +720,11 @@ vtkPolyDataPtr SeansVesselReg::crop(vtkPolyDataPtr input, vtkPolyDataPtr fixed,
 	targetBounds[4] -= margin;
 	targetBounds[5] += margin;
 
+	DoubleBoundingBox3D clipBounds(targetBounds);
+	DoubleBoundingBox3D inputBounds(input->GetPoints()->GetBounds());
+	if (clipBounds.contains(inputBounds.bottomLeft()) && clipBounds.contains(inputBounds.topRight()))
+		return input;
+
 	// clip the source data with a box
 	vtkPlanesPtr box = vtkPlanesPtr::New();
 	box->SetBounds(targetBounds);
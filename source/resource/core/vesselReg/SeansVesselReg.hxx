@@ -7,6 +7,8 @@
 #include "vtkForwardDeclarations.h"
 #include "cxTransform3D.h"
 #include "vtkSmartPointer.h"
+#include "cxPointCloudKdTree.h"
+#include <QDateTime>
 
 namespace cx
 {
@@ -35,7 +37,7 @@ public:
 	 */
 	struct cxResource_EXPORT Context
 	{
-		vtkCellLocatorPtr mTargetPointLocator; ///< input: target data wrapped in a locator
+		PointCloudKdTreePtr mTargetPointLocator; ///< input: target data wrapped in a locator, shared between runs on the same data
 		vtkPolyDataPtr mTargetPoints; ///< input: target data
 		vtkPointsPtr mSourcePoints; ///< input: current source data, modified according to last iteration
 
@@ -93,6 +95,7 @@ public:
 	int mt_maximumNumberOfIterations;
 	bool mt_verbose;
 	double mt_maximumDurationSeconds;
+	int mt_coarsestNumberOfPoints; ///< linear iterations start on subsampled source data of about this size, refining by 4 each level. 0 disables.
 	double margin;
 	QString m_logPath;
 
@@ -125,6 +128,8 @@ protected:
 	vtkPolyDataPtr crop(vtkPolyDataPtr input, vtkPolyDataPtr fixed, double margin);
 	ContextPtr linearRefineAllLTS(ContextPtr context);
 	void linearRefine(ContextPtr context);
+	void linearIterate(ContextPtr context, int maximumNumberOfIterations, QDateTime start);
+	ContextPtr subsampleContext(ContextPtr context, int stride);
 	SeansVesselReg::ContextPtr splitContext(ContextPtr context);
 
 	void print(vtkPointsPtr points);
@@ -0,0 +1,379 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxPointCloudKdTree.h"
+
+#include <list>
+#include <algorithm>
+#include <limits>
+#include <QMutex>
+#include <vtkPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkIdList.h>
+#include <vtkWeakPointer.h>
+#include "cxVector3D.h"
+
+namespace cx
+{
+
+namespace
+{
+/** Compare point indices along one axis.
+ */
+struct AxisLess
+{
+	AxisLess(const std::vector<double>& points, int axis) : mPoints(points), mAxis(axis) {}
+	bool operator()(int a, int b) const { return mPoints[3*a+mAxis] < mPoints[3*b+mAxis]; }
+	const std::vector<double>& mPoints;
+	int mAxis;
+};
+
+double squaredDistance(const double* a, const double* b)
+{
+	double dx = a[0]-b[0];
+	double dy = a[1]-b[1];
+	double dz = a[2]-b[2];
+	return dx*dx + dy*dy + dz*dz;
+}
+
+Vector3D closestPointOnSegment(const Vector3D& p, const Vector3D& a, const Vector3D& b)
+{
+	Vector3D ab = b-a;
+	double length2 = ab.squaredNorm();
+	if (similar(length2, 0))
+		return a;
+	double t = std::max(0.0, std::min(1.0, (p-a).dot(ab)/length2));
+	return a + t*ab;
+}
+
+/** Closest point on triangle abc, by the Voronoi region method from
+ *  Ericson: Real-Time Collision Detection, 2005.
+ */
+Vector3D closestPointOnTriangle(const Vector3D& p, const Vector3D& a, const Vector3D& b, const Vector3D& c)
+{
+	Vector3D ab = b-a;
+	Vector3D ac = c-a;
+	Vector3D ap = p-a;
+	double d1 = ab.dot(ap);
+	double d2 = ac.dot(ap);
+	if (d1<=0 && d2<=0)
+		return a;
+
+	Vector3D bp = p-b;
+	double d3 = ab.dot(bp);
+	double d4 = ac.dot(bp);
+	if (d3>=0 && d4<=d3)
+		return b;
+
+	double vc = d1*d4 - d3*d2;
+	if (vc<=0 && d1>=0 && d3<=0)
+		return a + d1/(d1-d3)*ab;
+
+	Vector3D cp = p-c;
+	double d5 = ab.dot(cp);
+	double d6 = ac.dot(cp);
+	if (d6>=0 && d5<=d6)
+		return c;
+
+	double vb = d5*d2 - d1*d6;
+	if (vb<=0 && d2>=0 && d6<=0)
+		return a + d2/(d2-d6)*ac;
+
+	double va = d3*d6 - d5*d4;
+	if (va<=0 && (d4-d3)>=0 && (d5-d6)>=0)
+		return b + (d4-d3)/((d4-d3)+(d5-d6))*(c-b);
+
+	double denom = va + vb + vc;
+	if (similar(denom, 0))
+		return a;
+	return a + ab*(vb/denom) + ac*(vc/denom);
+}
+
+/** Number of nearest vertices whose elements are searched when refining.
+ *  A single vertex misses the closest element when it is a large triangle
+ *  whose corners are all farther away than some other vertex.
+ */
+const int REFINE_NEIGHBOURS = 8;
+
+struct SharedEntry
+{
+	vtkWeakPointer<vtkPolyData> mData;
+	unsigned long mMTime;
+	PointCloudKdTreePtr mTree;
+};
+
+QMutex gSharedMutex;
+std::list<SharedEntry> gShared; ///< most recently used first
+const unsigned gMaxShared = 4;
+} // namespace
+
+/** The k nearest points found so far, closest first.
+ */
+struct PointCloudKdTree::Neighbours
+{
+	explicit Neighbours(int k) : mK(std::min(k, int(MAX_NEIGHBOURS))), mCount(0) {}
+	double getWorstDist2() const { return (mCount<mK) ? std::numeric_limits<double>::max() : mDist2[mCount-1]; }
+	void insert(int index, double dist2)
+	{
+		if (dist2 >= this->getWorstDist2())
+			return;
+		int pos = std::min(mCount, mK-1);
+		for (; pos>0 && mDist2[pos-1]>dist2; --pos)
+		{
+			mIndex[pos] = mIndex[pos-1];
+			mDist2[pos] = mDist2[pos-1];
+		}
+		mIndex[pos] = index;
+		mDist2[pos] = dist2;
+		mCount = std::min(mCount+1, mK);
+	}
+
+	enum { MAX_NEIGHBOURS = 16 };
+	int mK;
+	int mCount;
+	int mIndex[MAX_NEIGHBOURS];
+	double mDist2[MAX_NEIGHBOURS];
+};
+
+PointCloudKdTreePtr PointCloudKdTree::create(vtkPolyDataPtr data)
+{
+	return PointCloudKdTreePtr(new PointCloudKdTree(data));
+}
+
+PointCloudKdTreePtr PointCloudKdTree::getShared(vtkPolyDataPtr data)
+{
+	if (!data)
+		return create(data);
+
+	QMutexLocker sentry(&gSharedMutex);
+	for (std::list<SharedEntry>::iterator iter=gShared.begin(); iter!=gShared.end(); ++iter)
+	{
+		if (iter->mData.GetPointer()!=data.GetPointer())
+			continue;
+		if (iter->mMTime!=data->GetMTime())
+		{
+			gShared.erase(iter);
+			break;
+		}
+		gShared.splice(gShared.begin(), gShared, iter);
+		return iter->mTree;
+	}
+
+	SharedEntry entry;
+	entry.mData = data.GetPointer();
+	entry.mMTime = data->GetMTime();
+	entry.mTree = create(data);
+	gShared.push_front(entry);
+	while (gShared.size() > gMaxShared)
+		gShared.pop_back();
+	return entry.mTree;
+}
+
+void PointCloudKdTree::clearShared()
+{
+	QMutexLocker sentry(&gSharedMutex);
+	gShared.clear();
+}
+
+PointCloudKdTree::PointCloudKdTree(vtkPolyDataPtr data)
+{
+	if (!data || !data->GetPoints())
+		return;
+
+	int N = data->GetNumberOfPoints();
+	mPoints.resize(3*N);
+	for (int i=0; i<N; ++i)
+		data->GetPoint(i, &mPoints[3*i]);
+
+	mIndex.resize(N);
+	for (int i=0; i<N; ++i)
+		mIndex[i] = i;
+	mAxis.resize(N, 0);
+	this->build(0, N);
+
+	this->addElements(data->GetLines(), ctLINES);
+	this->addElements(data->GetPolys(), ctPOLYS);
+	this->addElements(data->GetStrips(), ctSTRIPS);
+	this->buildElementAdjacency();
+}
+
+int PointCloudKdTree::getNumberOfPoints() const
+{
+	return mIndex.size();
+}
+
+void PointCloudKdTree::build(int begin, int end)
+{
+	if (end-begin <= 1)
+		return;
+
+	// split along the axis with the largest extent
+	double lo[3] = { 1E30, 1E30, 1E30 };
+	double hi[3] = { -1E30, -1E30, -1E30 };
+	for (int i=begin; i<end; ++i)
+	{
+		const double* p = this->point(mIndex[i]);
+		for (int k=0; k<3; ++k)
+		{
+			lo[k] = std::min(lo[k], p[k]);
+			hi[k] = std::max(hi[k], p[k]);
+		}
+	}
+	int axis = 0;
+	for (int k=1; k<3; ++k)
+		if (hi[k]-lo[k] > hi[axis]-lo[axis])
+			axis = k;
+
+	int mid = (begin+end)/2;
+	std::nth_element(mIndex.begin()+begin, mIndex.begin()+mid, mIndex.begin()+end, AxisLess(mPoints, axis));
+	mAxis[mid] = axis;
+
+	this->build(begin, mid);
+	this->build(mid+1, end);
+}
+
+void PointCloudKdTree::search(const double p[3], int begin, int end, Neighbours* nearest) const
+{
+	if (end-begin <= 8)
+	{
+		for (int i=begin; i<end; ++i)
+			nearest->insert(mIndex[i], squaredDistance(p, this->point(mIndex[i])));
+		return;
+	}
+
+	int mid = (begin+end)/2;
+	const double* node = this->point(mIndex[mid]);
+	nearest->insert(mIndex[mid], squaredDistance(p, node));
+
+	double diff = p[mAxis[mid]] - node[mAxis[mid]];
+	if (diff < 0)
+	{
+		this->search(p, begin, mid, nearest);
+		if (diff*diff < nearest->getWorstDist2())
+			this->search(p, mid+1, end, nearest);
+	}
+	else
+	{
+		this->search(p, mid+1, end, nearest);
+		if (diff*diff < nearest->getWorstDist2())
+			this->search(p, begin, mid, nearest);
+	}
+}
+
+double PointCloudKdTree::findClosestPoint(const double p[3], double closest[3]) const
+{
+	if (mIndex.empty())
+		return -1;
+
+	Neighbours nearest(mElementOffsets.empty() ? 1 : REFINE_NEIGHBOURS);
+	this->search(p, 0, mIndex.size(), &nearest);
+
+	std::copy(this->point(nearest.mIndex[0]), this->point(nearest.mIndex[0])+3, closest);
+	if (mElementOffsets.empty() || similar(nearest.mDist2[0], 0))
+		return nearest.mDist2[0];
+	return this->refineOnElements(p, nearest, closest);
+}
+
+double PointCloudKdTree::refineOnElements(const double p[3], const Neighbours& nearest, double closest[3]) const
+{
+	Vector3D p_r(p);
+	Vector3D best(closest);
+	double bestDist2 = (best-p_r).squaredNorm();
+
+	for (int n=0; n<nearest.mCount; ++n)
+	{
+		int vertex = nearest.mIndex[n];
+		for (int i=mElementOffsets[vertex]; i<mElementOffsets[vertex+1]; ++i)
+		{
+			const int* element = &mElements[3*mElementIndices[i]];
+			Vector3D a(this->point(element[0]));
+			Vector3D b(this->point(element[1]));
+			Vector3D q;
+			if (element[2]<0)
+				q = closestPointOnSegment(p_r, a, b);
+			else
+				q = closestPointOnTriangle(p_r, a, b, Vector3D(this->point(element[2])));
+
+			double dist2 = (q-p_r).squaredNorm();
+			if (dist2 < bestDist2)
+			{
+				bestDist2 = dist2;
+				best = q;
+			}
+		}
+	}
+
+	std::copy(best.data(), best.data()+3, closest);
+	return bestDist2;
+}
+
+void PointCloudKdTree::addElements(vtkCellArray* cells, CELL_TYPE type)
+{
+	if (!cells || !cells->GetNumberOfCells())
+		return;
+
+	vtkIdListPtr cell = vtkIdListPtr::New();
+	cells->InitTraversal();
+	while (cells->GetNextCell(cell))
+	{
+		int n = cell->GetNumberOfIds();
+		if (type==ctLINES)
+		{
+			for (int k=0; k+1<n; ++k)
+			{
+				int segment[3] = { int(cell->GetId(k)), int(cell->GetId(k+1)), -1 };
+				mElements.insert(mElements.end(), segment, segment+3);
+			}
+		}
+		else if (type==ctPOLYS)
+		{
+			// triangle fan, exact for triangles and convex polygons
+			for (int k=1; k+1<n; ++k)
+			{
+				int triangle[3] = { int(cell->GetId(0)), int(cell->GetId(k)), int(cell->GetId(k+1)) };
+				mElements.insert(mElements.end(), triangle, triangle+3);
+			}
+		}
+		else
+		{
+			for (int k=0; k+2<n; ++k)
+			{
+				int triangle[3] = { int(cell->GetId(k)), int(cell->GetId(k+1)), int(cell->GetId(k+2)) };
+				mElements.insert(mElements.end(), triangle, triangle+3);
+			}
+		}
+	}
+}
+
+void PointCloudKdTree::buildElementAdjacency()
+{
+	int numberOfElements = mElements.size()/3;
+	if (!numberOfElements)
+		return;
+
+	int N = mIndex.size();
+	mElementOffsets.assign(N+1, 0);
+	for (int e=0; e<numberOfElements; ++e)
+		for (int k=0; k<3; ++k)
+			if (mElements[3*e+k]>=0)
+				++mElementOffsets[mElements[3*e+k]+1];
+	for (int i=0; i<N; ++i)
+		mElementOffsets[i+1] += mElementOffsets[i];
+
+	std::vector<int> fill(mElementOffsets.begin(), mElementOffsets.end()-1);
+	mElementIndices.resize(mElementOffsets[N]);
+	for (int e=0; e<numberOfElements; ++e)
+		for (int k=0; k<3; ++k)
+			if (mElements[3*e+k]>=0)
+				mElementIndices[fill[mElements[3*e+k]]++] = e;
+}
+
+} // namespace cx
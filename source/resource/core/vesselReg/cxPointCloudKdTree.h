@@ -0,0 +1,80 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXPOINTCLOUDKDTREE_H_
+#define CXPOINTCLOUDKDTREE_H_
+
+#include "cxResourceExport.h"
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "vtkForwardDeclarations.h"
+
+namespace cx
+{
+typedef boost::shared_ptr<class PointCloudKdTree> PointCloudKdTreePtr;
+
+/** \brief Closest point search in a fixed point set or surface.
+ *
+ * A balanced k-d tree over the points of a vtkPolyData, built once
+ * and queried read-only. Queries are thread-safe, and thus can be
+ * spread over several threads.
+ *
+ * If the data contains lines or triangles, the closest point is refined
+ * by projecting onto the lines and triangles sharing one of the nearest
+ * vertices, giving point-to-curve or point-to-surface distances. This is
+ * exact unless a triangle is large compared to the vertex spacing around
+ * it. Other cell types are represented by their vertices only.
+ *
+ * Use getShared() to reuse the tree for the same data across
+ * several registration runs.
+ *
+ * \ingroup cx_resource_core_utilities
+ * \date Oct 19, 2026
+ */
+class cxResource_EXPORT PointCloudKdTree
+{
+public:
+	static PointCloudKdTreePtr create(vtkPolyDataPtr data);
+	/** Return a tree for data, reusing a tree built earlier from the
+	 *  same object if it is unmodified since.
+	 */
+	static PointCloudKdTreePtr getShared(vtkPolyDataPtr data);
+	static void clearShared();
+
+	/** Find the point in the tree closest to p.
+	 *  Return the squared distance, or a negative value if the tree is empty.
+	 */
+	double findClosestPoint(const double p[3], double closest[3]) const;
+	int getNumberOfPoints() const;
+
+private:
+	enum CELL_TYPE { ctLINES, ctPOLYS, ctSTRIPS };
+	struct Neighbours;
+	explicit PointCloudKdTree(vtkPolyDataPtr data);
+	void build(int begin, int end);
+	void search(const double p[3], int begin, int end, Neighbours* nearest) const;
+	void addElements(vtkCellArray* cells, CELL_TYPE type);
+	void buildElementAdjacency();
+	double refineOnElements(const double p[3], const Neighbours& nearest, double closest[3]) const;
+	const double* point(int i) const { return &mPoints[3*i]; }
+
+	std::vector<double> mPoints; ///< xyz, as in the input
+	std::vector<int> mIndex; ///< point indices, ordered as an implicit tree: the median of each range is its node
+	std::vector<unsigned char> mAxis; ///< split axis for the node at each position of mIndex
+	std::vector<int> mElements; ///< point triplets, third is -1 for line segments
+	std::vector<int> mElementOffsets; ///< elements adjacent to point i are mElementIndices[mElementOffsets[i]..mElementOffsets[i+1]>
+	std::vector<int> mElementIndices;
+};
+
+} // namespace cx
+
+#endif /* CXPOINTCLOUDKDTREE_H_ */
@@ -77,6 +77,7 @@ typedef vtkSmartPointer<class vtkImageMapToWindowLevelColors> vtkImageMapToWindo
 typedef vtkSmartPointer<class vtkImagePlaneWidget> vtkImagePlaneWidgetPtr;
 typedef vtkSmartPointer<class vtkImageResample> vtkImageResamplePtr;
 typedef vtkSmartPointer<class vtkImageReslice> vtkImageReslicePtr;
+typedef vtkSmartPointer<class vtkImageResliceToColors> vtkImageResliceToColorsPtr;
 typedef vtkSmartPointer<class vtkImageShrink3D> vtkImageShrink3DPtr;
 typedef vtkSmartPointer<class vtkImageThreshold> vtkImageThresholdPtr;
 typedef vtkSmartPointer<class vtkInteractorStyleFlight> vtkInteractorStyleFlightPtr;
@@ -28,6 +28,7 @@ namespace cx
 typedef boost::shared_ptr<class SelectDataStringPropertyBase> SelectDataStringPropertyBasePtr;
 
 typedef boost::shared_ptr<class Filter> FilterPtr;
+class TimedBaseAlgorithm;
 
 
 /** Base class for CustusX filters/algorithms
@@ -142,6 +143,12 @@ public:
 	  *
 	  */
 	virtual bool postProcess() = 0;
+	/**
+	  * Set the algorithm that runs execute(), or NULL.
+	  * execute() can use it to check for cancellation
+	  * and to report progress. Default: ignored.
+	  */
+	virtual void setExecutingAlgorithm(TimedBaseAlgorithm* algorithm) {}
 
 public slots:
 	/**
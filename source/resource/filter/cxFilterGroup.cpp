@@ -24,12 +24,30 @@ std::vector<FilterPtr> FilterGroup::getFilters() const
 }
 
 void FilterGroup::append(FilterPtr filter)
+{
+    QString sourceUid;
+    if (!mFilters.empty())
+        sourceUid = mFilters.back()->getUid();
+    this->appendBranch(filter, sourceUid);
+}
+
+void FilterGroup::appendBranch(FilterPtr filter, QString sourceUid)
 {
     mFilters.push_back(filter);
 
     QString uid = QString("%1_%2").arg(filter->getType()).arg(mFilters.size());
     XmlOptionFile node = mOptions.descend(uid);
     filter->initialize(node.getElement(), uid);
+
+    mSources[filter->getUid()] = sourceUid;
+}
+
+QString FilterGroup::getSourceUid(QString uid) const
+{
+    std::map<QString, QString>::const_iterator iter = mSources.find(uid);
+    if (iter==mSources.end())
+        return "";
+    return iter->second;
 }
 
 void FilterGroup::remove(Filter* filter)
@@ -37,7 +55,10 @@ void FilterGroup::remove(Filter* filter)
     for (unsigned i=0; i<mFilters.size(); )
     {
         if (filter == mFilters[i].get())
+        {
+            mSources.erase(mFilters[i]->getUid());
             mFilters.erase(mFilters.begin()+i);
+        }
         else
             ++i;
     }
@@ -15,6 +15,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxResourceFilterExport.h"
 
 #include <vector>
+#include <map>
 #include "cxFilter.h"
 #include "cxXmlOptionItem.h"
 
@@ -26,6 +27,12 @@ namespace cx {
   *
   * Connects them by giving them unique id's.
   *
+  * The filters form a dependency graph: The main input of each
+  * filter is connected either to the main output of an earlier
+  * filter (its source) or to the input of the group.
+  * append() connects to the previous filter, giving a sequence,
+  * appendBranch() can connect to any earlier filter.
+  *
   */
 class cxResourceFilter_EXPORT FilterGroup
 {
@@ -40,10 +47,20 @@ public:
       */
     std::vector<FilterPtr> getFilters() const;
     /**
-      * Append a filter to group
+      * Append a filter to group, with input from the previous filter.
       */
     void append(FilterPtr filter);
+    /**
+      * Append a filter to group, with input from the filter sourceUid,
+      * or from the group input if sourceUid is empty.
+      */
+    void appendBranch(FilterPtr filter, QString sourceUid);
     void remove(Filter* filter);
+    /**
+      * Return the uid of the filter providing input to filter uid,
+      * empty if the input is the group input.
+      */
+    QString getSourceUid(QString uid) const;
 
     size_t size() const { return mFilters.size(); }
     bool empty() const { return mFilters.empty(); }
@@ -60,6 +77,7 @@ public:
 
 private:
     std::vector<FilterPtr> mFilters;
+    std::map<QString, QString> mSources;
     XmlOptionFile mOptions;
 };
 typedef boost::shared_ptr<FilterGroup> FilterGroupPtr;
@@ -18,15 +18,37 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxStringProperty.h"
 #include "cxPatientModelService.h"
 #include "cxVisServices.h"
+#include "cxTimedAlgorithm.h"
 
 namespace cx
 {
 
 FilterImpl::FilterImpl(VisServicesPtr services) :
-	mActive(false), mServices(services)
+	mActive(false), mServices(services), mExecutingAlgorithm(NULL)
 {
 }
 
+void FilterImpl::setExecutingAlgorithm(TimedBaseAlgorithm* algorithm)
+{
+	mExecutingAlgorithm = algorithm;
+}
+
+bool FilterImpl::isCancelRequested() const
+{
+	return mExecutingAlgorithm && mExecutingAlgorithm->isCancelRequested();
+}
+
+void FilterImpl::reportProgress(int step, int maxSteps)
+{
+	if (mExecutingAlgorithm)
+		mExecutingAlgorithm->reportProgress(step, maxSteps);
+}
+
+TimedBaseAlgorithm* FilterImpl::getExecutingAlgorithm() const
+{
+	return mExecutingAlgorithm;
+}
+
 PatientModelServicePtr FilterImpl::patientService()
 {
 	return mServices->patient();
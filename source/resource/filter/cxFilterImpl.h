@@ -50,6 +50,7 @@ public:
 	virtual QDomElement generatePresetFromCurrentlySetOptions(QString name) { return QDomElement(); }
 	virtual void setActive(bool on);
 	virtual bool preProcess();
+	virtual void setExecutingAlgorithm(TimedBaseAlgorithm* algorithm);
 
 public slots:
 	virtual void requestSetPresetSlot(QString name) {}
@@ -65,6 +66,15 @@ protected:
 	  */
 	void updateThresholdFromImageChange(QString uid, DoublePropertyPtr threshold);
 	void updateThresholdPairFromImageChange(QString uid, DoublePairPropertyPtr threshold);
+	/** Helper: Return true if the executing algorithm has been cancelled.
+	  * Thread safe, call from execute(). */
+	bool isCancelRequested() const;
+	/** Helper: Report progress to the executing algorithm, if any.
+	  * Thread safe, call from execute(). */
+	void reportProgress(int step, int maxSteps);
+	/** Helper: The algorithm running execute(), or NULL.
+	  * Use to connect VTK/ITK filters, see observeProgress(). */
+	TimedBaseAlgorithm* getExecutingAlgorithm() const;
 
 	virtual void createOptions() = 0;
 	virtual void createInputTypes() = 0;
@@ -84,6 +94,7 @@ protected:
 
 private:
 	QString mUid;
+	TimedBaseAlgorithm* mExecutingAlgorithm;
 
 };
 
@@ -21,10 +21,13 @@ FilterTimedAlgorithm::FilterTimedAlgorithm(FilterPtr filter) :
 {
 	mFilter = filter;
 	mUseDefaultMessages = false;
+	this->setPriority(wpINTERACTIVE);
 }
 
 FilterTimedAlgorithm::~FilterTimedAlgorithm()
-{}
+{
+	mFilter->setExecutingAlgorithm(NULL);
+}
 
 FilterPtr FilterTimedAlgorithm::getFilter()
 {
@@ -33,12 +36,22 @@ FilterPtr FilterTimedAlgorithm::getFilter()
 
 void FilterTimedAlgorithm::preProcessingSlot()
 {
+	mFilter->setExecutingAlgorithm(this);
 	mFilter->preProcess();
 }
 
 void FilterTimedAlgorithm::postProcessingSlot()
 {
 	bool success = this->getResult();
+	mFilter->setExecutingAlgorithm(NULL);
+
+	if (this->isCancelRequested())
+	{
+		reportWarning(QString("Cancelled \"%1\": [%2s]")
+		                                   .arg(mFilter->getName())
+		                                   .arg(this->getSecondsPassedAsString()));
+		return;
+	}
 
 	mFilter->postProcess();
 
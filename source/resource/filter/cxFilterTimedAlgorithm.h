@@ -22,6 +22,9 @@ typedef boost::shared_ptr<class Filter> FilterPtr;
 
 /** Wrap a Filter into a TimedAlgorithm
  *
+ * The filter is run with interactive priority, and can
+ * poll for cancellation and report progress through
+ * Filter::setExecutingAlgorithm().
  *
  * \ingroup cxResourceAlgorithms
  * \date Nov 16, 2012
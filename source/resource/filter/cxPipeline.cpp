@@ -24,6 +24,11 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxStringPropertyBase.h"
 #include "cxCompositeTimedAlgorithm.h"
 #include "cxFilterTimedAlgorithm.h"
+#include "cxImage.h"
+#include "cxMesh.h"
+#include "cxTransform3D.h"
+#include <vtkImageData.h>
+#include <vtkPolyData.h>
 
 namespace cx
 {
@@ -154,7 +159,13 @@ void Pipeline::initialize(FilterGroupPtr filters)
 	for (unsigned i=0; i<mFilters->size(); ++i)
 	{
 		FilterPtr current = mFilters->get(i);
-		mTimedAlgorithm[current->getUid()].reset(new FilterTimedAlgorithm(current));
+		QString uid = current->getUid();
+		TimedAlgorithmPtr algorithm(new FilterTimedAlgorithm(current));
+		mTimedAlgorithm[uid] = algorithm;
+		QtSignalAdapters::connect0<void()>(algorithm.get(), SIGNAL(aboutToStart()),
+		                                   boost::bind(&Pipeline::filterAboutToStart, this, uid));
+		QtSignalAdapters::connect0<void()>(algorithm.get(), SIGNAL(finished()),
+		                                   boost::bind(&Pipeline::filterFinished, this, uid));
 	}
 }
 FilterGroupPtr Pipeline::getFilters() const
@@ -237,10 +248,11 @@ std::vector<SelectDataStringPropertyBasePtr> Pipeline::createNodes()
 	// first node is the input of the first algo
 	retval.push_back(mFilters->get(0)->getInputTypes()[0]);
 
-	// intermediate nodes are fusions between output and input
+	// intermediate nodes are fusions between output of the source and input
 	for (unsigned i=1; i<mFilters->size(); ++i)
 	{
-		SelectDataStringPropertyBasePtr output = mFilters->get(i-1)->getOutputTypes()[0];
+		int sourceIndex = this->getFilterIndex(mFilters->getSourceUid(mFilters->get(i)->getUid()));
+		SelectDataStringPropertyBasePtr output = (sourceIndex<0) ? retval[0] : mFilters->get(sourceIndex)->getOutputTypes()[0];
 		SelectDataStringPropertyBasePtr base  = mFilters->get(i)->getInputTypes()[0];
 		StringPropertyFusedInputOutputSelectDataPtr node;
 		node = StringPropertyFusedInputOutputSelectData::create(mPatientModelService, base, output);
@@ -263,9 +275,119 @@ void Pipeline::nodeValueChanged(QString uid, int index)
 {
 	//    std::cout << "Pipeline::nodeValueChanged(QString uid, int index) " << uid << " " << index << std::endl;
 
-	// clear all nodes beyond the input:
-	for (unsigned i=index+1; i<mNodes.size(); ++i)
-		mNodes[i]->setValue("");
+	if (index >= int(mFilters->size()))
+		return;
+
+	// clear the outputs of all filters depending on the input:
+	std::vector<int> descendants = this->getDescendants(index);
+	for (unsigned i=0; i<descendants.size(); ++i)
+	{
+		FilterPtr filter = mFilters->get(descendants[i]);
+		mExecutedKeys.erase(filter->getUid());
+		filter->getOutputTypes()[0]->setValue("");
+	}
+}
+
+int Pipeline::getFilterIndex(QString uid)
+{
+	for (unsigned i=0; i<mFilters->size(); ++i)
+		if (mFilters->get(i)->getUid()==uid)
+			return i;
+	return -1;
+}
+
+/** Return index and all filters depending on filter index, in order.
+  */
+std::vector<int> Pipeline::getDescendants(int index)
+{
+	std::vector<bool> marked(mFilters->size(), false);
+	marked[index] = true;
+	for (unsigned i=index+1; i<mFilters->size(); ++i)
+	{
+		int source = this->getFilterIndex(mFilters->getSourceUid(mFilters->get(i)->getUid()));
+		if (source>=0 && marked[source])
+			marked[i] = true;
+	}
+
+	std::vector<int> retval;
+	for (unsigned i=0; i<marked.size(); ++i)
+		if (marked[i])
+			retval.push_back(i);
+	return retval;
+}
+
+bool Pipeline::hasOutput(FilterPtr filter)
+{
+	std::vector<SelectDataStringPropertyBasePtr> output = filter->getOutputTypes();
+	return !output.empty() && output[0]->getData();
+}
+
+QString Pipeline::getDataVersion(DataPtr data)
+{
+	if (!data)
+		return "none";
+
+	QString retval = data->getUid();
+	retval += "|" + qstring_cast(data->get_rMd());
+
+	ImagePtr image = boost::dynamic_pointer_cast<Image>(data);
+	if (image && image->getBaseVtkImageData())
+		retval += QString("|%1").arg(image->getBaseVtkImageData()->GetMTime());
+	MeshPtr mesh = boost::dynamic_pointer_cast<Mesh>(data);
+	if (mesh && mesh->getVtkPolyData())
+		retval += QString("|%1").arg(mesh->getVtkPolyData()->GetMTime());
+
+	return retval;
+}
+
+/** Create a key identifying the inputs and options of the filter.
+  * Equal keys means equal output.
+  */
+QString Pipeline::createExecutionKey(FilterPtr filter)
+{
+	QStringList parts;
+
+	std::vector<SelectDataStringPropertyBasePtr> input = filter->getInputTypes();
+	for (unsigned i=0; i<input.size(); ++i)
+		parts << this->getDataVersion(input[i]->getData());
+
+	std::vector<PropertyPtr> options = filter->getOptions();
+	for (unsigned i=0; i<options.size(); ++i)
+		parts << QString("%1=%2").arg(options[i]->getUid()).arg(options[i]->getValueAsVariant().toString());
+
+	QByteArray hash = QCryptographicHash::hash(parts.join("\n").toUtf8(), QCryptographicHash::Md5);
+	return QString(hash.toHex());
+}
+
+bool Pipeline::isUpToDate(QString uid)
+{
+	int index = this->getFilterIndex(uid);
+	if (index<0)
+		return false;
+	FilterPtr filter = mFilters->get(index);
+	if (!this->hasOutput(filter))
+		return false;
+	if (!mExecutedKeys.count(uid))
+		return false;
+	return mExecutedKeys[uid] == this->createExecutionKey(filter);
+}
+
+void Pipeline::filterAboutToStart(QString uid)
+{
+	FilterPtr filter = mFilters->get(uid);
+	if (filter)
+		mRunningKeys[uid] = this->createExecutionKey(filter);
+}
+
+void Pipeline::filterFinished(QString uid)
+{
+	QString key = mRunningKeys[uid];
+	mRunningKeys.erase(uid);
+
+	FilterPtr filter = mFilters->get(uid);
+	if (!filter || mTimedAlgorithm[uid]->isCancelRequested() || !this->hasOutput(filter))
+		return;
+	mExecutedKeys[uid] = key;
 }
 
 TimedAlgorithmPtr Pipeline::getTimedAlgorithm(QString uid)
@@ -280,55 +402,75 @@ TimedAlgorithmPtr Pipeline::getPipelineTimedAlgorithm()
 
 void Pipeline::execute(QString uid)
 {
-	// generate |startIndex, endIndex>, pointing to the filters to be executed
-
-	int endIndex = -1;
-	int startIndex = endIndex;
-
-	if (uid.isEmpty()) // execute entire pipeline, if necessary
+	if (mCompositeTimedAlgorithm->isRunning())
 	{
-		endIndex = mFilters->size();
-		startIndex = endIndex;
+		reportWarning("Pipeline is already running. Ignoring execute.");
+		return;
 	}
-	else // execute at least one given filter, more if necessary
+
+	// find the filters required by the request: the target and all filters it depends on
+	std::vector<bool> required(mFilters->size(), uid.isEmpty());
+	int target = this->getFilterIndex(uid);
+	if (!uid.isEmpty())
 	{
-		for (unsigned i=0; i<mFilters->size(); ++i)
-			if (mFilters->get(i)->getUid()==uid)
-				endIndex = i+1; // set end index to after filter to execute;
-		startIndex = endIndex-1;
+		if (target<0) // input filter not found: ignore
+			return;
+		for (int i=target; i>=0; i=this->getFilterIndex(mFilters->getSourceUid(mFilters->get(i)->getUid())))
+			required[i] = true;
 	}
 
-	if (endIndex<0) // input filter not found: ignore
-		return;
-
-//	// filter i require node i as input
+	// find stale filters, in dependency order, and their level in the graph.
+	// Filters on the same level have no dependencies between them and can run concurrently.
+	std::vector<int> level(mFilters->size(), -1);
+	int levelCount = 0;
+	for (unsigned i=0; i<mFilters->size(); ++i)
+	{
+		if (!required[i])
+			continue;
+		FilterPtr filter = mFilters->get(i);
+		int source = this->getFilterIndex(mFilters->getSourceUid(filter->getUid()));
+		bool sourceIsStale = (source>=0) && (level[source]>=0);
 
-	//	int startIndex = endIndex;
+		if (!sourceIsStale && this->isUpToDate(filter->getUid()))
+			continue;
 
-	// index now counts filters <0...N-1>
-	// nodes are <0...N>
+		if (!sourceIsStale && !mNodes[i]->getData())
+		{
+			reportWarning(QString("Cannot execute filter %1: No input data set").arg(filter->getName()));
+			return;
+		}
 
-	for ( ; startIndex>=-1; --startIndex)
-	{
-		if (startIndex<0)
-			break;
-		if (mNodes[startIndex]->getData()) // index output node for filter[startIndex]
-			break; // found node with data: stop here
+		level[i] = sourceIsStale ? level[source]+1 : 0;
+		levelCount = std::max(levelCount, level[i]+1);
 	}
 
-	std::cout << "Pipeline::execute filter range s=|" << startIndex << "," << endIndex << ">" << std::endl;
-
-	if (startIndex<0)
+	if (levelCount==0)
 	{
-		reportWarning(QString("Cannot execute filter %1: No input data set").arg(uid));
+		report(QString("Pipeline is up to date, nothing to execute."));
 		return;
 	}
 
 	mCompositeTimedAlgorithm->clear();
-	for (unsigned i=startIndex; i<endIndex; ++i)
-		mCompositeTimedAlgorithm->append(mTimedAlgorithm[mFilters->get(i)->getUid()]);
+	for (int l=0; l<levelCount; ++l)
+	{
+		std::vector<TimedAlgorithmPtr> algorithms;
+		for (unsigned i=0; i<level.size(); ++i)
+			if (level[i]==l)
+				algorithms.push_back(mTimedAlgorithm[mFilters->get(i)->getUid()]);
+
+		if (algorithms.size()==1)
+		{
+			mCompositeTimedAlgorithm->append(algorithms[0]);
+			continue;
+		}
+
+		CompositeParallelTimedAlgorithmPtr parallel(new CompositeParallelTimedAlgorithm());
+		for (unsigned i=0; i<algorithms.size(); ++i)
+			parallel->append(algorithms[i]);
+		mCompositeTimedAlgorithm->append(parallel);
+	}
 
-	// run all filters
+	// run all stale filters
 	mCompositeTimedAlgorithm->execute();
 }
 
@@ -22,6 +22,7 @@ namespace cx
 {
 typedef boost::shared_ptr<class TimedBaseAlgorithm> TimedAlgorithmPtr;
 typedef boost::shared_ptr<class CompositeTimedAlgorithm> CompositeTimedAlgorithmPtr;
+typedef boost::shared_ptr<class CompositeSerialTimedAlgorithm> CompositeSerialTimedAlgorithmPtr;
 
 typedef boost::shared_ptr<class StringPropertyFusedInputOutputSelectData> StringPropertyFusedInputOutputSelectDataPtr;
 
@@ -68,7 +69,15 @@ protected:
 
 
 
-/** Sequential execution of Filters.
+/** Execution of a dependency graph of Filters.
+ *
+ * The graph is defined by the FilterGroup. Filters are executed in
+ * dependency order, independent branches (filters whose inputs are
+ * available at the same time) run concurrently.
+ *
+ * The result of each filter is memoized: A filter is only executed
+ * if it has no output, if any of its inputs or options have changed
+ * since its last execution, or if a filter it depends on is executed.
  *
  * \ingroup cxPluginAlgorithms
  * \date Nov 22, 2012
@@ -97,7 +106,8 @@ public:
 	void setOption(QString valueName, QVariant value);
 	/**
 	  * Get all nodes. If there are N filters, there are N+1 nodes.
-	  * Node N are input to filter N, and have node N+1 as output.
+	  * Node N are input to filter N, and is the output of the source
+	  * filter of N (for a sequence: N-1). Node N+1 is the output of the last filter.
 	  *
 	  * Nodes are a fusion of output/input of filters in the pipeline.
 	  * Setting of an output will autoset the input of the next filter
@@ -118,15 +128,18 @@ public:
 	  */
 	TimedAlgorithmPtr getPipelineTimedAlgorithm();
 	/**
-	  * Execute the filter at filterIndex. Recursively execute
-	  * all filters earlier in the pipeline if they dont have
-	  * an output value.
+	  * Execute the filter uid. Recursively execute all filters
+	  * it depends on if they are stale.
 	  *
-	  * Empty input tries to update the pipeline output, i.e. execute
-	  * all filters required to generate the final output, or none if already
-	  * filled.
+	  * Empty input tries to update all pipeline outputs, i.e. execute
+	  * all stale filters, or none if all are up to date.
 	  */
 	void execute(QString uid = "");
+	/**
+	  * Return true if filter uid has an output generated from the
+	  * current inputs and options.
+	  */
+	bool isUpToDate(QString uid);
 
 signals:
 
@@ -136,12 +149,21 @@ public slots:
 private:
 	void setOption(PropertyPtr adapter, QVariant value);
 	std::vector<SelectDataStringPropertyBasePtr> createNodes();
+	int getFilterIndex(QString uid);
+	std::vector<int> getDescendants(int index);
+	bool hasOutput(FilterPtr filter);
+	QString createExecutionKey(FilterPtr filter);
+	QString getDataVersion(DataPtr data);
+	void filterAboutToStart(QString uid);
+	void filterFinished(QString uid);
 
 	FilterGroupPtr mFilters;
 	std::vector<SelectDataStringPropertyBasePtr> mNodes;
 	std::map<QString, TimedAlgorithmPtr> mTimedAlgorithm;
-	CompositeTimedAlgorithmPtr mCompositeTimedAlgorithm;
+	CompositeSerialTimedAlgorithmPtr mCompositeTimedAlgorithm;
 	PatientModelServicePtr mPatientModelService;
+	std::map<QString, QString> mExecutedKeys; ///< filter uid -> key of inputs and options for the current output
+	std::map<QString, QString> mRunningKeys; ///< filter uid -> key of inputs and options for a running execution
 };
 typedef boost::shared_ptr<Pipeline> PipelinePtr;
 
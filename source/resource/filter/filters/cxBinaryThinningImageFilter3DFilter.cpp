@@ -145,13 +145,8 @@ bool BinaryThinningImageFilter3DFilter::execute()
 	centerlineFilter->Update();
 	itkImage = centerlineFilter->GetOutput();
 
-	//Convert ITK to VTK
-	itkToVtkFilterType::Pointer itkToVtkFilter = itkToVtkFilterType::New();
-	itkToVtkFilter->SetInput(itkImage);
-	itkToVtkFilter->Update();
-
-	vtkImageDataPtr rawResult = vtkImageDataPtr::New();
-	rawResult->DeepCopy(itkToVtkFilter->GetOutput());
+	//Convert ITK to VTK, sharing the pixel buffer
+	vtkImageDataPtr rawResult = AlgorithmHelper::getVTKFromITK(itkImage);
 
 	mRawResult =  rawResult;
 	return true;
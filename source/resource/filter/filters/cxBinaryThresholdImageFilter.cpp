@@ -29,6 +29,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxViewService.h"
 #include "cxVolumeHelpers.h"
 #include "cxVisServices.h"
+#include "cxAlgorithmProgressObserver.h"
 
 namespace cx
 {
@@ -173,35 +174,43 @@ bool BinaryThresholdImageFilter::execute()
 	typedef itk::BinaryThresholdImageFilter<itkImageType, itkImageType> thresholdFilterType;
 	thresholdFilterType::Pointer thresholdFilter = thresholdFilterType::New();
 	thresholdFilter->SetInput(itkImage);
+	thresholdFilter->InPlaceOff(); // input shares buffer with the input image
 	thresholdFilter->SetOutsideValue(0);
 	thresholdFilter->SetInsideValue(1);
 	thresholdFilter->SetLowerThreshold(thresholds->getValue()[0]);
 	thresholdFilter->SetUpperThreshold(thresholds->getValue()[1]);
-	thresholdFilter->Update();
+	observeProgress(thresholdFilter, this->getExecutingAlgorithm(), 0, 2);
+	try
+	{
+		thresholdFilter->Update();
+	}
+	catch (itk::ProcessAborted&)
+	{
+		return false;
+	}
 	itkImage = thresholdFilter->GetOutput();
 
-	//Convert ITK to VTK
-	itkToVtkFilterType::Pointer itkToVtkFilter = itkToVtkFilterType::New();
-	itkToVtkFilter->SetInput(itkImage);
-	itkToVtkFilter->Update();
-
-	vtkImageDataPtr rawResult = vtkImageDataPtr::New();
-	rawResult->DeepCopy(itkToVtkFilter->GetOutput());
+	//Convert ITK to VTK, sharing the pixel buffer
+	vtkImageDataPtr rawResult = AlgorithmHelper::getVTKFromITK(itkImage);
 
 	vtkImageCastPtr imageCast = vtkImageCastPtr::New();
 	imageCast->SetInputData(rawResult);
 	imageCast->SetOutputScalarTypeToUnsignedChar();
+	observeProgress(imageCast, this->getExecutingAlgorithm(), 1, 2);
 	imageCast->Update();
 	rawResult = imageCast->GetOutput();
+	if (this->isCancelRequested())
+		return false;
 
-	// TODO: possible memory problem here - check debug mem system of itk/vtk
 
 	mRawResult =  rawResult;
 
 	if (generateSurface->getValue())
 	{
 		double threshold = 1;/// because the segmented image is 0..1
-		mRawContour = ContourFilter::execute(mRawResult, threshold);
+		mRawContour = ContourFilter::execute(mRawResult, threshold,
+		                                     false, true, true, 0.2, 15, 0.3, false, 0,
+		                                     this->getExecutingAlgorithm());
 	}
 
 	return true;
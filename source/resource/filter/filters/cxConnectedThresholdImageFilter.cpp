@@ -141,14 +141,8 @@ vtkImageDataPtr ConnectedThresholdImageFilter::calculate()
 
 	itkImage = thresholdFilter->GetOutput();
 
-	//Convert ITK to VTK
-	itkToVtkFilterType::Pointer itkToVtkFilter = itkToVtkFilterType::New();
-	itkToVtkFilter->SetInput(itkImage);
-	itkToVtkFilter->Update();
-
-	vtkImageDataPtr rawResult = vtkImageDataPtr::New();
-	rawResult->DeepCopy(itkToVtkFilter->GetOutput());
-	// TODO: possible memory problem here - check debug mem system of itk/vtk
+	//Convert ITK to VTK, sharing the pixel buffer
+	vtkImageDataPtr rawResult = AlgorithmHelper::getVTKFromITK(itkImage);
 
 	return rawResult;
 }
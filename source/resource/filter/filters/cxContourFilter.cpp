@@ -31,10 +31,27 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxPatientModelService.h"
 #include "cxViewService.h"
 #include "cxVisServices.h"
+#include "cxParallelContour.h"
+#include "cxTimedAlgorithm.h"
+#include "cxAlgorithmProgressObserver.h"
 
 namespace cx
 {
 
+namespace
+{
+bool isCancelled(TimedBaseAlgorithm* algorithm)
+{
+	return algorithm && algorithm->isCancelRequested();
+}
+
+void reportStep(TimedBaseAlgorithm* algorithm, int step, int maxSteps)
+{
+	if (algorithm)
+		algorithm->reportProgress(step*100, maxSteps*100);
+}
+} // namespace
+
 ContourFilter::ContourFilter(VisServicesPtr services) :
 	FilterImpl(services)
 {
@@ -58,7 +75,9 @@ QString ContourFilter::getHelp() const
 	        "<p>- Optional factor 2 reduction</p>"
 	        "<p>- Marching Cubes contouring</p>"
 	        "<p>- Optional Windowed Sinc smoothing</p>"
-	        "<p>- Decimation of triangles</p>"
+	        "<p>- Decimation of triangles, by ratio or to a maximum triangle count</p>"
+	        "<p>Multithreaded surfacing splits the volume into blocks contoured in parallel, "
+	        "and uses parallel Taubin smoothing instead of Windowed Sinc.</p>"
            "</html>";
 }
 
@@ -124,6 +143,21 @@ DoublePropertyPtr ContourFilter::getPassBandOption(QDomElement root)
                                                            0.30, DoubleRange(0.05, 0.95, 0.05), 2, root);
 }
 
+BoolPropertyPtr ContourFilter::getMultithreadedOption(QDomElement root)
+{
+	return BoolProperty::initialize("Multithreaded", "",
+	                                           "Use all cores for surface extraction, smoothing and normals.\n"
+	                                           "Uses Taubin smoothing, thus the surface differs slightly from the serial result.", false, root);
+}
+
+DoublePropertyPtr ContourFilter::getMaxTrianglesOption(QDomElement root)
+{
+	return DoubleProperty::initialize("Max triangles", "",
+	                                  "Decimate to at most this number of triangles. Replaces the decimation ratio.\n"
+	                                  "0 means use the decimation ratio.",
+	                                  0, DoubleRange(0, 10000000, 1000), 0, root);
+}
+
 void ContourFilter::createOptions()
 {
 	mReduceResolutionOption = this->getReduceResolutionOption(mOptions);
@@ -137,7 +171,9 @@ void ContourFilter::createOptions()
     mOptionsAdapters.push_back(this->getNumberOfIterationsOption(mOptions));
     mOptionsAdapters.push_back(this->getPassBandOption(mOptions));
 	mOptionsAdapters.push_back(this->getDecimationOption(mOptions));
+	mOptionsAdapters.push_back(this->getMaxTrianglesOption(mOptions));
 	mOptionsAdapters.push_back(this->getPreserveTopologyOption(mOptions));
+	mOptionsAdapters.push_back(this->getMultithreadedOption(mOptions));
 
 	mOptionsAdapters.push_back(this->getColorOption(mOptions));
 }
@@ -229,6 +265,8 @@ bool ContourFilter::execute()
 	BoolPropertyPtr preserveTopologyOption = this->getPreserveTopologyOption(mCopiedOptions);
 	DoublePropertyPtr surfaceThresholdOption = this->getSurfaceThresholdOption(mCopiedOptions);
 	DoublePropertyPtr decimationOption = this->getDecimationOption(mCopiedOptions);
+	BoolPropertyPtr multithreadedOption = this->getMultithreadedOption(mCopiedOptions);
+	DoublePropertyPtr maxTrianglesOption = this->getMaxTrianglesOption(mCopiedOptions);
 
 	//    report(QString("Creating contour from \"%1\"...").arg(input->getName()));
 
@@ -239,8 +277,11 @@ bool ContourFilter::execute()
 	                           preserveTopologyOption->getValue(),
                                decimationOption->getValue(),
                                numberOfIterationsOption->getValue(),
-                               passBandOption->getValue());
-	return true;
+                               passBandOption->getValue(),
+	                           multithreadedOption->getValue(),
+	                           maxTrianglesOption->getValue(),
+	                           this->getExecutingAlgorithm());
+	return mRawResult ? true : false;
 }
 
 vtkPolyDataPtr ContourFilter::execute(vtkImageDataPtr input,
@@ -250,11 +291,17 @@ vtkPolyDataPtr ContourFilter::execute(vtkImageDataPtr input,
                                       bool preserveTopology,
                                       double decimation,
                                       double numberOfIterations,
-                                      double passBand)
+                                      double passBand,
+                                      bool multithreaded,
+                                      double maxTriangles,
+                                      TimedBaseAlgorithm* algorithm)
 {
 	if (!input)
 		return vtkPolyDataPtr();
 
+	// progress steps: shrink, contour, smooth, decimate, normals
+	const int steps = 5;
+
 	//Shrink input volume
 	vtkImageShrink3DPtr shrinker = vtkImageShrink3DPtr::New();
 	if(reduceResolution)
@@ -262,28 +309,47 @@ vtkPolyDataPtr ContourFilter::execute(vtkImageDataPtr input,
 //		std::cout << "smooth" << std::endl;
 		shrinker->SetInputData(input);
 		shrinker->SetShrinkFactors(2,2,2);
+		observeProgress(shrinker, algorithm, 0, steps);
 		shrinker->Update();
 	}
 
-	// Find countour
-	vtkMarchingCubesPtr convert = vtkMarchingCubesPtr::New();
+	vtkImageDataPtr volume = input;
 	if(reduceResolution)
-		convert->SetInputConnection(shrinker->GetOutputPort());
-	else
-		convert->SetInputData(input);
+		volume = shrinker->GetOutput();
 
-	convert->SetValue(0, threshold);
-	convert->Update();
+	if (isCancelled(algorithm))
+		return vtkPolyDataPtr();
 
-	vtkPolyDataPtr cubesPolyData = convert->GetOutput();
-//	vtkPolyDataPtr cubesPolyData = vtkPolyDataPtr::New();
-//	cubesPolyData = convert->GetOutput();
-//	std::cout << "convert->GetOutput(); " << cubesPolyData.GetPointer() << std::endl;
+	multithreaded = multithreaded && ParallelContour::canExtract(volume);
+
+	// Find countour
+	vtkPolyDataPtr cubesPolyData;
+	if (multithreaded)
+	{
+		cubesPolyData = ParallelContour::extractSurface(volume, threshold);
+	}
+	else
+	{
+		vtkMarchingCubesPtr convert = vtkMarchingCubesPtr::New();
+		convert->SetInputData(volume);
+		convert->SetValue(0, threshold);
+		observeProgress(convert, algorithm, 1, steps);
+		convert->Update();
+		cubesPolyData = convert->GetOutput();
+	}
+
+	if (isCancelled(algorithm))
+		return vtkPolyDataPtr();
+	reportStep(algorithm, 2, steps);
 
 	// Smooth surface model
-	vtkWindowedSincPolyDataFilterPtr smoother = vtkWindowedSincPolyDataFilterPtr::New();
-	if(smoothing)
+	if(smoothing && multithreaded)
 	{
+		ParallelContour::smooth(cubesPolyData, numberOfIterations, passBand);
+	}
+	else if(smoothing)
+	{
+		vtkWindowedSincPolyDataFilterPtr smoother = vtkWindowedSincPolyDataFilterPtr::New();
 		smoother->SetInputData(cubesPolyData);
         smoother->SetNumberOfIterations(numberOfIterations);// Higher number = more smoothing  -  default 15
 		smoother->SetBoundarySmoothing(false);
@@ -291,30 +357,58 @@ vtkPolyDataPtr ContourFilter::execute(vtkImageDataPtr input,
 		smoother->SetNormalizeCoordinates(true);
 		smoother->SetFeatureAngle(120);
         smoother->SetPassBand(passBand);//Lower number = more smoothing  -  default 0.3
+		observeProgress(smoother, algorithm, 2, steps);
 		smoother->Update();
 		cubesPolyData = smoother->GetOutput();
 	}
 
-	//Create a surface of triangles
+	if (isCancelled(algorithm))
+		return vtkPolyDataPtr();
+	reportStep(algorithm, 3, steps);
+
+	if (maxTriangles > 0)
+		decimation = ParallelContour::getDecimationForBudget(cubesPolyData, maxTriangles);
 
 	//Decimate surface model (remove a percentage of the polygons)
-	vtkTriangleFilterPtr trifilt = vtkTriangleFilterPtr::New();
-	vtkDecimateProPtr deci = vtkDecimateProPtr::New();
-	vtkPolyDataNormalsPtr normals = vtkPolyDataNormalsPtr::New();
 	if (decimation > 0.000001)
 	{
-		trifilt->SetInputData(cubesPolyData);
-		trifilt->Update();
-		deci->SetInputConnection(trifilt->GetOutputPort());
+		vtkDecimateProPtr deci = vtkDecimateProPtr::New();
+		if (multithreaded)
+		{
+			// output from ParallelContour is already triangles
+			deci->SetInputData(cubesPolyData);
+		}
+		else
+		{
+			//Create a surface of triangles
+			vtkTriangleFilterPtr trifilt = vtkTriangleFilterPtr::New();
+			trifilt->SetInputData(cubesPolyData);
+			trifilt->Update();
+			deci->SetInputConnection(trifilt->GetOutputPort());
+		}
 		deci->SetTargetReduction(decimation);
 		deci->SetPreserveTopology(preserveTopology);
-		//    deci->PreserveTopologyOn();
+		observeProgress(deci, algorithm, 3, steps);
 		deci->Update();
 		cubesPolyData = deci->GetOutput();
 	}
 
+	if (isCancelled(algorithm))
+		return vtkPolyDataPtr();
+	reportStep(algorithm, 4, steps);
+
+	if (multithreaded)
+	{
+		ParallelContour::generateNormals(cubesPolyData);
+		return cubesPolyData;
+	}
+
+	vtkPolyDataNormalsPtr normals = vtkPolyDataNormalsPtr::New();
 	normals->SetInputData(cubesPolyData);
+	observeProgress(normals, algorithm, 4, steps);
 	normals->Update();
+	if (isCancelled(algorithm))
+		return vtkPolyDataPtr();
 
 	cubesPolyData->DeepCopy(normals->GetOutput());
 
@@ -52,9 +52,20 @@ public:
 	ColorPropertyPtr getColorOption(QDomElement root);
     DoublePropertyPtr getNumberOfIterationsOption(QDomElement root);
     DoublePropertyPtr getPassBandOption(QDomElement root);
+	BoolPropertyPtr getMultithreadedOption(QDomElement root);
+	DoublePropertyPtr getMaxTrianglesOption(QDomElement root);
 
 	/** This is the core algorithm, call this if you dont need all the filter stuff.
 	    Generate a contour from a vtkImageData.
+
+	    If multithreaded, the surface is extracted, smoothed and given normals
+	    in parallel using ParallelContour. This uses Taubin smoothing instead of
+	    vtkWindowedSincPolyDataFilter, thus the output differs from the default
+	    serial path.
+	    If maxTriangles>0, decimation is set to the value giving at most
+	    maxTriangles triangles, otherwise decimation is used.
+	    If algorithm is given, progress is reported to it, and the
+	    method returns NULL when it is cancelled.
 	  */
 	static vtkPolyDataPtr execute(vtkImageDataPtr input,
 			                              double threshold,
@@ -63,7 +74,10 @@ public:
 	                                      bool preserveTopology=true,
                                           double decimation=0.2,
                                           double numberOfIterations = 15,
-                                          double passBand = 0.3);
+                                          double passBand = 0.3,
+	                                      bool multithreaded = false,
+	                                      double maxTriangles = 0,
+	                                      TimedBaseAlgorithm* algorithm = NULL);
 	/** Generate a mesh from the contour using base to generate name.
 	  * Save to dataManager.
 	  */
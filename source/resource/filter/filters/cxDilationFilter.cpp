@@ -149,13 +149,8 @@ bool DilationFilter::execute() {
 	dilationFilter->Update();
 	itkImage = dilationFilter->GetOutput();
 
-	//Convert ITK to VTK
-	itkToVtkFilterType::Pointer itkToVtkFilter = itkToVtkFilterType::New();
-	itkToVtkFilter->SetInput(itkImage);
-	itkToVtkFilter->Update();
-
-	vtkImageDataPtr rawResult = vtkImageDataPtr::New();
-	rawResult->DeepCopy(itkToVtkFilter->GetOutput());
+	//Convert ITK to VTK, sharing the pixel buffer
+	vtkImageDataPtr rawResult = AlgorithmHelper::getVTKFromITK(itkImage);
 
 	vtkImageCastPtr imageCast = vtkImageCastPtr::New();
 	imageCast->SetInputData(rawResult);
@@ -163,7 +158,6 @@ bool DilationFilter::execute() {
 	imageCast->Update();
 	rawResult = imageCast->GetOutput();
 
-	// TODO: possible memory problem here - check debug mem system of itk/vtk
 
 	mRawResult =  rawResult;
 
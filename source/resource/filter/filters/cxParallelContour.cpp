@@ -0,0 +1,411 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxParallelContour.h"
+
+#include <map>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <QThread>
+#include <boost/bind.hpp>
+
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkDataArray.h>
+#include <vtkFloatArray.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <vtkIdList.h>
+#include <vtkPolyData.h>
+#include <vtkMarchingCubes.h>
+
+#include "cxWorkScheduler.h"
+
+namespace cx
+{
+
+namespace
+{
+
+/** Triangles of a mesh, and the triangles incident to each point.
+  */
+struct TriangleIncidence
+{
+	std::vector<vtkIdType> mTriangles; ///< 3 point ids per triangle
+	std::vector<vtkIdType> mOffsets; ///< point i is incident to mIncident[mOffsets[i]..mOffsets[i+1]>
+	std::vector<vtkIdType> mIncident;
+
+	explicit TriangleIncidence(vtkPolyDataPtr mesh)
+	{
+		vtkIdType numberOfPoints = mesh->GetNumberOfPoints();
+		vtkCellArray* polys = mesh->GetPolys();
+		mTriangles.reserve(3*polys->GetNumberOfCells());
+
+		vtkIdListPtr cell = vtkIdListPtr::New();
+		polys->InitTraversal();
+		while (polys->GetNextCell(cell))
+		{
+			// fan triangulation of any polygons, marching cubes gives only triangles.
+			for (vtkIdType i=2; i<cell->GetNumberOfIds(); ++i)
+			{
+				mTriangles.push_back(cell->GetId(0));
+				mTriangles.push_back(cell->GetId(i-1));
+				mTriangles.push_back(cell->GetId(i));
+			}
+		}
+
+		mOffsets.assign(numberOfPoints+1, 0);
+		for (unsigned i=0; i<mTriangles.size(); ++i)
+			++mOffsets[mTriangles[i]+1];
+		for (vtkIdType i=0; i<numberOfPoints; ++i)
+			mOffsets[i+1] += mOffsets[i];
+
+		mIncident.resize(mTriangles.size());
+		std::vector<vtkIdType> cursor(mOffsets.begin(), mOffsets.end()-1);
+		for (unsigned i=0; i<mTriangles.size(); ++i)
+			mIncident[cursor[mTriangles[i]]++] = i/3;
+	}
+
+	vtkIdType getNumberOfTriangles() const { return mTriangles.size()/3; }
+};
+
+/** Marching cubes on the slab [mZMin, mZMax] of a volume.
+  */
+struct ContourBlock
+{
+	vtkImageDataPtr mInput;
+	int mZMin;
+	int mZMax;
+	double mThreshold;
+	vtkPolyDataPtr mOutput;
+};
+
+/** Return a volume covering a z-range of input, sharing the scalar buffer.
+  */
+vtkImageDataPtr createSlab(vtkImageDataPtr input, int zMin, int zMax)
+{
+	int* extent = input->GetExtent();
+	vtkIdType sliceSize = vtkIdType(extent[1]-extent[0]+1)*(extent[3]-extent[2]+1);
+
+	vtkDataArray* scalars = input->GetPointData()->GetScalars();
+	vtkDataArray* slabScalars = scalars->NewInstance();
+	slabScalars->SetNumberOfComponents(1);
+	slabScalars->SetVoidArray(input->GetScalarPointer(extent[0], extent[2], zMin), sliceSize*(zMax-zMin+1), 1);
+
+	vtkImageDataPtr retval = vtkImageDataPtr::New();
+	retval->SetExtent(extent[0], extent[1], extent[2], extent[3], zMin, zMax);
+	retval->SetOrigin(input->GetOrigin());
+	retval->SetSpacing(input->GetSpacing());
+	retval->GetPointData()->SetScalars(slabScalars);
+	slabScalars->Delete();
+	return retval;
+}
+
+void contourBlock(ContourBlock& block)
+{
+	vtkMarchingCubesPtr contour = vtkMarchingCubesPtr::New();
+	contour->SetInputData(createSlab(block.mInput, block.mZMin, block.mZMax));
+	contour->SetValue(0, block.mThreshold);
+	contour->ComputeNormalsOff();
+	contour->ComputeGradientsOff();
+	contour->ComputeScalarsOff();
+	contour->Update();
+	block.mOutput = contour->GetOutput();
+}
+
+void contourBlocks(std::vector<ContourBlock>* blocks, qint64 begin, qint64 end)
+{
+	for (qint64 b=begin; b<end; ++b)
+		contourBlock((*blocks)[b]);
+}
+
+typedef std::pair<qint64, qint64> SeamKey;
+
+SeamKey createSeamKey(double* p, double* quantization)
+{
+	return SeamKey(qint64(std::floor(p[0]/quantization[0]+0.5)),
+				   qint64(std::floor(p[1]/quantization[1]+0.5)));
+}
+
+/** Append all blocks into one mesh. Points on the seam plane between
+  * two neighbouring blocks are generated by both, these are merged.
+  */
+vtkPolyDataPtr weldBlocks(const std::vector<ContourBlock>& blocks, vtkImageDataPtr input)
+{
+	double* origin = input->GetOrigin();
+	double* spacing = input->GetSpacing();
+	double quantization[2] = { 1E-4*spacing[0], 1E-4*spacing[1] };
+	double tolerance = 1E-4*std::fabs(spacing[2]);
+
+	vtkPointsPtr points = vtkPointsPtr::New();
+	vtkCellArrayPtr polys = vtkCellArrayPtr::New();
+	vtkIdListPtr cell = vtkIdListPtr::New();
+
+	std::map<SeamKey, vtkIdType> previousTop; // points on top of previous block -> merged id
+
+	for (unsigned b=0; b<blocks.size(); ++b)
+	{
+		vtkPolyDataPtr block = blocks[b].mOutput;
+		double bottom = origin[2] + spacing[2]*blocks[b].mZMin;
+		double top = origin[2] + spacing[2]*blocks[b].mZMax;
+		bool hasBottomSeam = (b>0);
+		bool hasTopSeam = (b+1<blocks.size());
+
+		std::map<SeamKey, vtkIdType> currentTop;
+		std::vector<vtkIdType> idMap(block->GetNumberOfPoints());
+		for (vtkIdType i=0; i<block->GetNumberOfPoints(); ++i)
+		{
+			double p[3];
+			block->GetPoint(i, p);
+			vtkIdType id = -1;
+			if (hasBottomSeam && std::fabs(p[2]-bottom) < tolerance)
+			{
+				std::map<SeamKey, vtkIdType>::iterator iter = previousTop.find(createSeamKey(p, quantization));
+				if (iter!=previousTop.end())
+					id = iter->second;
+			}
+			if (id<0)
+				id = points->InsertNextPoint(p);
+			if (hasTopSeam && std::fabs(p[2]-top) < tolerance)
+				currentTop[createSeamKey(p, quantization)] = id;
+			idMap[i] = id;
+		}
+
+		vtkCellArray* blockPolys = block->GetPolys();
+		blockPolys->InitTraversal();
+		while (blockPolys->GetNextCell(cell))
+		{
+			polys->InsertNextCell(cell->GetNumberOfIds());
+			for (vtkIdType i=0; i<cell->GetNumberOfIds(); ++i)
+				polys->InsertCellPoint(idMap[cell->GetId(i)]);
+		}
+
+		previousTop.swap(currentTop);
+	}
+
+	vtkPolyDataPtr retval = vtkPolyDataPtr::New();
+	retval->SetPoints(points);
+	retval->SetPolys(polys);
+	return retval;
+}
+
+void findBoundaryPoints(const TriangleIncidence* mesh, std::vector<char>* boundary, vtkIdType begin, vtkIdType end)
+{
+	std::vector<vtkIdType> neighbours;
+	for (vtkIdType p=begin; p<end; ++p)
+	{
+		neighbours.clear();
+		for (vtkIdType j=mesh->mOffsets[p]; j<mesh->mOffsets[p+1]; ++j)
+		{
+			const vtkIdType* tri = &mesh->mTriangles[3*mesh->mIncident[j]];
+			for (int k=0; k<3; ++k)
+				if (tri[k]!=p)
+					neighbours.push_back(tri[k]);
+		}
+		// interior edges are shared by two triangles, boundary edges by one.
+		std::sort(neighbours.begin(), neighbours.end());
+		bool isBoundary = neighbours.empty();
+		for (unsigned i=0; i<neighbours.size(); )
+		{
+			unsigned j = i;
+			while (j<neighbours.size() && neighbours[j]==neighbours[i])
+				++j;
+			if (j-i==1)
+				isBoundary = true;
+			i = j;
+		}
+		(*boundary)[p] = isBoundary;
+	}
+}
+
+/** One umbrella-operator step: output = input + factor*laplacian(input)
+  */
+void laplacianStep(const TriangleIncidence* mesh, const std::vector<char>* boundary, double factor,
+				   const std::vector<double>* input, std::vector<double>* output,
+				   vtkIdType begin, vtkIdType end)
+{
+	for (vtkIdType p=begin; p<end; ++p)
+	{
+		const double* x = &(*input)[3*p];
+		double* y = &(*output)[3*p];
+		if ((*boundary)[p])
+		{
+			y[0] = x[0]; y[1] = x[1]; y[2] = x[2];
+			continue;
+		}
+
+		double sum[3] = {0, 0, 0};
+		int count = 0;
+		for (vtkIdType j=mesh->mOffsets[p]; j<mesh->mOffsets[p+1]; ++j)
+		{
+			const vtkIdType* tri = &mesh->mTriangles[3*mesh->mIncident[j]];
+			for (int k=0; k<3; ++k)
+			{
+				if (tri[k]==p)
+					continue;
+				const double* n = &(*input)[3*tri[k]];
+				sum[0] += n[0]; sum[1] += n[1]; sum[2] += n[2];
+				++count;
+			}
+		}
+
+		for (int i=0; i<3; ++i)
+			y[i] = x[i] + factor*(sum[i]/count - x[i]);
+	}
+}
+
+void computeTriangleNormals(const TriangleIncidence* mesh, const std::vector<double>* x,
+							std::vector<double>* normals, vtkIdType begin, vtkIdType end)
+{
+	for (vtkIdType t=begin; t<end; ++t)
+	{
+		const double* a = &(*x)[3*mesh->mTriangles[3*t+0]];
+		const double* b = &(*x)[3*mesh->mTriangles[3*t+1]];
+		const double* c = &(*x)[3*mesh->mTriangles[3*t+2]];
+		double u[3] = { b[0]-a[0], b[1]-a[1], b[2]-a[2] };
+		double v[3] = { c[0]-a[0], c[1]-a[1], c[2]-a[2] };
+		// unnormalized: area weighting in the point normals
+		double* n = &(*normals)[3*t];
+		n[0] = u[1]*v[2] - u[2]*v[1];
+		n[1] = u[2]*v[0] - u[0]*v[2];
+		n[2] = u[0]*v[1] - u[1]*v[0];
+	}
+}
+
+void computePointNormals(const TriangleIncidence* mesh, const std::vector<double>* triangleNormals,
+						 float* normals, vtkIdType begin, vtkIdType end)
+{
+	for (vtkIdType p=begin; p<end; ++p)
+	{
+		double sum[3] = {0, 0, 0};
+		for (vtkIdType j=mesh->mOffsets[p]; j<mesh->mOffsets[p+1]; ++j)
+		{
+			const double* n = &(*triangleNormals)[3*mesh->mIncident[j]];
+			sum[0] += n[0]; sum[1] += n[1]; sum[2] += n[2];
+		}
+		double length = std::sqrt(sum[0]*sum[0] + sum[1]*sum[1] + sum[2]*sum[2]);
+		if (length < 1E-20)
+			length = 1;
+		for (int i=0; i<3; ++i)
+			normals[3*p+i] = sum[i]/length;
+	}
+}
+
+std::vector<double> getCoordinates(vtkPolyDataPtr mesh)
+{
+	std::vector<double> retval(3*mesh->GetNumberOfPoints());
+	for (vtkIdType i=0; i<mesh->GetNumberOfPoints(); ++i)
+		mesh->GetPoint(i, &retval[3*i]);
+	return retval;
+}
+
+} // namespace
+
+bool ParallelContour::canExtract(vtkImageDataPtr input)
+{
+	return input
+			&& input->GetPointData()->GetScalars()
+			&& (input->GetNumberOfScalarComponents()==1);
+}
+
+vtkPolyDataPtr ParallelContour::extractSurface(vtkImageDataPtr input, double threshold, int numberOfBlocks)
+{
+	if (!canExtract(input))
+		return vtkPolyDataPtr();
+
+	int* extent = input->GetExtent();
+	int layers = extent[5]-extent[4]; // number of cell layers along z
+	if (numberOfBlocks<=0)
+		numberOfBlocks = QThread::idealThreadCount();
+	numberOfBlocks = std::max(1, std::min(numberOfBlocks, layers/4));
+
+	// neighbouring blocks share one slice of voxels, but no cells.
+	std::vector<ContourBlock> blocks(numberOfBlocks);
+	for (int b=0; b<numberOfBlocks; ++b)
+	{
+		blocks[b].mInput = input;
+		blocks[b].mZMin = extent[4] + layers*b/numberOfBlocks;
+		blocks[b].mZMax = extent[4] + layers*(b+1)/numberOfBlocks;
+		blocks[b].mThreshold = threshold;
+	}
+
+	WorkScheduler::getInstance()->parallelFor(numberOfBlocks, 1, boost::bind(&contourBlocks, &blocks, _1, _2));
+
+	if (blocks.size()==1)
+		return blocks[0].mOutput;
+	return weldBlocks(blocks, input);
+}
+
+void ParallelContour::smooth(vtkPolyDataPtr mesh, int numberOfIterations, double passBand)
+{
+	if (!mesh || !mesh->GetNumberOfPoints())
+		return;
+
+	TriangleIncidence incidence(mesh);
+	vtkIdType numberOfPoints = mesh->GetNumberOfPoints();
+
+	std::vector<char> boundary(numberOfPoints, false);
+	WorkScheduler::getInstance()->parallelFor(numberOfPoints, 1, boost::bind(&findBoundaryPoints, &incidence, &boundary, _1, _2));
+
+	// Taubin smoothing: alternating shrinking (lambda) and inflating (mu) steps.
+	// Frequencies below passBand are preserved, as in vtkWindowedSincPolyDataFilter.
+	double lambda = 0.5;
+	double mu = 1.0/(passBand - 1.0/lambda);
+
+	std::vector<double> x = getCoordinates(mesh);
+	std::vector<double> y(x.size());
+	for (int i=0; i<numberOfIterations; ++i)
+	{
+		WorkScheduler::getInstance()->parallelFor(numberOfPoints, 1, boost::bind(&laplacianStep, &incidence, &boundary, lambda, &x, &y, _1, _2));
+		WorkScheduler::getInstance()->parallelFor(numberOfPoints, 1, boost::bind(&laplacianStep, &incidence, &boundary, mu, &y, &x, _1, _2));
+	}
+
+	vtkPointsPtr points = vtkPointsPtr::New();
+	points->SetNumberOfPoints(numberOfPoints);
+	for (vtkIdType i=0; i<numberOfPoints; ++i)
+		points->SetPoint(i, &x[3*i]);
+	mesh->SetPoints(points);
+}
+
+void ParallelContour::generateNormals(vtkPolyDataPtr mesh)
+{
+	if (!mesh)
+		return;
+
+	TriangleIncidence incidence(mesh);
+	vtkIdType numberOfPoints = mesh->GetNumberOfPoints();
+	std::vector<double> x = getCoordinates(mesh);
+
+	std::vector<double> triangleNormals(3*incidence.getNumberOfTriangles());
+	WorkScheduler::getInstance()->parallelFor(incidence.getNumberOfTriangles(), 1, boost::bind(&computeTriangleNormals, &incidence, &x, &triangleNormals, _1, _2));
+
+	vtkFloatArrayPtr normals = vtkFloatArrayPtr::New();
+	normals->SetName("Normals");
+	normals->SetNumberOfComponents(3);
+	normals->SetNumberOfTuples(numberOfPoints);
+	if (numberOfPoints)
+		WorkScheduler::getInstance()->parallelFor(numberOfPoints, 1, boost::bind(&computePointNormals, &incidence, &triangleNormals, normals->GetPointer(0), _1, _2));
+
+	mesh->GetPointData()->SetNormals(normals);
+}
+
+double ParallelContour::getDecimationForBudget(vtkPolyDataPtr mesh, double maxTriangles)
+{
+	if (!mesh || maxTriangles<=0)
+		return 0;
+	double triangles = mesh->GetNumberOfPolys();
+	if (triangles <= maxTriangles)
+		return 0;
+	return 1.0 - maxTriangles/triangles;
+}
+
+} // namespace cx
@@ -0,0 +1,62 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+#ifndef CXPARALLELCONTOUR_H
+#define CXPARALLELCONTOUR_H
+
+#include "cxResourceFilterExport.h"
+#include "vtkForwardDeclarations.h"
+
+namespace cx
+{
+
+/** Multithreaded surface generation from a volume.
+ *
+ * Surface extraction splits the volume into slabs along z. Each slab shares
+ * the scalar buffer of the input and is contoured in a separate thread.
+ * Vertices on the seams between slabs are welded, giving the same closed
+ * surface as contouring the entire volume at once.
+ *
+ * Smoothing (Taubin lambda/mu, parameterized by the same pass band as
+ * vtkWindowedSincPolyDataFilter) and normal generation run in parallel
+ * over the points, and modify the mesh in place.
+ *
+ * Used by ContourFilter.
+ *
+ * \ingroup cx_resource_filter
+ * \date Oct 19, 2026
+ */
+class cxResourceFilter_EXPORT ParallelContour
+{
+public:
+	/** Return true if extractSurface() supports input.
+	  * Only single-component volumes are supported.
+	  */
+	static bool canExtract(vtkImageDataPtr input);
+	/** Marching cubes on blocks of the volume.
+	  * numberOfBlocks<=0 uses one block per core.
+	  */
+	static vtkPolyDataPtr extractSurface(vtkImageDataPtr input, double threshold, int numberOfBlocks=0);
+	/** Smooth the triangle mesh in place. Boundary points are kept fixed.
+	  * Lower passBand = more smoothing.
+	  */
+	static void smooth(vtkPolyDataPtr mesh, int numberOfIterations, double passBand);
+	/** Set point normals on the triangle mesh, following the triangle orientation.
+	  */
+	static void generateNormals(vtkPolyDataPtr mesh);
+	/** Return the decimation ratio required to reduce the mesh to
+	  * at most maxTriangles triangles.
+	  */
+	static double getDecimationForBudget(vtkPolyDataPtr mesh, double maxTriangles);
+};
+
+} // namespace cx
+
+#endif // CXPARALLELCONTOUR_H
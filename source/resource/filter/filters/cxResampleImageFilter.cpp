@@ -104,8 +104,14 @@ bool ResampleImageFilter::execute()
 	DoublePropertyPtr marginOption = this->getMarginOption(mCopiedOptions);
 	double margin = marginOption->getValue();
 
+	// progress steps: orient, crop, resample
+	const int steps = 3;
+
 	Transform3D refMi = reference->get_rMd().inv() * input->get_rMd();
 	ImagePtr oriented = resampleImage(mServices->patient(), input, refMi);//There is an error with the transfer functions in this image
+	if (this->isCancelRequested())
+		return false;
+	this->reportProgress(1, steps);
 
 	Transform3D orient_M_ref = oriented->get_rMd().inv() * reference->get_rMd();
 	DoubleBoundingBox3D bb_crop = transform(orient_M_ref, reference->boundingBox());
@@ -121,11 +127,17 @@ bool ResampleImageFilter::execute()
 	oriented->setCroppingBox(bb_crop);
 
 	ImagePtr cropped = cropImage(mServices->patient(), oriented);
+	if (this->isCancelRequested())
+		return false;
+	this->reportProgress(2, steps);
 
 	QString uid = input->getUid() + "_resample%1";
 	QString name = input->getName() + " resample%1";
 
 	ImagePtr resampled = resampleImage(mServices->patient(), cropped, Vector3D(reference->getBaseVtkImageData()->GetSpacing()), uid, name);
+	if (this->isCancelRequested())
+		return false;
+	this->reportProgress(3, steps);
 
 	// important! move thread affinity to main thread - ensures signals/slots is still called correctly
 	resampled->moveThisAndChildrenToThread(QApplication::instance()->thread());
@@ -102,17 +102,12 @@ bool SmoothingImageFilter::execute()
 	smoothingFilterType::Pointer smoohingFilter = smoothingFilterType::New();
 	smoohingFilter->SetSigma(sigma->getValue());
 	smoohingFilter->SetInput(itkImage);
+	smoohingFilter->InPlaceOff(); // input shares buffer with the input image
 	smoohingFilter->Update();
 	itkImage = smoohingFilter->GetOutput();
 
-	//Convert ITK to VTK
-	itkToVtkFilterType::Pointer itkToVtkFilter = itkToVtkFilterType::New();
-	itkToVtkFilter->SetInput(itkImage);
-	itkToVtkFilter->Update();
-
-	vtkImageDataPtr rawResult = vtkImageDataPtr::New();
-	rawResult->DeepCopy(itkToVtkFilter->GetOutput());
-	// TODO: possible memory problem here - check debug mem system of itk/vtk
+	//Convert ITK to VTK, sharing the pixel buffer
+	vtkImageDataPtr rawResult = AlgorithmHelper::getVTKFromITK(itkImage);
 
 	mRawResult =  rawResult;
 	return true;
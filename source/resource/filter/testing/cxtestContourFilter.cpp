@@ -0,0 +1,93 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+                 
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+                 
+CustusX is released under a BSD 3-Clause license.
+                 
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+#include <vtkImageData.h>
+#include <vtkPolyData.h>
+#include <vtkPointData.h>
+#include <vtkFeatureEdges.h>
+#include "cxContourFilter.h"
+#include "cxParallelContour.h"
+#include "cxCompositeTimedAlgorithm.h"
+
+namespace
+{
+vtkImageDataPtr createBallVolume(int size, double radius)
+{
+	vtkImageDataPtr retval = vtkImageDataPtr::New();
+	retval->SetExtent(0, size-1, 0, size-1, 0, size-1);
+	retval->SetSpacing(0.5, 0.5, 0.8);
+	retval->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+	unsigned char* ptr = static_cast<unsigned char*>(retval->GetScalarPointer());
+	double c = (size-1)/2.0;
+	for (int z=0; z<size; ++z)
+		for (int y=0; y<size; ++y)
+			for (int x=0; x<size; ++x)
+			{
+				double r2 = (x-c)*(x-c) + (y-c)*(y-c) + (z-c)*(z-c);
+				*ptr++ = (r2 < radius*radius) ? 1 : 0;
+			}
+	return retval;
+}
+
+int countBoundaryEdges(vtkPolyDataPtr mesh)
+{
+	vtkSmartPointer<vtkFeatureEdges> edges = vtkSmartPointer<vtkFeatureEdges>::New();
+	edges->SetInputData(mesh);
+	edges->BoundaryEdgesOn();
+	edges->FeatureEdgesOff();
+	edges->NonManifoldEdgesOn();
+	edges->ManifoldEdgesOff();
+	edges->Update();
+	return edges->GetOutput()->GetNumberOfCells();
+}
+}
+
+TEST_CASE("ParallelContour: Block extraction gives the same closed surface as serial marching cubes", "[unit][resource][filter]")
+{
+	vtkImageDataPtr volume = createBallVolume(40, 15);
+
+	vtkPolyDataPtr serial = cx::ContourFilter::execute(volume, 0.5, false, false, true, 0, 15, 0.3, false);
+	vtkPolyDataPtr parallel = cx::ParallelContour::extractSurface(volume, 0.5, 5);
+
+	REQUIRE(serial.GetPointer());
+	REQUIRE(parallel.GetPointer());
+	CHECK(parallel->GetNumberOfPolys() == serial->GetNumberOfPolys());
+	CHECK(countBoundaryEdges(parallel) == 0);
+}
+
+TEST_CASE("ContourFilter: Multithreaded path smooths, decimates to budget and generates normals", "[unit][resource][filter]")
+{
+	vtkImageDataPtr volume = createBallVolume(40, 15);
+
+	double maxTriangles = 500;
+	vtkPolyDataPtr contour = cx::ContourFilter::execute(volume, 0.5, false, true, false, 0.2, 15, 0.3, true, maxTriangles);
+
+	REQUIRE(contour.GetPointer());
+	CHECK(contour->GetNumberOfPolys() > 0);
+	CHECK(contour->GetNumberOfPolys() <= maxTriangles*1.05);
+	REQUIRE(contour->GetPointData()->GetNormals());
+	CHECK(contour->GetPointData()->GetNormals()->GetNumberOfTuples() == contour->GetNumberOfPoints());
+}
+
+TEST_CASE("ContourFilter: Reports progress and stops when the executing algorithm is cancelled", "[unit][resource][filter]")
+{
+	vtkImageDataPtr volume = createBallVolume(40, 15);
+
+	cx::CompositeSerialTimedAlgorithm algorithm;
+	vtkPolyDataPtr contour = cx::ContourFilter::execute(volume, 0.5, false, true, true, 0.2, 15, 0.3, false, 0, &algorithm);
+	REQUIRE(contour.GetPointer());
+	CHECK(contour->GetNumberOfPolys() > 0);
+
+	algorithm.cancel();
+	CHECK_FALSE(cx::ContourFilter::execute(volume, 0.5, false, true, true, 0.2, 15, 0.3, false, 0, &algorithm).GetPointer());
+	CHECK_FALSE(cx::ContourFilter::execute(volume, 0.5, false, true, true, 0.2, 15, 0.3, true, 0, &algorithm).GetPointer());
+}
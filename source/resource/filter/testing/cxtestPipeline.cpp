@@ -0,0 +1,196 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <QAtomicInt>
+#include <QStringList>
+#include "cxPipeline.h"
+#include "cxFilterImpl.h"
+#include "cxFilterGroup.h"
+#include "cxImage.h"
+#include "cxVolumeHelpers.h"
+#include "cxDoubleProperty.h"
+#include "cxSelectDataStringProperty.h"
+#include "cxPatientModelService.h"
+#include "cxCompositeTimedAlgorithm.h"
+#include "cxtestVisServices.h"
+#include "cxtestQueuedSignalListener.h"
+
+namespace
+{
+typedef boost::shared_ptr<class CountingFilter> CountingFilterPtr;
+
+/** Filter that outputs its input under a new uid,
+  * counting executions and logging the order of completion.
+  */
+class CountingFilter : public cx::FilterImpl
+{
+public:
+	CountingFilter(cx::VisServicesPtr services, QString name, QStringList* log) :
+		cx::FilterImpl(services),
+		mName(name),
+		mLog(log),
+		mExecutions(0)
+	{}
+	virtual ~CountingFilter() {}
+
+	virtual QString getType() const { return "CountingFilter"; }
+	virtual QString getName() const { return mName; }
+	virtual QString getHelp() const { return "Test filter"; }
+
+	virtual bool execute()
+	{
+		mExecutions.fetchAndAddOrdered(1);
+		return true;
+	}
+	virtual bool postProcess()
+	{
+		cx::ImagePtr input = this->getCopiedInputImage();
+		if (!input)
+			return false;
+		cx::ImagePtr output(new cx::Image(input->getUid()+"_"+mName, input->getBaseVtkImageData()));
+		mServices->patient()->insertData(output);
+		mOutputTypes.front()->setValue(output->getUid());
+		mLog->push_back(mName);
+		return true;
+	}
+
+	int getExecutions() const { return mExecutions.load(); }
+	cx::DoublePropertyPtr getValueOption()
+	{
+		return boost::dynamic_pointer_cast<cx::DoubleProperty>(this->getOptions().front());
+	}
+
+protected:
+	virtual void createOptions()
+	{
+		mOptionsAdapters.push_back(cx::DoubleProperty::initialize("Value", "", "Test value",
+		                                                          1, cx::DoubleRange(0, 10, 1), 0, mOptions));
+	}
+	virtual void createInputTypes()
+	{
+		mInputTypes.push_back(cx::StringPropertySelectImage::New(mServices->patient()));
+	}
+	virtual void createOutputTypes()
+	{
+		mOutputTypes.push_back(cx::StringPropertySelectImage::New(mServices->patient()));
+	}
+
+private:
+	QString mName;
+	QStringList* mLog;
+	QAtomicInt mExecutions;
+};
+
+/** Pipeline with two branches from A:
+  *
+  *   input - A - B
+  *            \
+  *             C - D
+  */
+struct BranchedPipelineFixture
+{
+	BranchedPipelineFixture()
+	{
+		mServices = cxtest::TestVisServices::create();
+
+		cx::FilterGroupPtr group(new cx::FilterGroup(cx::XmlOptionFile()));
+		A = this->createFilter("A");
+		B = this->createFilter("B");
+		C = this->createFilter("C");
+		D = this->createFilter("D");
+		group->append(A);
+		group->append(B);
+		group->appendBranch(C, A->getUid());
+		group->append(D);
+
+		mPipeline.reset(new cx::Pipeline(mServices->patient()));
+		mPipeline->initialize(group);
+
+		vtkImageDataPtr raw = cx::generateVtkImageData(Eigen::Array3i(4,4,4), cx::Vector3D(1,1,1), 1);
+		cx::ImagePtr input(new cx::Image("input", raw));
+		mServices->patient()->insertData(input);
+		mPipeline->getNodes()[0]->setValue(input->getUid());
+	}
+
+	CountingFilterPtr createFilter(QString name)
+	{
+		return CountingFilterPtr(new CountingFilter(mServices, name, &mLog));
+	}
+
+	void executeAndWait()
+	{
+		mLog.clear();
+		mPipeline->execute();
+		REQUIRE(cxtest::waitForQueuedSignal(mPipeline->getPipelineTimedAlgorithm().get(), SIGNAL(finished()), 5000));
+	}
+
+	cxtest::TestVisServicesPtr mServices;
+	cx::PipelinePtr mPipeline;
+	QStringList mLog;
+	CountingFilterPtr A, B, C, D;
+};
+} // namespace
+
+TEST_CASE("Pipeline: Branched FilterGroup executes filters in dependency order", "[unit][resource][filter]")
+{
+	BranchedPipelineFixture fixture;
+	CHECK(fixture.mPipeline->getFilters()->getSourceUid(fixture.C->getUid()) == fixture.A->getUid());
+	CHECK(fixture.mPipeline->getFilters()->getSourceUid(fixture.D->getUid()) == fixture.C->getUid());
+
+	fixture.executeAndWait();
+
+	REQUIRE(fixture.mLog.size() == 4);
+	CHECK(fixture.mLog.indexOf("A") == 0);
+	CHECK(fixture.mLog.indexOf("C") < fixture.mLog.indexOf("D"));
+	CHECK(fixture.A->getExecutions() == 1);
+	CHECK(fixture.B->getExecutions() == 1);
+	CHECK(fixture.C->getExecutions() == 1);
+	CHECK(fixture.D->getExecutions() == 1);
+	CHECK(fixture.mPipeline->isUpToDate(fixture.B->getUid()));
+	CHECK(fixture.mPipeline->isUpToDate(fixture.D->getUid()));
+}
+
+TEST_CASE("Pipeline: Unchanged outputs in a branched FilterGroup are reused", "[unit][resource][filter]")
+{
+	BranchedPipelineFixture fixture;
+	fixture.executeAndWait();
+
+	fixture.mLog.clear();
+	fixture.mPipeline->execute();
+	fixture.mPipeline->execute(fixture.D->getUid());
+
+	CHECK(fixture.mLog.isEmpty());
+	CHECK(fixture.A->getExecutions() == 1);
+	CHECK(fixture.B->getExecutions() == 1);
+	CHECK(fixture.C->getExecutions() == 1);
+	CHECK(fixture.D->getExecutions() == 1);
+}
+
+TEST_CASE("Pipeline: Option change re-executes only the changed branch", "[unit][resource][filter]")
+{
+	BranchedPipelineFixture fixture;
+	fixture.executeAndWait();
+
+	fixture.C->getValueOption()->setValue(2);
+	CHECK_FALSE(fixture.mPipeline->isUpToDate(fixture.C->getUid()));
+	CHECK(fixture.mPipeline->isUpToDate(fixture.B->getUid()));
+
+	fixture.executeAndWait();
+
+	CHECK(fixture.mLog == QStringList() << "C" << "D");
+	CHECK(fixture.A->getExecutions() == 1);
+	CHECK(fixture.B->getExecutions() == 1);
+	CHECK(fixture.C->getExecutions() == 2);
+	CHECK(fixture.D->getExecutions() == 2);
+	CHECK(fixture.mPipeline->isUpToDate(fixture.D->getUid()));
+}
@@ -15,6 +15,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxImageStreamerOpenCV.h"
 #include "cxMHDImageStreamer.h"
 #include "cxImageStreamerSonix.h"
+#include "cxSyntheticLoadStreamer.h"
 #include "cxConfig.h"
 
 namespace cx
@@ -70,6 +71,7 @@ CommandlineImageStreamerFactory::CommandlineImageStreamerFactory()
 	mCommandLineStreamers.push_back(CommandLineStreamerPtr(new ImageStreamerOpenCV()));
 #endif
 	mCommandLineStreamers.push_back(DummyImageStreamerPtr(new DummyImageStreamer()));
+	mCommandLineStreamers.push_back(SyntheticLoadStreamerPtr(new SyntheticLoadStreamer()));
 }
 
 QString CommandlineImageStreamerFactory::getDefaultSenderType() const
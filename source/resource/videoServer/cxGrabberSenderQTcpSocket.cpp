@@ -52,6 +52,16 @@ void GrabberSenderQTcpSocket::send(IGTLinkUSStatusMessage::Pointer msg)
 	mSocket->write(reinterpret_cast<const char*> (msg->GetPackPointer()), msg->GetPackSize());
 }
 
+void GrabberSenderQTcpSocket::send(igtl::TransformMessage::Pointer msg)
+{
+	if (!msg || !this->isReady())
+		return;
+
+	// Pack (serialize) and send
+	msg->Pack();
+	mSocket->write(reinterpret_cast<const char*> (msg->GetPackPointer()), msg->GetPackSize());
+}
+
 void GrabberSenderQTcpSocket::send(ImagePtr msg)
 {
 	if (!this->isReady())
@@ -71,4 +81,13 @@ void GrabberSenderQTcpSocket::send(ProbeDefinitionPtr msg)
 }
 
 
+void GrabberSenderQTcpSocket::send(const ToolPosition& position)
+{
+	if (!this->isReady())
+		return;
+
+	IGTLinkConversion converter;
+	this->send(converter.encode(position.mUid, position.mTransform, position.mTimestamp));
+}
+
 } /* namespace cx */
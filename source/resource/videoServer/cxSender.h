@@ -14,7 +14,9 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include "cxGrabberExport.h"
 
+#include <vector>
 #include <QObject>
+#include <QDateTime>
 #include <boost/shared_ptr.hpp>
 #include <qtcpsocket.h>
 #include "cxIGTLinkImageMessage.h"
@@ -31,10 +33,20 @@ namespace cx
 * @{
 */
 
+/** Position of one tool, sent as a transform message.
+ */
+struct ToolPosition
+{
+	QString mUid;
+	Transform3D mTransform;
+	QDateTime mTimestamp;
+};
+
 struct Package
 {
 	ImagePtr mImage;
 	ProbeDefinitionPtr mProbe;
+	std::vector<ToolPosition> mToolPositions;
 };
 
 typedef boost::shared_ptr<Package> PackagePtr;
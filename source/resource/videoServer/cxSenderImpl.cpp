@@ -22,6 +22,8 @@ void SenderImpl::send(PackagePtr package)
 
 	if(package->mProbe)
 		this->send(package->mProbe);
+	for (unsigned i=0; i<package->mToolPositions.size(); ++i)
+		this->send(package->mToolPositions[i]);
 }
 
 
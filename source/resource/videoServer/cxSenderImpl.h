@@ -53,6 +53,9 @@ protected:
 	/** Send an US status message
 	 */
 	virtual void send(ProbeDefinitionPtr msg) = 0;
+	/** Send a tool position. Ignored by default.
+	 */
+	virtual void send(const ToolPosition& position) {}
 };
 
 /**
@@ -0,0 +1,311 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxSyntheticLoadStreamer.h"
+
+#include <math.h>
+#include <QTimer>
+#include <QDateTime>
+#include <QtEndian>
+#include <vtkImageData.h>
+#include "cxSender.h"
+#include "cxImage.h"
+#include "cxTime.h"
+#include "cxVector3D.h"
+#include "cxStringHelpers.h"
+#include "cxLogger.h"
+
+namespace cx
+{
+
+namespace
+{
+const quint64 MAX_BURST = 4; ///< max messages sent in one timer event when lagging behind
+const quint64 TOOL_SEQUENCE_MODULO = 1 << 24;
+
+double convertDoubleWithDefault(QString text, double def)
+{
+	bool ok = false;
+	double retval = text.toDouble(&ok);
+	return ok ? retval : def;
+}
+
+int getTimerInterval(double rate)
+{
+	return std::max(1, int(1000.0/rate));
+}
+} // namespace
+
+SyntheticLoadStreamer::SyntheticLoadStreamer() :
+	mImageRate(25),
+	mToolRate(60),
+	mNumberOfTools(0),
+	mUid("SyntheticLoad [R]"),
+	mToolTimer(NULL),
+	mImageSequence(0),
+	mToolSequence(0),
+	mDroppedImages(0),
+	mDroppedTools(0),
+	mLastReport(0)
+{
+	this->setSendInterval(40);
+}
+
+QString SyntheticLoadStreamer::getType()
+{
+	return "SyntheticLoad";
+}
+
+QStringList SyntheticLoadStreamer::getArgumentDescription()
+{
+	QStringList retval;
+	retval << "--width:		image width in pixels (default=640)";
+	retval << "--height:		image height in pixels (default=480)";
+	retval << "--format:		R for 8 bit gray, RGBA for 32 bit color (default=R)";
+	retval << "--fps:		images per second, 0 for no images (default=25)";
+	retval << "--tools:		number of tracked tools (default=0)";
+	retval << "--toolfps:		positions per second for each tool (default=60)";
+	return retval;
+}
+
+void SyntheticLoadStreamer::initialize(StringMap arguments)
+{
+	CommandLineStreamer::initialize(arguments);
+	this->setInitialized(false);
+
+	int width = convertStringWithDefault(arguments["width"], 640);
+	int height = convertStringWithDefault(arguments["height"], 480);
+	QString format = arguments["format"].isEmpty() ? QString("R") : arguments["format"];
+	mImageRate = convertDoubleWithDefault(arguments["fps"], 25);
+	mNumberOfTools = convertStringWithDefault(arguments["tools"], 0);
+	mToolRate = convertDoubleWithDefault(arguments["toolfps"], 60);
+
+	int components = 0;
+	if (format=="R")
+		components = 1;
+	else if (format=="RGBA")
+		components = 4;
+	if (!components)
+	{
+		reportError("SyntheticLoadStreamer: Unknown format " + format);
+		return;
+	}
+	if (width*height*components < 16)
+	{
+		reportError("SyntheticLoadStreamer: Image must be at least 16 bytes to hold the marker");
+		return;
+	}
+
+	mUid = QString("SyntheticLoad [%1]").arg(format);
+	this->createFrames(width, height, components);
+
+	this->createSendTimer();
+	mSendTimer->setTimerType(Qt::PreciseTimer);
+	if (mImageRate > 0)
+		this->setSendInterval(getTimerInterval(mImageRate));
+
+	mToolTimer = new QTimer(this);
+	mToolTimer->setTimerType(Qt::PreciseTimer);
+	connect(mToolTimer, SIGNAL(timeout()), this, SLOT(streamToolsSlot()));
+
+	report(QString("SyntheticLoadStreamer: %1x%2 %3 images at %4 fps, %5 tools at %6 fps")
+		   .arg(width).arg(height).arg(format).arg(mImageRate).arg(mNumberOfTools).arg(mToolRate));
+	this->setInitialized(true);
+}
+
+void SyntheticLoadStreamer::createFrames(int width, int height, int components)
+{
+	// a few frames with a moving pattern, thus the receiver sees changing content
+	mFrames.clear();
+	for (int f=0; f<8; ++f)
+	{
+		vtkImageDataPtr frame = vtkImageDataPtr::New();
+		frame->SetDimensions(width, height, 1);
+		frame->AllocateScalars(VTK_UNSIGNED_CHAR, components);
+		unsigned char* data = static_cast<unsigned char*>(frame->GetScalarPointer());
+		for (int y=0; y<height; ++y)
+		{
+			for (int x=0; x<width; ++x)
+			{
+				unsigned char* pixel = data + (size_t(y)*width + x)*components;
+				unsigned char value = (x + y + 32*f) & 0xff;
+				if (components==1)
+				{
+					pixel[0] = value;
+				}
+				else
+				{
+					pixel[0] = value;
+					pixel[1] = (y + 32*f) & 0xff;
+					pixel[2] = (x - 32*f) & 0xff;
+					pixel[3] = 255;
+				}
+			}
+		}
+		mFrames.push_back(frame);
+	}
+}
+
+void SyntheticLoadStreamer::startStreaming(SenderPtr sender)
+{
+	if (!this->isInitialized())
+	{
+		reportError("SyntheticLoadStreamer: Failed to start streaming: Not initialized.");
+		return;
+	}
+	mSender = sender;
+	mImageSequence = 0;
+	mToolSequence = 0;
+	mDroppedImages = 0;
+	mDroppedTools = 0;
+	mLastReport = 0;
+	mClock.start();
+
+	if (mImageRate > 0)
+		mSendTimer->start(this->getSendInterval());
+	if (mNumberOfTools > 0 && mToolRate > 0)
+		mToolTimer->start(getTimerInterval(mToolRate));
+}
+
+void SyntheticLoadStreamer::stopStreaming()
+{
+	if (mSendTimer)
+		mSendTimer->stop();
+	if (mToolTimer)
+		mToolTimer->stop();
+}
+
+bool SyntheticLoadStreamer::isStreaming()
+{
+	return this->isInitialized();
+}
+
+int SyntheticLoadStreamer::takeDueCount(double rate, quint64* sequence, quint64* dropped)
+{
+	// send according to the elapsed time, thus the average rate is exact
+	// even if the timer interval is rounded or events are late.
+	quint64 expected = quint64(mClock.nsecsElapsed()*1.0E-9*rate) + 1;
+	if (expected <= *sequence)
+		return 0;
+	quint64 due = expected - *sequence;
+	if (due > MAX_BURST)
+	{
+		*dropped += due - MAX_BURST;
+		*sequence += due - MAX_BURST;
+		due = MAX_BURST;
+	}
+	return due;
+}
+
+void SyntheticLoadStreamer::streamSlot()
+{
+	int due = this->takeDueCount(mImageRate, &mImageSequence, &mDroppedImages);
+	for (int i=0; i<due; ++i)
+		this->sendImage();
+	this->reportStatus();
+}
+
+void SyntheticLoadStreamer::streamToolsSlot()
+{
+	int due = this->takeDueCount(mToolRate, &mToolSequence, &mDroppedTools);
+	for (int i=0; i<due; ++i)
+		this->sendTools();
+	this->reportStatus();
+}
+
+void SyntheticLoadStreamer::sendImage()
+{
+	quint64 sequence = mImageSequence++;
+	if (!this->isReadyToSend())
+	{
+		++mDroppedImages;
+		return;
+	}
+
+	vtkImageDataPtr copy = vtkImageDataPtr::New();
+	copy->DeepCopy(mFrames[sequence % mFrames.size()]);
+	double now = getMicroSecondsSinceEpoch();
+	writeMarker(copy, sequence, quint64(now));
+
+	ImagePtr image(new Image(mUid, copy));
+	image->setAcquisitionTime(QDateTime::fromMSecsSinceEpoch(now/1000));
+	PackagePtr package(new Package());
+	package->mImage = image;
+	mSender->send(package);
+}
+
+void SyntheticLoadStreamer::sendTools()
+{
+	quint64 sequence = mToolSequence++;
+	if (!this->isReadyToSend())
+	{
+		++mDroppedTools;
+		return;
+	}
+
+	QDateTime timestamp = QDateTime::fromMSecsSinceEpoch(getMicroSecondsSinceEpoch()/1000);
+	double t = mClock.nsecsElapsed()*1.0E-9;
+
+	PackagePtr package(new Package());
+	for (int i=0; i<mNumberOfTools; ++i)
+	{
+		// tools moving on a circle, spread evenly
+		double angle = 2*M_PI*(0.25*t + double(i)/mNumberOfTools);
+		Vector3D translation(50*cos(angle), 50*sin(angle), sequence % TOOL_SEQUENCE_MODULO);
+
+		ToolPosition position;
+		position.mUid = QString("SyntheticTool%1").arg(i);
+		position.mTransform = createTransformTranslate(translation) * createTransformRotateZ(angle);
+		position.mTimestamp = timestamp;
+		package->mToolPositions.push_back(position);
+	}
+	mSender->send(package);
+}
+
+void SyntheticLoadStreamer::reportStatus()
+{
+	qint64 elapsed = mClock.elapsed();
+	if (elapsed - mLastReport < 10000)
+		return;
+	mLastReport = elapsed;
+	report(QString("SyntheticLoadStreamer: Sent %1 images (%2 dropped), %3 tool positions (%4 dropped) in %5 s")
+		   .arg(mImageSequence - mDroppedImages).arg(mDroppedImages)
+		   .arg(mToolSequence - mDroppedTools).arg(mDroppedTools)
+		   .arg(elapsed/1000));
+}
+
+void SyntheticLoadStreamer::writeMarker(vtkImageDataPtr image, quint64 sequence, quint64 sendTime)
+{
+	unsigned char* data = static_cast<unsigned char*>(image->GetScalarPointer());
+	qToLittleEndian<quint64>(sequence, data);
+	qToLittleEndian<quint64>(sendTime, data+8);
+}
+
+bool SyntheticLoadStreamer::readMarker(vtkImageDataPtr image, quint64* sequence, quint64* sendTime)
+{
+	if (!image || !image->GetScalarPointer())
+		return false;
+	qint64 size = image->GetNumberOfPoints() * image->GetNumberOfScalarComponents() * image->GetScalarSize();
+	if (size < 16)
+		return false;
+
+	const unsigned char* data = static_cast<const unsigned char*>(image->GetScalarPointer());
+	*sequence = qFromLittleEndian<quint64>(data);
+	*sendTime = qFromLittleEndian<quint64>(data+8);
+	return true;
+}
+
+quint64 SyntheticLoadStreamer::readSequence(const Transform3D& toolPosition)
+{
+	return quint64(toolPosition(2,3) + 0.5);
+}
+
+}
@@ -0,0 +1,92 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXSYNTHETICLOADSTREAMER_H_
+#define CXSYNTHETICLOADSTREAMER_H_
+
+#include "cxGrabberExport.h"
+
+#include <vector>
+#include <QElapsedTimer>
+#include "cxStreamer.h"
+#include "cxForwardDeclarations.h"
+#include "vtkForwardDeclarations.h"
+#include "cxTransform3D.h"
+
+namespace cx
+{
+
+/**
+ * Generates images and tool positions at fixed rates, for stress testing
+ * the receive path without hardware.
+ *
+ * Each image carries a marker in its first 16 bytes: The sequence number
+ * and the send time in microseconds since epoch, both as little endian
+ * uint64. Each tool position carries the sequence number in the z
+ * translation, modulo 2^24 to be exact in the float32 transform message.
+ * All tools are sent with the same sequence number and timestamp.
+ *
+ * Sequence numbers are incremented also when the sender is not ready,
+ * thus a receiver sees frames dropped by the server as gaps.
+ *
+ * \ingroup cx_resource_videoserver
+ * \date Oct 19, 2026
+ */
+class cxGrabber_EXPORT SyntheticLoadStreamer: public CommandLineStreamer
+{
+Q_OBJECT
+
+public:
+	SyntheticLoadStreamer();
+	virtual ~SyntheticLoadStreamer(){}
+
+	virtual void initialize(StringMap arguments);
+	virtual void startStreaming(SenderPtr sender);
+	virtual void stopStreaming();
+	virtual bool isStreaming();
+
+	virtual QString getType();
+	virtual QStringList getArgumentDescription();
+
+	static void writeMarker(vtkImageDataPtr image, quint64 sequence, quint64 sendTime);
+	static bool readMarker(vtkImageDataPtr image, quint64* sequence, quint64* sendTime);
+	static quint64 readSequence(const Transform3D& toolPosition); ///< sequence number modulo 2^24
+
+private slots:
+	virtual void streamSlot();
+	void streamToolsSlot();
+
+private:
+	void createFrames(int width, int height, int components);
+	void sendImage();
+	void sendTools();
+	int takeDueCount(double rate, quint64* sequence, quint64* dropped);
+	void reportStatus();
+
+	double mImageRate; ///< images per second, 0 means no images
+	double mToolRate; ///< tool positions per second, for each tool
+	int mNumberOfTools;
+	QString mUid;
+	std::vector<vtkImageDataPtr> mFrames;
+
+	QTimer* mToolTimer;
+	QElapsedTimer mClock;
+	quint64 mImageSequence;
+	quint64 mToolSequence;
+	quint64 mDroppedImages;
+	quint64 mDroppedTools;
+	qint64 mLastReport;
+};
+typedef boost::shared_ptr<class SyntheticLoadStreamer> SyntheticLoadStreamerPtr;
+
+}
+
+#endif /* CXSYNTHETICLOADSTREAMER_H_ */
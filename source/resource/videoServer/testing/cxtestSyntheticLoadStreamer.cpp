@@ -0,0 +1,113 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "catch.hpp"
+
+#include <vtkImageData.h>
+#include "cxSyntheticLoadStreamer.h"
+#include "cxtestSender.h"
+#include "cxtestQueuedSignalListener.h"
+#include "cxImage.h"
+#include "cxTime.h"
+
+namespace cxtest
+{
+
+TEST_CASE("SyntheticLoadStreamer: Marker is read back from image", "[resource][videoserver][unit]")
+{
+	vtkImageDataPtr image = vtkImageDataPtr::New();
+	image->SetDimensions(4, 4, 1);
+	image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+
+	cx::SyntheticLoadStreamer::writeMarker(image, 123456789, 987654321012345ULL);
+	quint64 sequence = 0;
+	quint64 sendTime = 0;
+	REQUIRE(cx::SyntheticLoadStreamer::readMarker(image, &sequence, &sendTime));
+	CHECK(sequence == 123456789);
+	CHECK(sendTime == 987654321012345ULL);
+
+	vtkImageDataPtr tooSmall = vtkImageDataPtr::New();
+	tooSmall->SetDimensions(2, 2, 1);
+	tooSmall->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+	CHECK_FALSE(cx::SyntheticLoadStreamer::readMarker(tooSmall, &sequence, &sendTime));
+}
+
+TEST_CASE("SyntheticLoadStreamer: Rejects unknown format", "[resource][videoserver][unit]")
+{
+	cx::StringMap args;
+	args["format"] = "YUV";
+	cx::SyntheticLoadStreamerPtr streamer(new cx::SyntheticLoadStreamer());
+	streamer->initialize(args);
+	CHECK_FALSE(streamer->isStreaming());
+}
+
+TEST_CASE("SyntheticLoadStreamer: Sends sequenced images and tool positions", "[resource][videoserver][unit]")
+{
+	cx::StringMap args;
+	args["width"] = "32";
+	args["height"] = "16";
+	args["format"] = "RGBA";
+	args["fps"] = "50";
+	args["tools"] = "3";
+	args["toolfps"] = "50";
+
+	cx::SyntheticLoadStreamerPtr streamer(new cx::SyntheticLoadStreamer());
+	streamer->initialize(args);
+	REQUIRE(streamer->isStreaming());
+
+	TestSenderPtr sender(new TestSender());
+	double start = cx::getMicroSecondsSinceEpoch();
+	streamer->startStreaming(sender);
+
+	int images = 0;
+	int tools = 0;
+	quint64 lastImageSequence = 0;
+	for (int i=0; i<40 && (images<3 || tools<3); ++i)
+	{
+		REQUIRE(waitForQueuedSignal(sender.get(), SIGNAL(newPackage()), 500, true));
+		cx::PackagePtr package = sender->getSentPackage();
+		REQUIRE(package);
+
+		if (package->mImage)
+		{
+			vtkImageDataPtr data = package->mImage->getBaseVtkImageData();
+			CHECK(data->GetDimensions()[0] == 32);
+			CHECK(data->GetDimensions()[1] == 16);
+			CHECK(data->GetNumberOfScalarComponents() == 4);
+
+			quint64 sequence = 0;
+			quint64 sendTime = 0;
+			REQUIRE(cx::SyntheticLoadStreamer::readMarker(data, &sequence, &sendTime));
+			if (images)
+				CHECK(sequence > lastImageSequence);
+			CHECK(sendTime >= quint64(start));
+			lastImageSequence = sequence;
+			++images;
+		}
+		else
+		{
+			REQUIRE(package->mToolPositions.size() == 3);
+			quint64 sequence = cx::SyntheticLoadStreamer::readSequence(package->mToolPositions[0].mTransform);
+			for (unsigned k=0; k<3; ++k)
+			{
+				CHECK(package->mToolPositions[k].mUid == QString("SyntheticTool%1").arg(k));
+				CHECK(cx::SyntheticLoadStreamer::readSequence(package->mToolPositions[k].mTransform) == sequence);
+			}
+			++tools;
+		}
+	}
+	streamer->stopStreaming();
+
+	CHECK(images >= 3);
+	CHECK(tools >= 3);
+}
+
+} // namespace cxtest
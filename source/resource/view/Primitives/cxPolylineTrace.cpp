@@ -0,0 +1,265 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#include "cxPolylineTrace.h"
+
+#include <algorithm>
+#include <vtkPolyData.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+
+namespace cx
+{
+
+namespace
+{
+double distanceToSegment(const Vector3D& p, const Vector3D& a, const Vector3D& b)
+{
+	Vector3D ab = b - a;
+	double length2 = dot(ab, ab);
+	if (length2 < 1E-12)
+		return (p - a).length();
+	double t = std::max(0.0, std::min(1.0, dot(p - a, ab)/length2));
+	return (p - (a + t*ab)).length();
+}
+}
+
+PolylineTrace::PolylineTrace() :
+	mChunkSize(64),
+	mDecimationTolerance(0),
+	mMaxRenderedPoints(0),
+	mStride(1),
+	mLastRenderedIndex(-1),
+	mLastRenderedId(-1)
+{
+	mPoints = vtkPointsPtr::New();
+	mLines = vtkCellArrayPtr::New();
+	mPolyData = vtkPolyDataPtr::New();
+	mPolyData->SetPoints(mPoints);
+	mPolyData->SetLines(mLines);
+	mPolyData->SetVerts(mLines);
+
+	mTailPoints = vtkPointsPtr::New();
+	mTailLines = vtkCellArrayPtr::New();
+	mTailPolyData = vtkPolyDataPtr::New();
+	mTailPolyData->SetPoints(mTailPoints);
+	mTailPolyData->SetLines(mTailLines);
+	mTailPolyData->SetVerts(mTailLines);
+}
+
+void PolylineTrace::setChunkSize(int size)
+{
+	mChunkSize = std::max(2, size);
+}
+
+void PolylineTrace::setDecimationTolerance(double tolerance)
+{
+	mDecimationTolerance = tolerance;
+}
+
+void PolylineTrace::setMaxRenderedPoints(int count)
+{
+	mMaxRenderedPoints = count;
+	if ((mMaxRenderedPoints > 0) && (mPoints->GetNumberOfPoints() > mMaxRenderedPoints))
+		this->rebuildRenderedPoints();
+}
+
+vtkPolyDataPtr PolylineTrace::getPolyData()
+{
+	return mPolyData;
+}
+
+vtkPolyDataPtr PolylineTrace::getTailPolyData()
+{
+	return mTailPolyData;
+}
+
+int PolylineTrace::getNumberOfPoints() const
+{
+	return mStored.size() + mPending.size();
+}
+
+Vector3D PolylineTrace::getPoint(int index) const
+{
+	if (index < int(mStored.size()))
+		return mStored[index];
+	return mPending[index - mStored.size()];
+}
+
+void PolylineTrace::clear()
+{
+	mStored.clear();
+	mPending.clear();
+	mStride = 1;
+	mLastRenderedIndex = -1;
+	mLastRenderedId = -1;
+	mPoints->Reset();
+	mLines->Reset();
+	mPoints->Modified();
+	mLines->Modified();
+	mPolyData->Modified();
+	this->updateTail();
+}
+
+void PolylineTrace::addPoint(const Vector3D& p)
+{
+	mPending.push_back(p);
+	if (int(mPending.size()) >= mChunkSize)
+		this->storePending();
+	this->updateTail();
+}
+
+void PolylineTrace::flush()
+{
+	this->storePending();
+	this->updateTail();
+}
+
+void PolylineTrace::storePending()
+{
+	if (mPending.empty())
+		return;
+
+	if (mDecimationTolerance > 0)
+	{
+		// anchor the window in the last stored point, it must be kept.
+		std::vector<Vector3D> window;
+		window.reserve(mPending.size()+1);
+		if (!mStored.empty())
+			window.push_back(mStored.back());
+		window.insert(window.end(), mPending.begin(), mPending.end());
+
+		std::vector<Vector3D> kept = decimate(window, mDecimationTolerance);
+		mStored.insert(mStored.end(), kept.begin() + (mStored.empty() ? 0 : 1), kept.end());
+	}
+	else
+	{
+		mStored.insert(mStored.end(), mPending.begin(), mPending.end());
+	}
+	mPending.clear();
+
+	this->appendRenderedPoints();
+}
+
+/** Append all stored points after the last rendered one, using the current
+  * stride, as one polyline cell continuing from the last rendered point.
+  */
+void PolylineTrace::appendRenderedPoints()
+{
+	std::vector<vtkIdType> ids;
+	if (mLastRenderedId >= 0)
+		ids.push_back(mLastRenderedId);
+
+	int first = (mLastRenderedIndex < 0) ? 0 : mLastRenderedIndex + mStride;
+	for (int i=first; i<int(mStored.size()); i+=mStride)
+	{
+		mLastRenderedId = mPoints->InsertNextPoint(mStored[i].begin());
+		mLastRenderedIndex = i;
+		ids.push_back(mLastRenderedId);
+	}
+
+	if (ids.size() < 2 && !(ids.size()==1 && mLines->GetNumberOfCells()==0))
+		return;
+
+	mLines->InsertNextCell(ids.size(), &ids[0]);
+	mPoints->Modified();
+	mLines->Modified();
+	mPolyData->Modified();
+
+	if ((mMaxRenderedPoints > 0) && (mPoints->GetNumberOfPoints() > mMaxRenderedPoints))
+		this->rebuildRenderedPoints();
+}
+
+void PolylineTrace::rebuildRenderedPoints()
+{
+	while (int(mStored.size()) > mStride*mMaxRenderedPoints)
+		mStride *= 2;
+
+	mPoints->Reset();
+	mLines->Reset();
+	mLastRenderedIndex = -1;
+	mLastRenderedId = -1;
+	this->appendRenderedPoints();
+	this->updateTail();
+}
+
+/** The tail continues the rendered polyline from the last rendered point,
+  * through the stored points not rendered because of the stride, to the pending points.
+  */
+void PolylineTrace::updateTail()
+{
+	mTailPoints->Reset();
+	mTailLines->Reset();
+
+	int first = std::max(mLastRenderedIndex, 0);
+	for (int i=first; i<int(mStored.size()); ++i)
+		mTailPoints->InsertNextPoint(mStored[i].begin());
+	for (unsigned i=0; i<mPending.size(); ++i)
+		mTailPoints->InsertNextPoint(mPending[i].begin());
+
+	vtkIdType count = mTailPoints->GetNumberOfPoints();
+	if (count > 1)
+	{
+		mTailLines->InsertNextCell(count);
+		for (vtkIdType i=0; i<count; ++i)
+			mTailLines->InsertCellPoint(i);
+	}
+
+	mTailPoints->Modified();
+	mTailLines->Modified();
+	mTailPolyData->Modified();
+}
+
+std::vector<Vector3D> PolylineTrace::decimate(const std::vector<Vector3D>& points, double tolerance)
+{
+	if (points.size() < 3)
+		return points;
+
+	std::vector<bool> keep(points.size(), false);
+	keep.front() = true;
+	keep.back() = true;
+
+	std::vector<std::pair<int,int> > stack;
+	stack.push_back(std::make_pair(0, int(points.size())-1));
+	while (!stack.empty())
+	{
+		int first = stack.back().first;
+		int last = stack.back().second;
+		stack.pop_back();
+
+		double maxDistance = -1;
+		int index = -1;
+		for (int i=first+1; i<last; ++i)
+		{
+			double distance = distanceToSegment(points[i], points[first], points[last]);
+			if (distance > maxDistance)
+			{
+				maxDistance = distance;
+				index = i;
+			}
+		}
+
+		if (index >= 0 && maxDistance > tolerance)
+		{
+			keep[index] = true;
+			stack.push_back(std::make_pair(first, index));
+			stack.push_back(std::make_pair(index, last));
+		}
+	}
+
+	std::vector<Vector3D> retval;
+	for (unsigned i=0; i<points.size(); ++i)
+		if (keep[i])
+			retval.push_back(points[i]);
+	return retval;
+}
+
+} // namespace cx
@@ -0,0 +1,95 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+
+CustusX is released under a BSD 3-Clause license.
+
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+
+#ifndef CXPOLYLINETRACE_H_
+#define CXPOLYLINETRACE_H_
+
+#include "cxResourceVisualizationExport.h"
+
+#include <deque>
+#include <vector>
+#include "cxVector3D.h"
+#include "vtkForwardDeclarations.h"
+
+namespace cx
+{
+
+/** \brief Incrementally growing polyline, for tracing paths of any length.
+ *
+ * Points are added one at a time at constant cost:
+ *
+ *  - New points are collected in a pending chunk of at most chunkSize points.
+ *    The pending points are shown by getTailPolyData(), which is rebuilt
+ *    on each added point, but is bounded in size.
+ *  - When the chunk is full, it is optionally decimated (Douglas-Peucker
+ *    on the chunk, anchored in the last stored point), moved to the point
+ *    storage and appended as a new polyline cell to getPolyData().
+ *  - If the number of points in getPolyData() exceeds maxRenderedPoints,
+ *    only every second stored point is rendered from then on (level of detail).
+ *    The rebuild doubles the stride, thus the amortized cost stays constant.
+ *
+ * Stored points are kept in full resolution in a chunked buffer.
+ *
+ * \ingroup cx_resource_view
+ * \date Oct 19, 2026
+ */
+class cxResourceVisualization_EXPORT PolylineTrace
+{
+public:
+	PolylineTrace();
+
+	void addPoint(const Vector3D& p);
+	void flush(); ///< store and render all pending points
+	void clear();
+
+	void setChunkSize(int size); ///< number of points collected before decimation and storage. Default 64.
+	void setDecimationTolerance(double tolerance); ///< max deviation (mm) of removed points from the polyline. <=0 means no decimation (default).
+	void setMaxRenderedPoints(int count); ///< level of detail limit for getPolyData(). <=0 means render all points (default).
+
+	vtkPolyDataPtr getPolyData(); ///< stored points, as polyline cells and vertices
+	vtkPolyDataPtr getTailPolyData(); ///< points not yet in getPolyData(), continuing its polyline
+
+	int getNumberOfPoints() const; ///< stored and pending points
+	Vector3D getPoint(int index) const; ///< point index among the stored and pending points
+	int getRenderStride() const { return mStride; }
+
+	/** Douglas-Peucker polyline simplification. The end points are always kept.
+	  */
+	static std::vector<Vector3D> decimate(const std::vector<Vector3D>& points, double tolerance);
+
+private:
+	void storePending();
+	void appendRenderedPoints();
+	void rebuildRenderedPoints();
+	void updateTail();
+
+	int mChunkSize;
+	double mDecimationTolerance;
+	int mMaxRenderedPoints;
+	int mStride;
+
+	std::deque<Vector3D> mStored;
+	std::vector<Vector3D> mPending;
+	int mLastRenderedIndex; ///< index in mStored of the last point in mPoints, -1 if none
+	vtkIdType mLastRenderedId; ///< id in mPoints of the same point
+
+	vtkPolyDataPtr mPolyData;
+	vtkPointsPtr mPoints;
+	vtkCellArrayPtr mLines;
+
+	vtkPolyDataPtr mTailPolyData;
+	vtkPointsPtr mTailPoints;
+	vtkCellArrayPtr mTailLines;
+};
+
+} // namespace cx
+
+#endif /*CXPOLYLINETRACE_H_*/
@@ -44,25 +44,23 @@ ToolTracer::ToolTracer(SpaceProviderPtr spaceProvider)
 {
 	mSpaceProvider = spaceProvider;
 	mRunning = false;
-	mPolyData = vtkPolyDataPtr::New();
 	mActor = vtkActorPtr::New();
 	mPolyDataMapper = vtkPolyDataMapperPtr::New();
-
-	mPolyDataMapper->SetInputData(mPolyData);
+	mPolyDataMapper->SetInputData(mTrace.getPolyData());
 	mActor->SetMapper(mPolyDataMapper);
 
+	mTailActor = vtkActorPtr::New();
+	mTailPolyDataMapper = vtkPolyDataMapperPtr::New();
+	mTailPolyDataMapper->SetInputData(mTrace.getTailPolyData());
+	mTailActor->SetMapper(mTailPolyDataMapper);
+
 	mProperty = vtkPropertyPtr::New();
 	mActor->SetProperty( mProperty );
+	mTailActor->SetProperty( mProperty );
 	mProperty->SetPointSize(4);
 
 	this->setColor(QColor("red"));
 
-	mPoints = vtkPointsPtr::New();
-	mLines = vtkCellArrayPtr::New();
-
-	mPolyData->SetPoints(mPoints);
-	mPolyData->SetLines(mLines);
-	mPolyData->SetVerts(mLines);
 	mFirstPoint = false;
 	mMinDistance = -1.0;
 	mSkippedPoints = 0;
@@ -89,13 +87,12 @@ void ToolTracer::stop()
 		return;
 	this->disconnectTool();
 	mRunning = false;
+	mTrace.flush();
 }
 
 void ToolTracer::clear()
 {
-	mPoints->Reset();
-	mLines->Reset();
-	mPolyData->Modified();
+	mTrace.clear();
 }
 
 void ToolTracer::connectTool()
@@ -130,7 +127,7 @@ void ToolTracer::setTool(ToolPtr tool)
 
 vtkPolyDataPtr ToolTracer::getPolyData()
 {
-	return mPolyData;
+	return mTrace.getPolyData();
 }
 
 vtkActorPtr ToolTracer::getActor()
@@ -138,11 +135,17 @@ vtkActorPtr ToolTracer::getActor()
 	return mActor;
 }
 
+vtkActorPtr ToolTracer::getTailActor()
+{
+	return mTailActor;
+}
+
 void ToolTracer::onSpaceChanged()
 {
 	Transform3D rMpr = mSpaceProvider->get_rMpr();
 //	std::cout << "rMpr ToolTracer: \n" << rMpr << std::endl;
 	mActor->SetUserMatrix(rMpr.getVtkMatrix());
+	mTailActor->SetUserMatrix(rMpr.getVtkMatrix());
 }
 
 bool ToolTracer::isRunning() const
@@ -164,21 +167,7 @@ void ToolTracer::receiveTransforms(Transform3D prMt, double timestamp)
 	}
 	mFirstPoint = false;
 	mPreviousPoint = p;
-	mPoints->InsertNextPoint(p.begin());
-
-	if (mPoints->GetNumberOfPoints() > 1)
-	{
-		// fill cell points for the entire polydata.
-		// This is very ineffective, but I have no idea how to update mLines incrementally.
-		mLines->Initialize();
-		std::vector<vtkIdType> ids(mPoints->GetNumberOfPoints());
-		for (unsigned i=0; i<ids.size(); ++i)
-			ids[i] = i;
-		mLines->InsertNextCell(ids.size(), &(*ids.begin()));
-		mLines->Modified();
-		
-		mPolyData->Modified();
-	}
+	mTrace.addPoint(p);
 }
 
 void ToolTracer::addManyPositions(TimedTransformMap trackerRecordedData_prMt)
@@ -189,6 +178,7 @@ void ToolTracer::addManyPositions(TimedTransformMap trackerRecordedData_prMt)
             Transform3D prMt = iter->second;
             this->receiveTransforms(prMt, timestamp);
         }
+    mTrace.flush();
 }
 
 
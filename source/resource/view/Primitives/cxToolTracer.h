@@ -26,6 +26,7 @@ typedef vtkSmartPointer<class vtkPolyData> vtkPolyDataPtr;
 #include "vtkForwardDeclarations.h"
 #include "cxForwardDeclarations.h"
 #include "cxTool.h"
+#include "cxPolylineTrace.h"
 
 class QColor;
 
@@ -40,6 +41,10 @@ typedef boost::shared_ptr<class SpaceListener> SpaceListenerPtr;
  *
  * ToolTracer is used internally by ToolRep3D as an option.
  *
+ * The trace is stored in a PolylineTrace, adding points at constant cost.
+ * Recent points are rendered by the tail actor until they are moved
+ * into the main polydata. Both actors must be added to the renderer.
+ *
  * Used by CustusX.
  *
  * \ingroup cx_resource_view
@@ -52,6 +57,7 @@ public:
 	void setTool(ToolPtr tool);
 	vtkPolyDataPtr getPolyData();
 	vtkActorPtr getActor();
+	vtkActorPtr getTailActor(); ///< actor for the most recent points
 
 	void setColor(QColor color);
 
@@ -61,6 +67,9 @@ public:
 	bool isRunning() const; // true if started and not stopped.
 	void setMinDistance(double distance) { mMinDistance = distance; }
 	int getSkippedPoints() { return mSkippedPoints; }
+	void setDecimationTolerance(double tolerance) { mTrace.setDecimationTolerance(tolerance); } ///< see PolylineTrace
+	void setMaxRenderedPoints(int count) { mTrace.setMaxRenderedPoints(count); } ///< see PolylineTrace
+	int getNumberOfPoints() const { return mTrace.getNumberOfPoints(); }
 	void addManyPositions(TimedTransformMap trackerRecordedData_prMt);
 
 private slots:
@@ -72,15 +81,14 @@ private:
 	void onSpaceChanged();
 
 	bool mRunning;
-	vtkPolyDataPtr mPolyData; ///< polydata representation of the probe, in space u
+	PolylineTrace mTrace; ///< the traced path, in space pr
 	vtkActorPtr mActor;
+	vtkActorPtr mTailActor;
 	ToolPtr mTool;
 	vtkPolyDataMapperPtr mPolyDataMapper;
+	vtkPolyDataMapperPtr mTailPolyDataMapper;
 	vtkPropertyPtr mProperty;
 
-	vtkPointsPtr mPoints;
-	vtkCellArrayPtr mLines;
-
 	bool mFirstPoint;
 	int mSkippedPoints;
 	Vector3D mPreviousPoint;
@@ -11,6 +11,8 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 
 #include "cxRepImpl.h"
+
+#include <QElapsedTimer>
 #include "cxTypeConversions.h"
 #include "cxView.h"
 #include "vtkCallbackCommand.h"
@@ -23,6 +25,7 @@ RepImpl::RepImpl(const QString& uid, const QString& name) :
 	mName(name), mUid(uid)
 {
 	mModified = true;
+	mUpdateTime = 0;
 	this->mCallbackCommand = vtkCallbackCommandPtr::New();
 	this->mCallbackCommand->SetClientData(this);
 	this->mCallbackCommand->SetCallback(RepImpl::ProcessEvents);
@@ -97,8 +100,11 @@ void RepImpl::ProcessEvents(vtkObject* vtkNotUsed(object), unsigned long event,
 		void* vtkNotUsed(calldata))
 {
 	RepImpl* self = reinterpret_cast<RepImpl*>(clientdata);
+	QElapsedTimer timer;
+	timer.start();
 	self->onStartRenderPrivate();
 	self->onEveryRender();
+	self->mUpdateTime += timer.nsecsElapsed()/1.0E6;
 }
 
 void RepImpl::onStartRenderPrivate()
@@ -53,6 +53,8 @@ public:
 	QString getName() const; ///< \return a reps name
 	QString getUid() const; ///< \return a reps unique id
 	virtual void printSelf(std::ostream & os, Indent indent);
+	double getUpdateTime() const { return mUpdateTime; } ///< total time (ms) spent in onModifiedStartRender() and onEveryRender(), for benchmarking
+	void resetUpdateTime() { mUpdateTime = 0; }
 
 	/** Usage:
 	  * Define functions in each subclass with the signature:
@@ -91,6 +93,7 @@ private:
 										void* clientdata,
 										void* calldata);
 	bool mModified;
+	double mUpdateTime;
 	vtkCallbackCommandPtr mCallbackCommand;
 	void onStartRenderPrivate();
 	ViewWeakPtr mView;
@@ -208,6 +208,7 @@ void ToolRep3D::setToolOffsetLineColor(const QColor& color)
 void ToolRep3D::addRepActorsToViewRenderer(ViewPtr view)
 {
 	view->getRenderer()->AddActor(mTracer->getActor());
+	view->getRenderer()->AddActor(mTracer->getTailActor());
 
 	view->getRenderer()->AddActor(mToolActor);
 	view->getRenderer()->AddActor(mProbeSectorActor);
@@ -235,6 +236,7 @@ void ToolRep3D::addRepActorsToViewRenderer(ViewPtr view)
 void ToolRep3D::removeRepActorsFromViewRenderer(ViewPtr view)
 {
 	view->getRenderer()->RemoveActor(mTracer->getActor());
+	view->getRenderer()->RemoveActor(mTracer->getTailActor());
 	view->getRenderer()->RemoveActor(mToolActor);
 	view->getRenderer()->RemoveActor(mProbeSectorActor);
 
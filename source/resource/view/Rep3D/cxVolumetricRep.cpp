@@ -26,9 +26,12 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <vtkVolume.h>
 #include <vtkRenderer.h>
 #include <vtkMatrix4x4.h>
+#include <vtkCamera.h>
+#include <QTimer>
 
 #include "cxView.h"
 #include "cxImage.h"
+#include "cxImagePyramid.h"
 #include "cxImageTF3D.h"
 #include "cxSlicePlaneClipper.h"
 #include "cxTypeConversions.h"
@@ -46,10 +49,21 @@ VolumetricRep::VolumetricRep() :
 	VolumetricBaseRep(),
 	mVolume(vtkVolumePtr::New()),
 	mVolumeProperty(cx::VolumeProperty::create()),
-	mMaxVoxels(0)
+	mMaxVoxels(0),
+	mInteractiveMaxVoxels(0),
+	mInteracting(false),
+	mCameraPosition(Vector3D::Zero()),
+	mCameraFocalPoint(Vector3D::Zero()),
+	mCameraViewUp(Vector3D::Zero()),
+	mCameraScale(0)
 {
 	this->setUseVolumeTextureMapper();
 	mVolume->SetProperty(mVolumeProperty->getVolumeProperty());
+
+	mRefineTimer = new QTimer(this);
+	mRefineTimer->setSingleShot(true);
+	mRefineTimer->setInterval(300);
+	connect(mRefineTimer, &QTimer::timeout, this, &VolumetricRep::refineSlot);
 }
 
 VolumetricRep::~VolumetricRep()
@@ -109,6 +123,10 @@ void VolumetricRep::setImage(ImagePtr image)
 		disconnect(mImage.get(), &Image::transformChanged, this, &VolumetricRep::transformChangedSlot);
 		mMonitor.reset();
 		mMapper->SetInputData( (vtkImageData*)NULL );
+		mInput = vtkImageDataPtr();
+		if (mPyramid)
+			disconnect(mPyramid.get(), &ImagePyramid::levelAdded, this, &VolumetricRep::pyramidLevelAddedSlot);
+		mPyramid.reset();
 	}
 
 	mImage = image;
@@ -153,8 +171,121 @@ void VolumetricRep::updateVtkImageDataSlot()
 	if (!mImage)
 		return;
 
-	vtkImageDataPtr volume = mImage->resample(this->mMaxVoxels);
-	mMapper->SetInputData(volume);
+	ImagePyramidPtr pyramid;
+	if (this->needsPyramid())
+		pyramid = mImage->getPyramid();
+
+	if (pyramid != mPyramid)
+	{
+		if (mPyramid)
+			disconnect(mPyramid.get(), &ImagePyramid::levelAdded, this, &VolumetricRep::pyramidLevelAddedSlot);
+		mPyramid = pyramid;
+		if (mPyramid)
+			connect(mPyramid.get(), &ImagePyramid::levelAdded, this, &VolumetricRep::pyramidLevelAddedSlot);
+	}
+
+	mInput = vtkImageDataPtr();
+	if (mPyramid)
+	{
+		this->updateInput();
+	}
+	else
+	{
+		mInput = mImage->resample(mMaxVoxels);
+		mMapper->SetInputData(mInput);
+	}
+}
+
+/**Return true if the image is larger than the max or interactive volume size,
+ * thus must be rendered from a coarser pyramid level. Smaller images are
+ * rendered as is and get no pyramid.
+ */
+bool VolumetricRep::needsPyramid() const
+{
+	long voxels = mImage->getBaseVtkImageData()->GetNumberOfPoints();
+	if (mMaxVoxels>0 && voxels>mMaxVoxels)
+		return true;
+	if (mInteractiveMaxVoxels>0 && voxels>mInteractiveMaxVoxels)
+		return true;
+	return false;
+}
+
+/**Set the mapper input to the finest pyramid level within the current budget.
+ * If no such level is built yet, keep the current input, or resample the image
+ * if there is none.
+ */
+void VolumetricRep::updateInput()
+{
+	long maxVoxels = mMaxVoxels;
+	if (mInteracting && mInteractiveMaxVoxels>0)
+		maxVoxels = mMaxVoxels ? std::min(mMaxVoxels, mInteractiveMaxVoxels) : mInteractiveMaxVoxels;
+
+	vtkImageDataPtr volume = mPyramid->getLevelForMaxVoxels(maxVoxels);
+	if (!volume && !mInput)
+		volume = mImage->resample(mMaxVoxels);
+	if (!volume || volume==mInput)
+		return;
+
+	mInput = volume;
+	mMapper->SetInputData(mInput);
+}
+
+void VolumetricRep::pyramidLevelAddedSlot()
+{
+	if (!mImage)
+		return;
+	this->updateInput();
+	this->setModified();
+}
+
+/**Show a coarse level while the camera moves.
+ */
+void VolumetricRep::onEveryRender()
+{
+	if (!mPyramid || !mInteractiveMaxVoxels)
+		return;
+	if (!this->cameraHasMoved())
+		return;
+
+	if (!mInteracting)
+	{
+		mInteracting = true;
+		this->updateInput();
+	}
+	mRefineTimer->start();
+}
+
+void VolumetricRep::refineSlot()
+{
+	mInteracting = false;
+	if (!mPyramid)
+		return;
+	this->updateInput();
+	this->setModified();
+}
+
+/**Compare the camera pose against the last call. Clipping range changes are ignored,
+ * as they happen on every render.
+ */
+bool VolumetricRep::cameraHasMoved()
+{
+	vtkCamera* camera = this->getRenderer()->GetActiveCamera();
+	Vector3D position(camera->GetPosition());
+	Vector3D focalPoint(camera->GetFocalPoint());
+	Vector3D viewUp(camera->GetViewUp());
+	double scale = camera->GetParallelProjection() ? camera->GetParallelScale() : camera->GetViewAngle();
+
+	bool initialized = !similar(mCameraViewUp, Vector3D::Zero());
+	bool moved = !similar(position, mCameraPosition)
+			|| !similar(focalPoint, mCameraFocalPoint)
+			|| !similar(viewUp, mCameraViewUp)
+			|| !similar(scale, mCameraScale);
+
+	mCameraPosition = position;
+	mCameraFocalPoint = focalPoint;
+	mCameraViewUp = viewUp;
+	mCameraScale = scale;
+	return initialized && moved;
 }
 
 void VolumetricRep::setMaxVolumeSize(long maxVoxels)
@@ -162,6 +293,11 @@ void VolumetricRep::setMaxVolumeSize(long maxVoxels)
 	mMaxVoxels = maxVoxels;
 }
 
+void VolumetricRep::setInteractiveVolumeSize(long maxVoxels)
+{
+	mInteractiveMaxVoxels = maxVoxels;
+}
+
 
 //---------------------------------------------------------
 } // namespace cx
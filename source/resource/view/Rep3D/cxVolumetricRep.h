@@ -16,6 +16,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxResourceVisualizationExport.h"
 
 #include "cxRepImpl.h"
+#include "cxVector3D.h"
 
 #include "vtkForwardDeclarations.h"
 #include "cxForwardDeclarations.h"
@@ -25,8 +26,11 @@ namespace cx
 {
 	typedef boost::shared_ptr<class VolumeProperty> VolumePropertyPtr;
 	typedef boost::shared_ptr<class ImageMapperMonitor> ImageMapperMonitorPtr;
+	typedef boost::shared_ptr<class ImagePyramid> ImagePyramidPtr;
 }
 
+class QTimer;
+
 namespace cx
 {
 
@@ -59,6 +63,11 @@ protected:
  *
  * Use this to render volumetric image data in a 3D scene. Both
  * texture rendering and GPU raycasting are available.
+ *
+ * Volumes larger than the max volume size are taken from the image pyramid:
+ * the finest level below the max volume size. If an interactive volume size
+ * is set, a coarser level below it is shown while the camera moves, refined
+ * when the camera has been still for a short while.
  * 
  * Used by Sonowand.
  * Used by CustusX.
@@ -79,6 +88,7 @@ public:
 	virtual bool hasImage(ImagePtr image) const; ///< check if the reps has the image
 	virtual vtkVolumePtr getVtkVolume() { return mVolume; } ///< get the images vtkVolume
 	void setMaxVolumeSize(long maxVoxels); ///< set max volume size for rendering. Must be set before setImage()
+	void setInteractiveVolumeSize(long maxVoxels); ///< max volume size while the camera moves, 0 disables. Must be set before setImage()
 	void setUseGPUVolumeRayCastMapper();
 	void setUseVolumeTextureMapper();
 
@@ -86,11 +96,13 @@ protected:
 	VolumetricRep();
 	virtual void addRepActorsToViewRenderer(ViewPtr view);
 	virtual void removeRepActorsFromViewRenderer(ViewPtr view);
+	virtual void onEveryRender();
 
 	cx::VolumePropertyPtr mVolumeProperty;
 	vtkVolumeMapperPtr mMapper;
 	vtkVolumePtr mVolume;
 	long mMaxVoxels; ///< always resample volume below this size.
+	long mInteractiveMaxVoxels; ///< volume size used while the camera moves
 
 	ImagePtr mImage;
 	cx::ImageMapperMonitorPtr mMonitor; ///< helper object for visualizing clipping/cropping
@@ -99,6 +111,22 @@ protected slots:
 	void transformChangedSlot();
 	void vtkImageDataChangedSlot();
 	void updateVtkImageDataSlot();
+	void pyramidLevelAddedSlot();
+	void refineSlot();
+
+private:
+	void updateInput();
+	bool needsPyramid() const;
+	bool cameraHasMoved();
+
+	ImagePyramidPtr mPyramid;
+	vtkImageDataPtr mInput; ///< current mapper input, a level of mPyramid or a resampled image
+	bool mInteracting;
+	QTimer* mRefineTimer;
+	Vector3D mCameraPosition;
+	Vector3D mCameraFocalPoint;
+	Vector3D mCameraViewUp;
+	double mCameraScale;
 };
 //---------------------------------------------------------
 } // namespace cx
@@ -16,6 +16,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include "cxView.h"
 #include "cxLayoutData.h"
+#include "cxForwardDeclarations.h"
 #include <QWidget>
 
 
@@ -51,6 +52,17 @@ public:
 	virtual void clearViews() = 0;
 	virtual void setModified() = 0;
 	virtual void render() = 0;
+	/**
+	 * Render modified views, those with the highest render priority first.
+	 * Views not reached within budget ms are left modified for the next call.
+	 * Render time for each view is stored in logger, if given.
+	 */
+	virtual void renderModified(qint64 budget, CyclicActionLoggerPtr logger)
+	{
+		Q_UNUSED(budget);
+		Q_UNUSED(logger);
+		this->render();
+	}
 	virtual void setGridSpacing(int val) = 0;
 	virtual void setGridMargin(int val) = 0;
     virtual int getGridSpacing() const = 0;
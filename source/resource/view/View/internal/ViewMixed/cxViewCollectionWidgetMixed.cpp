@@ -17,6 +17,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "vtkRenderWindow.h"
 #include "cxGLHelpers.h"
 #include "cxLogger.h"
+#include "cxCyclicActionLogger.h"
 #include "cxMultiViewCache.h"
 #include "cxRenderWindowFactory.h"
 
@@ -132,6 +133,22 @@ void ViewCollectionWidgetMixed::render()
     emit rendered();
 }
 
+void ViewCollectionWidgetMixed::renderModified(qint64 budget, CyclicActionLoggerPtr logger)
+{
+	mBaseLayout->renderModified(budget, logger);
+
+	for (unsigned i=0; i<mOverlays.size(); ++i)
+	{
+		if (!mOverlays[i]->isModified())
+			continue;
+		mOverlays[i]->render();
+		if (logger)
+			logger->time("overlay " + mOverlays[i]->getView()->getName());
+	}
+
+	emit rendered();
+}
+
 void ViewCollectionWidgetMixed::setGridSpacing(int val)
 {
 	mLayout->setSpacing(val);
@@ -10,9 +10,12 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 =========================================================================*/
 
 #include "cxViewCollectionWidgetUsingViewWidgets.h"
+#include <algorithm>
 #include "cxGLHelpers.h"
 #include "cxViewUtilities.h"
 #include "cxLogger.h"
+#include <QElapsedTimer>
+#include "cxCyclicActionLogger.h"
 #include "vtkRenderWindow.h"
 #include "cxMultiViewCache.h"
 
@@ -96,6 +99,38 @@ void LayoutWidgetUsingViewWidgets::render()
     emit rendered();
 }
 
+namespace
+{
+bool higherRenderPriority(ViewWidget* a, ViewWidget* b)
+{
+	return a->getView()->getRenderPriority() > b->getView()->getRenderPriority();
+}
+}
+
+void LayoutWidgetUsingViewWidgets::renderModified(qint64 budget, CyclicActionLoggerPtr logger)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	std::vector<ViewWidget*> modified;
+	for (unsigned i=0; i<mViews.size(); ++i)
+		if (mViews[i]->isModified())
+			modified.push_back(mViews[i]);
+	std::stable_sort(modified.begin(), modified.end(), higherRenderPriority);
+
+	for (unsigned i=0; i<modified.size(); ++i)
+	{
+		// always render at least one view, in order to progress under load.
+		if (i>0 && timer.elapsed() > budget)
+			break;
+		modified[i]->render();
+		if (logger)
+			logger->time("view " + modified[i]->getView()->getName());
+	}
+
+	emit rendered();
+}
+
 QPoint LayoutWidgetUsingViewWidgets::getPosition(ViewPtr view)
 {
     ViewWidget* widget = this->WidgetFromView(view);
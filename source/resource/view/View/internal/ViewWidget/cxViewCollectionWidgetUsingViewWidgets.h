@@ -48,6 +48,7 @@ public:
 	virtual void clearViews();
 	virtual void setModified();
 	virtual void render();
+	virtual void renderModified(qint64 budget, CyclicActionLoggerPtr logger);
 	virtual void setGridSpacing(int val);
 	virtual void setGridMargin(int val);
     virtual int getGridSpacing() const;
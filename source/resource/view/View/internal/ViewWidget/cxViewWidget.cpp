@@ -28,7 +28,7 @@ namespace cx
 ViewWidget::ViewWidget(RenderWindowFactoryPtr factory, const QString& uid, const QString& name, QWidget *parent, Qt::WindowFlags f) :
 	inherited(parent, f)
 {
-	mMTimeHash = 0;
+	mRenderedMTime = 0;
 	this->setContextMenuPolicy(Qt::CustomContextMenu);
 	mZoomFactor = -1.0;
 	vtkRenderWindowPtr rw = factory->getRenderWindow(uid);
@@ -63,20 +63,24 @@ vtkRendererPtr ViewWidget::getRenderer()
 	return this->getView()->getRenderer();
 }
 
+bool ViewWidget::isModified()
+{
+	return mView->getRenderMTime() > mRenderedMTime;
+}
+
 void ViewWidget::render()
 {
 	// Render is called only when mtime is changed.
 	// At least on MaxOS, this is not done automatically.
-	unsigned long hash = mView->computeTotalMTime();
+	if (!this->isModified())
+		return;
 
-	if (hash != mMTimeHash)
-	{
-		this->getRenderWindow()->Render();
-		mMTimeHash = hash;
+	this->getRenderWindow()->Render();
+	// sample after render: changes done by the reps during render are already drawn.
+	mRenderedMTime = mView->getRenderMTime();
 
-		QString msg("During rendering of view: " + this->getView()->getName());
-		report_gl_error_text(cstring_cast(msg));
-	}
+	QString msg("During rendering of view: " + this->getView()->getName());
+	report_gl_error_text(cstring_cast(msg));
 }
 
 void ViewWidget::resizeEvent(QResizeEvent * event)
@@ -48,7 +48,8 @@ public:
 	virtual DoubleBoundingBox3D getViewport_s() const;
 
 	virtual void setModified() { mView->setModified(); }
-	void render();
+	bool isModified(); ///< true if anything in the view changed since the last render
+	void render(); ///< render if modified
 
 signals:
 	void resized(QSize size);
@@ -74,7 +75,7 @@ private:
 
 	double mZoomFactor; ///< zoom factor for this view. 1 means that 1m on screen is 1m
 	boost::shared_ptr<class ViewRepCollection> mView;
-	unsigned long mMTimeHash; ///< sum of all MTimes in objects rendered
+	unsigned long mRenderedMTime; ///< latest MTime of objects rendered, sampled after the last render
 
 //	SharedOpenGLContextPtr mSharedOpenGLContext;
 };
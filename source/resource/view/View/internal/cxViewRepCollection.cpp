@@ -11,8 +11,12 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include "cxViewRepCollection.h"
 
+#include <algorithm>
 #include <vtkImageActor.h>
 #include <vtkImageData.h>
+#include <vtkCamera.h>
+#include <vtkLight.h>
+#include <vtkLightCollection.h>
 #include "vtkRenderWindow.h"
 #include "vtkRenderer.h"
 
@@ -217,4 +221,54 @@ int ViewRepCollection::computeTotalMTime()
 	return hash;
 }
 
+/** MTimes are taken from a global counter, thus the latest MTime
+  * of all objects in the view changes if and only if any of them changes.
+  * The objects are the renderer, window, active camera, lights and props.
+  * This is in contrast to computeTotalMTime(), where changes might cancel out.
+  */
+unsigned long ViewRepCollection::getRenderMTime()
+{
+	unsigned long retval = 0;
+
+	retval = std::max<unsigned long>(retval, this->getRenderer()->GetMTime());
+	retval = std::max<unsigned long>(retval, this->getRenderWindow()->GetMTime());
+	if (this->getRenderer()->IsActiveCameraCreated()) // GetActiveCamera() would create one
+		retval = std::max<unsigned long>(retval, this->getRenderer()->GetActiveCamera()->GetMTime());
+	vtkLightCollection* lights = this->getRenderer()->GetLights();
+	retval = std::max<unsigned long>(retval, lights->GetMTime());
+	lights->InitTraversal();
+	for (vtkLight* light = lights->GetNextItem(); light != NULL; light = lights->GetNextItem())
+		retval = std::max<unsigned long>(retval, light->GetMTime());
+	vtkPropCollection* props = this->getRenderer()->GetViewProps();
+	retval = std::max<unsigned long>(retval, props->GetMTime()); // props added or removed
+	props->InitTraversal();
+	for (vtkProp* prop = props->GetNextProp(); prop != NULL; prop = props->GetNextProp())
+	{
+		vtkImageActor* imageActor = vtkImageActor::SafeDownCast(prop);
+		if (imageActor && imageActor->GetInput())
+			retval = std::max<unsigned long>(retval, imageActor->GetInput()->GetMTime());
+		retval = std::max<unsigned long>(retval, prop->GetMTime());
+		retval = std::max<unsigned long>(retval, prop->GetRedrawMTime());
+	}
+
+	return retval;
+}
+
+int ViewRepCollection::getRenderPriority()
+{
+	if (mType == View::VIEW_REAL_TIME)
+		return 2;
+
+	int retval = 0;
+	for (unsigned i = 0; i < mReps.size(); ++i)
+	{
+		QString type = mReps[i]->getType();
+		if (type == "RealTimeStreamFixedPlaneRep" || type == "Stream2DRep3D" || type == "StreamRep3D")
+			return 2;
+		if (type.endsWith("ToolRep3D") || type.endsWith("ToolRep2D"))
+			retval = 1;
+	}
+	return retval;
+}
+
 } // namespace cx
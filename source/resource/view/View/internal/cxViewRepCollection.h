@@ -63,6 +63,8 @@ public:
 
 	virtual void setModified();
 	int computeTotalMTime();
+	unsigned long getRenderMTime(); ///< latest MTime of all objects rendered. Increases when a render is needed.
+	int getRenderPriority(); ///< 2 for views with live video, 1 for views with tools, 0 otherwise.
 
 	QColor mBackgroundColor;
 	QString mUid; ///< The view's unique id
@@ -32,10 +32,27 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include "cxImage.h"
 #include "cxUtilHelpers.h"
 #include "cxSettings.h"
+#include "cxDirtyExtentTracker.h"
 
 namespace cx
 {
 
+namespace
+{
+long getNumberOfBytes(vtkImageDataPtr data, const IntBoundingBox3D& region)
+{
+	return DirtyExtentTracker::getNumberOfVoxels(region) * data->GetScalarSize() * data->GetNumberOfScalarComponents();
+}
+}
+
+bool SharedOpenGLContext::Texture3DState::hasFormatOf(vtkImageDataPtr data) const
+{
+	int* dim = data->GetDimensions();
+	return (dim[0]==mDim[0]) && (dim[1]==mDim[1]) && (dim[2]==mDim[2])
+			&& (data->GetScalarType()==mDataType)
+			&& (data->GetNumberOfScalarComponents()==mNumComps);
+}
+
 bool SharedOpenGLContext::isValid(vtkOpenGLRenderWindowPtr opengl_renderwindow, bool print)
 {
 	bool valid = true;
@@ -64,7 +81,8 @@ bool SharedOpenGLContext::isValid(vtkOpenGLRenderWindowPtr opengl_renderwindow,
 }
 
 SharedOpenGLContext::SharedOpenGLContext(vtkOpenGLRenderWindowPtr sharedContext) :
-	mContext(sharedContext)
+	mContext(sharedContext),
+	mUploadedBytes(0)
 {
 }
 
@@ -103,12 +121,27 @@ bool SharedOpenGLContext::delete3DTextureForImage(QString image_uid)
 	{
 		m3DTextureObjects.erase(it);
 		texture->ReleaseGraphicsResources(mContext);
+		this->release3DTextureState(image_uid);
 		success = true;
 	}
 
 	return success;
 }
 
+void SharedOpenGLContext::release3DTextureState(QString image_uid)
+{
+	std::map<QString, Texture3DState>::iterator it = m3DTextureStates.find(image_uid);
+	if(it == m3DTextureStates.end())
+		return;
+
+	for(int i=0; i<2; ++i)
+	{
+		if(it->second.mPixelBuffers[i] && this->makeCurrent())
+			glDeleteBuffers(1, &it->second.mPixelBuffers[i]);
+	}
+	m3DTextureStates.erase(it);
+}
+
 vtkImageDataPtr SharedOpenGLContext::downloadImageFromTextureBuffer(QString image_uid)
 {
 	vtkPixelBufferObjectPtr pixelBuffer;
@@ -170,10 +203,27 @@ bool SharedOpenGLContext::uploadImage(ImagePtr image)
 	bool not_uploaded = it == m3DTextureObjects.end();
 	bool uploade_and_not_modified = (it != m3DTextureObjects.end() && (it->second.second == new_modified_time) );
 
-	if( uploaded_but_modified || not_uploaded)
+	vtkImageDataPtr vtkImageData = image->getBaseVtkImageData();
+	Texture3DState& state = m3DTextureStates[image->getUid()];
+	bool same_format = uploaded_but_modified && state.hasFormatOf(vtkImageData);
+
+	if(same_format)
+	{
+		//update the existing texture: the changed bricks only if known, otherwise everything
+		vtkTextureObjectPtr texture_object = it->second.first;
+		std::vector<IntBoundingBox3D> modified = image->getDirtyExtents()->getModifiedSince(vtkImageData, it->second.second);
+		IntBoundingBox3D wholeExtent(vtkImageData->GetExtent());
+		bool partial = !modified.empty() && (modified.size()>1 || modified[0]!=wholeExtent);
+
+		if(partial)
+			success = this->updateSubRegions3D(texture_object, vtkImageData, DirtyExtentTracker::toBricks(modified, wholeExtent, 32));
+		else
+			success = this->stream3DTexture(texture_object, state, vtkImageData);
+		it->second.second = new_modified_time;
+	}
+	else if( uploaded_but_modified || not_uploaded)
 	{
 		//upload new data to gpu
-		vtkImageDataPtr vtkImageData = image->getBaseVtkImageData();
 		int* dims = vtkImageData->GetDimensions();
 		int dataType = vtkImageData->GetScalarType();
 		int numComps = vtkImageData->GetNumberOfScalarComponents();
@@ -198,6 +248,11 @@ bool SharedOpenGLContext::uploadImage(ImagePtr image)
 
 		success = this->create3DTextureObject(texture_object, dims[0], dims[1], dims[2], dataType, numComps, data, mContext);
 		m3DTextureObjects[image->getUid()] = std::make_pair(texture_object, vtkImageData->GetMTime());
+		mUploadedBytes += getNumberOfBytes(vtkImageData, IntBoundingBox3D(vtkImageData->GetExtent()));
+
+		std::copy(dims, dims+3, state.mDim);
+		state.mDataType = dataType;
+		state.mNumComps = numComps;
 	}
 	else if(uploade_and_not_modified)
 	{
@@ -440,6 +495,95 @@ bool SharedOpenGLContext::create3DTextureObject(vtkTextureObjectPtr texture_obje
 	return true;
 }
 
+/**
+ * Send the regions of data to the existing texture, reading directly from the image memory.
+ */
+bool SharedOpenGLContext::updateSubRegions3D(vtkTextureObjectPtr texture_object, vtkImageDataPtr data, std::vector<IntBoundingBox3D> regions)
+{
+	// use the same pixel format as when the texture was created by Create3DFromRaw()
+	GLenum format = texture_object->GetFormat(data->GetScalarType(), data->GetNumberOfScalarComponents(), false);
+	GLenum type = texture_object->GetDataType(data->GetScalarType());
+	if(!this->makeCurrent())
+	{
+		CX_LOG_ERROR() << "Could not update 3D texture";
+		return false;
+	}
+
+	int* dims = data->GetDimensions();
+	int* extent = data->GetExtent();
+
+	texture_object->Activate();
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, dims[0]);
+	glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, dims[1]);
+
+	for(unsigned i=0; i<regions.size(); ++i)
+	{
+		const IntBoundingBox3D& r = regions[i];
+		void* ptr = data->GetScalarPointer(r[0], r[2], r[4]);
+		glTexSubImage3D(GL_TEXTURE_3D, 0,
+						r[0]-extent[0], r[2]-extent[2], r[4]-extent[4],
+						r[1]-r[0]+1, r[3]-r[2]+1, r[5]-r[4]+1,
+						format, type, ptr);
+		mUploadedBytes += getNumberOfBytes(data, r);
+	}
+
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+	texture_object->Deactivate();
+	report_gl_error();
+	return true;
+}
+
+/**
+ * Send all of data to the existing texture through a pixel buffer.
+ *
+ * The two pixel buffers of the texture are used alternately: the driver
+ * can still be transferring the previous volume from one buffer while
+ * the next volume is copied into the other.
+ */
+bool SharedOpenGLContext::stream3DTexture(vtkTextureObjectPtr texture_object, Texture3DState& state, vtkImageDataPtr data)
+{
+	// use the same pixel format as when the texture was created by Create3DFromRaw()
+	GLenum format = texture_object->GetFormat(data->GetScalarType(), data->GetNumberOfScalarComponents(), false);
+	GLenum type = texture_object->GetDataType(data->GetScalarType());
+	if(!this->makeCurrent())
+	{
+		CX_LOG_ERROR() << "Could not stream 3D texture";
+		return false;
+	}
+
+	IntBoundingBox3D wholeExtent(data->GetExtent());
+	long bytes = getNumberOfBytes(data, wholeExtent);
+
+	GLuint& buffer = state.mPixelBuffers[state.mNextPixelBuffer];
+	state.mNextPixelBuffer = (state.mNextPixelBuffer+1)%2;
+	if(!buffer)
+		glGenBuffers(1, &buffer);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, NULL, GL_STREAM_DRAW); // orphan old storage instead of waiting for it
+	void* mapped = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+	if(!mapped)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		CX_LOG_ERROR() << "Could not map pixel buffer for 3D texture";
+		return false;
+	}
+	memcpy(mapped, data->GetScalarPointer(), bytes);
+	glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+	texture_object->Activate();
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, state.mDim[0], state.mDim[1], state.mDim[2], format, type, 0); // reads from the bound pixel buffer
+	texture_object->Deactivate();
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	mUploadedBytes += bytes;
+	report_gl_error();
+	return true;
+}
+
 bool SharedOpenGLContext::useLinearInterpolation() const
 {
 	return settings()->value("View2D/useLinearInterpolationIn2DRendering").toBool();
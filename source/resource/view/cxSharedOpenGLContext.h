@@ -18,12 +18,15 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 
 #include <GL/glew.h>
 
+#include <map>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 #include "vtkForwardDeclarations.h"
 
 #include "cxResourceVisualizationExport.h"
 #include "cxForwardDeclarations.h"
 #include "vtkForwardDeclarations.h"
+#include "cxBoundingBox3D.h"
 
 namespace cx
 {
@@ -40,6 +43,12 @@ typedef boost::shared_ptr<class SharedOpenGLContext> SharedOpenGLContextPtr;
  * There exist only one shared OpenGL context, and this is set to be the id of the first context created by vtkRenderWindow.
  * All vtkRenderWindows created gets this shared context.
  * This means that the first vtkRenderWindow MUST NOT be deleted, as it contains THE OpenGL context.
+ *
+ * When an uploaded image is modified, only the bricks touched by the
+ * modified extents (see Image::setVtkImageDataModified()) are sent to
+ * the existing texture. Images replaced entirely, such as streamed
+ * volumes, are sent through two pixel buffers used alternately, so that
+ * copying a new volume does not wait for the transfer of the previous one.
  */
 class cxResourceVisualization_EXPORT SharedOpenGLContext
 {
@@ -69,11 +78,32 @@ public:
 	bool hasUploadedTextureCoordinates(QString uid) const;
 	vtkOpenGLBufferObjectPtr getTextureCoordinates(QString uid) const;
 	vtkImageDataPtr downloadImageFromTextureBuffer(QString image_uid);//For testing
+	long getUploadedBytes() const { return mUploadedBytes; } ///< total image bytes sent to the GPU, for testing and benchmarking
 
 
 private:
 	bool create1DTextureObject(vtkTextureObjectPtr texture_object, unsigned int width, int dataType, int numComps, void *data, vtkOpenGLRenderWindowPtr opengl_renderwindow) const;
 	bool create3DTextureObject(vtkTextureObjectPtr texture_object, unsigned int width, unsigned int height, unsigned int depth, int dataType, int numComps, void *data, vtkOpenGLRenderWindowPtr opengl_renderwindow) const;
+	/**
+	 * Format of an uploaded 3D texture, and the pixel buffers used for streamed updates
+	 */
+	struct Texture3DState
+	{
+		Texture3DState() : mDataType(0), mNumComps(0), mNextPixelBuffer(0)
+		{
+			mDim[0] = mDim[1] = mDim[2] = 0;
+			mPixelBuffers[0] = mPixelBuffers[1] = 0;
+		}
+		bool hasFormatOf(vtkImageDataPtr data) const;
+		int mDim[3];
+		int mDataType;
+		int mNumComps;
+		GLuint mPixelBuffers[2];
+		int mNextPixelBuffer;
+	};
+	bool updateSubRegions3D(vtkTextureObjectPtr texture_object, vtkImageDataPtr data, std::vector<IntBoundingBox3D> regions);
+	bool stream3DTexture(vtkTextureObjectPtr texture_object, Texture3DState& state, vtkImageDataPtr data);
+	void release3DTextureState(QString image_uid);
 	vtkOpenGLBufferObjectPtr allocateAndUploadArrayBuffer(QString uid, int my_numberOfTextureCoordinates, int numberOfComponentsPerTexture, const float *texture_data) const;
 
 	/**
@@ -85,6 +115,8 @@ private:
 	std::map<QString, std::pair<vtkTextureObjectPtr, unsigned long> > m3DTextureObjects;
 
 	std::map<QString, vtkOpenGLBufferObjectPtr > mTextureCoordinateBuffers;
+	std::map<QString, Texture3DState> m3DTextureStates;
+	long mUploadedBytes;
 
 	vtkOpenGLRenderWindowPtr mContext;
 
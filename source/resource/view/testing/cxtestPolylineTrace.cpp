@@ -0,0 +1,72 @@
+/*=========================================================================
+This file is part of CustusX, an Image Guided Therapy Application.
+                 
+Copyright (c) SINTEF Department of Medical Technology.
+All rights reserved.
+                 
+CustusX is released under a BSD 3-Clause license.
+                 
+See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt) for details.
+=========================================================================*/
+#include "catch.hpp"
+#include <vtkPolyData.h>
+#include "cxPolylineTrace.h"
+
+namespace cxtest
+{
+
+TEST_CASE("PolylineTrace: All points are stored and rendered in chunks", "[unit][resource][visualization]")
+{
+	cx::PolylineTrace trace;
+	trace.setChunkSize(10);
+
+	for (int i=0; i<25; ++i)
+		trace.addPoint(cx::Vector3D(i, 0, 0));
+
+	CHECK(trace.getNumberOfPoints() == 25);
+	CHECK(trace.getPolyData()->GetNumberOfPoints() == 20);
+	CHECK(trace.getTailPolyData()->GetNumberOfPoints() == 6); // last stored point + 5 pending
+
+	trace.flush();
+	CHECK(trace.getPolyData()->GetNumberOfPoints() == 25);
+	CHECK(trace.getPoint(24)[0] == Approx(24));
+
+	trace.clear();
+	CHECK(trace.getNumberOfPoints() == 0);
+	CHECK(trace.getPolyData()->GetNumberOfPoints() == 0);
+}
+
+TEST_CASE("PolylineTrace: Decimation removes points on straight segments", "[unit][resource][visualization]")
+{
+	cx::PolylineTrace trace;
+	trace.setChunkSize(100);
+	trace.setDecimationTolerance(0.1);
+
+	// an L-shaped path: only the corner and end points are required
+	for (int i=0; i<=50; ++i)
+		trace.addPoint(cx::Vector3D(i, 0, 0));
+	for (int i=1; i<=49; ++i)
+		trace.addPoint(cx::Vector3D(50, i, 0));
+	trace.flush();
+
+	CHECK(trace.getNumberOfPoints() == 3);
+	CHECK(trace.getPoint(1)[0] == Approx(50));
+	CHECK(trace.getPoint(1)[1] == Approx(0));
+}
+
+TEST_CASE("PolylineTrace: Level of detail limits the rendered points", "[unit][resource][visualization]")
+{
+	cx::PolylineTrace trace;
+	trace.setChunkSize(16);
+	trace.setMaxRenderedPoints(100);
+
+	for (int i=0; i<1000; ++i)
+		trace.addPoint(cx::Vector3D(i, i%7, 0));
+	trace.flush();
+
+	CHECK(trace.getNumberOfPoints() == 1000);
+	CHECK(trace.getPolyData()->GetNumberOfPoints() <= 100);
+	CHECK(trace.getRenderStride() > 1);
+}
+
+} // namespace cxtest
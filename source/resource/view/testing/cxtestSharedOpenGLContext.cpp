@@ -98,6 +98,45 @@ TEST_CASE("SharedOpenGLContext download texture", "[opengl][resource][visualizat
 	}
 }
 
+TEST_CASE("SharedOpenGLContext uploads only modified bricks", "[opengl][resource][visualization][integration]")
+{
+	cx::RenderWindowFactoryPtr renderWindowFactory = cx::RenderWindowFactoryPtr(new cx::RenderWindowFactory());
+	REQUIRE(renderWindowFactory->getRenderWindow("TestWindowUid"));
+	cx::SharedOpenGLContextPtr sharedOpenGLContext = renderWindowFactory->getSharedOpenGLContext();
+	REQUIRE(sharedOpenGLContext);
+
+	cx::ImagePtr image = createDummyImage(0, 100);
+	vtkImageDataPtr imageData0 = image->getBaseVtkImageData();
+	long fullBytes = imageData0->GetNumberOfPoints() * imageData0->GetScalarSize() * imageData0->GetNumberOfScalarComponents();
+
+	long bytes0 = sharedOpenGLContext->getUploadedBytes();
+	REQUIRE(sharedOpenGLContext->uploadImage(image));
+	CHECK(sharedOpenGLContext->getUploadedBytes()-bytes0 == fullBytes);
+
+	cx::IntBoundingBox3D region(2,5, 2,5, 2,5);
+	for (int z=region[4]; z<=region[5]; ++z)
+		for (int y=region[2]; y<=region[3]; ++y)
+			for (int x=region[0]; x<=region[1]; ++x)
+				static_cast<unsigned char*>(imageData0->GetScalarPointer(x,y,z))[0] = 17;
+	image->setVtkImageDataModified(region);
+
+	long bytes1 = sharedOpenGLContext->getUploadedBytes();
+	REQUIRE(sharedOpenGLContext->uploadImage(image));
+	long brickBytes = sharedOpenGLContext->getUploadedBytes()-bytes1;
+	CHECK(brickBytes == 32*32*32*imageData0->GetScalarSize()*imageData0->GetNumberOfScalarComponents());
+	CHECK(brickBytes < fullBytes);
+
+	vtkImageDataPtr imageData = sharedOpenGLContext->downloadImageFromTextureBuffer(image->getUid());
+	REQUIRE(imageData);
+	char* imagePtr = static_cast<char*>(imageData->GetScalarPointer());
+	char* imagePtr0 = static_cast<char*>(imageData0->GetScalarPointer());
+	for (int i = 0; i < fullBytes; ++i)
+	{
+		INFO(i);
+		REQUIRE(imagePtr[i] == imagePtr0[i]);
+	}
+}
+
 TEST_CASE("SharedOpenGLContext upload many textures", "[opengl][resource][visualization][integration]")
 {
 	cx::RenderWindowFactoryPtr renderWindowFactory = cx::RenderWindowFactoryPtr(new cx::RenderWindowFactory());
@@ -37,6 +37,13 @@ TimedAlgorithmProgressBar::TimedAlgorithmProgressBar(QWidget* parent) :
 	mProgressBar = new QProgressBar;
 	mProgressBar->hide();
 	layout->addWidget(mProgressBar);
+
+	mCancelButton = new QToolButton;
+	mCancelButton->setText("Cancel");
+	mCancelButton->setToolTip("Cancel the running algorithm");
+	mCancelButton->hide();
+	connect(mCancelButton, SIGNAL(clicked()), this, SLOT(cancelSlot()));
+	layout->addWidget(mCancelButton);
 }
 
 void TimedAlgorithmProgressBar::attach(std::set<cx::TimedAlgorithmPtr> threads)
@@ -63,6 +70,7 @@ void TimedAlgorithmProgressBar::attach(TimedAlgorithmPtr algorithm)
 		connect(algorithm.get(), SIGNAL(started(int)), this, SLOT(algorithmStartedSlot(int)));
 		connect(algorithm.get(), SIGNAL(finished()), this, SLOT(algorithmFinishedSlot()));
 		connect(algorithm.get(), SIGNAL(productChanged()), this, SLOT(productChangedSlot()));
+		connect(algorithm.get(), SIGNAL(progress(int, int)), this, SLOT(algorithmProgressSlot(int, int)));
 	}
 
 	mAlgorithm.insert(algorithm);
@@ -78,6 +86,7 @@ void TimedAlgorithmProgressBar::detach(TimedAlgorithmPtr algorithm)
 		disconnect(algorithm.get(), SIGNAL(started(int)), this, SLOT(algorithmStartedSlot(int)));
 		disconnect(algorithm.get(), SIGNAL(finished()), this, SLOT(algorithmFinishedSlot()));
 		disconnect(algorithm.get(), SIGNAL(productChanged()), this, SLOT(productChangedSlot()));
+		disconnect(algorithm.get(), SIGNAL(progress(int, int)), this, SLOT(algorithmProgressSlot(int, int)));
 		this->algorithmFinished(algorithm.get());
 	}
 
@@ -118,6 +127,24 @@ void TimedAlgorithmProgressBar::algorithmStartedSlot(int maxSteps)
 	mProgressBar->setRange(0, maxSteps);
 	mProgressBar->setValue(0);
 	mProgressBar->show();
+	mCancelButton->show();
+}
+
+void TimedAlgorithmProgressBar::algorithmProgressSlot(int step, int maxSteps)
+{
+	if (mProgressBar->maximum()!=maxSteps)
+		mProgressBar->setRange(0, maxSteps);
+	mProgressBar->setValue(step);
+}
+
+void TimedAlgorithmProgressBar::cancelSlot()
+{
+	std::set<TimedAlgorithmPtr>::iterator iter;
+	for(iter=mAlgorithm.begin(); iter!=mAlgorithm.end(); ++iter)
+	{
+		if (*iter && mStartedAlgos.count(iter->get()))
+			(*iter)->cancel();
+	}
 }
 
 void TimedAlgorithmProgressBar::algorithmFinishedSlot()
@@ -139,6 +166,7 @@ void TimedAlgorithmProgressBar::algorithmFinished(TimedBaseAlgorithm* algo)
 	mProgressBar->setValue(0);
 	mProgressBar->hide();
 	mLabel->hide();
+	mCancelButton->hide();
 
 	mTimerWidget->hide();
 	mTimerWidget->stop();
@@ -19,6 +19,7 @@ See Lisence.txt (https://github.com/SINTEFMedtek/CustusX/blob/master/License.txt
 #include <QWidget>
 class QProgressBar;
 class QLabel;
+class QToolButton;
 
 namespace cx
 {
@@ -66,13 +67,16 @@ public:
 private slots:
 	void algorithmStartedSlot(int maxSteps);
 	void algorithmFinishedSlot();
+	void algorithmProgressSlot(int step, int maxSteps);
 	void productChangedSlot();
+	void cancelSlot();
 
 private:
 	void algorithmFinished(TimedBaseAlgorithm* algo);
 	std::set<TimedAlgorithmPtr> mAlgorithm;
 	QProgressBar* mProgressBar;
 	QLabel* mLabel;
+	QToolButton* mCancelButton;
 	std::set<TimedBaseAlgorithm*> mStartedAlgos;
 	DisplayTimerWidget* mTimerWidget;
     bool mShowTextLabel;